@@ -430,6 +430,17 @@ class EnumerationFieldType(IntegerFieldType, collections.abc.Sequence):
 
         return self._get_mapping_iter(iter_ptr)
 
+    def labels_by_value(self, value):
+        if self.is_signed:
+            utils._check_int64(value)
+            labels = native_bt.py3_field_type_enumeration_get_mapping_names_by_signed_value(self._ptr, value)
+        else:
+            utils._check_uint64(value)
+            labels = native_bt.py3_field_type_enumeration_get_mapping_names_by_unsigned_value(self._ptr, value)
+
+        assert(labels is not None)
+        return labels
+
     def append_mapping(self, name, lower, upper=None):
         utils._check_str(name)
 
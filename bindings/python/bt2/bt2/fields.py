@@ -373,7 +373,7 @@ class _EnumerationField(_IntegerField):
         self.integer_field.value = value
 
     def _repr(self):
-        labels = [repr(v.name) for v in self.mappings]
+        labels = [repr(label) for label in self.labels]
         return '{} ({})'.format(self._value, ', '.join(labels))
 
     value = property(fset=_set_value)
@@ -382,6 +382,17 @@ class _EnumerationField(_IntegerField):
     def _value(self):
         return self.integer_field._value
 
+    @property
+    def labels(self):
+        if self.field_type.is_signed:
+            get_fn = native_bt.py3_field_type_enumeration_get_mapping_names_by_signed_value
+        else:
+            get_fn = native_bt.py3_field_type_enumeration_get_mapping_names_by_unsigned_value
+
+        labels = get_fn(self.field_type._ptr, self._value)
+        assert(labels is not None)
+        return labels
+
     @property
     def mappings(self):
         iter_ptr = native_bt.field_enumeration_get_mappings(self._ptr)
@@ -180,6 +180,114 @@ int bt_field_type_enumeration_mapping_iterator_get_unsigned(
 int bt_field_type_enumeration_mapping_iterator_next(
 		struct bt_field_type_enumeration_mapping_iterator *iter);
 
+/* Enumeration field type mapping names functions */
+%{
+static PyObject *bt_py3_enum_ft_mapping_names_to_py_list(
+		const char **names, int64_t count)
+{
+	PyObject *py_names;
+	int64_t i;
+
+	py_names = PyList_New(count);
+	if (!py_names) {
+		goto end;
+	}
+
+	for (i = 0; i < count; i++) {
+		PyObject *py_name = PyUnicode_FromString(names[i]);
+
+		if (!py_name) {
+			Py_DECREF(py_names);
+			py_names = NULL;
+			goto end;
+		}
+
+		/* Steals the reference */
+		PyList_SET_ITEM(py_names, i, py_name);
+	}
+
+end:
+	return py_names;
+}
+
+/*
+ * Returns a list of the names of the mappings which contain `value`, or
+ * None on error.
+ */
+static PyObject *bt_py3_field_type_enumeration_get_mapping_names(
+		struct bt_field_type *enum_field_type, int is_signed,
+		int64_t signed_value, uint64_t unsigned_value)
+{
+	const char *local_names[8];
+	const char **names = local_names;
+	PyObject *py_names = NULL;
+	int64_t count;
+
+	if (is_signed) {
+		count = bt_field_type_enumeration_get_mapping_names_by_signed_value(
+			enum_field_type, signed_value, names,
+			G_N_ELEMENTS(local_names));
+	} else {
+		count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+			enum_field_type, unsigned_value, names,
+			G_N_ELEMENTS(local_names));
+	}
+
+	if (count < 0) {
+		goto end;
+	}
+
+	if ((uint64_t) count > G_N_ELEMENTS(local_names)) {
+		names = g_new(const char *, count);
+		if (!names) {
+			goto end;
+		}
+
+		if (is_signed) {
+			count = bt_field_type_enumeration_get_mapping_names_by_signed_value(
+				enum_field_type, signed_value, names, count);
+		} else {
+			count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+				enum_field_type, unsigned_value, names, count);
+		}
+	}
+
+	py_names = bt_py3_enum_ft_mapping_names_to_py_list(names, count);
+
+end:
+	if (names != local_names) {
+		g_free(names);
+	}
+
+	if (!py_names) {
+		PyErr_Clear();
+		Py_INCREF(Py_None);
+		py_names = Py_None;
+	}
+
+	return py_names;
+}
+
+static PyObject *bt_py3_field_type_enumeration_get_mapping_names_by_signed_value(
+		struct bt_field_type *enum_field_type, int64_t value)
+{
+	return bt_py3_field_type_enumeration_get_mapping_names(
+		enum_field_type, 1, value, 0);
+}
+
+static PyObject *bt_py3_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		struct bt_field_type *enum_field_type, uint64_t value)
+{
+	return bt_py3_field_type_enumeration_get_mapping_names(
+		enum_field_type, 0, 0, value);
+}
+%}
+
+PyObject *bt_py3_field_type_enumeration_get_mapping_names_by_signed_value(
+		struct bt_field_type *enum_field_type, int64_t value);
+PyObject *bt_py3_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		struct bt_field_type *enum_field_type, uint64_t value);
+
 /* String field type functions */
 struct bt_field_type *bt_field_type_string_create(void);
 enum bt_string_encoding bt_field_type_string_get_encoding(
@@ -1341,6 +1341,7 @@ enum {
 	OPT_RUN_ARGS,
 	OPT_RUN_ARGS_0,
 	OPT_STREAM_INTERSECTION,
+	OPT_THREADED,
 	OPT_TIMERANGE,
 	OPT_URL,
 	OPT_VALUE,
@@ -2310,6 +2311,8 @@ void print_run_usage(FILE *fp)
 	fprintf(fp, "      --retry-duration=DUR          When babeltrace(1) needs to retry to run\n");
 	fprintf(fp, "                                    the graph later, retry in DUR µs\n");
 	fprintf(fp, "                                    (default: 100000)\n");
+	fprintf(fp, "      --threaded                    Run the source and filter components'\n");
+	fprintf(fp, "                                    notification iterators on worker threads\n");
 	fprintf(fp, "      --value=VAL                   Add a string initialization parameter to\n");
 	fprintf(fp, "                                    the current component with a name given by\n");
 	fprintf(fp, "                                    the last argument of the --key option and a\n");
@@ -2393,6 +2396,7 @@ struct bt_config *bt_config_run_from_args(int argc, const char *argv[],
 		{ "plugin-path", '\0', POPT_ARG_STRING, NULL, OPT_PLUGIN_PATH, NULL, NULL },
 		{ "reset-base-params", 'r', POPT_ARG_NONE, NULL, OPT_RESET_BASE_PARAMS, NULL, NULL },
 		{ "retry-duration", '\0', POPT_ARG_LONG, &retry_duration, OPT_RETRY_DURATION, NULL, NULL },
+		{ "threaded", '\0', POPT_ARG_NONE, NULL, OPT_THREADED, NULL, NULL },
 		{ "value", '\0', POPT_ARG_STRING, NULL, OPT_VALUE, NULL, NULL },
 		{ NULL, 0, '\0', NULL, 0, NULL, NULL },
 	};
@@ -2617,6 +2621,9 @@ struct bt_config *bt_config_run_from_args(int argc, const char *argv[],
 			cfg->cmd_data.run.retry_duration_us =
 				(uint64_t) retry_duration;
 			break;
+		case OPT_THREADED:
+			cfg->cmd_data.run.threaded = true;
+			break;
 		case OPT_HELP:
 			print_run_usage(stdout);
 			*retcode = -1;
@@ -2786,6 +2793,8 @@ void print_convert_usage(FILE *fp)
 	fprintf(fp, "                                    formatted for `xargs -0`, and quit\n");
 	fprintf(fp, "      --stream-intersection         Only process events when all streams\n");
 	fprintf(fp, "                                    are active\n");
+	fprintf(fp, "      --threaded                    Run the source and filter components'\n");
+	fprintf(fp, "                                    notification iterators on worker threads\n");
 	fprintf(fp, "  -u, --url=URL                     Set the `url` string parameter of the\n");
 	fprintf(fp, "                                    current component to URL\n");
 	fprintf(fp, "  -h, --help                        Show this help and quit\n");
@@ -2917,6 +2926,7 @@ struct poptOption convert_long_options[] = {
 	{ "run-args", '\0', POPT_ARG_NONE, NULL, OPT_RUN_ARGS, NULL, NULL },
 	{ "run-args-0", '\0', POPT_ARG_NONE, NULL, OPT_RUN_ARGS_0, NULL, NULL },
 	{ "stream-intersection", '\0', POPT_ARG_NONE, NULL, OPT_STREAM_INTERSECTION, NULL, NULL },
+	{ "threaded", '\0', POPT_ARG_NONE, NULL, OPT_THREADED, NULL, NULL },
 	{ "timerange", '\0', POPT_ARG_STRING, NULL, OPT_TIMERANGE, NULL, NULL },
 	{ "url", 'u', POPT_ARG_STRING, NULL, OPT_URL, NULL, NULL },
 	{ "verbose", 'v', POPT_ARG_NONE, NULL, OPT_VERBOSE, NULL, NULL },
@@ -3918,6 +3928,13 @@ struct bt_config *bt_config_convert_from_args(int argc, const char *argv[],
 				goto error;
 			}
 			break;
+		case OPT_THREADED:
+			if (bt_value_array_append_string(run_args,
+					"--threaded")) {
+				print_err_oom();
+				goto error;
+			}
+			break;
 		case OPT_PLUGIN_PATH:
 			if (bt_config_append_plugin_paths_check_setuid_setgid(
 					plugin_paths, arg)) {
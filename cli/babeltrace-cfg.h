@@ -93,6 +93,9 @@ struct bt_config {
 			 */
 			uint64_t retry_duration_us;
 
+			/* Whether or not to make the graph threaded */
+			bool threaded;
+
 			/*
 			 * Whether or not to trim the source trace to the
 			 * intersection of its streams.
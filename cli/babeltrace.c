@@ -68,6 +68,8 @@ static const char* log_level_env_var_names[] = {
 	"BABELTRACE_SINK_TEXT_PRETTY_LOG_LEVEL",
 	"BABELTRACE_FLT_UTILS_MUXER_LOG_LEVEL",
 	"BABELTRACE_FLT_UTILS_TRIMMER_LOG_LEVEL",
+	"BABELTRACE_SINK_UTILS_COLUMNAR_LOG_LEVEL",
+	"BABELTRACE_SINK_UTILS_STATS_LOG_LEVEL",
 	"BABELTRACE_PYTHON_BT2_LOG_LEVEL",
 	"BABELTRACE_PYTHON_PLUGIN_PROVIDER_LOG_LEVEL",
 	NULL,
@@ -2056,6 +2058,12 @@ int cmd_run_ctx_init(struct cmd_run_ctx *ctx, struct bt_config *cfg)
 		goto error;
 	}
 
+	if (cfg->cmd_data.run.threaded) {
+		if (bt_graph_set_threaded(ctx->graph, BT_TRUE)) {
+			goto error;
+		}
+	}
+
 	the_graph = ctx->graph;
 	ret = bt_graph_add_port_added_listener(ctx->graph,
 		graph_port_added_listener, NULL, ctx);
@@ -2649,15 +2657,26 @@ int cmd_run(struct bt_config *cfg)
 			}
 
 			if (cfg->cmd_data.run.retry_duration_us > 0) {
-				BT_LOGV("Got BT_GRAPH_STATUS_AGAIN: sleeping: "
-					"time-us=%" PRIu64,
-					cfg->cmd_data.run.retry_duration_us);
+				enum bt_graph_status wait_status;
 
-				if (usleep(cfg->cmd_data.run.retry_duration_us)) {
-					if (bt_graph_is_canceled(ctx.graph)) {
-						BT_LOGI_STR("Graph was canceled by user.");
-						goto error;
-					}
+				/*
+				 * Wait until a component is ready, or
+				 * for the retry duration at most.
+				 */
+				BT_LOGV("Got BT_GRAPH_STATUS_AGAIN: waiting: "
+					"max-time-us=%" PRIu64,
+					cfg->cmd_data.run.retry_duration_us);
+				wait_status = bt_graph_wait_ready(ctx.graph,
+					(int64_t) MIN(cfg->cmd_data.run.retry_duration_us,
+						(uint64_t) INT64_MAX));
+				if (wait_status == BT_GRAPH_STATUS_CANCELED) {
+					BT_LOGI_STR("Graph was canceled by user.");
+					goto error;
+				} else if (wait_status < 0) {
+					BT_LOGE("Cannot wait for a ready component: "
+						"status=%s",
+						bt_graph_status_str(wait_status));
+					goto error;
 				}
 			}
 			break;
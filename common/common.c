@@ -1246,3 +1246,18 @@ size_t bt_common_get_page_size(void)
 
 	return page_size;
 }
+
+BT_HIDDEN
+unsigned int bt_common_get_cpu_count(void)
+{
+	long cpu_count;
+
+	cpu_count = bt_sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpu_count < 1) {
+		BT_LOGW("Cannot get system's online processor count: ret=%ld",
+			cpu_count);
+		cpu_count = 1;
+	}
+
+	return (unsigned int) cpu_count;
+}
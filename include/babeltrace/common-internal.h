@@ -205,4 +205,11 @@ GString *bt_common_normalize_path(const char *path, const char *wd);
 BT_HIDDEN
 size_t bt_common_get_page_size(void);
 
+/*
+ * Return the number of online processors, or 1 if it cannot be
+ * determined.
+ */
+BT_HIDDEN
+unsigned int bt_common_get_cpu_count(void);
+
 #endif /* BABELTRACE_COMMON_INTERNAL_H */
@@ -232,4 +232,33 @@ end:
 }
 #endif /* #else #ifdef BABELTRACE_HAVE_POSIX_FALLOCATE */
 
+#ifdef BABELTRACE_HAVE_POSIX_FADVISE
+
+#include <fcntl.h>
+
+#define BT_POSIX_FADV_NORMAL		POSIX_FADV_NORMAL
+#define BT_POSIX_FADV_SEQUENTIAL	POSIX_FADV_SEQUENTIAL
+#define BT_POSIX_FADV_WILLNEED		POSIX_FADV_WILLNEED
+
+static inline
+int bt_posix_fadvise(int fd, off_t offset, off_t len, int advice)
+{
+	return posix_fadvise(fd, offset, len, advice);
+}
+
+#else /* #ifdef BABELTRACE_HAVE_POSIX_FADVISE */
+
+#define BT_POSIX_FADV_NORMAL		0
+#define BT_POSIX_FADV_SEQUENTIAL	2
+#define BT_POSIX_FADV_WILLNEED		3
+
+/* Advice only: do nothing when not supported. */
+static inline
+int bt_posix_fadvise(int fd, off_t offset, off_t len, int advice)
+{
+	return 0;
+}
+
+#endif /* #else #ifdef BABELTRACE_HAVE_POSIX_FADVISE */
+
 #endif /* _BABELTRACE_COMPAT_FCNTL_H */
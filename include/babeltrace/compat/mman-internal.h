@@ -76,4 +76,31 @@ int bt_munmap(void *addr, size_t length)
 # endif
 #endif
 
+#if defined(BABELTRACE_HAVE_POSIX_MADVISE) && !defined(__MINGW32__)
+
+#define BT_POSIX_MADV_NORMAL		POSIX_MADV_NORMAL
+#define BT_POSIX_MADV_SEQUENTIAL	POSIX_MADV_SEQUENTIAL
+#define BT_POSIX_MADV_WILLNEED		POSIX_MADV_WILLNEED
+
+static inline
+int bt_posix_madvise(void *addr, size_t length, int advice)
+{
+	return posix_madvise(addr, length, advice);
+}
+
+#else /* #if defined(BABELTRACE_HAVE_POSIX_MADVISE) && !defined(__MINGW32__) */
+
+#define BT_POSIX_MADV_NORMAL		0
+#define BT_POSIX_MADV_SEQUENTIAL	2
+#define BT_POSIX_MADV_WILLNEED		3
+
+/* Advice only: do nothing when not supported. */
+static inline
+int bt_posix_madvise(void *addr, size_t length, int advice)
+{
+	return 0;
+}
+
+#endif /* #else #if defined(BABELTRACE_HAVE_POSIX_MADVISE) && !defined(__MINGW32__) */
+
 #endif /* _BABELTRACE_COMPAT_MMAN_H */
@@ -33,6 +33,7 @@
 #include <errno.h>
 
 #define _SC_PAGESIZE 30
+#define _SC_NPROCESSORS_ONLN 84
 
 static inline
 long bt_sysconf(int name)
@@ -43,12 +44,29 @@ long bt_sysconf(int name)
 	case _SC_PAGESIZE:
 		GetNativeSystemInfo(&si);
 		return si.dwPageSize;
+	case _SC_NPROCESSORS_ONLN:
+		GetNativeSystemInfo(&si);
+		return si.dwNumberOfProcessors;
 	default:
 		errno = EINVAL;
 		return -1;
 	}
 }
 
+/*
+ * Not atomic with respect to the file offset, unlike pread(): the
+ * caller must not share the file descriptor with another thread.
+ */
+static inline
+ssize_t bt_pread(int fd, void *buf, size_t count, off_t offset)
+{
+	if (lseek(fd, offset, SEEK_SET) < 0) {
+		return -1;
+	}
+
+	return read(fd, buf, count);
+}
+
 #else
 
 static inline
@@ -57,5 +75,11 @@ long bt_sysconf(int name)
 	return sysconf(name);
 }
 
+static inline
+ssize_t bt_pread(int fd, void *buf, size_t count, off_t offset)
+{
+	return pread(fd, buf, count, offset);
+}
+
 #endif
 #endif /* _BABELTRACE_COMPAT_UNISTD_H */
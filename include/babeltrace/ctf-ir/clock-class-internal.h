@@ -30,13 +30,50 @@
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/ctf-ir/trace-internal.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/object-pool-internal.h>
 #include <babeltrace/babeltrace-internal.h>
 #include <babeltrace/compat/uuid-internal.h>
 #include <babeltrace/types.h>
+#include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <glib.h>
 
+/*
+ * Parameters of the conversion from a clock value (cycles) to
+ * nanoseconds from Epoch, computed once when the clock class is frozen
+ * since its properties cannot change afterwards:
+ *
+ *     ns = offset_ns + cycles * mult + ((cycles * frac_mult) >> 64)
+ *
+ * `mult` is the integral part of 10^9 / frequency and `frac_mult` is
+ * its fractional part as an unsigned 0.64 fixed-point number, rounded
+ * up. The result is exactly floor(cycles * 10^9 / frequency) for any
+ * clock value up to `exact_max_cycles`; beyond this, it can be 1 ns
+ * greater, which bt_clock_class_cycles_to_ns_from_epoch() corrects.
+ */
+struct bt_clock_class_ns_conv {
+	uint64_t mult;
+	uint64_t frac_mult;
+	uint64_t exact_max_cycles;
+
+	/* Greatest clock value for which `ns` above does not overflow */
+	uint64_t max_cycles;
+
+	/*
+	 * Offset (`offset_s` and `offset`) in nanoseconds from Epoch;
+	 * only valid if `offset_overflows` is false.
+	 */
+	int64_t offset_ns;
+	bool offset_overflows;
+
+	/*
+	 * A clock value converted to nanoseconds must be less than this
+	 * so that `offset_ns` plus this value fits the int64_t range.
+	 */
+	uint64_t max_value_ns;
+};
+
 struct bt_clock_class {
 	struct bt_object base;
 	GString *name;
@@ -54,8 +91,81 @@ struct bt_clock_class {
 	 * class.
 	 */
 	int frozen;
+
+	/* Pool of recycled clock values of this class */
+	struct bt_object_pool value_pool;
+
+	/* Valid once the clock class is frozen */
+	struct bt_clock_class_ns_conv ns_conv;
 };
 
+/* Returns the upper 64 bits of the 128-bit product of `a` and `b`. */
+static inline
+uint64_t bt_clock_class_mul_u64_hi(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	return (uint64_t) (((unsigned __int128) a * b) >> 64);
+#else
+	uint64_t a_lo = a & UINT32_MAX, a_hi = a >> 32;
+	uint64_t b_lo = b & UINT32_MAX, b_hi = b >> 32;
+	uint64_t lo_lo = a_lo * b_lo;
+	uint64_t hi_lo = a_hi * b_lo;
+	uint64_t lo_hi = a_lo * b_hi;
+	uint64_t cross = (lo_lo >> 32) + (hi_lo & UINT32_MAX) + lo_hi;
+
+	return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+/* Returns whether or not `a_hi:a_lo` is greater than `b_hi:b_lo`. */
+static inline
+bool bt_clock_class_u128_gt(uint64_t a_hi, uint64_t a_lo,
+		uint64_t b_hi, uint64_t b_lo)
+{
+	return a_hi > b_hi || (a_hi == b_hi && a_lo > b_lo);
+}
+
+/*
+ * Converts the clock value `cycles` of the frozen clock class
+ * `clock_class` to nanoseconds from Epoch. Returns 0 on success, or -1
+ * if the result does not fit the int64_t range.
+ */
+static inline
+int bt_clock_class_cycles_to_ns_from_epoch(struct bt_clock_class *clock_class,
+		uint64_t cycles, int64_t *ns_from_epoch)
+{
+	const struct bt_clock_class_ns_conv *conv = &clock_class->ns_conv;
+	uint64_t value_ns;
+
+	assert(clock_class->frozen);
+
+	if (unlikely(conv->offset_overflows || cycles > conv->max_cycles)) {
+		return -1;
+	}
+
+	value_ns = cycles * conv->mult +
+		bt_clock_class_mul_u64_hi(cycles, conv->frac_mult);
+
+	if (unlikely(cycles > conv->exact_max_cycles) &&
+			bt_clock_class_u128_gt(
+				bt_clock_class_mul_u64_hi(value_ns,
+					clock_class->frequency),
+				value_ns * clock_class->frequency,
+				bt_clock_class_mul_u64_hi(cycles,
+					UINT64_C(1000000000)),
+				cycles * UINT64_C(1000000000))) {
+		/* value_ns * frequency > cycles * 10^9: 1 ns too much */
+		value_ns--;
+	}
+
+	if (unlikely(value_ns >= conv->max_value_ns)) {
+		return -1;
+	}
+
+	*ns_from_epoch = conv->offset_ns + (int64_t) value_ns;
+	return 0;
+}
+
 BT_HIDDEN
 void bt_clock_class_freeze(struct bt_clock_class *clock_class);
 
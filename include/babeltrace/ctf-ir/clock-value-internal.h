@@ -24,11 +24,10 @@
  */
 
 #include <babeltrace/object-internal.h>
+#include <babeltrace/ctf-ir/clock-class-internal.h>
 #include <stdbool.h>
 #include <stdint.h>
 
-struct bt_clock_class;
-
 struct bt_clock_value {
 	struct bt_object base;
 	struct bt_clock_class *clock_class;
@@ -37,4 +36,23 @@ struct bt_clock_value {
 	int64_t ns_from_epoch;
 };
 
+/*
+ * Sets the value (cycles) of `clock_value`, of which the clock class
+ * is frozen, and converts it to nanoseconds from Epoch.
+ */
+static inline
+void bt_clock_value_set_value_no_check(struct bt_clock_value *clock_value,
+		uint64_t value)
+{
+	clock_value->value = value;
+	clock_value->ns_from_epoch_overflows =
+		bt_clock_class_cycles_to_ns_from_epoch(
+			clock_value->clock_class, value,
+			&clock_value->ns_from_epoch) != 0;
+
+	if (clock_value->ns_from_epoch_overflows) {
+		clock_value->ns_from_epoch = 0;
+	}
+}
+
 #endif /* BABELTRACE_CTF_IR_CLOCK_VALUE_INTERNAL_H */
@@ -36,6 +36,7 @@
 #include <babeltrace/ctf-ir/stream.h>
 #include <babeltrace/ctf-ir/event-class.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/object-pool-internal.h>
 #include <glib.h>
 
 struct bt_event_class {
@@ -59,6 +60,12 @@ struct bt_event_class {
 	int64_t id;
 	enum bt_event_class_log_level log_level;
 	GString *emf_uri;
+
+	/*
+	 * Pool of recycled events of this class (struct bt_event), with
+	 * their reset field trees.
+	 */
+	struct bt_object_pool event_pool;
 };
 
 BT_HIDDEN
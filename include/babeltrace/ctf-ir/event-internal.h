@@ -35,6 +35,7 @@
 #include <babeltrace/ctf-ir/stream.h>
 #include <babeltrace/ctf-ir/packet.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/ctf-ir/clock-value-internal.h>
 #include <assert.h>
 #include <glib.h>
 
@@ -48,11 +49,24 @@ struct bt_event {
 	struct bt_field *stream_event_context;
 	struct bt_field *context_payload;
 	struct bt_field *fields_payload;
-	/* Maps clock classes to bt_clock_value. */
-	GHashTable *clock_values;
+	/*
+	 * Clock values of this event (struct bt_clock_value *), at the
+	 * same indexes as their clock classes within the trace. This
+	 * owns them, and they are never freed before the event: each
+	 * one has this event as its parent, so that getting it gets the
+	 * event. An entry is NULL or has no clock class when the event
+	 * has no value for the corresponding clock class.
+	 */
+	GPtrArray *clock_values;
 	int frozen;
 };
 
+BT_HIDDEN
+struct bt_event *bt_event_new(struct bt_event_class *event_class);
+
+BT_HIDDEN
+void bt_event_destroy(struct bt_event *event);
+
 BT_HIDDEN
 int bt_event_validate(struct bt_event *event);
 
@@ -79,4 +93,25 @@ struct bt_event_class *bt_event_borrow_event_class(
 	return event->event_class;
 }
 
+static inline
+struct bt_clock_value *bt_event_borrow_clock_value(
+		struct bt_event *event, struct bt_clock_class *clock_class)
+{
+	guint i;
+
+	assert(event);
+	assert(clock_class);
+
+	for (i = 0; i < event->clock_values->len; i++) {
+		struct bt_clock_value *clock_value =
+			g_ptr_array_index(event->clock_values, i);
+
+		if (clock_value && clock_value->clock_class == clock_class) {
+			return clock_value;
+		}
+	}
+
+	return NULL;
+}
+
 #endif /* BABELTRACE_CTF_IR_EVENT_INTERNAL_H */
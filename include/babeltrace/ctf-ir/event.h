@@ -165,6 +165,60 @@ with bt_trace_add_stream_class(), then this function fails.
 extern struct bt_event *bt_event_create(
 		struct bt_event_class *event_class);
 
+/**
+@brief	Flags of bt_event_create_with_flags().
+*/
+enum bt_event_create_flags {
+	/// Create all the fields (same as bt_event_create()).
+	BT_EVENT_CREATE_FLAG_DEFAULT			= 0,
+
+	/// Do not create the stream event header field.
+	BT_EVENT_CREATE_FLAG_NO_HEADER			= 1 << 0,
+
+	/// Do not create the stream event context field.
+	BT_EVENT_CREATE_FLAG_NO_STREAM_EVENT_CONTEXT	= 1 << 1,
+
+	/// Do not create the event context field.
+	BT_EVENT_CREATE_FLAG_NO_EVENT_CONTEXT		= 1 << 2,
+
+	/// Do not create the event payload field.
+	BT_EVENT_CREATE_FLAG_NO_EVENT_PAYLOAD		= 1 << 3,
+};
+
+/**
+@brief  Creates a CTF IR event from the CTF IR event class
+	\p event_class, without creating the fields which \p flags
+	excludes.
+
+This function is the same as bt_event_create(), except that it does not
+create the fields which \p flags excludes: use this function when you
+set those fields yourself right after creating the event (for example,
+with bt_event_set_header()), so that the library does not create
+fields which you would replace immediately.
+
+An excluded field \em can still be set when \p event is a recycled
+event which kept its field: you can get it with the corresponding
+getter to reuse it, or replace it.
+
+You \em must set the excluded fields which have a field type before you
+create an event notification from the event.
+
+@param[in] event_class	CTF IR event class to use to create the
+			CTF IR event.
+@param[in] flags	Fields not to create (bitwise OR of
+			#bt_event_create_flags values).
+@returns		Created event object, or \c NULL on error.
+
+@prenotnull{event_class}
+@pre \p event_class has a parent stream class.
+@postsuccessrefcountret1
+
+@sa bt_event_create(): Creates a default CTF IR event.
+*/
+extern struct bt_event *bt_event_create_with_flags(
+		struct bt_event_class *event_class,
+		enum bt_event_create_flags flags);
+
 /**
 @brief	Returns the parent CTF IR event class of the CTF IR event
 	\p event.
@@ -35,6 +35,7 @@
 #include <babeltrace/ctf-ir/clock-class.h>
 #include <babeltrace/ctf-ir/field-types.h>
 #include <babeltrace/babeltrace-internal.h>
+#include <babeltrace/compiler-internal.h>
 #include <babeltrace/object-internal.h>
 #include <babeltrace/types.h>
 #include <glib.h>
@@ -61,6 +62,13 @@ struct bt_field_type {
 	 * a valid field type are also valid (and thus frozen).
 	 */
 	int valid;
+
+	/*
+	 * Size of the arena of a field tree of which the root field has
+	 * this type (see struct bt_field_arena). Set when the field
+	 * type is frozen.
+	 */
+	size_t field_arena_size;
 };
 
 struct bt_field_type_integer {
@@ -86,12 +94,54 @@ struct enumeration_mapping {
 	GQuark string;
 };
 
+/*
+ * Range of values of an enumeration field type which all match the same
+ * mappings. The values are keys (see enumeration_index): the first and
+ * last keys are included.
+ */
+struct enumeration_index_segment {
+	uint64_t first;
+	uint64_t last;
+
+	/* Matching mappings: `count` elements of `matches` from `offset` */
+	uint32_t offset;
+	uint32_t count;
+};
+
+/*
+ * Lookup index of a frozen enumeration field type.
+ *
+ * The keys are the values of the enumeration field type, with the sign
+ * bit flipped if it's signed, so that they compare as unsigned integers
+ * in the same order as the original values.
+ */
+struct enumeration_index {
+	/* Segments (struct enumeration_index_segment) sorted by key */
+	GArray *segments;
+
+	/* Indexes (uint32_t) of the mappings matched by the segments */
+	GArray *matches;
+
+	/*
+	 * Direct lookup table when the span of the keys is small: for
+	 * the key `direct_first + i`, `direct[i]` is the index of its
+	 * segment plus one, or 0 if no mapping contains it. NULL if
+	 * there's no direct lookup table.
+	 */
+	uint32_t *direct;
+	uint64_t direct_first;
+	uint64_t direct_len;
+};
+
 struct bt_field_type_enumeration {
 	struct bt_field_type parent;
 	struct bt_field_type *container;
 	GPtrArray *entries; /* Array of ptrs to struct enumeration_mapping */
 	/* Only set during validation. */
 	bt_bool has_overlapping_ranges;
+
+	/* Built when frozen, NULL if not frozen or on memory error */
+	struct enumeration_index *index;
 };
 
 enum bt_field_type_enumeration_mapping_iterator_type {
@@ -220,6 +270,16 @@ int bt_field_type_integer_set_mapped_clock_class_no_check(
 		struct bt_field_type *int_field_type,
 		struct bt_clock_class *clock_class);
 
+static inline
+struct bt_clock_class *bt_field_type_integer_borrow_mapped_clock_class(
+		struct bt_field_type *type)
+{
+	assert(type);
+	assert(type->id == BT_FIELD_TYPE_ID_INTEGER);
+	return container_of(type, struct bt_field_type_integer,
+		parent)->mapped_clock;
+}
+
 static inline
 const char *bt_field_type_id_string(enum bt_field_type_id type_id)
 {
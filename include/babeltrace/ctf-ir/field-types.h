@@ -1231,6 +1231,12 @@ operations:
 Those functions return a @enumftiter on the result set of the find
 operation.
 
+When you only need the names of the mappings which contain a given
+value, use bt_field_type_enumeration_get_mapping_names_by_unsigned_value()
+or bt_field_type_enumeration_get_mapping_names_by_signed_value()
+instead: they do not allocate anything, and they use a lookup index
+once the enumeration field type is frozen.
+
 Many mappings can share the same name, and the ranges of a given
 enumeration field type are allowed to overlap. For example,
 this is a valid set of mappings:
@@ -1505,6 +1511,92 @@ bt_field_type_enumeration_find_mappings_by_unsigned_value(
 		struct bt_field_type *enum_field_type,
 		uint64_t value);
 
+/**
+@brief  Returns the names of the mappings of the @enumft
+	\p enum_field_type which contain the signed value \p value in
+	their range.
+
+This function sets at most \p count elements of \p names, in the
+order of the mappings within \p enum_field_type, and returns the total
+number of mappings which contain \p value: if the returned value is
+greater than \p count, call this function again with a larger array
+to get all the names.
+
+This function does not allocate memory. Once \p enum_field_type is
+frozen, its lookup is not linear with the number of mappings.
+
+On success, \p enum_field_type remains the sole owner of the returned
+names.
+
+@param[in] enum_field_type	Enumeration field type of which to find
+				the mappings which contain \p value.
+@param[in] value		Value to find in the ranges of the
+				mappings of \p enum_field_type.
+@param[out] names		Returned names of the mappings which
+				contain \p value.
+@param[in] count		Number of elements in \p names.
+@returns			Number of mappings of
+				\p enum_field_type which contain
+				\p value (0 if none), or a negative
+				value on error.
+
+@prenotnull{enum_field_type}
+@pre \p names is not \c NULL if \p count is greater than 0.
+@preisenumft{enum_field_type}
+@pre The wrapped @intft of \p enum_field_type is signed.
+@postrefcountsame{enum_field_type}
+
+@sa bt_field_type_enumeration_get_mapping_names_by_unsigned_value():
+	Returns the names of the mappings of a given enumeration field
+	type which contain a given unsigned value in their range.
+*/
+extern int64_t bt_field_type_enumeration_get_mapping_names_by_signed_value(
+		struct bt_field_type *enum_field_type, int64_t value,
+		const char **names, uint64_t count);
+
+/**
+@brief  Returns the names of the mappings of the @enumft
+	\p enum_field_type which contain the unsigned value \p value in
+	their range.
+
+This function sets at most \p count elements of \p names, in the
+order of the mappings within \p enum_field_type, and returns the total
+number of mappings which contain \p value: if the returned value is
+greater than \p count, call this function again with a larger array
+to get all the names.
+
+This function does not allocate memory. Once \p enum_field_type is
+frozen, its lookup is not linear with the number of mappings.
+
+On success, \p enum_field_type remains the sole owner of the returned
+names.
+
+@param[in] enum_field_type	Enumeration field type of which to find
+				the mappings which contain \p value.
+@param[in] value		Value to find in the ranges of the
+				mappings of \p enum_field_type.
+@param[out] names		Returned names of the mappings which
+				contain \p value.
+@param[in] count		Number of elements in \p names.
+@returns			Number of mappings of
+				\p enum_field_type which contain
+				\p value (0 if none), or a negative
+				value on error.
+
+@prenotnull{enum_field_type}
+@pre \p names is not \c NULL if \p count is greater than 0.
+@preisenumft{enum_field_type}
+@pre The wrapped @intft of \p enum_field_type is unsigned.
+@postrefcountsame{enum_field_type}
+
+@sa bt_field_type_enumeration_get_mapping_names_by_signed_value():
+	Returns the names of the mappings of a given enumeration field
+	type which contain a given signed value in their range.
+*/
+extern int64_t bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		struct bt_field_type *enum_field_type, uint64_t value,
+		const char **names, uint64_t count);
+
 /**
 @brief  Adds a mapping to the @enumft \p enum_field_type which maps the
 	name \p name to the signed range \p range_begin (included) to
@@ -31,6 +31,7 @@
 #include <babeltrace/ctf-writer/event-fields.h>
 #include <babeltrace/object-internal.h>
 #include <babeltrace/babeltrace-internal.h>
+#include <babeltrace/compiler-internal.h>
 #include <babeltrace/types.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -38,9 +39,65 @@
 
 struct bt_stream_pos;
 
+#define BT_FIELD_ARENA_ALIGN			8
+
+/*
+ * Maximum size of the elements of an array field within a field arena:
+ * the elements of a larger array field are created on their own, and
+ * only when needed.
+ */
+#define BT_FIELD_ARENA_MAX_ARRAY_ELEMENTS_SIZE	65536
+
+/*
+ * A field arena is a single memory block which contains a whole field
+ * tree created by bt_field_create(): the root field, all the fields it
+ * contains, and the pointer arrays of its structure and array fields.
+ * Its size comes from the field type's layout (see
+ * bt_field_arena_size_from_type()).
+ *
+ * Each field of an arena keeps its own reference count: an arena is
+ * only a way to allocate the fields, not to own them. The arena's
+ * reference count is the number of its fields which are not destroyed
+ * yet, so that the block is freed when its last field is destroyed,
+ * whatever the order.
+ *
+ * Only the fields which the type describes statically are in the arena:
+ * the payload of a variant field, the elements of a sequence field, the
+ * elements of a large array field, and the fields which replace fields
+ * of the tree are allocated on their own.
+ */
+struct bt_field_arena {
+	/* Number of fields of this arena which are not destroyed yet */
+	struct bt_ref ref_count;
+
+	/* Size of `data` and offset of its next free byte */
+	size_t size;
+	size_t offset;
+
+	/* Fields and pointer arrays */
+	uint8_t data[] __attribute__((aligned(BT_FIELD_ARENA_ALIGN)));
+};
+
+/*
+ * Bytes to which a string, array, or sequence field refers instead of
+ * copying them (see bt_field_string_set_borrowed_value() and
+ * bt_field_array_set_borrowed_bytes()).
+ */
+struct bt_field_borrowed_bytes {
+	/* `NULL` if the field does not refer to bytes */
+	const uint8_t *addr;
+	size_t len;
+
+	/* Owned reference to the object keeping `addr` alive, or `NULL` */
+	struct bt_object *owner;
+};
+
 struct bt_field {
 	struct bt_object base;
 	struct bt_field_type *type;
+
+	/* Arena containing this field (weak), or `NULL` if on its own */
+	struct bt_field_arena *arena;
 	bool payload_set;
 	bool frozen;
 };
@@ -65,7 +122,10 @@ struct bt_field_floating_point {
 
 struct bt_field_structure {
 	struct bt_field parent;
-	GPtrArray *fields; /* Array of pointers to struct bt_field */
+
+	/* Array of `field_count` owned fields */
+	struct bt_field **fields;
+	uint64_t field_count;
 };
 
 struct bt_field_variant {
@@ -76,20 +136,62 @@ struct bt_field_variant {
 
 struct bt_field_array {
 	struct bt_field parent;
-	GPtrArray *elements; /* Array of pointers to struct bt_field */
+
+	/* Array of `element_count` owned fields (lazily created) */
+	struct bt_field **elements;
+	uint64_t element_count;
+
+	/* Element values when the elements are not set yet */
+	struct bt_field_borrowed_bytes borrowed;
 };
 
 struct bt_field_sequence {
 	struct bt_field parent;
 	struct bt_field *length;
 	GPtrArray *elements; /* Array of pointers to struct bt_field */
+
+	/* Element values when the elements are not set yet */
+	struct bt_field_borrowed_bytes borrowed;
 };
 
 struct bt_field_string {
 	struct bt_field parent;
+
+	/* Copied value, unused when `borrowed.addr` is not `NULL` */
 	GString *payload;
+
+	/* Null-terminated borrowed value */
+	struct bt_field_borrowed_bytes borrowed;
 };
 
+static inline
+struct bt_field_type *bt_field_borrow_type(struct bt_field *field)
+{
+	assert(field);
+	return field->type;
+}
+
+static inline
+struct bt_field *bt_field_structure_borrow_field_by_index(
+		struct bt_field *field, uint64_t index)
+{
+	struct bt_field_structure *structure;
+
+	assert(field);
+	assert(bt_field_type_get_type_id(field->type) ==
+		BT_FIELD_TYPE_ID_STRUCT);
+	structure = container_of(field, struct bt_field_structure, parent);
+	assert(index < structure->field_count);
+	return structure->fields[index];
+}
+
+/*
+ * Returns the size of the arena of a field tree of which the root
+ * field's type is `type`, a frozen field type.
+ */
+BT_HIDDEN
+size_t bt_field_arena_size_from_type(struct bt_field_type *type);
+
 /* Validate that the field's payload is set (returns 0 if set). */
 BT_HIDDEN
 int bt_field_validate(struct bt_field *field);
@@ -102,4 +204,28 @@ int bt_field_serialize(struct bt_field *field,
 BT_HIDDEN
 void bt_field_freeze(struct bt_field *field);
 
+/*
+ * Puts the references which the variant and sequence fields of the
+ * field tree rooted at `field` hold on their tag/length fields and on
+ * their current payload/elements. Those references usually target
+ * other fields of the same event, so they must be dropped, for all the
+ * field trees of an event, before calling bt_field_recycle() on any of
+ * them.
+ */
+BT_HIDDEN
+void bt_field_put_dynamic_refs(struct bt_field *field);
+
+/*
+ * Unfreezes and resets the field tree rooted at `field` so that it can
+ * be filled again, but only if no field of this tree is reachable from
+ * anything else than its parent field (or, for the root, the single
+ * reference of the caller).
+ *
+ * Returns 0 if the field tree is ready to be reused, or a negative
+ * value if it is still shared, in which case the caller must discard
+ * it.
+ */
+BT_HIDDEN
+int bt_field_recycle(struct bt_field *field);
+
 #endif /* BABELTRACE_CTF_IR_FIELDS_INTERNAL_H */
@@ -822,6 +822,44 @@ extern int bt_field_string_append_len(
 		struct bt_field *string_field, const char *value,
 		unsigned int length);
 
+/**
+@brief	Sets the string value of the @stringfield \p string_field to
+	\p value without copying it.
+
+Instead of copying \p value, \p string_field refers to it until its
+value changes or until it is reset. \p owner is the object which keeps
+the memory of \p value valid and unchanged for as long as it exists:
+\p string_field holds a reference on it for as long as it refers to
+\p value. This is how a source component can make string fields refer
+to the bytes of a memory-mapped packet, for example.
+
+bt_field_string_get_value() returns \p value as is. Appending to the
+value of \p string_field, with bt_field_string_append() or
+bt_field_string_append_len(), first copies \p value.
+
+@param[in] string_field	String field of which to set the string value.
+@param[in] value	New string value of \p string_field (not copied).
+@param[in] length	Length of \p value, excluding its terminating null
+			character.
+@param[in] owner	Object which keeps \p value alive, or \c NULL if
+			\p value has static storage.
+@returns		0 on success, or a negative value on error.
+
+@prenotnull{string_field}
+@prenotnull{value}
+@preisstringfield{string_field}
+@prehot{string_field}
+@pre \p value[\p length] is the first null character of \p value.
+@postrefcountsame{string_field}
+@postsuccessrefcountinc{owner}
+
+@sa bt_field_string_set_value(): Sets the string value of a given
+	string field, copying it.
+*/
+extern int bt_field_string_set_borrowed_value(
+		struct bt_field *string_field, const char *value,
+		size_t length, void *owner);
+
 /** @} */
 
 /**
@@ -995,6 +1033,67 @@ exist.
 extern struct bt_field *bt_field_array_get_field(
 		struct bt_field *array_field, uint64_t index);
 
+/**
+@brief	Sets the values of all the @intfields of the @arrayfield
+	\p array_field from the bytes at \p bytes without copying them.
+
+The element @ft of the field type of \p array_field must be an 8-bit
+@intft. Instead of copying the bytes, \p array_field refers to them
+until it is reset: its element fields are only created and set, from
+those bytes, when you get one of them with bt_field_array_get_field().
+Meanwhile, bt_field_array_get_borrowed_bytes() returns \p bytes.
+
+\p owner is the object which keeps the memory of \p bytes valid and
+unchanged for as long as it exists: \p array_field holds a reference
+on it for as long as it refers to \p bytes.
+
+@param[in] array_field	Array field of which to set the element values.
+@param[in] bytes	Element values of \p array_field, one byte per
+			element (not copied).
+@param[in] owner	Object which keeps \p bytes alive, or \c NULL if
+			\p bytes has static storage.
+@returns		0 on success, or a negative value on error.
+
+@prenotnull{array_field}
+@prenotnull{bytes}
+@preisarrayfield{array_field}
+@prehot{array_field}
+@pre The element field type of the field type of \p array_field is an
+	8-bit integer field type.
+@pre \p bytes contains as many bytes as the length of the field type
+	of \p array_field.
+@postrefcountsame{array_field}
+@postsuccessrefcountinc{owner}
+
+@sa bt_field_array_get_borrowed_bytes(): Returns the bytes to which a
+	given array field refers.
+*/
+extern int bt_field_array_set_borrowed_bytes(struct bt_field *array_field,
+		const uint8_t *bytes, void *owner);
+
+/**
+@brief	Returns the bytes to which the @arrayfield \p array_field
+	refers, as set with bt_field_array_set_borrowed_bytes().
+
+This function returns \c NULL if \p array_field does not refer to
+bytes, in which case you need to get its element fields with
+bt_field_array_get_field() to get its values. Getting an element
+field of \p array_field makes it stop referring to bytes.
+
+@param[in] array_field	Array field of which to get the bytes.
+@returns		Bytes of \p array_field, one per element, or
+			\c NULL if \p array_field does not refer to bytes.
+
+@prenotnull{array_field}
+@preisarrayfield{array_field}
+@postrefcountsame{array_field}
+
+@sa bt_field_array_set_borrowed_bytes(): Makes a given array field
+	refer to bytes.
+*/
+extern const uint8_t *bt_field_array_get_borrowed_bytes(
+		struct bt_field *array_field);
+
 /** @} */
 
 /**
@@ -1101,6 +1200,66 @@ fields contained in \p sequence_field.
 extern int bt_field_sequence_set_length(struct bt_field *sequence_field,
 		struct bt_field *length_field);
 
+/**
+@brief	Sets the values of all the @intfields of the @seqfield
+	\p sequence_field from the bytes at \p bytes without copying
+	them.
+
+This function is the sequence field equivalent of
+bt_field_array_set_borrowed_bytes(): the number of bytes at \p bytes
+is the current integral value of the length field of
+\p sequence_field.
+
+@param[in] sequence_field	Sequence field of which to set the
+				element values.
+@param[in] bytes		Element values of \p sequence_field,
+				one byte per element (not copied).
+@param[in] owner		Object which keeps \p bytes alive, or
+				\c NULL if \p bytes has static storage.
+@returns			0 on success, or a negative value on
+				error.
+
+@prenotnull{sequence_field}
+@prenotnull{bytes}
+@preisseqfield{sequence_field}
+@prehot{sequence_field}
+@pre \p sequence_field has a length field previously set with
+	bt_field_sequence_set_length().
+@pre The element field type of the field type of \p sequence_field is
+	an 8-bit integer field type.
+@postrefcountsame{sequence_field}
+@postsuccessrefcountinc{owner}
+
+@sa bt_field_sequence_get_borrowed_bytes(): Returns the bytes to which
+	a given sequence field refers.
+*/
+extern int bt_field_sequence_set_borrowed_bytes(
+		struct bt_field *sequence_field, const uint8_t *bytes,
+		void *owner);
+
+/**
+@brief	Returns the bytes to which the @seqfield \p sequence_field
+	refers, as set with bt_field_sequence_set_borrowed_bytes().
+
+This function is the sequence field equivalent of
+bt_field_array_get_borrowed_bytes().
+
+@param[in] sequence_field	Sequence field of which to get the
+				bytes.
+@returns			Bytes of \p sequence_field, one per
+				element, or \c NULL if \p sequence_field
+				does not refer to bytes.
+
+@prenotnull{sequence_field}
+@preisseqfield{sequence_field}
+@postrefcountsame{sequence_field}
+
+@sa bt_field_sequence_set_borrowed_bytes(): Makes a given sequence
+	field refer to bytes.
+*/
+extern const uint8_t *bt_field_sequence_get_borrowed_bytes(
+		struct bt_field *sequence_field);
+
 /** @} */
 
 /**
@@ -32,6 +32,7 @@
 #include <babeltrace/ctf-writer/event-types.h>
 #include <babeltrace/ctf-ir/trace.h>
 #include <babeltrace/object-internal.h>
+#include <babeltrace/object-pool-internal.h>
 #include <babeltrace/babeltrace-internal.h>
 #include <babeltrace/ctf-ir/trace-internal.h>
 #include <assert.h>
@@ -59,6 +60,12 @@ struct bt_stream_class {
 	 * stream class is _always_ frozen.
 	 */
 	int valid;
+
+	/*
+	 * Pool of recycled event notifications of which the event's
+	 * class is part of this stream class.
+	 */
+	struct bt_object_pool event_notif_pool;
 };
 
 BT_HIDDEN
@@ -49,6 +49,15 @@ struct bt_clock_class_priority_map {
 	bt_bool frozen;
 };
 
+static inline
+struct bt_clock_class *
+bt_clock_class_priority_map_borrow_highest_priority_clock_class(
+		struct bt_clock_class_priority_map *cc_prio_map)
+{
+	assert(cc_prio_map);
+	return cc_prio_map->highest_prio_cc;
+}
+
 static inline
 void bt_clock_class_priority_map_freeze(
 		struct bt_clock_class_priority_map *cc_prio_map)
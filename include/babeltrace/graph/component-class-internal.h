@@ -66,6 +66,13 @@ struct bt_component_class {
 	} methods;
 	/* Array of struct bt_component_class_destroy_listener */
 	GArray *destroy_listeners;
+
+	/*
+	 * True if the notifications of this component class's
+	 * notification iterators do not need to be validated (see
+	 * bt_component_class_set_trusted()).
+	 */
+	bt_bool trusted;
 	bt_bool frozen;
 	struct bt_list_head node;
 	struct bt_plugin_so_shared_lib_handle *so_handle;
@@ -75,6 +82,8 @@ struct bt_component_class_notification_iterator_methods {
 	bt_component_class_notification_iterator_init_method init;
 	bt_component_class_notification_iterator_finalize_method finalize;
 	bt_component_class_notification_iterator_next_method next;
+	bt_component_class_notification_iterator_seek_time_method seek_time;
+	bt_component_class_notification_iterator_next_batch_method next_batch;
 };
 
 struct bt_component_class_source {
@@ -48,6 +48,16 @@ int bt_component_class_source_set_notification_iterator_finalize_method(
 		struct bt_component_class *component_class,
 		bt_component_class_notification_iterator_finalize_method method);
 
+extern
+int bt_component_class_source_set_notification_iterator_seek_time_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_seek_time_method method);
+
+extern
+int bt_component_class_source_set_notification_iterator_next_batch_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_next_batch_method method);
+
 #ifdef __cplusplus
 }
 #endif
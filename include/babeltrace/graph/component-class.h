@@ -97,6 +97,17 @@ typedef struct bt_notification_iterator_next_method_return
 (*bt_component_class_notification_iterator_next_method)(
 		struct bt_private_connection_private_notification_iterator *notification_iterator);
 
+typedef enum bt_notification_iterator_status
+		(*bt_component_class_notification_iterator_seek_time_method)(
+		struct bt_private_connection_private_notification_iterator *notification_iterator,
+		int64_t ns_from_epoch);
+
+typedef enum bt_notification_iterator_status
+		(*bt_component_class_notification_iterator_next_batch_method)(
+		struct bt_private_connection_private_notification_iterator *notification_iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
 typedef struct bt_component_class_query_method_return (*bt_component_class_query_method)(
 		struct bt_component_class *component_class,
 		struct bt_query_executor *query_executor,
@@ -148,6 +159,29 @@ extern int bt_component_class_set_help(
 		struct bt_component_class *component_class,
 		const char *help);
 
+/**
+ * Set whether or not a component class is trusted.
+ *
+ * The notification iterators of the components of a trusted component
+ * class are known to always return notifications which satisfy the
+ * notification iterator API guarantees (no notification after the end
+ * of its stream, no duplicate "stream begin" or "packet begin"
+ * notification, and no stream shared by two ports of the same
+ * component, for example). The library does not validate those
+ * notifications.
+ *
+ * Only set this for vetted component classes: with an untrusted
+ * component class, the library catches those errors instead of
+ * delivering invalid notifications downstream.
+ *
+ * @param component_class	Component class of which to set the trust
+ * @param trusted		#BT_TRUE if the component class is trusted
+ * @returns			0 on success, or a negative value on error
+ */
+extern int bt_component_class_set_trusted(
+		struct bt_component_class *component_class,
+		bt_bool trusted);
+
 extern int bt_component_class_freeze(
 		struct bt_component_class *component_class);
 
@@ -175,6 +209,17 @@ extern const char *bt_component_class_get_description(
 extern const char *bt_component_class_get_help(
 		struct bt_component_class *component_class);
 
+/**
+ * Get whether or not a component class is trusted.
+ *
+ * @param component_class	Component class of which to get the trust
+ * @returns			#BT_TRUE if \p component_class is trusted
+ *
+ * @see bt_component_class_set_trusted()
+ */
+extern bt_bool bt_component_class_is_trusted(
+		struct bt_component_class *component_class);
+
 /**
  * Get a component class' type.
  *
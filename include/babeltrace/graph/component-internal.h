@@ -58,6 +58,13 @@ struct bt_component {
 	/* User-defined data */
 	void *user_data;
 
+	/*
+	 * File descriptor which becomes readable when the component
+	 * can make progress, or -1 (see
+	 * bt_private_component_set_ready_fd()).
+	 */
+	int ready_fd;
+
 	/* Input and output ports (weak references) */
 	GPtrArray *input_ports;
 	GPtrArray *output_ports;
@@ -82,6 +89,17 @@ struct bt_private_component *bt_private_component_from_component(
 	return (void *) component;
 }
 
+/*
+ * The user can set the readiness file descriptor of a component from
+ * a worker thread of a threaded graph.
+ */
+static inline
+int bt_component_get_ready_fd_no_check(struct bt_component *comp)
+{
+	assert(comp);
+	return __atomic_load_n(&comp->ready_fd, __ATOMIC_RELAXED);
+}
+
 static inline
 struct bt_graph *bt_component_borrow_graph(struct bt_component *comp)
 {
@@ -86,6 +86,18 @@ bt_bool bt_component_is_sink(struct bt_component *component)
 
 extern struct bt_graph *bt_component_get_graph(struct bt_component *component);
 
+/**
+ * Get component's readiness file descriptor.
+ *
+ * @param component	Component instance of which to get the readiness
+ *			file descriptor
+ * @returns		The component's readiness file descriptor, or -1
+ *			if it has none
+ *
+ * @see bt_graph_wait_ready()
+ */
+extern int bt_component_get_ready_fd(struct bt_component *component);
+
 #ifdef __cplusplus
 }
 #endif
@@ -62,6 +62,13 @@ struct bt_graph {
 	bt_bool in_remove_listener;
 	bt_bool has_sink;
 
+	/*
+	 * If this is BT_TRUE, then the "next" methods of the
+	 * notification iterators created on the graph's connections are
+	 * called on worker threads (see bt_graph_set_threaded()).
+	 */
+	bt_bool threaded;
+
 	/*
 	 * If this is BT_FALSE, then the public API's consuming
 	 * functions (bt_graph_consume() and bt_graph_run()) return
@@ -125,9 +125,69 @@ extern int bt_graph_add_ports_disconnected_listener(struct bt_graph *graph,
 		bt_graph_ports_disconnected_listener listener,
 		bt_graph_listener_removed listener_removed, void *data);
 
+/**
+ * Makes a graph threaded or not.
+ *
+ * In a threaded graph, each notification iterator created on one of the
+ * graph's connections gets the notifications of its upstream component
+ * from a dedicated worker thread: the upstream source or filter
+ * component produces notifications while the downstream component
+ * consumes the previous ones. A bounded queue sits between the worker
+ * thread and the consumer of the notification iterator: the worker
+ * thread waits while the queue is full. The consumer waits while the
+ * queue is empty, so that the notification iterator never returns
+ * #BT_NOTIFICATION_ITERATOR_STATUS_AGAIN: the worker thread calls the
+ * upstream component's method again later instead.
+ *
+ * The methods of a given notification iterator are never called
+ * concurrently, but the methods of different notification iterators can
+ * be, even if they belong to the same component.
+ *
+ * Making a graph threaded makes the reference counting of all the
+ * library's objects thread-safe for the rest of the process's lifetime,
+ * which is a little slower.
+ *
+ * You can only call this function before connecting any ports. A graph
+ * is not threaded by default.
+ *
+ * @param graph		Graph to make threaded or not
+ * @param threaded	#BT_TRUE to make \p graph threaded
+ * @returns		#BT_GRAPH_STATUS_OK on success,
+ *			#BT_GRAPH_STATUS_INVALID if \p graph already
+ *			has connections, or #BT_GRAPH_STATUS_ERROR if
+ *			the library cannot share objects between threads
+ */
+extern enum bt_graph_status bt_graph_set_threaded(struct bt_graph *graph,
+		bt_bool threaded);
+
 extern enum bt_graph_status bt_graph_cancel(struct bt_graph *graph);
 extern bt_bool bt_graph_is_canceled(struct bt_graph *graph);
 
+/**
+ * Waits until a component of a graph is ready to make progress.
+ *
+ * Call this function when bt_graph_run() or bt_graph_consume() returns
+ * #BT_GRAPH_STATUS_AGAIN instead of sleeping for a fixed duration: it
+ * returns as soon as the readiness file descriptor of any component of
+ * \p graph becomes readable (see
+ * bt_private_component_set_ready_fd()), or when \p timeout_us elapses.
+ * If no component of \p graph has a readiness file descriptor, this
+ * function only waits for \p timeout_us.
+ *
+ * The timeout is rounded up to the millisecond. A signal (for example,
+ * after which the handler calls bt_graph_cancel()) interrupts the wait.
+ *
+ * @param graph		Graph of which to wait for a component
+ * @param timeout_us	Maximum duration of the wait (µs), or a negative
+ *			value to wait without any timeout
+ * @returns		#BT_GRAPH_STATUS_OK if a component is ready,
+ *			#BT_GRAPH_STATUS_AGAIN if the wait timed out or was
+ *			interrupted, #BT_GRAPH_STATUS_CANCELED if \p graph
+ *			is canceled, or an error status
+ */
+extern enum bt_graph_status bt_graph_wait_ready(struct bt_graph *graph,
+		int64_t timeout_us);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,12 +36,29 @@
 extern "C" {
 #endif
 
+struct bt_stream_class;
+
 struct bt_notification_event {
 	struct bt_notification parent;
 	struct bt_event *event;
 	struct bt_clock_class_priority_map *cc_prio_map;
 };
 
+/*
+ * Allocates an empty event notification: used by the event
+ * notification pool of `stream_class`.
+ */
+BT_HIDDEN
+struct bt_notification *bt_notification_event_new(
+		struct bt_stream_class *stream_class);
+
+/*
+ * Frees an event notification which bt_notification_event_new()
+ * allocated: used by the event notification pool of a stream class.
+ */
+BT_HIDDEN
+void bt_notification_event_destroy(struct bt_notification *notif);
+
 static inline
 struct bt_event *bt_notification_event_borrow_event(
 		struct bt_notification *notif)
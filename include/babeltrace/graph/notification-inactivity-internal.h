@@ -23,9 +23,14 @@
  * SOFTWARE.
  */
 
+#include <babeltrace/compiler-internal.h>
+#include <babeltrace/graph/notification-internal.h>
 #include <glib.h>
+#include <assert.h>
 
 struct bt_clock_class_priority_map;
+struct bt_clock_class;
+struct bt_clock_value;
 
 struct bt_notification_inactivity {
 	struct bt_notification parent;
@@ -33,4 +38,30 @@ struct bt_notification_inactivity {
 	GHashTable *clock_values;
 };
 
+static inline
+struct bt_clock_class_priority_map *
+bt_notification_inactivity_borrow_clock_class_priority_map(
+		struct bt_notification *notif)
+{
+	struct bt_notification_inactivity *notif_inactivity = container_of(
+		notif, struct bt_notification_inactivity, parent);
+
+	assert(notif_inactivity);
+	return notif_inactivity->cc_prio_map;
+}
+
+static inline
+struct bt_clock_value *bt_notification_inactivity_borrow_clock_value(
+		struct bt_notification *notif,
+		struct bt_clock_class *clock_class)
+{
+	struct bt_notification_inactivity *notif_inactivity = container_of(
+		notif, struct bt_notification_inactivity, parent);
+
+	assert(notif_inactivity);
+	assert(clock_class);
+	return g_hash_table_lookup(notif_inactivity->clock_values,
+		clock_class);
+}
+
 #endif /* BABELTRACE_COMPONENT_NOTIFICATION_INACTIVITY_INTERNAL_H */
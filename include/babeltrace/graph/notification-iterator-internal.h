@@ -39,6 +39,7 @@
 
 struct bt_port;
 struct bt_graph;
+struct bt_notification_iterator_worker;
 
 enum bt_notification_iterator_type {
 	BT_NOTIFICATION_ITERATOR_TYPE_PRIVATE_CONNECTION,
@@ -132,6 +133,33 @@ struct bt_notification_iterator_private_connection {
 	 */
 	uint32_t subscription_mask;
 
+	/*
+	 * False if the user of this iterator cannot observe the state
+	 * of the streams, that is, if it is only subscribed to event
+	 * and/or inactivity notifications. In this case, this iterator
+	 * does not track the stream states, does not validate the
+	 * notifications, and does not generate automatic
+	 * notifications: it only enqueues the subscribed
+	 * notifications.
+	 */
+	bt_bool track_streams;
+
+	/*
+	 * False if the upstream component's class is trusted (see
+	 * bt_component_class_set_trusted()): this iterator does not
+	 * validate the notifications it gets from it.
+	 */
+	bt_bool validate_notifs;
+
+	/*
+	 * True if the user's "next" method is called on a worker
+	 * thread (threaded graph, see bt_graph_set_threaded()). In
+	 * this case, `worker` is the worker thread, or NULL if it is
+	 * not started yet (owned by this).
+	 */
+	bt_bool threaded;
+	struct bt_notification_iterator_worker *worker;
+
 	enum bt_private_connection_notification_iterator_state state;
 	void *user_data;
 };
@@ -157,8 +185,8 @@ void bt_notification_iterator_replace_current_notification(
 		struct bt_notification *notification)
 {
 	assert(iterator);
-	bt_put(iterator->current_notification);
-	iterator->current_notification = bt_get(notification);
+	bt_object_put_ref(iterator->current_notification);
+	iterator->current_notification = bt_object_get_ref(notification);
 }
 
 static inline
@@ -86,6 +86,56 @@ extern struct bt_notification *bt_notification_iterator_get_notification(
 extern enum bt_notification_iterator_status
 bt_notification_iterator_next(struct bt_notification_iterator *iterator);
 
+/**
+ * Get the next notifications of the iterator at once.
+ *
+ * On success, this function sets \p *count to the number of
+ * notifications written to \p notifications, which is at least 1 and at
+ * most \p capacity. The caller owns a reference to each notification.
+ * The iterator does not wait for \p capacity notifications to be
+ * available: it returns what it has when at least one notification is
+ * available.
+ *
+ * After this call, the iterator has no current notification (see
+ * bt_notification_iterator_get_notification()).
+ *
+ * @param iterator	Iterator instance
+ * @param notifications	Array of at least \p capacity notifications
+ * @param capacity	Maximum number of notifications to get (not 0)
+ * @param count		Returned number of notifications
+ * @returns		#BT_NOTIFICATION_ITERATOR_STATUS_OK on success, or
+ *			another status (\p *count is 0 in this case)
+ *
+ * @see bt_put()
+ */
+extern enum bt_notification_iterator_status
+bt_notification_iterator_next_batch(struct bt_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
+/**
+ * Move the iterator's position to a given time.
+ *
+ * After a successful call, the next notifications of the iterator
+ * include all the events of which the time is greater than or equal to
+ * \p ns_from_epoch. The iterator may still deliver some events which
+ * occur before this time: the seek operation is only a hint which
+ * allows the upstream component to skip data, not a filter.
+ *
+ * The iterator's notification queue is discarded. The iterator
+ * automatically ends the current packets of its streams as needed.
+ *
+ * @param iterator	Iterator instance
+ * @param ns_from_epoch	Time to seek (nanoseconds from Epoch)
+ * @returns		#BT_NOTIFICATION_ITERATOR_STATUS_OK on success,
+ *			#BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED if the
+ *			upstream component class does not support this
+ *			operation, or another status on error
+ */
+extern enum bt_notification_iterator_status
+bt_notification_iterator_seek_time(struct bt_notification_iterator *iterator,
+		int64_t ns_from_epoch);
+
 #ifdef __cplusplus
 }
 #endif
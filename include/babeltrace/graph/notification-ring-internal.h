@@ -0,0 +1,157 @@
+#ifndef BABELTRACE_GRAPH_NOTIFICATION_RING_INTERNAL_H
+#define BABELTRACE_GRAPH_NOTIFICATION_RING_INTERNAL_H
+
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <babeltrace/babeltrace-internal.h>
+#include <babeltrace/graph/notification-iterator.h>
+#include <babeltrace/types.h>
+#include <stdint.h>
+#include <pthread.h>
+
+struct bt_notification;
+
+#define BT_NOTIFICATION_RING_CACHE_LINE_SIZE	64
+
+/*
+ * A notification ring is a bounded, single-producer, single-consumer
+ * queue of notifications which two threads share: the producer pushes
+ * notifications and the consumer pops them without taking any lock.
+ *
+ * The lock and the condition are only used to put the producer to
+ * sleep when the ring is full (backpressure) and the consumer to sleep
+ * when the ring is empty. Blocked threads also wake up periodically to
+ * check if the graph is canceled.
+ *
+ * When the producer has no more notifications to push, it closes the
+ * ring with a final status (for example
+ * BT_NOTIFICATION_ITERATOR_STATUS_END): the consumer gets this status
+ * once it has popped all the remaining notifications.
+ *
+ * The consumer can ask the producer to stop: the producer's blocking
+ * push operation fails from this point.
+ */
+struct bt_notification_ring {
+	/* Array of `capacity` notifications (owned by this) */
+	struct bt_notification **notifs;
+
+	/* Power of two */
+	uint64_t capacity;
+
+	/* Canceled flag of the graph (weak) */
+	const bt_bool *canceled;
+
+	/* Written by the producer only */
+	uint64_t tail __attribute__((aligned(BT_NOTIFICATION_RING_CACHE_LINE_SIZE)));
+
+	/* Producer's last known value of `head` */
+	uint64_t producer_head;
+
+	/* Written by the consumer only */
+	uint64_t head __attribute__((aligned(BT_NOTIFICATION_RING_CACHE_LINE_SIZE)));
+
+	/* Consumer's last known value of `tail` */
+	uint64_t consumer_tail;
+
+	/* Set by the producer after it writes `close_status` */
+	bt_bool closed __attribute__((aligned(BT_NOTIFICATION_RING_CACHE_LINE_SIZE)));
+	enum bt_notification_iterator_status close_status;
+
+	/* Set by the consumer */
+	bt_bool stopping;
+
+	/* True when a thread sleeps on `cond` */
+	bt_bool producer_waiting;
+	bt_bool consumer_waiting;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+/*
+ * Creates a notification ring which can contain at most `capacity`
+ * notifications (must be a power of two). `canceled` points to the
+ * canceled flag of the graph.
+ */
+BT_HIDDEN
+struct bt_notification_ring *bt_notification_ring_create(uint64_t capacity,
+		const bt_bool *canceled);
+
+/*
+ * Destroys a notification ring, putting the notifications it still
+ * contains. No thread must use the ring at this point.
+ */
+BT_HIDDEN
+void bt_notification_ring_destroy(struct bt_notification_ring *ring);
+
+/*
+ * Producer: pushes `notif`, moving the caller's reference, waiting for
+ * some space if the ring is full.
+ *
+ * Returns 0 on success, or -1 if the consumer asked the producer to
+ * stop or if the graph is canceled. In the latter case, the caller
+ * keeps its reference.
+ */
+BT_HIDDEN
+int bt_notification_ring_push(struct bt_notification_ring *ring,
+		struct bt_notification *notif);
+
+/*
+ * Producer: closes the ring with the final status `status`. The
+ * producer must not push any notification after this.
+ */
+BT_HIDDEN
+void bt_notification_ring_close(struct bt_notification_ring *ring,
+		enum bt_notification_iterator_status status);
+
+/*
+ * Producer: returns whether or not the consumer asked the producer to
+ * stop or the graph is canceled.
+ */
+BT_HIDDEN
+bt_bool bt_notification_ring_producer_must_stop(
+		struct bt_notification_ring *ring);
+
+/*
+ * Consumer: pops at most `capacity` notifications, moving their
+ * references to `notifs`, waiting for at least one notification if
+ * the ring is empty.
+ *
+ * Returns BT_NOTIFICATION_ITERATOR_STATUS_OK with `*count` set to the
+ * number of popped notifications (at least 1), the status of the
+ * producer if the ring is empty and closed, or
+ * BT_NOTIFICATION_ITERATOR_STATUS_CANCELED if the graph is canceled.
+ */
+BT_HIDDEN
+enum bt_notification_iterator_status bt_notification_ring_pop(
+		struct bt_notification_ring *ring,
+		struct bt_notification **notifs, uint64_t capacity,
+		uint64_t *count);
+
+/*
+ * Consumer: asks the producer to stop, waking it up if it waits for
+ * some space.
+ */
+BT_HIDDEN
+void bt_notification_ring_stop(struct bt_notification_ring *ring);
+
+#endif /* BABELTRACE_GRAPH_NOTIFICATION_RING_INTERNAL_H */
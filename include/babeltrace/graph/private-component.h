@@ -40,6 +40,20 @@ extern enum bt_component_status bt_private_component_set_user_data(
 		struct bt_private_component *private_component,
 		void *user_data);
 
+/*
+ * Sets the readiness file descriptor of a component to fd, or removes
+ * it if fd is -1.
+ *
+ * A component which can return "try again later" (for example,
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN from a notification iterator)
+ * can set a file descriptor which becomes readable when it is ready to
+ * make progress again: a socket, a pipe, or an eventfd, for example.
+ * bt_graph_wait_ready() waits on those file descriptors. The component
+ * keeps the ownership of fd: it must remove it before closing it.
+ */
+extern enum bt_component_status bt_private_component_set_ready_fd(
+		struct bt_private_component *private_component, int fd);
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,7 +51,7 @@ long bt_object_get_ref_count(const void *ptr)
 {
 	const struct bt_object *obj = ptr;
 
-	return obj->ref_count.count;
+	return __atomic_load_n(&obj->ref_count.count, __ATOMIC_RELAXED);
 }
 
 static inline
@@ -99,6 +99,60 @@ void generic_release(struct bt_object *obj)
 	}
 }
 
+/*
+ * Library-internal, inline versions of bt_get() and bt_put() for the
+ * hot paths: no logging and no "is this object reference counted?"
+ * check, so `ptr` must not be a static object like `bt_value_null`.
+ *
+ * Only the library can use those: plugins must stick to bt_get(),
+ * bt_put(), and the inline borrowing accessors of the internal headers.
+ */
+static inline
+void bt_object_get_no_null_check(void *ptr)
+{
+	struct bt_object *obj = ptr;
+
+	assert(obj);
+	assert(obj->ref_count.release);
+
+	/*
+	 * See bt_get(): only the 0 to 1 transition of a parented object
+	 * needs to get the parent, which is rare.
+	 */
+	if (unlikely(bt_ref_get(&obj->ref_count) == 0 && obj->parent)) {
+		bt_get(obj->parent);
+	}
+}
+
+static inline
+void bt_object_put_no_null_check(void *ptr)
+{
+	struct bt_object *obj = ptr;
+
+	assert(obj);
+	assert(obj->ref_count.release);
+	assert(bt_object_get_ref_count(obj) > 0);
+	bt_ref_put(&obj->ref_count);
+}
+
+static inline
+void *bt_object_get_ref(void *ptr)
+{
+	if (likely(ptr)) {
+		bt_object_get_no_null_check(ptr);
+	}
+
+	return ptr;
+}
+
+static inline
+void bt_object_put_ref(void *ptr)
+{
+	if (likely(ptr)) {
+		bt_object_put_no_null_check(ptr);
+	}
+}
+
 static inline
 struct bt_object *bt_object_borrow_parent(void *ptr)
 {
@@ -28,6 +28,7 @@
  */
 
 #include <babeltrace/babeltrace-internal.h>
+#include <stdbool.h>
 #include <assert.h>
 
 struct bt_object;
@@ -38,6 +39,23 @@ struct bt_ref {
 	bt_object_release_func release;
 };
 
+/*
+ * If this is true, reference counts are updated with atomic operations
+ * so that objects can be shared between threads. Otherwise they are
+ * updated with plain operations, which is faster, but only safe when a
+ * single thread uses a given object.
+ *
+ * Objects are not owned by a given graph (a class can be shared by many
+ * graphs, for example), so this mode is global: it is enabled as soon
+ * as a graph becomes threaded (see bt_graph_set_threaded()), before any
+ * worker thread exists, and it is never disabled afterwards.
+ */
+BT_HIDDEN
+extern bool bt_ref_atomic_mode;
+
+BT_HIDDEN
+void bt_ref_enable_atomic_mode(void);
+
 static inline
 void bt_ref_init(struct bt_ref *ref, bt_object_release_func release)
 {
@@ -46,26 +64,50 @@ void bt_ref_init(struct bt_ref *ref, bt_object_release_func release)
 	ref->release = release;
 }
 
+/*
+ * Increments a reference count and returns its old value.
+ */
 static inline
-void bt_ref_get(struct bt_ref *ref)
+unsigned long bt_ref_get(struct bt_ref *ref)
 {
+	unsigned long old_count;
+
 	assert(ref);
 
-	if (unlikely(!ref->release)) {
-		return;
+	if (likely(!bt_ref_atomic_mode)) {
+		old_count = ref->count++;
+	} else {
+		old_count = __atomic_fetch_add(&ref->count, 1,
+			__ATOMIC_RELAXED);
 	}
 
-	ref->count++;
 	/* Overflow check. */
-	assert(ref->count);
+	assert(old_count + 1);
+	return old_count;
 }
 
 static inline
 void bt_ref_put(struct bt_ref *ref)
 {
+	unsigned long new_count;
+
 	assert(ref);
+
+	if (likely(!bt_ref_atomic_mode)) {
+		new_count = --ref->count;
+	} else {
+		/*
+		 * Release ordering makes this thread's accesses to the
+		 * object happen before its release by another thread;
+		 * acquire ordering makes the accesses of the other
+		 * threads happen before the release by this one.
+		 */
+		new_count = __atomic_sub_fetch(&ref->count, 1,
+			__ATOMIC_ACQ_REL);
+	}
+
 	/* Only assert if the object has opted-in for reference counting. */
-	if (unlikely((--ref->count) == 0 && ref->release)) {
+	if (unlikely(new_count == 0 && ref->release)) {
 		ref->release((struct bt_object *) ref);
 	}
 }
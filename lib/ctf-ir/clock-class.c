@@ -43,6 +43,28 @@
 static
 void bt_clock_class_destroy(struct bt_object *obj);
 
+static
+void bt_clock_value_release(struct bt_object *obj);
+
+static
+struct bt_clock_value *new_clock_value(struct bt_clock_class *clock_class)
+{
+	struct bt_clock_value *value = g_new0(struct bt_clock_value, 1);
+
+	if (!value) {
+		BT_LOGE_STR("Failed to allocate one clock value.");
+	}
+
+	return value;
+}
+
+static
+void free_clock_value(struct bt_clock_value *value,
+		struct bt_clock_class *clock_class)
+{
+	g_free(value);
+}
+
 BT_HIDDEN
 bt_bool bt_clock_class_is_valid(struct bt_clock_class *clock_class)
 {
@@ -134,6 +156,15 @@ struct bt_clock_class *bt_clock_class_create(const char *name,
 	clock_class->precision = 1;
 	clock_class->frequency = freq;
 	bt_object_init(clock_class, bt_clock_class_destroy);
+	ret = bt_object_pool_initialize(&clock_class->value_pool,
+		(bt_object_pool_new_object_func) new_clock_value,
+		(bt_object_pool_destroy_object_func) free_clock_value,
+		clock_class);
+	if (ret) {
+		BT_LOGE("Failed to initialize clock value pool: ret=%d",
+			ret);
+		goto error;
+	}
 
 	if (name) {
 		ret = bt_clock_class_set_name(clock_class, name);
@@ -507,24 +538,141 @@ end:
 	return ret;
 }
 
-static uint64_t ns_from_value(uint64_t frequency, uint64_t value)
+/*
+ * Computes the parameters of the conversion from a clock value to
+ * nanoseconds from Epoch (see struct bt_clock_class_ns_conv).
+ */
+static
+void init_ns_conv(struct bt_clock_class *clock_class)
 {
-	uint64_t ns;
+	struct bt_clock_class_ns_conv *conv = &clock_class->ns_conv;
+	uint64_t freq = clock_class->frequency;
+	uint64_t rem = UINT64_C(1000000000) % freq;
+	uint64_t offset_cycles;
+	uint64_t offset_cycles_ns;
+
+	assert(freq != 0);
+	conv->mult = UINT64_C(1000000000) / freq;
+	conv->frac_mult = 0;
+
+	if (rem != 0) {
+		/* frac_mult = ceil(rem * 2^64 / freq): long division */
+		uint64_t r = rem;
+		int i;
+
+		for (i = 0; i < 64; i++) {
+			bool carry = (r >> 63) != 0;
+
+			r <<= 1;
+			conv->frac_mult <<= 1;
+
+			if (carry || r >= freq) {
+				r -= freq;
+				conv->frac_mult |= 1;
+			}
+		}
+
+		if (r != 0) {
+			conv->frac_mult++;
+		}
+	}
+
+	/*
+	 * The rounding error of the fractional part is less than
+	 * cycles / 2^64 ns, which cannot change the integral result
+	 * as long as it is less than 1 / freq.
+	 */
+	conv->exact_max_cycles = UINT64_MAX / freq;
+
+	/*
+	 * The fractional part adds less than `cycles` to the product,
+	 * hence the `+ 1`.
+	 */
+	if (conv->mult == 0) {
+		conv->max_cycles = UINT64_MAX;
+	} else {
+		conv->max_cycles = UINT64_MAX /
+			(conv->mult + (conv->frac_mult ? 1 : 0));
+	}
+
+	conv->offset_ns = 0;
+	conv->offset_overflows = false;
+	conv->max_value_ns = INT64_MAX;
+
+	/* Offset in seconds */
+	if (clock_class->offset_s <= (INT64_MIN / 1000000000) ||
+			clock_class->offset_s >= (INT64_MAX / 1000000000)) {
+		/*
+		 * Overflow: offset in seconds converted to nanoseconds
+		 * is outside the int64_t range.
+		 */
+		goto overflow;
+	}
+
+	conv->offset_ns = clock_class->offset_s * (int64_t) 1000000000;
 
-	if (frequency == 1000000000) {
-		ns = value;
+	/* Offset in cycles */
+	if (clock_class->offset < 0) {
+		offset_cycles = (uint64_t) 0 - (uint64_t) clock_class->offset;
 	} else {
-		double dblres = ((1e9 * (double) value) / (double) frequency);
+		offset_cycles = (uint64_t) clock_class->offset;
+	}
+
+	if (offset_cycles > conv->max_cycles) {
+		goto overflow;
+	}
+
+	offset_cycles_ns = offset_cycles * conv->mult +
+		bt_clock_class_mul_u64_hi(offset_cycles, conv->frac_mult);
+	if (offset_cycles_ns >= INT64_MAX) {
+		/*
+		 * Overflow: offset in cycles converted to nanoseconds
+		 * is outside the int64_t range.
+		 */
+		goto overflow;
+	}
+
+	if (clock_class->offset < 0) {
+		if (conv->offset_ns < 0 && (int64_t) offset_cycles_ns >=
+				conv->offset_ns - INT64_MIN) {
+			/*
+			 * Overflow: offset in seconds plus offset in
+			 * cycles, in nanoseconds, is outside the
+			 * int64_t range.
+			 */
+			goto overflow;
+		}
 
-		if (dblres >= (double) UINT64_MAX) {
-			/* Overflows uint64_t */
-			ns = -1ULL;
-		} else {
-			ns = (uint64_t) dblres;
+		conv->offset_ns -= (int64_t) offset_cycles_ns;
+	} else {
+		if (conv->offset_ns > 0 && (int64_t) offset_cycles_ns >=
+				INT64_MAX - conv->offset_ns) {
+			/* Overflow (see above) */
+			goto overflow;
 		}
+
+		conv->offset_ns += (int64_t) offset_cycles_ns;
 	}
 
-	return ns;
+	/* A clock value (cycles) is always positive */
+	if (conv->offset_ns > 0) {
+		conv->max_value_ns = (uint64_t) (INT64_MAX - conv->offset_ns);
+	}
+
+	goto end;
+
+overflow:
+	conv->offset_ns = 0;
+	conv->offset_overflows = true;
+
+end:
+	BT_LOGV("Computed clock class's conversion to nanoseconds from Epoch: "
+		"addr=%p, name=\"%s\", mult=%" PRIu64 ", "
+		"frac-mult=%" PRIu64 ", max-cycles=%" PRIu64 ", "
+		"offset-ns=%" PRId64 ", offset-overflows=%d",
+		clock_class, bt_clock_class_get_name(clock_class),
+		conv->mult, conv->frac_mult, conv->max_cycles,
+		conv->offset_ns, conv->offset_overflows);
 }
 
 BT_HIDDEN
@@ -538,6 +686,7 @@ void bt_clock_class_freeze(struct bt_clock_class *clock_class)
 	if (!clock_class->frozen) {
 		BT_LOGD("Freezing clock class: addr=%p, name=\"%s\"",
 			clock_class, bt_clock_class_get_name(clock_class));
+		init_ns_conv(clock_class);
 		clock_class->frozen = 1;
 	}
 }
@@ -607,156 +756,34 @@ void bt_clock_class_destroy(struct bt_object *obj)
 		g_string_free(clock_class->description, TRUE);
 	}
 
+	bt_object_pool_finalize(&clock_class->value_pool);
 	g_free(clock_class);
 }
 
 static
-void bt_clock_value_destroy(struct bt_object *obj)
+void bt_clock_value_release(struct bt_object *obj)
 {
 	struct bt_clock_value *value;
+	struct bt_clock_class *clock_class;
 
 	if (!obj) {
 		return;
 	}
 
 	value = container_of(obj, struct bt_clock_value, base);
-	BT_LOGD("Destroying clock value: addr=%p, clock-class-addr=%p, "
-		"clock-class-name=\"%s\"", obj, value->clock_class,
-		bt_clock_class_get_name(value->clock_class));
-	bt_put(value->clock_class);
-	g_free(value);
-}
-
-static
-void set_ns_from_epoch(struct bt_clock_value *clock_value)
-{
-	struct bt_clock_class *clock_class = clock_value->clock_class;
-	int64_t diff;
-	int64_t s_ns;
-	uint64_t u_ns;
-	uint64_t cycles;
-
-	/* Initialize nanosecond timestamp to clock's offset in seconds */
-	if (clock_class->offset_s <= (INT64_MIN / 1000000000) ||
-			clock_class->offset_s >= (INT64_MAX / 1000000000)) {
-		/*
-		 * Overflow: offset in seconds converted to nanoseconds
-		 * is outside the int64_t range.
-		 */
-		clock_value->ns_from_epoch_overflows = true;
-		goto end;
-	}
-
-	clock_value->ns_from_epoch = clock_class->offset_s * (int64_t) 1000000000;
-
-	/* Add offset in cycles */
-	if (clock_class->offset < 0) {
-		cycles = (uint64_t) (-clock_class->offset);
-	} else {
-		cycles = (uint64_t) clock_class->offset;
-	}
-
-	u_ns = ns_from_value(clock_class->frequency, cycles);
-
-	if (u_ns == -1ULL || u_ns >= INT64_MAX) {
-		/*
-		 * Overflow: offset in cycles converted to nanoseconds
-		 * is outside the int64_t range.
-		 */
-		clock_value->ns_from_epoch_overflows = true;
-		goto end;
-	}
-
-	s_ns = (int64_t) u_ns;
-	assert(s_ns >= 0);
-
-	if (clock_class->offset < 0) {
-		if (clock_value->ns_from_epoch >= 0) {
-			/*
-			 * Offset in cycles is negative so it must also
-			 * be negative once converted to nanoseconds.
-			 */
-			s_ns = -s_ns;
-			goto offset_ok;
-		}
-
-		diff = clock_value->ns_from_epoch - INT64_MIN;
-
-		if (s_ns >= diff) {
-			/*
-			 * Overflow: current timestamp in nanoseconds
-			 * plus the offset in cycles converted to
-			 * nanoseconds is outside the int64_t range.
-			 */
-			clock_value->ns_from_epoch_overflows = true;
-			goto end;
-		}
-
-		/*
-		 * Offset in cycles is negative so it must also be
-		 * negative once converted to nanoseconds.
-		 */
-		s_ns = -s_ns;
-	} else {
-		if (clock_value->ns_from_epoch <= 0) {
-			goto offset_ok;
-		}
-
-		diff = INT64_MAX - clock_value->ns_from_epoch;
-
-		if (s_ns >= diff) {
-			/*
-			 * Overflow: current timestamp in nanoseconds
-			 * plus the offset in cycles converted to
-			 * nanoseconds is outside the int64_t range.
-			 */
-			clock_value->ns_from_epoch_overflows = true;
-			goto end;
-		}
-	}
-
-offset_ok:
-	clock_value->ns_from_epoch += s_ns;
-
-	/* Add clock value (cycles) */
-	u_ns = ns_from_value(clock_class->frequency, clock_value->value);
-
-	if (u_ns == -1ULL || u_ns >= INT64_MAX) {
-		/*
-		 * Overflow: value converted to nanoseconds is outside
-		 * the int64_t range.
-		 */
-		clock_value->ns_from_epoch_overflows = true;
-		goto end;
-	}
-
-	s_ns = (int64_t) u_ns;
-	assert(s_ns >= 0);
-
-	/* Clock value (cycles) is always positive */
-	if (clock_value->ns_from_epoch <= 0) {
-		goto value_ok;
-	}
-
-	diff = INT64_MAX - clock_value->ns_from_epoch;
-
-	if (s_ns >= diff) {
-		/*
-		 * Overflow: current timestamp in nanoseconds plus the
-		 * clock value converted to nanoseconds is outside the
-		 * int64_t range.
-		 */
-		clock_value->ns_from_epoch_overflows = true;
-		goto end;
-	}
-
-value_ok:
-	clock_value->ns_from_epoch += s_ns;
-
-end:
-	if (clock_value->ns_from_epoch_overflows) {
-		clock_value->ns_from_epoch = 0;
-	}
+	clock_class = value->clock_class;
+	BT_LOGV("Recycling clock value: addr=%p, clock-class-addr=%p, "
+		"clock-class-name=\"%s\"", obj, clock_class,
+		bt_clock_class_get_name(clock_class));
+
+	/*
+	 * Put the clock class _after_ the value is back in its pool:
+	 * this could be the last reference, in which case the clock
+	 * class destroys the pool, and therefore this value.
+	 */
+	value->clock_class = NULL;
+	bt_object_pool_recycle_object(&clock_class->value_pool, value);
+	bt_put(clock_class);
 }
 
 struct bt_clock_value *bt_clock_value_create(
@@ -773,17 +800,16 @@ struct bt_clock_value *bt_clock_value_create(
 		goto end;
 	}
 
-	ret = g_new0(struct bt_clock_value, 1);
+	ret = bt_object_pool_create_object(&clock_class->value_pool);
 	if (!ret) {
-		BT_LOGE_STR("Failed to allocate one clock value.");
+		BT_LOGE_STR("Cannot create clock value from pool.");
 		goto end;
 	}
 
-	bt_object_init(ret, bt_clock_value_destroy);
+	bt_object_init(ret, bt_clock_value_release);
 	ret->clock_class = bt_get(clock_class);
-	ret->value = value;
-	set_ns_from_epoch(ret);
 	bt_clock_class_freeze(clock_class);
+	bt_clock_value_set_value_no_check(ret, value);
 	BT_LOGD("Created clock value object: clock-value-addr=%p, "
 		"clock-class-addr=%p, clock-class-name=\"%s\", "
 		"ns-from-epoch=%" PRId64 ", ns-from-epoch-overflows=%d",
@@ -33,6 +33,7 @@
 #include <babeltrace/ctf-ir/field-types-internal.h>
 #include <babeltrace/ctf-ir/event-class.h>
 #include <babeltrace/ctf-ir/event-class-internal.h>
+#include <babeltrace/ctf-ir/event-internal.h>
 #include <babeltrace/ctf-ir/stream-class.h>
 #include <babeltrace/ctf-ir/stream-class-internal.h>
 #include <babeltrace/ctf-ir/trace-internal.h>
@@ -50,8 +51,16 @@
 static
 void bt_event_class_destroy(struct bt_object *obj);
 
+static
+void free_event(struct bt_event *event,
+		struct bt_event_class *event_class)
+{
+	bt_event_destroy(event);
+}
+
 struct bt_event_class *bt_event_class_create(const char *name)
 {
+	int ret;
 	struct bt_value *obj = NULL;
 	struct bt_event_class *event_class = NULL;
 
@@ -70,6 +79,16 @@ struct bt_event_class *bt_event_class_create(const char *name)
 	}
 
 	bt_object_init(event_class, bt_event_class_destroy);
+	ret = bt_object_pool_initialize(&event_class->event_pool,
+		(bt_object_pool_new_object_func) bt_event_new,
+		(bt_object_pool_destroy_object_func) free_event,
+		event_class);
+	if (ret) {
+		BT_LOGE("Failed to initialize event pool: ret=%d",
+			ret);
+		goto error;
+	}
+
 	event_class->fields = bt_field_type_structure_create();
 	if (!event_class->fields) {
 		BT_LOGE_STR("Cannot create event class's initial payload field type object.");
@@ -612,6 +631,7 @@ void bt_event_class_destroy(struct bt_object *obj)
 		bt_event_class_get_id(event_class));
 	g_string_free(event_class->name, TRUE);
 	g_string_free(event_class->emf_uri, TRUE);
+	bt_object_pool_finalize(&event_class->event_pool);
 	BT_LOGD_STR("Putting context field type.");
 	bt_put(event_class->context);
 	BT_LOGD_STR("Putting payload field type.");
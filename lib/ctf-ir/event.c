@@ -54,9 +54,142 @@
 #include <inttypes.h>
 
 static
-void bt_event_destroy(struct bt_object *obj);
+void bt_event_release(struct bt_object *obj);
+
+BT_HIDDEN
+struct bt_event *bt_event_new(struct bt_event_class *event_class)
+{
+	struct bt_event *event;
+
+	event = g_new0(struct bt_event, 1);
+	if (!event) {
+		BT_LOGE_STR("Failed to allocate one event.");
+		goto end;
+	}
+
+	event->clock_values = g_ptr_array_new_with_free_func(g_free);
+	if (!event->clock_values) {
+		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		g_free(event);
+		event = NULL;
+		goto end;
+	}
+
+end:
+	return event;
+}
+
+static
+int create_missing_scope_field(struct bt_field **field,
+		struct bt_field_type *field_type)
+{
+	int ret = 0;
+
+	if (*field || !field_type) {
+		goto end;
+	}
+
+	*field = bt_field_create(field_type);
+	if (!*field) {
+		BT_LOGE("Cannot create scope field: ft-addr=%p", field_type);
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Returns whether or not `event_class` (whose parent is `stream_class`)
+ * is known to be valid for good.
+ *
+ * This is the case when the event class and its stream class were
+ * validated, and the stream class is frozen: none of their field types
+ * (or the trace's, if any, which is frozen too) can change from this
+ * point, so there's no need to validate them again for each event.
+ */
+static inline
+bool event_class_is_valid(struct bt_event_class *event_class,
+		struct bt_stream_class *stream_class)
+{
+	return event_class->valid && stream_class->valid &&
+		stream_class->frozen;
+}
+
+/*
+ * Creates an event out of an event class which is known to be valid
+ * (see event_class_is_valid()): no validation and no type reference
+ * count update.
+ *
+ * The event is a recycled one if the event class's pool is not empty.
+ * Scope fields which were still shared when the event was recycled
+ * were discarded: this function creates fresh ones, except the ones
+ * which `flags` excludes.
+ */
+static
+struct bt_event *create_event_from_valid_class(
+		struct bt_event_class *event_class,
+		struct bt_stream_class *stream_class,
+		enum bt_event_create_flags flags)
+{
+	struct bt_event *event;
+
+	event = bt_object_pool_create_object(&event_class->event_pool);
+	if (unlikely(!event)) {
+		BT_LOGE_STR("Cannot create event object from pool.");
+		goto end;
+	}
+
+	bt_object_init(event, bt_event_release);
+	bt_object_get_no_null_check(event_class);
+	event->event_class = event_class;
+
+	if (!(flags & BT_EVENT_CREATE_FLAG_NO_HEADER) &&
+			create_missing_scope_field(&event->event_header,
+				stream_class->event_header_type)) {
+		goto error;
+	}
+
+	if (!(flags & BT_EVENT_CREATE_FLAG_NO_STREAM_EVENT_CONTEXT) &&
+			create_missing_scope_field(&event->stream_event_context,
+				stream_class->event_context_type)) {
+		goto error;
+	}
+
+	if (!(flags & BT_EVENT_CREATE_FLAG_NO_EVENT_CONTEXT) &&
+			create_missing_scope_field(&event->context_payload,
+				event_class->context)) {
+		goto error;
+	}
+
+	if (!(flags & BT_EVENT_CREATE_FLAG_NO_EVENT_PAYLOAD) &&
+			create_missing_scope_field(&event->fields_payload,
+				event_class->fields)) {
+		goto error;
+	}
+
+	BT_LOGV("Created event object from valid class: addr=%p, "
+		"event-class-name=\"%s\", event-class-id=%" PRId64 ", "
+		"flags=0x%x",
+		event, bt_event_class_get_name(event_class),
+		bt_event_class_get_id(event_class), flags);
+	goto end;
+
+error:
+	BT_PUT(event);
+
+end:
+	return event;
+}
 
 struct bt_event *bt_event_create(struct bt_event_class *event_class)
+{
+	return bt_event_create_with_flags(event_class,
+		BT_EVENT_CREATE_FLAG_DEFAULT);
+}
+
+struct bt_event *bt_event_create_with_flags(struct bt_event_class *event_class,
+		enum bt_event_create_flags flags)
 {
 	int ret;
 	enum bt_validation_flag validation_flags =
@@ -79,17 +212,24 @@ struct bt_event *bt_event_create(struct bt_event_class *event_class)
 	struct bt_validation_output validation_output = { 0 };
 	int trace_valid = 0;
 
-	BT_LOGD("Creating event object: event-class-addr=%p, "
-		"event-class-name=\"%s\", event-class-id=%" PRId64,
-		event_class, bt_event_class_get_name(event_class),
-		bt_event_class_get_id(event_class));
-
 	if (!event_class) {
 		BT_LOGW_STR("Invalid parameter: event class is NULL.");
 		goto error;
 	}
 
-	stream_class = bt_event_class_get_stream_class(event_class);
+	stream_class = bt_event_class_borrow_stream_class(event_class);
+	if (likely(stream_class &&
+			event_class_is_valid(event_class, stream_class))) {
+		return create_event_from_valid_class(event_class,
+			stream_class, flags);
+	}
+
+	BT_LOGD("Creating event object: event-class-addr=%p, "
+		"event-class-name=\"%s\", event-class-id=%" PRId64 ", "
+		"flags=0x%x",
+		event_class, bt_event_class_get_name(event_class),
+		bt_event_class_get_id(event_class), flags);
+	stream_class = bt_get(stream_class);
 
 	/*
 	 * We disallow the creation of an event if its event class has not been
@@ -155,13 +295,12 @@ struct bt_event *bt_event_create(struct bt_event_class *event_class)
 	 * current types, are valid. We may proceed with creating
 	 * the event.
 	 */
-	event = g_new0(struct bt_event, 1);
+	event = bt_event_new(event_class);
 	if (!event) {
-		BT_LOGE_STR("Failed to allocate one event.");
 		goto error;
 	}
 
-	bt_object_init(event, bt_event_destroy);
+	bt_object_init(event, bt_event_release);
 
 	/*
 	 * event does not share a common ancestor with the event class; it has
@@ -171,10 +310,9 @@ struct bt_event *bt_event_create(struct bt_event_class *event_class)
 	 * lifetime.
 	 */
 	event->event_class = bt_get(event_class);
-	event->clock_values = g_hash_table_new_full(g_direct_hash,
-			g_direct_equal, bt_put, bt_put);
 
-	if (validation_output.event_header_type) {
+	if (validation_output.event_header_type &&
+			!(flags & BT_EVENT_CREATE_FLAG_NO_HEADER)) {
 		BT_LOGD("Creating initial event header field: ft-addr=%p",
 			validation_output.event_header_type);
 		event_header =
@@ -185,7 +323,8 @@ struct bt_event *bt_event_create(struct bt_event_class *event_class)
 		}
 	}
 
-	if (validation_output.stream_event_ctx_type) {
+	if (validation_output.stream_event_ctx_type &&
+			!(flags & BT_EVENT_CREATE_FLAG_NO_STREAM_EVENT_CONTEXT)) {
 		BT_LOGD("Creating initial stream event context field: ft-addr=%p",
 			validation_output.stream_event_ctx_type);
 		stream_event_context = bt_field_create(
@@ -196,7 +335,8 @@ struct bt_event *bt_event_create(struct bt_event_class *event_class)
 		}
 	}
 
-	if (validation_output.event_context_type) {
+	if (validation_output.event_context_type &&
+			!(flags & BT_EVENT_CREATE_FLAG_NO_EVENT_CONTEXT)) {
 		BT_LOGD("Creating initial event context field: ft-addr=%p",
 			validation_output.event_context_type);
 		event_context = bt_field_create(
@@ -207,7 +347,8 @@ struct bt_event *bt_event_create(struct bt_event_class *event_class)
 		}
 	}
 
-	if (validation_output.event_payload_type) {
+	if (validation_output.event_payload_type &&
+			!(flags & BT_EVENT_CREATE_FLAG_NO_EVENT_PAYLOAD)) {
 		BT_LOGD("Creating initial event payload field: ft-addr=%p",
 			validation_output.event_payload_type);
 		event_payload = bt_field_create(
@@ -291,14 +432,12 @@ end:
 	return event_class;
 }
 
-struct bt_stream *bt_event_get_stream(struct bt_event *event)
+static
+struct bt_stream *borrow_stream(struct bt_event *event)
 {
 	struct bt_stream *stream = NULL;
 
-	if (!event) {
-		BT_LOGW_STR("Invalid parameter: event is NULL.");
-		goto end;
-	}
+	assert(event);
 
 	/*
 	 * If the event has a parent, then this is its (writer) stream.
@@ -306,13 +445,27 @@ struct bt_stream *bt_event_get_stream(struct bt_event *event)
 	 * is its (non-writer) stream.
 	 */
 	if (event->base.parent) {
-		stream = (struct bt_stream *) bt_object_get_parent(event);
+		stream = (struct bt_stream *) bt_object_borrow_parent(event);
 	} else {
 		if (event->packet) {
-			stream = bt_get(event->packet->stream);
+			stream = event->packet->stream;
 		}
 	}
 
+	return stream;
+}
+
+struct bt_stream *bt_event_get_stream(struct bt_event *event)
+{
+	struct bt_stream *stream = NULL;
+
+	if (!event) {
+		BT_LOGW_STR("Invalid parameter: event is NULL.");
+		goto end;
+	}
+
+	stream = bt_get(borrow_stream(event));
+
 end:
 	return stream;
 }
@@ -737,15 +890,17 @@ void bt_ctf_event_put(struct bt_event *event)
 	bt_put(event);
 }
 
-void bt_event_destroy(struct bt_object *obj)
+BT_HIDDEN
+void bt_event_destroy(struct bt_event *event)
 {
-	struct bt_event *event;
-
-	event = container_of(obj, struct bt_event, base);
-	BT_LOGD("Destroying event: addr=%p, "
-		"event-class-name=\"%s\", event-class-id=%" PRId64,
-		event, bt_event_class_get_name(event->event_class),
-		bt_event_class_get_id(event->event_class));
+	if (event->event_class) {
+		BT_LOGD("Destroying event: addr=%p, "
+			"event-class-name=\"%s\", event-class-id=%" PRId64,
+			event, bt_event_class_get_name(event->event_class),
+			bt_event_class_get_id(event->event_class));
+	} else {
+		BT_LOGD("Destroying recycled event: addr=%p", event);
+	}
 
 	if (!event->base.parent) {
 		/*
@@ -755,7 +910,7 @@ void bt_event_destroy(struct bt_object *obj)
 		 */
 		bt_put(event->event_class);
 	}
-	g_hash_table_destroy(event->clock_values);
+	g_ptr_array_free(event->clock_values, TRUE);
 	BT_LOGD_STR("Putting event's header field.");
 	bt_put(event->event_header);
 	BT_LOGD_STR("Putting event's stream event context field.");
@@ -769,6 +924,89 @@ void bt_event_destroy(struct bt_object *obj)
 	g_free(event);
 }
 
+static
+void recycle_scope_field(struct bt_event *event, struct bt_field **field)
+{
+	if (*field && bt_field_recycle(*field)) {
+		BT_LOGV("Discarding event's scope field which is still shared: "
+			"event-addr=%p, field-addr=%p", event, *field);
+		BT_PUT(*field);
+	}
+}
+
+static
+void reset_clock_values(struct bt_event *event)
+{
+	guint i;
+
+	for (i = 0; i < event->clock_values->len; i++) {
+		struct bt_clock_value *clock_value =
+			g_ptr_array_index(event->clock_values, i);
+
+		if (clock_value) {
+			assert(bt_object_get_ref_count(clock_value) == 0);
+			clock_value->clock_class = NULL;
+		}
+	}
+}
+
+static
+void bt_event_recycle(struct bt_event *event)
+{
+	struct bt_event_class *event_class = event->event_class;
+
+	assert(event_class);
+	BT_LOGV("Recycling event: addr=%p, "
+		"event-class-name=\"%s\", event-class-id=%" PRId64,
+		event, bt_event_class_get_name(event_class),
+		bt_event_class_get_id(event_class));
+
+	/*
+	 * Variant and sequence fields can refer to fields of any scope
+	 * of this event: drop all those references first so that
+	 * bt_field_recycle() only sees references coming from outside
+	 * this event.
+	 */
+	bt_field_put_dynamic_refs(event->event_header);
+	bt_field_put_dynamic_refs(event->stream_event_context);
+	bt_field_put_dynamic_refs(event->context_payload);
+	bt_field_put_dynamic_refs(event->fields_payload);
+	recycle_scope_field(event, &event->event_header);
+	recycle_scope_field(event, &event->stream_event_context);
+	recycle_scope_field(event, &event->context_payload);
+	recycle_scope_field(event, &event->fields_payload);
+	reset_clock_values(event);
+	bt_object_put_ref(event->packet);
+	event->packet = NULL;
+	event->frozen = 0;
+
+	/*
+	 * A recycled event does not keep a reference to its class: put
+	 * it _after_ the event is in the pool since this could be the
+	 * last reference, in which case the event class (and its pool)
+	 * is destroyed.
+	 */
+	event->event_class = NULL;
+	bt_object_pool_recycle_object(&event_class->event_pool, event);
+	bt_object_put_no_null_check(event_class);
+}
+
+static
+void bt_event_release(struct bt_object *obj)
+{
+	struct bt_event *event = container_of(obj, struct bt_event, base);
+
+	if (event->base.parent) {
+		/*
+		 * This event was appended to a CTF writer stream, which
+		 * releases it when flushing: do not recycle it.
+		 */
+		bt_event_destroy(event);
+	} else {
+		bt_event_recycle(event);
+	}
+}
+
 struct bt_clock_value *bt_event_get_clock_value(
 		struct bt_event *event, struct bt_clock_class *clock_class)
 {
@@ -781,7 +1019,7 @@ struct bt_clock_value *bt_event_get_clock_value(
 		goto end;
 	}
 
-	clock_value = g_hash_table_lookup(event->clock_values, clock_class);
+	clock_value = bt_event_borrow_clock_value(event, clock_class);
 	if (!clock_value) {
 		BT_LOGV("No clock value associated to the given clock class: "
 			"event-addr=%p, event-class-name=\"%s\", "
@@ -798,6 +1036,41 @@ end:
 	return clock_value;
 }
 
+/*
+ * Returns the clock value of `event` at `index`, creating it if needed.
+ * A new event clock value has no reference: its first reference gets
+ * its parent event (see bt_get()), and it is freed with the event.
+ */
+static
+struct bt_clock_value *get_or_create_clock_value_at(struct bt_event *event,
+		guint index)
+{
+	struct bt_clock_value *clock_value = NULL;
+
+	if (index >= event->clock_values->len) {
+		g_ptr_array_set_size(event->clock_values, index + 1);
+	}
+
+	clock_value = g_ptr_array_index(event->clock_values, index);
+	if (clock_value) {
+		goto end;
+	}
+
+	clock_value = g_new0(struct bt_clock_value, 1);
+	if (!clock_value) {
+		BT_LOGE_STR("Failed to allocate one clock value.");
+		goto end;
+	}
+
+	bt_object_init(clock_value, NULL);
+	clock_value->base.ref_count.count = 0;
+	clock_value->base.parent = &event->base;
+	g_ptr_array_index(event->clock_values, index) = clock_value;
+
+end:
+	return clock_value;
+}
+
 int bt_event_set_clock_value(struct bt_event *event,
 		struct bt_clock_value *value)
 {
@@ -805,7 +1078,9 @@ int bt_event_set_clock_value(struct bt_event *event,
 	struct bt_trace *trace;
 	struct bt_stream_class *stream_class;
 	struct bt_event_class *event_class;
-	struct bt_clock_class *clock_class = NULL;
+	struct bt_clock_class *clock_class;
+	struct bt_clock_value *event_clock_value;
+	guint i;
 
 	if (!event || !value) {
 		BT_LOGW("Invalid parameter: event or clock value is NULL: "
@@ -824,7 +1099,7 @@ int bt_event_set_clock_value(struct bt_event *event,
 		goto end;
 	}
 
-	clock_class = bt_clock_value_get_class(value);
+	clock_class = value->clock_class;
 	event_class = bt_event_borrow_event_class(event);
 	assert(event_class);
 	stream_class = bt_event_class_borrow_stream_class(event_class);
@@ -832,7 +1107,13 @@ int bt_event_set_clock_value(struct bt_event *event,
 	trace = bt_stream_class_borrow_trace(stream_class);
 	assert(trace);
 
-	if (!bt_trace_has_clock_class(trace, clock_class)) {
+	for (i = 0; i < trace->clocks->len; i++) {
+		if (g_ptr_array_index(trace->clocks, i) == clock_class) {
+			break;
+		}
+	}
+
+	if (i == trace->clocks->len) {
 		BT_LOGW("Invalid parameter: clock class is not part of event's trace: "
 			"event-addr=%p, event-class-name=\"%s\", "
 			"event-class-id=%" PRId64 ", clock-class-addr=%p, "
@@ -844,7 +1125,21 @@ int bt_event_set_clock_value(struct bt_event *event,
 		goto end;
 	}
 
-	g_hash_table_insert(event->clock_values, clock_class, bt_get(value));
+	event_clock_value = get_or_create_clock_value_at(event, i);
+	if (!event_clock_value) {
+		ret = -1;
+		goto end;
+	}
+
+	/*
+	 * The event's trace owns the clock class, and the event
+	 * keeps its trace alive: no need for a reference.
+	 */
+	event_clock_value->clock_class = clock_class;
+	event_clock_value->value = value->value;
+	event_clock_value->ns_from_epoch = value->ns_from_epoch;
+	event_clock_value->ns_from_epoch_overflows =
+		value->ns_from_epoch_overflows;
 	BT_LOGV("Set event's clock value: "
 		"event-addr=%p, event-class-name=\"%s\", "
 		"event-class-id=%" PRId64 ", clock-class-addr=%p, "
@@ -854,10 +1149,8 @@ int bt_event_set_clock_value(struct bt_event *event,
 		bt_event_class_get_id(event->event_class),
 		clock_class, bt_clock_class_get_name(clock_class),
 		value, value->value);
-	clock_class = NULL;
 
 end:
-	bt_put(clock_class);
 	return ret;
 }
 
@@ -993,9 +1286,9 @@ end:
 int bt_event_set_packet(struct bt_event *event,
 		struct bt_packet *packet)
 {
-	struct bt_stream_class *event_stream_class = NULL;
-	struct bt_stream_class *packet_stream_class = NULL;
-	struct bt_stream *stream = NULL;
+	struct bt_stream_class *event_stream_class;
+	struct bt_stream_class *packet_stream_class;
+	struct bt_stream *stream;
 	int ret = 0;
 
 	if (!event || !packet) {
@@ -1019,7 +1312,7 @@ int bt_event_set_packet(struct bt_event *event,
 	 * Make sure the new packet was created by this event's
 	 * stream, if it is set.
 	 */
-	stream = bt_event_get_stream(event);
+	stream = borrow_stream(event);
 	if (stream) {
 		if (packet->stream != stream) {
 			BT_LOGW("Invalid parameter: packet's stream and event's stream differ: "
@@ -1034,9 +1327,9 @@ int bt_event_set_packet(struct bt_event *event,
 		}
 	} else {
 		event_stream_class =
-			bt_event_class_get_stream_class(event->event_class);
+			bt_event_class_borrow_stream_class(event->event_class);
 		packet_stream_class =
-			bt_stream_get_class(packet->stream);
+			bt_stream_borrow_stream_class(packet->stream);
 
 		assert(event_stream_class);
 		assert(packet_stream_class);
@@ -1054,8 +1347,9 @@ int bt_event_set_packet(struct bt_event *event,
 		}
 	}
 
-	bt_get(packet);
-	BT_MOVE(event->packet, packet);
+	bt_object_get_no_null_check(packet);
+	bt_object_put_ref(event->packet);
+	event->packet = packet;
 	BT_LOGV("Set event's packet: event-addr=%p, "
 		"event-class-name=\"%s\", event-class-id=%" PRId64 ", "
 		"packet-addr=%p",
@@ -1063,10 +1357,6 @@ int bt_event_set_packet(struct bt_event *event,
 		bt_event_class_get_id(event->event_class), packet);
 
 end:
-	BT_PUT(stream);
-	BT_PUT(event_stream_class);
-	BT_PUT(packet_stream_class);
-
 	return ret;
 }
 
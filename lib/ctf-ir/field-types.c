@@ -30,6 +30,7 @@
 #include <babeltrace/lib-logging-internal.h>
 
 #include <babeltrace/ctf-ir/field-types-internal.h>
+#include <babeltrace/ctf-ir/fields-internal.h>
 #include <babeltrace/ctf-ir/field-path-internal.h>
 #include <babeltrace/ctf-ir/utils.h>
 #include <babeltrace/ref.h>
@@ -568,6 +569,274 @@ end:
 	}
 }
 
+/*
+ * Maximum number of keys covered by the direct lookup table of an
+ * enumeration field type's index.
+ */
+#define ENUMERATION_INDEX_DIRECT_MAX_LEN	4096
+
+static inline
+uint64_t enumeration_key(bt_bool is_signed, uint64_t value)
+{
+	/* Flip the sign bit so that signed values compare as unsigned */
+	return is_signed ? value ^ (UINT64_C(1) << 63) : value;
+}
+
+static inline
+void enumeration_mapping_keys(struct enumeration_mapping *mapping,
+		bt_bool is_signed, uint64_t *first, uint64_t *last)
+{
+	if (is_signed) {
+		*first = enumeration_key(is_signed,
+			(uint64_t) mapping->range_start._signed);
+		*last = enumeration_key(is_signed,
+			(uint64_t) mapping->range_end._signed);
+	} else {
+		*first = mapping->range_start._unsigned;
+		*last = mapping->range_end._unsigned;
+	}
+}
+
+static
+int compare_enumeration_keys(const void *a, const void *b)
+{
+	uint64_t key_a = *(const uint64_t *) a;
+	uint64_t key_b = *(const uint64_t *) b;
+
+	if (key_a < key_b) {
+		return -1;
+	} else if (key_a > key_b) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static
+void enumeration_index_destroy(struct enumeration_index *index)
+{
+	if (!index) {
+		return;
+	}
+
+	if (index->segments) {
+		g_array_free(index->segments, TRUE);
+	}
+
+	if (index->matches) {
+		g_array_free(index->matches, TRUE);
+	}
+
+	g_free(index->direct);
+	g_free(index);
+}
+
+static
+int enumeration_index_build_direct(struct enumeration_index *index)
+{
+	struct enumeration_index_segment *first_seg;
+	struct enumeration_index_segment *last_seg;
+	uint32_t i;
+	int ret = 0;
+
+	if (index->segments->len == 0) {
+		goto end;
+	}
+
+	first_seg = &g_array_index(index->segments,
+		struct enumeration_index_segment, 0);
+	last_seg = &g_array_index(index->segments,
+		struct enumeration_index_segment, index->segments->len - 1);
+
+	if (last_seg->last - first_seg->first >=
+			ENUMERATION_INDEX_DIRECT_MAX_LEN) {
+		/* Too sparse: binary search only */
+		goto end;
+	}
+
+	index->direct_first = first_seg->first;
+	index->direct_len = last_seg->last - first_seg->first + 1;
+	index->direct = g_new0(uint32_t, index->direct_len);
+	if (!index->direct) {
+		BT_LOGE_STR("Failed to allocate a direct lookup table.");
+		ret = -1;
+		goto end;
+	}
+
+	for (i = 0; i < index->segments->len; i++) {
+		struct enumeration_index_segment *seg = &g_array_index(
+			index->segments, struct enumeration_index_segment, i);
+		uint64_t j;
+
+		/* Offsets, not keys: the last key can be UINT64_MAX */
+		for (j = seg->first - index->direct_first;
+				j <= seg->last - index->direct_first; j++) {
+			index->direct[j] = i + 1;
+		}
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Builds the lookup index of an enumeration field type: its key space
+ * is split at each mapping boundary, so that all the keys of a segment
+ * match the same mappings. The segments which match no mappings are
+ * not kept.
+ *
+ * Note: This algorithm is O(n^2) vs number of enumeration mappings.
+ * Only used when freezing an enumeration.
+ */
+static
+struct enumeration_index *enumeration_index_create(
+		struct bt_field_type_enumeration *enumeration)
+{
+	struct enumeration_index *index = NULL;
+	uint64_t *bounds = NULL;
+	size_t bound_count = 0;
+	size_t unique_count = 0;
+	uint32_t mapping_count = enumeration->entries->len;
+	bt_bool is_signed = bt_field_type_integer_is_signed(
+		enumeration->container);
+	uint32_t i;
+	size_t k;
+
+	index = g_new0(struct enumeration_index, 1);
+	if (!index) {
+		BT_LOGE_STR("Failed to allocate one enumeration field type index.");
+		goto error;
+	}
+
+	index->segments = g_array_new(FALSE, FALSE,
+		sizeof(struct enumeration_index_segment));
+	index->matches = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+	bounds = g_new(uint64_t, 2 * (size_t) mapping_count + 1);
+	if (!index->segments || !index->matches || !bounds) {
+		BT_LOGE_STR("Failed to allocate enumeration field type index's arrays.");
+		goto error;
+	}
+
+	/* Segment boundaries: first key and key following the last key */
+	for (i = 0; i < mapping_count; i++) {
+		uint64_t first, last;
+
+		enumeration_mapping_keys(
+			g_ptr_array_index(enumeration->entries, i),
+			is_signed, &first, &last);
+		bounds[bound_count++] = first;
+
+		if (last != UINT64_MAX) {
+			bounds[bound_count++] = last + 1;
+		}
+	}
+
+	qsort(bounds, bound_count, sizeof(*bounds), compare_enumeration_keys);
+
+	for (k = 0; k < bound_count; k++) {
+		if (unique_count == 0 || bounds[k] != bounds[unique_count - 1]) {
+			bounds[unique_count++] = bounds[k];
+		}
+	}
+
+	for (k = 0; k < unique_count; k++) {
+		struct enumeration_index_segment seg;
+
+		seg.first = bounds[k];
+		seg.last = k + 1 < unique_count ? bounds[k + 1] - 1 :
+			UINT64_MAX;
+		seg.offset = index->matches->len;
+		seg.count = 0;
+
+		for (i = 0; i < mapping_count; i++) {
+			uint64_t first, last;
+
+			enumeration_mapping_keys(
+				g_ptr_array_index(enumeration->entries, i),
+				is_signed, &first, &last);
+
+			if (first <= seg.first && last >= seg.last) {
+				g_array_append_val(index->matches, i);
+				seg.count++;
+			}
+		}
+
+		if (seg.count > 0) {
+			g_array_append_val(index->segments, seg);
+		}
+	}
+
+	if (enumeration_index_build_direct(index)) {
+		goto error;
+	}
+
+	BT_LOGD("Built enumeration field type's index: addr=%p, "
+		"mapping-count=%" PRIu32 ", segment-count=%u, "
+		"match-count=%u, direct-len=%" PRIu64,
+		enumeration, mapping_count, index->segments->len,
+		index->matches->len, index->direct_len);
+	goto end;
+
+error:
+	enumeration_index_destroy(index);
+	index = NULL;
+
+end:
+	g_free(bounds);
+	return index;
+}
+
+/*
+ * Returns the segment of `index` which contains `key`, or NULL if no
+ * mapping contains `key`.
+ */
+static inline
+struct enumeration_index_segment *enumeration_index_find(
+		struct enumeration_index *index, uint64_t key)
+{
+	struct enumeration_index_segment *seg = NULL;
+	uint32_t low = 0;
+	uint32_t high = index->segments->len;
+
+	if (index->direct) {
+		uint64_t i = key - index->direct_first;
+
+		/* Keys out of the table's span wrap to a large `i` */
+		if (i < index->direct_len && index->direct[i] > 0) {
+			seg = &g_array_index(index->segments,
+				struct enumeration_index_segment,
+				index->direct[i] - 1);
+		}
+
+		goto end;
+	}
+
+	/* Find the first segment of which the last key is >= `key` */
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+
+		if (g_array_index(index->segments,
+				struct enumeration_index_segment,
+				mid).last < key) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (low < index->segments->len) {
+		seg = &g_array_index(index->segments,
+			struct enumeration_index_segment, low);
+
+		if (seg->first > key) {
+			seg = NULL;
+		}
+	}
+
+end:
+	return seg;
+}
+
 static
 int bt_field_type_enumeration_validate(struct bt_field_type *type)
 {
@@ -1292,6 +1561,47 @@ error:
 	return NULL;
 }
 
+/*
+ * Moves a value mapping iterator to its next mapping using the index of
+ * its frozen enumeration field type.
+ */
+static
+int enumeration_mapping_iterator_next_indexed(
+		struct bt_field_type_enumeration_mapping_iterator *iter)
+{
+	struct bt_field_type_enumeration *enumeration =
+		iter->enumeration_type;
+	struct enumeration_index_segment *seg;
+	uint64_t key;
+	uint32_t i;
+
+	if (iter->type == ITERATOR_BY_SIGNED_VALUE) {
+		key = enumeration_key(BT_TRUE, (uint64_t) iter->u.signed_value);
+	} else {
+		key = iter->u.unsigned_value;
+	}
+
+	seg = enumeration_index_find(enumeration->index, key);
+	if (!seg) {
+		goto error;
+	}
+
+	/* The matching mappings are sorted by index */
+	for (i = 0; i < seg->count; i++) {
+		uint32_t mapping_index = g_array_index(
+			enumeration->index->matches, uint32_t,
+			seg->offset + i);
+
+		if ((int) mapping_index > iter->index) {
+			iter->index = (int) mapping_index;
+			return 0;
+		}
+	}
+
+error:
+	return -1;
+}
+
 int bt_field_type_enumeration_mapping_iterator_next(
 		struct bt_field_type_enumeration_mapping_iterator *iter)
 {
@@ -1307,6 +1617,12 @@ int bt_field_type_enumeration_mapping_iterator_next(
 
 	enumeration = iter->enumeration_type;
 	type = &enumeration->parent;
+
+	if (enumeration->index && iter->type != ITERATOR_BY_NAME) {
+		ret = enumeration_mapping_iterator_next_indexed(iter);
+		goto end;
+	}
+
 	len = enumeration->entries->len;
 	for (i = iter->index + 1; i < len; i++) {
 		struct enumeration_mapping *mapping =
@@ -1410,6 +1726,109 @@ error:
 	return NULL;
 }
 
+static
+int64_t enumeration_get_mapping_names(struct bt_field_type *type,
+		bt_bool is_signed, uint64_t key, const char **names,
+		uint64_t count)
+{
+	struct bt_field_type_enumeration *enumeration;
+	int64_t match_count = 0;
+	uint32_t i;
+
+	if (!type) {
+		BT_LOGW_STR("Invalid parameter: field type is NULL.");
+		match_count = -1;
+		goto end;
+	}
+
+	if (type->id != BT_FIELD_TYPE_ID_ENUM) {
+		BT_LOGW("Invalid parameter: field type is not an enumeration field type: "
+			"addr=%p, ft-id=%s", type,
+			bt_field_type_id_string(type->id));
+		match_count = -1;
+		goto end;
+	}
+
+	if (!names && count > 0) {
+		BT_LOGW_STR("Invalid parameter: names is NULL.");
+		match_count = -1;
+		goto end;
+	}
+
+	enumeration = container_of(type, struct bt_field_type_enumeration,
+		parent);
+
+	if (bt_field_type_integer_is_signed(enumeration->container) !=
+			is_signed) {
+		BT_LOGW("Invalid parameter: enumeration field type's signedness does not match the value's: "
+			"enum-ft-addr=%p, int-ft-addr=%p, value-is-signed=%d",
+			type, enumeration->container, is_signed);
+		match_count = -1;
+		goto end;
+	}
+
+	if (enumeration->index) {
+		struct enumeration_index_segment *seg =
+			enumeration_index_find(enumeration->index, key);
+
+		if (!seg) {
+			goto end;
+		}
+
+		for (i = 0; i < seg->count && i < count; i++) {
+			uint32_t mapping_index = g_array_index(
+				enumeration->index->matches, uint32_t,
+				seg->offset + i);
+			struct enumeration_mapping *mapping =
+				g_ptr_array_index(enumeration->entries,
+					mapping_index);
+
+			names[i] = g_quark_to_string(mapping->string);
+		}
+
+		match_count = seg->count;
+		goto end;
+	}
+
+	/* Not frozen: linear scan */
+	for (i = 0; i < enumeration->entries->len; i++) {
+		struct enumeration_mapping *mapping =
+			g_ptr_array_index(enumeration->entries, i);
+		uint64_t first, last;
+
+		enumeration_mapping_keys(mapping, is_signed, &first, &last);
+
+		if (key < first || key > last) {
+			continue;
+		}
+
+		if ((uint64_t) match_count < count) {
+			names[match_count] = g_quark_to_string(mapping->string);
+		}
+
+		match_count++;
+	}
+
+end:
+	return match_count;
+}
+
+int64_t bt_field_type_enumeration_get_mapping_names_by_signed_value(
+		struct bt_field_type *type, int64_t value,
+		const char **names, uint64_t count)
+{
+	return enumeration_get_mapping_names(type, BT_TRUE,
+		enumeration_key(BT_TRUE, (uint64_t) value), names, count);
+}
+
+int64_t bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		struct bt_field_type *type, uint64_t value,
+		const char **names, uint64_t count)
+{
+	return enumeration_get_mapping_names(type, BT_FALSE, value, names,
+		count);
+}
+
 int bt_field_type_enumeration_mapping_iterator_get_signed(
 		struct bt_field_type_enumeration_mapping_iterator *iter,
 		const char **mapping_name, int64_t *range_begin,
@@ -3248,6 +3667,9 @@ void bt_field_type_freeze(struct bt_field_type *type)
 	}
 
 	type->freeze(type);
+
+	/* The layout of this type's fields cannot change anymore */
+	type->field_arena_size = bt_field_arena_size_from_type(type);
 }
 
 BT_HIDDEN
@@ -3600,6 +4022,7 @@ void bt_field_type_enumeration_destroy(struct bt_field_type *type)
 	}
 
 	BT_LOGD("Destroying enumeration field type object: addr=%p", type);
+	enumeration_index_destroy(enumeration->index);
 	g_ptr_array_free(enumeration->entries, TRUE);
 	BT_LOGD_STR("Putting container field type.");
 	bt_put(enumeration->container);
@@ -3736,6 +4159,12 @@ void bt_field_type_enumeration_freeze(struct bt_field_type *type)
 	BT_LOGD("Freezing enumeration field type object: addr=%p", type);
 	type->alignment = bt_field_type_get_alignment(type);
 	set_enumeration_range_overlap(type);
+
+	/*
+	 * Without an index (memory error), lookups fall back to a
+	 * linear scan of the mappings.
+	 */
+	enumeration_type->index = enumeration_index_create(enumeration_type);
 	generic_field_type_freeze(type);
 	BT_LOGD("Freezing enumeration field type object's container field type: int-ft-addr=%p",
 		enumeration_type->container);
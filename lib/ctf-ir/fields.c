@@ -40,27 +40,29 @@
 #include <inttypes.h>
 
 static
-struct bt_field *bt_field_integer_create(struct bt_field_type *);
+struct bt_field *bt_field_integer_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_enumeration_create(
-		struct bt_field_type *);
+struct bt_field *bt_field_enumeration_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_floating_point_create(
-		struct bt_field_type *);
+struct bt_field *bt_field_floating_point_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_structure_create(
-		struct bt_field_type *);
+struct bt_field *bt_field_structure_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_variant_create(
-		struct bt_field_type *);
+struct bt_field *bt_field_variant_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_array_create(
-		struct bt_field_type *);
+struct bt_field *bt_field_array_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_sequence_create(
-		struct bt_field_type *);
+struct bt_field *bt_field_sequence_create(struct bt_field_type *,
+		struct bt_field_arena *);
 static
-struct bt_field *bt_field_string_create(struct bt_field_type *);
+struct bt_field *bt_field_string_create(struct bt_field_type *,
+		struct bt_field_arena *);
 
 static
 void bt_field_destroy(struct bt_object *);
@@ -181,9 +183,12 @@ bt_bool bt_field_sequence_is_set(struct bt_field *);
 static
 int increase_packet_size(struct bt_stream_pos *pos);
 
+static
+int copy_field_into(struct bt_field *src, struct bt_field *dst);
+
 static
 struct bt_field *(* const field_create_funcs[])(
-		struct bt_field_type *) = {
+		struct bt_field_type *, struct bt_field_arena *) = {
 	[BT_FIELD_TYPE_ID_INTEGER] = bt_field_integer_create,
 	[BT_FIELD_TYPE_ID_ENUM] = bt_field_enumeration_create,
 	[BT_FIELD_TYPE_ID_FLOAT] =
@@ -283,9 +288,439 @@ bt_bool (* const field_is_set_funcs[])(struct bt_field *) = {
 	[BT_FIELD_TYPE_ID_STRING] = bt_field_generic_is_set,
 };
 
+static
+const size_t field_sizes[] = {
+	[BT_FIELD_TYPE_ID_INTEGER] = sizeof(struct bt_field_integer),
+	[BT_FIELD_TYPE_ID_ENUM] = sizeof(struct bt_field_enumeration),
+	[BT_FIELD_TYPE_ID_FLOAT] = sizeof(struct bt_field_floating_point),
+	[BT_FIELD_TYPE_ID_STRUCT] = sizeof(struct bt_field_structure),
+	[BT_FIELD_TYPE_ID_VARIANT] = sizeof(struct bt_field_variant),
+	[BT_FIELD_TYPE_ID_ARRAY] = sizeof(struct bt_field_array),
+	[BT_FIELD_TYPE_ID_SEQUENCE] = sizeof(struct bt_field_sequence),
+	[BT_FIELD_TYPE_ID_STRING] = sizeof(struct bt_field_string),
+};
+
+static inline
+size_t arena_ptr_array_size(uint64_t count)
+{
+	return ALIGN(count * sizeof(struct bt_field *), BT_FIELD_ARENA_ALIGN);
+}
+
+/*
+ * Returns whether or not the elements of an array field of type
+ * `array_type`, of which the element type's arena size is
+ * `elem_arena_size`, are created in the array field's arena.
+ */
+static inline
+bool array_elements_in_arena(struct bt_field_type_array *array_type,
+		size_t elem_arena_size)
+{
+	return elem_arena_size > 0 && array_type->length <=
+		BT_FIELD_ARENA_MAX_ARRAY_ELEMENTS_SIZE / elem_arena_size;
+}
+
+BT_HIDDEN
+size_t bt_field_arena_size_from_type(struct bt_field_type *type)
+{
+	enum bt_field_type_id type_id = bt_field_type_get_type_id(type);
+	size_t size;
+
+	assert(type_id > BT_FIELD_TYPE_ID_UNKNOWN &&
+		type_id < BT_FIELD_TYPE_ID_NR);
+	size = ALIGN(field_sizes[type_id], BT_FIELD_ARENA_ALIGN);
+
+	switch (type_id) {
+	case BT_FIELD_TYPE_ID_ENUM:
+	{
+		struct bt_field_type_enumeration *enum_type =
+			container_of(type, struct bt_field_type_enumeration,
+				parent);
+
+		size += bt_field_arena_size_from_type(enum_type->container);
+		break;
+	}
+	case BT_FIELD_TYPE_ID_STRUCT:
+	{
+		struct bt_field_type_structure *struct_type =
+			container_of(type, struct bt_field_type_structure,
+				parent);
+		guint i;
+
+		size += arena_ptr_array_size(struct_type->fields->len);
+
+		for (i = 0; i < struct_type->fields->len; i++) {
+			struct structure_field *struct_field =
+				g_ptr_array_index(struct_type->fields, i);
+
+			size += bt_field_arena_size_from_type(
+				struct_field->type);
+		}
+
+		break;
+	}
+	case BT_FIELD_TYPE_ID_ARRAY:
+	{
+		struct bt_field_type_array *array_type =
+			container_of(type, struct bt_field_type_array, parent);
+		size_t elem_size = bt_field_arena_size_from_type(
+			array_type->element_type);
+
+		size += arena_ptr_array_size(array_type->length);
+
+		if (array_elements_in_arena(array_type, elem_size)) {
+			size += array_type->length * elem_size;
+		}
+
+		break;
+	}
+	default:
+		/*
+		 * Variant and sequence fields are created empty: their
+		 * contents are dynamic.
+		 */
+		break;
+	}
+
+	return size;
+}
+
+static
+void field_arena_release(struct bt_object *obj)
+{
+	struct bt_field_arena *arena = (void *) obj;
+
+	BT_LOGV("Destroying field arena: addr=%p, size=%zu", arena,
+		arena->size);
+	g_free(arena);
+}
+
+/*
+ * Creates a field arena of `size` bytes. The caller owns a reference
+ * to it, which it must put once it has created its fields.
+ */
+static
+struct bt_field_arena *field_arena_create(size_t size)
+{
+	struct bt_field_arena *arena;
+
+	arena = g_malloc0(sizeof(*arena) + size);
+	if (!arena) {
+		BT_LOGE("Failed to allocate one field arena: size=%zu", size);
+		goto end;
+	}
+
+	bt_ref_init(&arena->ref_count, field_arena_release);
+	arena->size = size;
+	BT_LOGV("Created field arena: addr=%p, size=%zu", arena, size);
+
+end:
+	return arena;
+}
+
+/*
+ * Allocates a zeroed field structure of `size` bytes (starting with a
+ * `struct bt_field` member) in `arena`, or on its own if `arena` is
+ * `NULL`, and sets its arena.
+ */
+static
+void *field_alloc(struct bt_field_arena *arena, size_t size)
+{
+	struct bt_field *field;
+
+	if (!arena) {
+		return g_malloc0(size);
+	}
+
+	size = ALIGN(size, BT_FIELD_ARENA_ALIGN);
+	assert(arena->offset + size <= arena->size);
+	field = (void *) &arena->data[arena->offset];
+	arena->offset += size;
+	field->arena = arena;
+	bt_ref_get(&arena->ref_count);
+	return field;
+}
+
+/*
+ * Allocates a zeroed array of `count` field pointers in `arena`, or on
+ * its own if `arena` is `NULL`. Such an array shares the lifetime of
+ * its field: it does not hold a reference on the arena.
+ */
+static
+struct bt_field **field_alloc_ptr_array(struct bt_field_arena *arena,
+		uint64_t count)
+{
+	struct bt_field **ptrs;
+
+	if (!arena) {
+		/*
+		 * g_new0() returns `NULL` for zero elements: always
+		 * allocate at least one so that an empty structure or
+		 * array field is not mistaken for an allocation failure.
+		 */
+		return g_new0(struct bt_field *, MAX(count, 1));
+	}
+
+	assert(arena->offset + arena_ptr_array_size(count) <= arena->size);
+	ptrs = (void *) &arena->data[arena->offset];
+	arena->offset += arena_ptr_array_size(count);
+	return ptrs;
+}
+
+/* Frees a field allocated with field_alloc(). */
+static
+void field_free(struct bt_field *field)
+{
+	struct bt_field_arena *arena = field->arena;
+
+	if (arena) {
+		bt_ref_put(&arena->ref_count);
+	} else {
+		g_free(field);
+	}
+}
+
+/*
+ * Puts the `count` fields of `ptrs`, the pointer array of the
+ * structure or array field `field`, and frees it if needed.
+ */
+static
+void put_field_ptr_array(struct bt_field *field, struct bt_field **ptrs,
+		uint64_t count)
+{
+	uint64_t i;
+
+	if (!ptrs) {
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		bt_put(ptrs[i]);
+	}
+
+	if (!field->arena) {
+		g_free(ptrs);
+	}
+}
+
+static inline
+void borrowed_bytes_set(struct bt_field_borrowed_bytes *borrowed,
+		const uint8_t *addr, size_t len, void *owner)
+{
+	struct bt_object *old_owner = borrowed->owner;
+
+	borrowed->addr = addr;
+	borrowed->len = len;
+	borrowed->owner = bt_object_get_ref(owner);
+	bt_object_put_ref(old_owner);
+}
+
+static inline
+void borrowed_bytes_reset(struct bt_field_borrowed_bytes *borrowed)
+{
+	borrowed->addr = NULL;
+	borrowed->len = 0;
+	bt_object_put_ref(borrowed->owner);
+	borrowed->owner = NULL;
+}
+
+/*
+ * Creates, if needed, and sets the `len` element fields of `elements`,
+ * of type `elem_type` (an 8-bit integer field type), of the array or
+ * sequence field `field` from the bytes at `addr`.
+ *
+ * If `field` is frozen, the created element fields are frozen too.
+ */
+static
+int set_byte_elements(struct bt_field *field, const uint8_t *addr,
+		size_t len, struct bt_field **elements,
+		struct bt_field_type *elem_type)
+{
+	struct bt_field_type_integer *int_type = container_of(elem_type,
+		struct bt_field_type_integer, parent);
+	size_t i;
+	int ret = 0;
+
+	BT_LOGV("Creating element fields from bytes: "
+		"field-addr=%p, bytes-addr=%p, count=%zu", field, addr, len);
+
+	for (i = 0; i < len; i++) {
+		struct bt_field_integer *integer;
+
+		if (!elements[i]) {
+			elements[i] = bt_field_create(elem_type);
+			if (!elements[i]) {
+				BT_LOGE("Cannot create element field: "
+					"field-addr=%p, index=%zu", field, i);
+				ret = -1;
+				goto end;
+			}
+		}
+
+		integer = container_of(elements[i], struct bt_field_integer,
+			parent);
+
+		if (int_type->is_signed) {
+			integer->payload.signd = (int8_t) addr[i];
+		} else {
+			integer->payload.unsignd = addr[i];
+		}
+
+		integer->parent.payload_set = true;
+
+		if (field->frozen) {
+			bt_field_freeze(elements[i]);
+		}
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Creates, if needed, and sets the element fields of `elements`, of
+ * type `elem_type` (an 8-bit integer field type), from the bytes to
+ * which their array or sequence field `field` refers, and then makes
+ * this field stop referring to them.
+ *
+ * This is also called for a frozen field, as the element fields are
+ * only a different representation of its value: in this case, the
+ * created element fields are frozen too.
+ */
+static
+int materialize_borrowed_bytes(struct bt_field *field,
+		struct bt_field_borrowed_bytes *borrowed,
+		struct bt_field **elements, struct bt_field_type *elem_type)
+{
+	int ret;
+
+	ret = set_byte_elements(field, borrowed->addr, borrowed->len,
+		elements, elem_type);
+	if (ret) {
+		goto end;
+	}
+
+	borrowed_bytes_reset(borrowed);
+
+end:
+	return ret;
+}
+
+static inline
+int array_materialize(struct bt_field_array *array)
+{
+	if (likely(!array->borrowed.addr)) {
+		return 0;
+	}
+
+	return materialize_borrowed_bytes(&array->parent, &array->borrowed,
+		array->elements, container_of(array->parent.type,
+			struct bt_field_type_array, parent)->element_type);
+}
+
+static inline
+int sequence_materialize(struct bt_field_sequence *sequence)
+{
+	if (likely(!sequence->borrowed.addr)) {
+		return 0;
+	}
+
+	return materialize_borrowed_bytes(&sequence->parent,
+		&sequence->borrowed,
+		(struct bt_field **) sequence->elements->pdata,
+		container_of(sequence->parent.type,
+			struct bt_field_type_sequence, parent)->element_type);
+}
+
+/*
+ * Sets the owned value of the string field `string` to the `len` bytes
+ * at `value`.
+ */
+static
+int string_set_payload_len(struct bt_field_string *string,
+		const char *value, size_t len)
+{
+	int ret = 0;
+
+	if (string->payload) {
+		g_string_truncate(string->payload, 0);
+		g_string_append_len(string->payload, value, len);
+	} else {
+		string->payload = g_string_new_len(value, len);
+		if (!string->payload) {
+			BT_LOGE_STR("Failed to allocate a GString.");
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * Copies the value to which the string field `string` refers, if any,
+ * so that it can be modified.
+ */
+static
+int string_materialize(struct bt_field_string *string)
+{
+	int ret = 0;
+
+	if (likely(!string->borrowed.addr)) {
+		goto end;
+	}
+
+	ret = string_set_payload_len(string,
+		(const char *) string->borrowed.addr, string->borrowed.len);
+	if (ret) {
+		goto end;
+	}
+
+	borrowed_bytes_reset(&string->borrowed);
+
+end:
+	return ret;
+}
+
+/*
+ * Returns whether or not `type` is an 8-bit integer field type, the
+ * only element field type of array and sequence fields which can refer
+ * to borrowed bytes.
+ */
+static
+bool is_byte_int_field_type(struct bt_field_type *type)
+{
+	return type->id == BT_FIELD_TYPE_ID_INTEGER &&
+		container_of(type, struct bt_field_type_integer,
+			parent)->size == 8;
+}
+
+/*
+ * Creates a field of type `type`, which is valid and frozen, in `arena`
+ * (can be `NULL`).
+ */
+static
+struct bt_field *field_create(struct bt_field_type *type,
+		struct bt_field_arena *arena)
+{
+	struct bt_field *field;
+
+	field = field_create_funcs[bt_field_type_get_type_id(type)](type,
+		arena);
+	if (!field) {
+		goto end;
+	}
+
+	bt_get(type);
+	bt_object_init(field, bt_field_destroy);
+	field->type = type;
+
+end:
+	return field;
+}
+
 struct bt_field *bt_field_create(struct bt_field_type *type)
 {
 	struct bt_field *field = NULL;
+	struct bt_field_arena *arena = NULL;
 	enum bt_field_type_id type_id;
 	int ret;
 
@@ -311,16 +746,27 @@ struct bt_field *bt_field_create(struct bt_field_type *type)
 		goto error;
 	}
 
-	field = field_create_funcs[type_id](type);
-	if (!field) {
-		goto error;
+	/*
+	 * The type's declaration can't change after this point: its
+	 * arena size is known.
+	 */
+	bt_field_type_freeze(type);
+
+	if (type->field_arena_size > ALIGN(field_sizes[type_id],
+			BT_FIELD_ARENA_ALIGN)) {
+		/* Compound field: create the whole tree in one block */
+		arena = field_arena_create(type->field_arena_size);
+		if (!arena) {
+			goto error;
+		}
+	}
+
+	field = field_create(type, arena);
+	if (arena) {
+		/* Only the fields now keep the arena alive */
+		bt_ref_put(&arena->ref_count);
 	}
 
-	/* The type's declaration can't change after this point */
-	bt_field_type_freeze(type);
-	bt_get(type);
-	bt_object_init(field, bt_field_destroy);
-	field->type = type;
 error:
 	return field;
 }
@@ -347,7 +793,7 @@ struct bt_field_type *bt_field_get_type(struct bt_field *field)
 	}
 
 	ret = field->type;
-	bt_get(ret);
+	bt_object_get_no_null_check(ret);
 end:
 	return ret;
 }
@@ -496,6 +942,7 @@ int bt_field_sequence_set_length(struct bt_field *field,
 		parent);
 	sequence_length = length->payload.unsignd;
 	sequence = container_of(field, struct bt_field_sequence, parent);
+	borrowed_bytes_reset(&sequence->borrowed);
 	if (sequence->elements) {
 		g_ptr_array_free(sequence->elements, TRUE);
 		bt_put(sequence->length);
@@ -560,7 +1007,7 @@ struct bt_field *bt_field_structure_get_field_by_name(
 		goto error;
 	}
 
-	ret = bt_get(structure->fields->pdata[index]);
+	ret = bt_object_get_ref(structure->fields[index]);
 	assert(ret);
 error:
 	return ret;
@@ -587,14 +1034,14 @@ struct bt_field *bt_field_structure_get_field_by_index(
 	}
 
 	structure = container_of(field, struct bt_field_structure, parent);
-	if (index >= structure->fields->len) {
+	if (index >= structure->field_count) {
 		BT_LOGW("Invalid parameter: index is out of bounds: "
-			"addr=%p, index=%" PRIu64 ", count=%u",
-			field, index, structure->fields->len);
+			"addr=%p, index=%" PRIu64 ", count=%" PRIu64,
+			field, index, structure->field_count);
 		goto end;
 	}
 
-	ret = bt_get(structure->fields->pdata[index]);
+	ret = bt_object_get_ref(structure->fields[index]);
 end:
 	return ret;
 }
@@ -666,7 +1113,7 @@ int bt_field_structure_set_field_by_name(struct bt_field *field,
 		goto end;
 	}
 	bt_get(value);
-	BT_MOVE(structure->fields->pdata[index], value);
+	BT_MOVE(structure->fields[index], value);
 end:
 	if (expected_field_type) {
 		bt_put(expected_field_type);
@@ -696,16 +1143,20 @@ struct bt_field *bt_field_array_get_field(struct bt_field *field,
 	}
 
 	array = container_of(field, struct bt_field_array, parent);
-	if (index >= array->elements->len) {
+	if (index >= array->element_count) {
 		BT_LOGW("Invalid parameter: index is out of bounds: "
-			"addr=%p, index=%" PRIu64 ", count=%u",
-			field, index, array->elements->len);
+			"addr=%p, index=%" PRIu64 ", count=%" PRIu64,
+			field, index, array->element_count);
+		goto end;
+	}
+
+	if (array_materialize(array)) {
 		goto end;
 	}
 
 	field_type = bt_field_type_array_get_element_type(field->type);
-	if (array->elements->pdata[(size_t)index]) {
-		new_field = array->elements->pdata[(size_t)index];
+	if (array->elements[(size_t)index]) {
+		new_field = array->elements[(size_t)index];
 		goto end;
 	}
 
@@ -723,13 +1174,13 @@ struct bt_field *bt_field_array_get_field(struct bt_field *field,
 	}
 
 	new_field = bt_field_create(field_type);
-	array->elements->pdata[(size_t)index] = new_field;
+	array->elements[(size_t)index] = new_field;
 end:
 	if (field_type) {
 		bt_put(field_type);
 	}
 	if (new_field) {
-		bt_get(new_field);
+		bt_object_get_no_null_check(new_field);
 	}
 	return new_field;
 }
@@ -769,6 +1220,10 @@ struct bt_field *bt_field_sequence_get_field(struct bt_field *field,
 		goto end;
 	}
 
+	if (sequence_materialize(sequence)) {
+		goto end;
+	}
+
 	field_type = bt_field_type_sequence_get_element_type(field->type);
 	if (sequence->elements->pdata[(size_t) index]) {
 		new_field = sequence->elements->pdata[(size_t) index];
@@ -788,16 +1243,169 @@ struct bt_field *bt_field_sequence_get_field(struct bt_field *field,
 		goto end;
 	}
 
-	new_field = bt_field_create(field_type);
-	sequence->elements->pdata[(size_t) index] = new_field;
+	new_field = bt_field_create(field_type);
+	sequence->elements->pdata[(size_t) index] = new_field;
+end:
+	if (field_type) {
+		bt_put(field_type);
+	}
+	if (new_field) {
+		bt_object_get_no_null_check(new_field);
+	}
+	return new_field;
+}
+
+/*
+ * Validates the parameters of bt_field_array_set_borrowed_bytes() and
+ * bt_field_sequence_set_borrowed_bytes().
+ */
+static
+int validate_borrowed_bytes_params(struct bt_field *field,
+		const uint8_t *bytes, enum bt_field_type_id type_id)
+{
+	int ret = 0;
+	struct bt_field_type *elem_type;
+
+	if (!field) {
+		BT_LOGW_STR("Invalid parameter: field is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	if (!bytes) {
+		BT_LOGW_STR("Invalid parameter: bytes is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	if (field->frozen) {
+		BT_LOGW("Invalid parameter: field is frozen: addr=%p",
+			field);
+		ret = -1;
+		goto end;
+	}
+
+	if (bt_field_type_get_type_id(field->type) != type_id) {
+		BT_LOGW("Invalid parameter: unexpected field type: "
+			"field-addr=%p, ft-addr=%p, ft-id=%s, "
+			"expected-ft-id=%s", field, field->type,
+			bt_field_type_id_string(field->type->id),
+			bt_field_type_id_string(type_id));
+		ret = -1;
+		goto end;
+	}
+
+	if (type_id == BT_FIELD_TYPE_ID_ARRAY) {
+		elem_type = container_of(field->type,
+			struct bt_field_type_array, parent)->element_type;
+	} else {
+		elem_type = container_of(field->type,
+			struct bt_field_type_sequence, parent)->element_type;
+	}
+
+	if (!is_byte_int_field_type(elem_type)) {
+		BT_LOGW("Invalid parameter: element field type is not an 8-bit integer field type: "
+			"field-addr=%p, ft-addr=%p, elem-ft-addr=%p",
+			field, field->type, elem_type);
+		ret = -1;
+		goto end;
+	}
+
+end:
+	return ret;
+}
+
+int bt_field_array_set_borrowed_bytes(struct bt_field *field,
+		const uint8_t *bytes, void *owner)
+{
+	int ret;
+	struct bt_field_array *array;
+
+	ret = validate_borrowed_bytes_params(field, bytes,
+		BT_FIELD_TYPE_ID_ARRAY);
+	if (ret) {
+		goto end;
+	}
+
+	array = container_of(field, struct bt_field_array, parent);
+	borrowed_bytes_set(&array->borrowed, bytes,
+		(size_t) array->element_count, owner);
+end:
+	return ret;
+}
+
+const uint8_t *bt_field_array_get_borrowed_bytes(struct bt_field *field)
+{
+	const uint8_t *bytes = NULL;
+
+	if (!field) {
+		BT_LOGW_STR("Invalid parameter: field is NULL.");
+		goto end;
+	}
+
+	if (bt_field_type_get_type_id(field->type) !=
+			BT_FIELD_TYPE_ID_ARRAY) {
+		BT_LOGW("Invalid parameter: field's type is not an array field type: "
+			"field-addr=%p, ft-addr=%p, ft-id=%s", field,
+			field->type,
+			bt_field_type_id_string(field->type->id));
+		goto end;
+	}
+
+	bytes = container_of(field, struct bt_field_array,
+		parent)->borrowed.addr;
+end:
+	return bytes;
+}
+
+int bt_field_sequence_set_borrowed_bytes(struct bt_field *field,
+		const uint8_t *bytes, void *owner)
+{
+	int ret;
+	struct bt_field_sequence *sequence;
+
+	ret = validate_borrowed_bytes_params(field, bytes,
+		BT_FIELD_TYPE_ID_SEQUENCE);
+	if (ret) {
+		goto end;
+	}
+
+	sequence = container_of(field, struct bt_field_sequence, parent);
+	if (!sequence->elements) {
+		BT_LOGW("Invalid parameter: sequence field's length is not set: "
+			"addr=%p", field);
+		ret = -1;
+		goto end;
+	}
+
+	borrowed_bytes_set(&sequence->borrowed, bytes,
+		(size_t) sequence->elements->len, owner);
+end:
+	return ret;
+}
+
+const uint8_t *bt_field_sequence_get_borrowed_bytes(struct bt_field *field)
+{
+	const uint8_t *bytes = NULL;
+
+	if (!field) {
+		BT_LOGW_STR("Invalid parameter: field is NULL.");
+		goto end;
+	}
+
+	if (bt_field_type_get_type_id(field->type) !=
+			BT_FIELD_TYPE_ID_SEQUENCE) {
+		BT_LOGW("Invalid parameter: field's type is not a sequence field type: "
+			"field-addr=%p, ft-addr=%p, ft-id=%s", field,
+			field->type,
+			bt_field_type_id_string(field->type->id));
+		goto end;
+	}
+
+	bytes = container_of(field, struct bt_field_sequence,
+		parent)->borrowed.addr;
 end:
-	if (field_type) {
-		bt_put(field_type);
-	}
-	if (new_field) {
-		bt_get(new_field);
-	}
-	return new_field;
+	return bytes;
 }
 
 struct bt_field *bt_field_variant_get_field(struct bt_field *field,
@@ -952,7 +1560,7 @@ struct bt_field *bt_field_variant_get_current_field(
 
 	if (variant->payload) {
 		current_field = variant->payload;
-		bt_get(current_field);
+		bt_object_get_no_null_check(current_field);
 		goto end;
 	}
 
@@ -1034,7 +1642,7 @@ struct bt_field *bt_field_enumeration_get_container(
 	}
 
 	container = enumeration->payload;
-	bt_get(container);
+	bt_object_get_ref(container);
 end:
 	return container;
 }
@@ -1420,7 +2028,11 @@ const char *bt_field_string_get_value(struct bt_field *field)
 
 	string = container_of(field,
 		struct bt_field_string, parent);
-	ret = string->payload->str;
+	if (string->borrowed.addr) {
+		ret = (const char *) string->borrowed.addr;
+	} else {
+		ret = string->payload->str;
+	}
 end:
 	return ret;
 }
@@ -1461,6 +2073,7 @@ int bt_field_string_set_value(struct bt_field *field,
 	}
 
 	string = container_of(field, struct bt_field_string, parent);
+	borrowed_bytes_reset(&string->borrowed);
 	if (string->payload) {
 		g_string_assign(string->payload, value);
 	} else {
@@ -1472,6 +2085,57 @@ end:
 	return ret;
 }
 
+int bt_field_string_set_borrowed_value(struct bt_field *field,
+		const char *value, size_t length, void *owner)
+{
+	int ret = 0;
+	struct bt_field_string *string;
+
+	if (!field) {
+		BT_LOGW_STR("Invalid parameter: field is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	if (!value) {
+		BT_LOGW_STR("Invalid parameter: value is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	if (field->frozen) {
+		BT_LOGW("Invalid parameter: field is frozen: addr=%p",
+			field);
+		ret = -1;
+		goto end;
+	}
+
+	if (bt_field_type_get_type_id(field->type) !=
+			BT_FIELD_TYPE_ID_STRING) {
+		BT_LOGW("Invalid parameter: field's type is not a string field type: "
+			"field-addr=%p, ft-addr=%p, ft-id=%s", field,
+			field->type,
+			bt_field_type_id_string(field->type->id));
+		ret = -1;
+		goto end;
+	}
+
+	if (value[length] != '\0') {
+		BT_LOGW("Invalid parameter: value is not null-terminated at the given length: "
+			"field-addr=%p, value-addr=%p, length=%zu",
+			field, value, length);
+		ret = -1;
+		goto end;
+	}
+
+	string = container_of(field, struct bt_field_string, parent);
+	borrowed_bytes_set(&string->borrowed, (const uint8_t *) value,
+		length, owner);
+	string->parent.payload_set = true;
+end:
+	return ret;
+}
+
 int bt_field_string_append(struct bt_field *field,
 		const char *value)
 {
@@ -1508,6 +2172,10 @@ int bt_field_string_append(struct bt_field *field,
 	}
 
 	string_field = container_of(field, struct bt_field_string, parent);
+	ret = string_materialize(string_field);
+	if (ret) {
+		goto end;
+	}
 
 	if (string_field->payload) {
 		g_string_append(string_field->payload, value);
@@ -1559,6 +2227,10 @@ int bt_field_string_append_len(struct bt_field *field,
 	}
 
 	string_field = container_of(field, struct bt_field_string, parent);
+	ret = string_materialize(string_field);
+	if (ret) {
+		goto end;
+	}
 
 	/* make sure no null bytes are appended */
 	for (i = 0; i < length; ++i) {
@@ -1640,6 +2312,152 @@ end:
 	return ret;
 }
 
+BT_HIDDEN
+void bt_field_put_dynamic_refs(struct bt_field *field)
+{
+	enum bt_field_type_id type_id;
+	size_t i;
+
+	/*
+	 * Do not touch a field which is also reachable from somewhere
+	 * else: bt_field_recycle() will refuse to recycle it anyway.
+	 */
+	if (!field || bt_object_get_ref_count(field) != 1) {
+		return;
+	}
+
+	type_id = bt_field_get_type_id(field);
+	switch (type_id) {
+	case BT_FIELD_TYPE_ID_STRUCT:
+	{
+		struct bt_field_structure *structure = container_of(field,
+			struct bt_field_structure, parent);
+
+		for (i = 0; i < structure->field_count; i++) {
+			bt_field_put_dynamic_refs(structure->fields[i]);
+		}
+
+		break;
+	}
+	case BT_FIELD_TYPE_ID_ARRAY:
+	{
+		struct bt_field_array *array = container_of(field,
+			struct bt_field_array, parent);
+
+		for (i = 0; i < array->element_count; i++) {
+			bt_field_put_dynamic_refs(array->elements[i]);
+		}
+
+		break;
+	}
+	case BT_FIELD_TYPE_ID_VARIANT:
+	case BT_FIELD_TYPE_ID_SEQUENCE:
+		/*
+		 * Resetting a variant or a sequence field puts its
+		 * tag/length field and its current payload/elements.
+		 */
+		(void) field_reset_funcs[type_id](field);
+		break;
+	default:
+		break;
+	}
+}
+
+static
+bool field_unfreeze_if_exclusive(struct bt_field *field)
+{
+	bool exclusive = false;
+	size_t i;
+
+	if (!field) {
+		/* Lazily created field: nothing to check */
+		exclusive = true;
+		goto end;
+	}
+
+	if (bt_object_get_ref_count(field) != 1) {
+		BT_LOGV("Field is still shared: addr=%p, ref-count=%ld",
+			field, bt_object_get_ref_count(field));
+		goto end;
+	}
+
+	switch (bt_field_get_type_id(field)) {
+	case BT_FIELD_TYPE_ID_STRUCT:
+	{
+		struct bt_field_structure *structure = container_of(field,
+			struct bt_field_structure, parent);
+
+		for (i = 0; i < structure->field_count; i++) {
+			if (!field_unfreeze_if_exclusive(
+					structure->fields[i])) {
+				goto end;
+			}
+		}
+
+		break;
+	}
+	case BT_FIELD_TYPE_ID_ARRAY:
+	{
+		struct bt_field_array *array = container_of(field,
+			struct bt_field_array, parent);
+
+		for (i = 0; i < array->element_count; i++) {
+			if (!field_unfreeze_if_exclusive(
+					array->elements[i])) {
+				goto end;
+			}
+		}
+
+		break;
+	}
+	case BT_FIELD_TYPE_ID_ENUM:
+	{
+		struct bt_field_enumeration *enumeration = container_of(field,
+			struct bt_field_enumeration, parent);
+
+		if (!field_unfreeze_if_exclusive(enumeration->payload)) {
+			goto end;
+		}
+
+		break;
+	}
+	default:
+		break;
+	}
+
+	field->frozen = false;
+	exclusive = true;
+
+end:
+	return exclusive;
+}
+
+BT_HIDDEN
+int bt_field_recycle(struct bt_field *field)
+{
+	int ret = 0;
+
+	assert(field);
+	BT_LOGV("Recycling field: addr=%p", field);
+
+	if (!field_unfreeze_if_exclusive(field)) {
+		/*
+		 * Some fields of this tree could be unfrozen at this
+		 * point, but only the ones which are exclusively owned
+		 * by the tree, which is about to be discarded.
+		 */
+		BT_LOGV("Cannot recycle field: field tree is still shared: "
+			"addr=%p", field);
+		ret = -1;
+		goto end;
+	}
+
+	ret = bt_field_reset(field);
+
+end:
+	return ret;
+}
+
 BT_HIDDEN
 int bt_field_serialize(struct bt_field *field,
 		struct bt_stream_pos *pos,
@@ -1717,8 +2535,7 @@ struct bt_field *bt_field_copy(struct bt_field *field)
 		goto end;
 	}
 
-	copy->payload_set = field->payload_set;
-	ret = field_copy_funcs[type_id](field, copy);
+	ret = copy_field_into(field, copy);
 	if (ret) {
 		bt_put(copy);
 		copy = NULL;
@@ -1727,11 +2544,53 @@ end:
 	return copy;
 }
 
+/*
+ * Copies the contents of `src` into `dst`, an existing field of the
+ * same type.
+ */
+static
+int copy_field_into(struct bt_field *src, struct bt_field *dst)
+{
+	dst->payload_set = src->payload_set;
+	return field_copy_funcs[bt_field_get_type_id(src)](src, dst);
+}
+
+/*
+ * Copies `src` to the field slot `*dst`: into the existing field if
+ * there's one (for example, a field of the destination tree's arena),
+ * or into a new field otherwise. If `src` is `NULL`, the slot becomes
+ * empty too.
+ */
+static
+int copy_field_to_slot(struct bt_field *src, struct bt_field **dst)
+{
+	int ret = 0;
+
+	if (!src) {
+		BT_PUT(*dst);
+		goto end;
+	}
+
+	if (*dst) {
+		ret = copy_field_into(src, *dst);
+		goto end;
+	}
+
+	*dst = bt_field_copy(src);
+	if (!*dst) {
+		ret = -1;
+	}
+
+end:
+	return ret;
+}
+
 static
-struct bt_field *bt_field_integer_create(struct bt_field_type *type)
+struct bt_field *bt_field_integer_create(struct bt_field_type *type,
+		struct bt_field_arena *arena)
 {
-	struct bt_field_integer *integer = g_new0(
-		struct bt_field_integer, 1);
+	struct bt_field_integer *integer = field_alloc(arena,
+		sizeof(*integer));
 
 	BT_LOGD("Creating integer field object: ft-addr=%p", type);
 
@@ -1747,31 +2606,52 @@ struct bt_field *bt_field_integer_create(struct bt_field_type *type)
 
 static
 struct bt_field *bt_field_enumeration_create(
-	struct bt_field_type *type)
+	struct bt_field_type *type, struct bt_field_arena *arena)
 {
-	struct bt_field_enumeration *enumeration = g_new0(
-		struct bt_field_enumeration, 1);
+	struct bt_field_enumeration *enumeration = field_alloc(arena,
+		sizeof(*enumeration));
 
 	BT_LOGD("Creating enumeration field object: ft-addr=%p", type);
 
-	if (enumeration) {
-		BT_LOGD("Created enumeration field object: addr=%p, ft-addr=%p",
-			&enumeration->parent, type);
-	} else {
+	if (!enumeration) {
 		BT_LOGE_STR("Failed to allocate one enumeration field.");
+		goto end;
 	}
 
+	if (arena) {
+		struct bt_field_type_enumeration *enumeration_type =
+			container_of(type, struct bt_field_type_enumeration,
+				parent);
+
+		/*
+		 * The container field is in the arena: create it now
+		 * instead of in bt_field_enumeration_get_container().
+		 */
+		enumeration->payload = field_create(enumeration_type->container,
+			arena);
+		if (!enumeration->payload) {
+			BT_LOGE_STR("Cannot create enumeration field's container field.");
+			bt_field_enumeration_destroy(&enumeration->parent);
+			enumeration = NULL;
+			goto end;
+		}
+	}
+
+	BT_LOGD("Created enumeration field object: addr=%p, ft-addr=%p",
+		&enumeration->parent, type);
+
+end:
 	return enumeration ? &enumeration->parent : NULL;
 }
 
 static
 struct bt_field *bt_field_floating_point_create(
-	struct bt_field_type *type)
+	struct bt_field_type *type, struct bt_field_arena *arena)
 {
 	struct bt_field_floating_point *floating_point;
 
 	BT_LOGD("Creating floating point number field object: ft-addr=%p", type);
-	floating_point = g_new0(struct bt_field_floating_point, 1);
+	floating_point = field_alloc(arena, sizeof(*floating_point));
 
 	if (floating_point) {
 		BT_LOGD("Created floating point number field object: addr=%p, ft-addr=%p",
@@ -1785,12 +2665,12 @@ struct bt_field *bt_field_floating_point_create(
 
 static
 struct bt_field *bt_field_structure_create(
-	struct bt_field_type *type)
+	struct bt_field_type *type, struct bt_field_arena *arena)
 {
 	struct bt_field_type_structure *structure_type = container_of(type,
 		struct bt_field_type_structure, parent);
-	struct bt_field_structure *structure = g_new0(
-		struct bt_field_structure, 1);
+	struct bt_field_structure *structure = field_alloc(arena,
+		sizeof(*structure));
 	struct bt_field *ret = NULL;
 	size_t i;
 
@@ -1801,18 +2681,27 @@ struct bt_field *bt_field_structure_create(
 		goto end;
 	}
 
-	structure->fields = g_ptr_array_new_with_free_func(
-		(GDestroyNotify) bt_put);
-	g_ptr_array_set_size(structure->fields,
+	structure->fields = field_alloc_ptr_array(arena,
 		structure_type->fields->len);
+	if (!structure->fields) {
+		BT_LOGE_STR("Failed to allocate structure field's fields.");
+		field_free(&structure->parent);
+		goto end;
+	}
+
+	structure->field_count = structure_type->fields->len;
 
-	/* Create all fields contained by the structure field. */
+	/*
+	 * Create all fields contained by the structure field. The
+	 * structure field type is valid, so its field types are valid
+	 * and frozen too.
+	 */
 	for (i = 0; i < structure_type->fields->len; i++) {
 		struct bt_field *field;
 		struct structure_field *field_type =
 			g_ptr_array_index(structure_type->fields, i);
 
-		field = bt_field_create(field_type->type);
+		field = field_create(field_type->type, arena);
 		if (!field) {
 			BT_LOGE("Failed to create structure field's member: name=\"%s\", index=%zu",
 				g_quark_to_string(field_type->name), i);
@@ -1820,7 +2709,7 @@ struct bt_field *bt_field_structure_create(
 			goto end;
 		}
 
-		g_ptr_array_index(structure->fields, i) = field;
+		structure->fields[i] = field;
 	}
 
 	ret = &structure->parent;
@@ -1831,10 +2720,11 @@ end:
 }
 
 static
-struct bt_field *bt_field_variant_create(struct bt_field_type *type)
+struct bt_field *bt_field_variant_create(struct bt_field_type *type,
+		struct bt_field_arena *arena)
 {
-	struct bt_field_variant *variant = g_new0(
-		struct bt_field_variant, 1);
+	struct bt_field_variant *variant = field_alloc(arena,
+		sizeof(*variant));
 
 	BT_LOGD("Creating variant field object: ft-addr=%p", type);
 
@@ -1849,11 +2739,13 @@ struct bt_field *bt_field_variant_create(struct bt_field_type *type)
 }
 
 static
-struct bt_field *bt_field_array_create(struct bt_field_type *type)
+struct bt_field *bt_field_array_create(struct bt_field_type *type,
+		struct bt_field_arena *arena)
 {
-	struct bt_field_array *array = g_new0(struct bt_field_array, 1);
+	struct bt_field_array *array = field_alloc(arena, sizeof(*array));
 	struct bt_field_type_array *array_type;
 	unsigned int array_length;
+	unsigned int i;
 
 	BT_LOGD("Creating array field object: ft-addr=%p", type);
 	assert(type);
@@ -1865,28 +2757,46 @@ struct bt_field *bt_field_array_create(struct bt_field_type *type)
 
 	array_type = container_of(type, struct bt_field_type_array, parent);
 	array_length = array_type->length;
-	array->elements = g_ptr_array_sized_new(array_length);
+	array->elements = field_alloc_ptr_array(arena, array_length);
 	if (!array->elements) {
+		BT_LOGE_STR("Failed to allocate array field's elements.");
+		field_free(&array->parent);
 		goto error;
 	}
 
-	g_ptr_array_set_free_func(array->elements,
-		(GDestroyNotify) bt_put);
-	g_ptr_array_set_size(array->elements, array_length);
+	array->element_count = array_length;
+
+	if (arena && array_elements_in_arena(array_type,
+			array_type->element_type->field_arena_size)) {
+		/*
+		 * The elements are in the arena: create them now
+		 * instead of in bt_field_array_get_field().
+		 */
+		for (i = 0; i < array_length; i++) {
+			array->elements[i] = field_create(
+				array_type->element_type, arena);
+			if (!array->elements[i]) {
+				BT_LOGE("Failed to create array field's element: "
+					"index=%u", i);
+				bt_field_array_destroy(&array->parent);
+				goto error;
+			}
+		}
+	}
+
 	BT_LOGD("Created array field object: addr=%p, ft-addr=%p",
 		&array->parent, type);
 	return &array->parent;
 error:
-	g_free(array);
 	return NULL;
 }
 
 static
 struct bt_field *bt_field_sequence_create(
-	struct bt_field_type *type)
+	struct bt_field_type *type, struct bt_field_arena *arena)
 {
-	struct bt_field_sequence *sequence = g_new0(
-		struct bt_field_sequence, 1);
+	struct bt_field_sequence *sequence = field_alloc(arena,
+		sizeof(*sequence));
 
 	BT_LOGD("Creating sequence field object: ft-addr=%p", type);
 
@@ -1901,10 +2811,10 @@ struct bt_field *bt_field_sequence_create(
 }
 
 static
-struct bt_field *bt_field_string_create(struct bt_field_type *type)
+struct bt_field *bt_field_string_create(struct bt_field_type *type,
+		struct bt_field_arena *arena)
 {
-	struct bt_field_string *string = g_new0(
-		struct bt_field_string, 1);
+	struct bt_field_string *string = field_alloc(arena, sizeof(*string));
 
 	BT_LOGD("Creating string field object: ft-addr=%p", type);
 
@@ -1946,7 +2856,7 @@ void bt_field_integer_destroy(struct bt_field *field)
 
 	BT_LOGD("Destroying integer field object: addr=%p", field);
 	integer = container_of(field, struct bt_field_integer, parent);
-	g_free(integer);
+	field_free(&integer->parent);
 }
 
 static
@@ -1963,7 +2873,7 @@ void bt_field_enumeration_destroy(struct bt_field *field)
 		parent);
 	BT_LOGD_STR("Putting payload field.");
 	bt_put(enumeration->payload);
-	g_free(enumeration);
+	field_free(&enumeration->parent);
 }
 
 static
@@ -1978,7 +2888,7 @@ void bt_field_floating_point_destroy(struct bt_field *field)
 	BT_LOGD("Destroying floating point number field object: addr=%p", field);
 	floating_point = container_of(field, struct bt_field_floating_point,
 		parent);
-	g_free(floating_point);
+	field_free(&floating_point->parent);
 }
 
 static
@@ -1992,8 +2902,8 @@ void bt_field_structure_destroy(struct bt_field *field)
 
 	BT_LOGD("Destroying structure field object: addr=%p", field);
 	structure = container_of(field, struct bt_field_structure, parent);
-	g_ptr_array_free(structure->fields, TRUE);
-	g_free(structure);
+	put_field_ptr_array(field, structure->fields, structure->field_count);
+	field_free(&structure->parent);
 }
 
 static
@@ -2011,7 +2921,7 @@ void bt_field_variant_destroy(struct bt_field *field)
 	bt_put(variant->tag);
 	BT_LOGD_STR("Putting payload field.");
 	bt_put(variant->payload);
-	g_free(variant);
+	field_free(&variant->parent);
 }
 
 static
@@ -2025,8 +2935,9 @@ void bt_field_array_destroy(struct bt_field *field)
 
 	BT_LOGD("Destroying array field object: addr=%p", field);
 	array = container_of(field, struct bt_field_array, parent);
-	g_ptr_array_free(array->elements, TRUE);
-	g_free(array);
+	borrowed_bytes_reset(&array->borrowed);
+	put_field_ptr_array(field, array->elements, array->element_count);
+	field_free(&array->parent);
 }
 
 static
@@ -2040,12 +2951,13 @@ void bt_field_sequence_destroy(struct bt_field *field)
 
 	BT_LOGD("Destroying sequence field object: addr=%p", field);
 	sequence = container_of(field, struct bt_field_sequence, parent);
+	borrowed_bytes_reset(&sequence->borrowed);
 	if (sequence->elements) {
 		g_ptr_array_free(sequence->elements, TRUE);
 	}
 	BT_LOGD_STR("Putting length field.");
 	bt_put(sequence->length);
-	g_free(sequence);
+	field_free(&sequence->parent);
 }
 
 static
@@ -2059,10 +2971,11 @@ void bt_field_string_destroy(struct bt_field *field)
 
 	BT_LOGD("Destroying string field object: addr=%p", field);
 	string = container_of(field, struct bt_field_string, parent);
+	borrowed_bytes_reset(&string->borrowed);
 	if (string->payload) {
 		g_string_free(string->payload, TRUE);
 	}
-	g_free(string);
+	field_free(&string->parent);
 }
 
 static
@@ -2111,8 +3024,8 @@ int bt_field_structure_validate(struct bt_field *field)
 	}
 
 	structure = container_of(field, struct bt_field_structure, parent);
-	for (i = 0; i < structure->fields->len; i++) {
-		struct bt_field *entry_field = structure->fields->pdata[i];
+	for (i = 0; i < structure->field_count; i++) {
+		struct bt_field *entry_field = structure->fields[i];
 		ret = bt_field_validate(entry_field);
 
 		if (ret) {
@@ -2173,8 +3086,13 @@ int bt_field_array_validate(struct bt_field *field)
 	}
 
 	array = container_of(field, struct bt_field_array, parent);
-	for (i = 0; i < array->elements->len; i++) {
-		struct bt_field *elem_field = array->elements->pdata[i];
+	if (array->borrowed.addr) {
+		/* All the element values are set */
+		goto end;
+	}
+
+	for (i = 0; i < array->element_count; i++) {
+		struct bt_field *elem_field = array->elements[i];
 
 		ret = bt_field_validate(elem_field);
 		if (ret) {
@@ -2202,6 +3120,11 @@ int bt_field_sequence_validate(struct bt_field *field)
 	}
 
 	sequence = container_of(field, struct bt_field_sequence, parent);
+	if (sequence->borrowed.addr) {
+		/* All the element values are set */
+		goto end;
+	}
+
 	for (i = 0; i < sequence->elements->len; i++) {
 		struct bt_field *elem_field = sequence->elements->pdata[i];
 
@@ -2270,8 +3193,8 @@ int bt_field_structure_reset(struct bt_field *field)
 	}
 
 	structure = container_of(field, struct bt_field_structure, parent);
-	for (i = 0; i < structure->fields->len; i++) {
-		struct bt_field *member = structure->fields->pdata[i];
+	for (i = 0; i < structure->field_count; i++) {
+		struct bt_field *member = structure->fields[i];
 
 		if (!member) {
 			/*
@@ -2326,8 +3249,9 @@ int bt_field_array_reset(struct bt_field *field)
 	}
 
 	array = container_of(field, struct bt_field_array, parent);
-	for (i = 0; i < array->elements->len; i++) {
-		struct bt_field *member = array->elements->pdata[i];
+	borrowed_bytes_reset(&array->borrowed);
+	for (i = 0; i < array->element_count; i++) {
+		struct bt_field *member = array->elements[i];
 
 		if (!member) {
 			/*
@@ -2362,6 +3286,7 @@ int bt_field_sequence_reset(struct bt_field *field)
 	}
 
 	sequence = container_of(field, struct bt_field_sequence, parent);
+	borrowed_bytes_reset(&sequence->borrowed);
 	if (sequence->elements) {
 		g_ptr_array_free(sequence->elements, TRUE);
 		sequence->elements = NULL;
@@ -2389,6 +3314,7 @@ int bt_field_string_reset(struct bt_field *field)
 	}
 
 	string = container_of(field, struct bt_field_string, parent);
+	borrowed_bytes_reset(&string->borrowed);
 	if (string->payload) {
 		g_string_truncate(string->payload, 0);
 	}
@@ -2515,9 +3441,8 @@ int bt_field_structure_serialize(struct bt_field *field,
 		goto end;
 	}
 
-	for (i = 0; i < structure->fields->len; i++) {
-		struct bt_field *member = g_ptr_array_index(
-			structure->fields, i);
+	for (i = 0; i < structure->field_count; i++) {
+		struct bt_field *member = structure->fields[i];
 		const char *field_name = NULL;
 
 		if (BT_LOG_ON_WARN) {
@@ -2581,10 +3506,14 @@ int bt_field_array_serialize(struct bt_field *field,
 	BT_LOGV("Serializing array field: addr=%p, pos-offset=%" PRId64 ", "
 		"native-bo=%s", field, pos->offset,
 		bt_byte_order_string(native_byte_order));
+	ret = array_materialize(array);
+	if (ret) {
+		goto end;
+	}
 
-	for (i = 0; i < array->elements->len; i++) {
+	for (i = 0; i < array->element_count; i++) {
 		struct bt_field *elem_field =
-			g_ptr_array_index(array->elements, i);
+			array->elements[i];
 
 		BT_LOGV("Serializing array field's element field: "
 			"pos-offset=%" PRId64 ", field-addr=%p, index=%" PRId64,
@@ -2615,6 +3544,10 @@ int bt_field_sequence_serialize(struct bt_field *field,
 	BT_LOGV("Serializing sequence field: addr=%p, pos-offset=%" PRId64 ", "
 		"native-bo=%s", field, pos->offset,
 		bt_byte_order_string(native_byte_order));
+	ret = sequence_materialize(sequence);
+	if (ret) {
+		goto end;
+	}
 
 	for (i = 0; i < sequence->elements->len; i++) {
 		struct bt_field *elem_field =
@@ -2648,6 +3581,8 @@ int bt_field_string_serialize(struct bt_field *field,
 	struct bt_field_type *character_type =
 		get_field_type(FIELD_TYPE_ALIAS_UINT8_T);
 	struct bt_field *character;
+	const char *str;
+	size_t len;
 
 	BT_LOGV("Serializing string field: addr=%p, pos-offset=%" PRId64 ", "
 		"native-bo=%s", field, pos->offset,
@@ -2656,8 +3591,16 @@ int bt_field_string_serialize(struct bt_field *field,
 	BT_LOGV_STR("Creating character field from string field's character field type.");
 	character = bt_field_create(character_type);
 
-	for (i = 0; i < string->payload->len + 1; i++) {
-		const uint64_t chr = (uint64_t) string->payload->str[i];
+	if (string->borrowed.addr) {
+		str = (const char *) string->borrowed.addr;
+		len = string->borrowed.len;
+	} else {
+		str = string->payload->str;
+		len = string->payload->len;
+	}
+
+	for (i = 0; i < len + 1; i++) {
+		const uint64_t chr = (uint64_t) str[i];
 
 		ret = bt_field_unsigned_integer_set_value(character, chr);
 		if (ret) {
@@ -2712,14 +3655,11 @@ int bt_field_enumeration_copy(struct bt_field *src,
 	enum_src = container_of(src, struct bt_field_enumeration, parent);
 	enum_dst = container_of(dst, struct bt_field_enumeration, parent);
 
-	if (enum_src->payload) {
-		BT_LOGD_STR("Copying enumeration field's payload field.");
-		enum_dst->payload = bt_field_copy(enum_src->payload);
-		if (!enum_dst->payload) {
-			BT_LOGE_STR("Cannot copy enumeration field's payload field.");
-			ret = -1;
-			goto end;
-		}
+	BT_LOGD_STR("Copying enumeration field's payload field.");
+	ret = copy_field_to_slot(enum_src->payload, &enum_dst->payload);
+	if (ret) {
+		BT_LOGE_STR("Cannot copy enumeration field's payload field.");
+		goto end;
 	}
 
 	BT_LOGD_STR("Copied enumeration field.");
@@ -2757,27 +3697,21 @@ int bt_field_structure_copy(struct bt_field *src,
 	struct_src = container_of(src, struct bt_field_structure, parent);
 	struct_dst = container_of(dst, struct bt_field_structure, parent);
 
-	g_ptr_array_set_size(struct_dst->fields, struct_src->fields->len);
+	assert(struct_dst->field_count == struct_src->field_count);
 
-	for (i = 0; i < struct_src->fields->len; i++) {
+	for (i = 0; i < struct_src->field_count; i++) {
 		struct bt_field *field =
-			g_ptr_array_index(struct_src->fields, i);
-		struct bt_field *field_copy = NULL;
+			struct_src->fields[i];
 
-		if (field) {
-			BT_LOGD("Copying structure field's field: src-field-addr=%p"
-				"index=%" PRId64, field, i);
-			field_copy = bt_field_copy(field);
-			if (!field_copy) {
-				BT_LOGE("Cannot copy structure field's field: "
-					"src-field-addr=%p, index=%" PRId64,
-					field, i);
-				ret = -1;
-				goto end;
-			}
+		BT_LOGD("Copying structure field's field: src-field-addr=%p"
+			"index=%" PRId64, field, i);
+		ret = copy_field_to_slot(field, &struct_dst->fields[i]);
+		if (ret) {
+			BT_LOGE("Cannot copy structure field's field: "
+				"src-field-addr=%p, index=%" PRId64,
+				field, i);
+			goto end;
 		}
-
-		BT_MOVE(g_ptr_array_index(struct_dst->fields, i), field_copy);
 	}
 
 	BT_LOGD_STR("Copied structure field.");
@@ -2836,26 +3770,41 @@ int bt_field_array_copy(struct bt_field *src,
 	array_src = container_of(src, struct bt_field_array, parent);
 	array_dst = container_of(dst, struct bt_field_array, parent);
 
-	g_ptr_array_set_size(array_dst->elements, array_src->elements->len);
-	for (i = 0; i < array_src->elements->len; i++) {
-		struct bt_field *field =
-			g_ptr_array_index(array_src->elements, i);
-		struct bt_field *field_copy = NULL;
+	assert(array_dst->element_count == array_src->element_count);
 
-		if (field) {
-			BT_LOGD("Copying array field's element field: field-addr=%p, "
-				"index=%" PRId64, field, i);
-			field_copy = bt_field_copy(field);
-			if (!field_copy) {
-				BT_LOGE("Cannot copy array field's element field: "
-					"src-field-addr=%p, index=%" PRId64,
-					field, i);
-				ret = -1;
-				goto end;
-			}
+	borrowed_bytes_reset(&array_dst->borrowed);
+
+	if (array_src->borrowed.addr) {
+		/*
+		 * The copy owns its value: it must not keep the
+		 * borrowed bytes' owner (for example, a memory mapped
+		 * window of a data stream file) alive.
+		 */
+		ret = set_byte_elements(dst, array_src->borrowed.addr,
+			array_src->borrowed.len, array_dst->elements,
+			container_of(src->type, struct bt_field_type_array,
+				parent)->element_type);
+		if (ret) {
+			BT_LOGE("Cannot create array field copy's element fields: "
+				"src-field-addr=%p", src);
 		}
 
-		g_ptr_array_index(array_dst->elements, i) = field_copy;
+		goto end;
+	}
+
+	for (i = 0; i < array_src->element_count; i++) {
+		struct bt_field *field =
+			array_src->elements[i];
+
+		BT_LOGD("Copying array field's element field: field-addr=%p, "
+			"index=%" PRId64, field, i);
+		ret = copy_field_to_slot(field, &array_dst->elements[i]);
+		if (ret) {
+			BT_LOGE("Cannot copy array field's element field: "
+				"src-field-addr=%p, index=%" PRId64,
+				field, i);
+			goto end;
+		}
 	}
 
 	BT_LOGD_STR("Copied array field.");
@@ -2907,6 +3856,22 @@ int bt_field_sequence_copy(struct bt_field *src,
 
 	assert(sequence_dst->elements->len == sequence_src->elements->len);
 
+	if (sequence_src->borrowed.addr) {
+		/* The copy owns its value: see bt_field_array_copy() */
+		ret = set_byte_elements(dst, sequence_src->borrowed.addr,
+			sequence_src->borrowed.len,
+			(struct bt_field **) sequence_dst->elements->pdata,
+			container_of(src->type,
+				struct bt_field_type_sequence,
+				parent)->element_type);
+		if (ret) {
+			BT_LOGE("Cannot create sequence field copy's element fields: "
+				"src-field-addr=%p", src);
+		}
+
+		goto end;
+	}
+
 	for (i = 0; i < sequence_src->elements->len; i++) {
 		struct bt_field *field =
 			g_ptr_array_index(sequence_src->elements, i);
@@ -2946,7 +3911,19 @@ int bt_field_string_copy(struct bt_field *src,
 	string_src = container_of(src, struct bt_field_string, parent);
 	string_dst = container_of(dst, struct bt_field_string, parent);
 
-	if (string_src->payload) {
+	borrowed_bytes_reset(&string_dst->borrowed);
+
+	if (string_src->borrowed.addr) {
+		/* The copy owns its value: see bt_field_array_copy() */
+		ret = string_set_payload_len(string_dst,
+			(const char *) string_src->borrowed.addr,
+			string_src->borrowed.len);
+		goto end;
+	}
+
+	if (string_src->payload && string_dst->payload) {
+		g_string_assign(string_dst->payload, string_src->payload->str);
+	} else if (string_src->payload) {
 		string_dst->payload = g_string_new(string_src->payload->str);
 		if (!string_dst->payload) {
 			BT_LOGE_STR("Failed to allocate a GString.");
@@ -3034,9 +4011,9 @@ void bt_field_structure_freeze(struct bt_field *field)
 
 	BT_LOGD("Freezing structure field object: addr=%p", field);
 
-	for (i = 0; i < structure_field->fields->len; i++) {
+	for (i = 0; i < structure_field->field_count; i++) {
 		struct bt_field *field =
-			g_ptr_array_index(structure_field->fields, i);
+			structure_field->fields[i];
 
 		BT_LOGD("Freezing structure field's field: field-addr=%p, index=%" PRId64,
 			field, i);
@@ -3069,9 +4046,9 @@ void bt_field_array_freeze(struct bt_field *field)
 
 	BT_LOGD("Freezing array field object: addr=%p", field);
 
-	for (i = 0; i < array_field->elements->len; i++) {
+	for (i = 0; i < array_field->element_count; i++) {
 		struct bt_field *elem_field =
-			g_ptr_array_index(array_field->elements, i);
+			array_field->elements[i];
 
 		BT_LOGD("Freezing array field object's element field: "
 			"element-field-addr=%p, index=%" PRId64,
@@ -3168,9 +4145,9 @@ bt_bool bt_field_structure_is_set(struct bt_field *field)
 	}
 
 	structure = container_of(field, struct bt_field_structure, parent);
-	for (i = 0; i < structure->fields->len; i++) {
+	for (i = 0; i < structure->field_count; i++) {
 		is_set = bt_field_is_set(
-			structure->fields->pdata[i]);
+			structure->fields[i]);
 		if (!is_set) {
 			goto end;
 		}
@@ -3207,8 +4184,13 @@ bt_bool bt_field_array_is_set(struct bt_field *field)
 	}
 
 	array = container_of(field, struct bt_field_array, parent);
-	for (i = 0; i < array->elements->len; i++) {
-		is_set = bt_field_is_set(array->elements->pdata[i]);
+	if (array->borrowed.addr) {
+		is_set = BT_TRUE;
+		goto end;
+	}
+
+	for (i = 0; i < array->element_count; i++) {
+		is_set = bt_field_is_set(array->elements[i]);
 		if (!is_set) {
 			goto end;
 		}
@@ -3233,6 +4215,11 @@ bt_bool bt_field_sequence_is_set(struct bt_field *field)
 		goto end;
 	}
 
+	if (sequence->borrowed.addr) {
+		is_set = BT_TRUE;
+		goto end;
+	}
+
 	for (i = 0; i < sequence->elements->len; i++) {
 		is_set = bt_field_is_set(sequence->elements->pdata[i]);
 		if (!is_set) {
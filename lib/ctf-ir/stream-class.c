@@ -41,6 +41,7 @@
 #include <babeltrace/ctf-ir/stream-class-internal.h>
 #include <babeltrace/ctf-ir/validation-internal.h>
 #include <babeltrace/ctf-ir/visitor-internal.h>
+#include <babeltrace/graph/notification-event-internal.h>
 #include <babeltrace/ctf-writer/functor-internal.h>
 #include <babeltrace/ctf-ir/utils.h>
 #include <babeltrace/ref.h>
@@ -91,6 +92,13 @@ error:
 	return stream_class;
 }
 
+static
+void free_event_notif(struct bt_notification *notif,
+		struct bt_stream_class *stream_class)
+{
+	bt_notification_event_destroy(notif);
+}
+
 struct bt_stream_class *bt_stream_class_create_empty(const char *name)
 {
 	struct bt_stream_class *stream_class = NULL;
@@ -119,6 +127,14 @@ struct bt_stream_class *bt_stream_class_create_empty(const char *name)
 	}
 
 	bt_object_init(stream_class, bt_stream_class_destroy);
+	if (bt_object_pool_initialize(&stream_class->event_notif_pool,
+			(bt_object_pool_new_object_func) bt_notification_event_new,
+			(bt_object_pool_destroy_object_func) free_event_notif,
+			stream_class)) {
+		BT_LOGE_STR("Failed to initialize event notification pool.");
+		goto error;
+	}
+
 	BT_LOGD("Created empty stream class object: addr=%p, name=\"%s\"",
 		stream_class, name);
 	return stream_class;
@@ -1100,6 +1116,7 @@ void bt_stream_class_destroy(struct bt_object *obj)
 	bt_put(stream_class->packet_context_type);
 	BT_LOGD_STR("Putting event context field type.");
 	bt_put(stream_class->event_context_type);
+	bt_object_pool_finalize(&stream_class->event_notif_pool);
 	g_free(stream_class);
 }
 
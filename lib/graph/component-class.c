@@ -606,6 +606,113 @@ end:
 	return ret;
 }
 
+/*
+ * Validates the parameters of a setter of an optional notification
+ * iterator method of a source or filter component class. Returns the
+ * iterator methods of `component_class` to set, or NULL if a
+ * parameter is invalid.
+ */
+static
+struct bt_component_class_notification_iterator_methods *
+get_iterator_methods_to_set(struct bt_component_class *component_class,
+		enum bt_component_class_type type, void *method)
+{
+	struct bt_component_class_notification_iterator_methods *methods =
+		NULL;
+
+	if (!component_class) {
+		BT_LOGW_STR("Invalid parameter: component class is NULL.");
+		goto end;
+	}
+
+	if (!method) {
+		BT_LOGW_STR("Invalid parameter: method is NULL.");
+		goto end;
+	}
+
+	if (component_class->type != type) {
+		BT_LOGW("Invalid parameter: unexpected component class type: "
+			"addr=%p, name=\"%s\", type=%s, expected-type=%s",
+			component_class,
+			bt_component_class_get_name(component_class),
+			bt_component_class_type_string(component_class->type),
+			bt_component_class_type_string(type));
+		goto end;
+	}
+
+	if (component_class->frozen) {
+		BT_LOGW("Invalid parameter: component class is frozen: "
+			"addr=%p, name=\"%s\", type=%s",
+			component_class,
+			bt_component_class_get_name(component_class),
+			bt_component_class_type_string(component_class->type));
+		goto end;
+	}
+
+	if (type == BT_COMPONENT_CLASS_TYPE_SOURCE) {
+		methods = &container_of(component_class,
+			struct bt_component_class_source,
+			parent)->methods.iterator;
+	} else {
+		methods = &container_of(component_class,
+			struct bt_component_class_filter,
+			parent)->methods.iterator;
+	}
+
+end:
+	return methods;
+}
+
+int bt_component_class_source_set_notification_iterator_seek_time_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_seek_time_method method)
+{
+	struct bt_component_class_notification_iterator_methods *methods;
+	int ret = 0;
+
+	methods = get_iterator_methods_to_set(component_class,
+		BT_COMPONENT_CLASS_TYPE_SOURCE, method);
+	if (!methods) {
+		ret = -1;
+		goto end;
+	}
+
+	methods->seek_time = method;
+	BT_LOGV("Set source component class's notification iterator seek time method: "
+		"addr=%p, name=\"%s\", method-addr=%p",
+		component_class,
+		bt_component_class_get_name(component_class),
+		method);
+
+end:
+	return ret;
+}
+
+int bt_component_class_source_set_notification_iterator_next_batch_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_next_batch_method method)
+{
+	struct bt_component_class_notification_iterator_methods *methods;
+	int ret = 0;
+
+	methods = get_iterator_methods_to_set(component_class,
+		BT_COMPONENT_CLASS_TYPE_SOURCE, method);
+	if (!methods) {
+		ret = -1;
+		goto end;
+	}
+
+	methods->next_batch = method;
+	BT_LOGV("Set source component class's notification iterator \"next batch\" method: "
+		"addr=%p, name=\"%s\", method-addr=%p",
+		component_class,
+		bt_component_class_get_name(component_class),
+		method);
+
+end:
+	return ret;
+}
+
 int bt_component_class_filter_set_notification_iterator_init_method(
 		struct bt_component_class *component_class,
 		bt_component_class_notification_iterator_init_method method)
@@ -711,6 +818,56 @@ end:
 	return ret;
 }
 
+int bt_component_class_filter_set_notification_iterator_seek_time_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_seek_time_method method)
+{
+	struct bt_component_class_notification_iterator_methods *methods;
+	int ret = 0;
+
+	methods = get_iterator_methods_to_set(component_class,
+		BT_COMPONENT_CLASS_TYPE_FILTER, method);
+	if (!methods) {
+		ret = -1;
+		goto end;
+	}
+
+	methods->seek_time = method;
+	BT_LOGV("Set filter component class's notification iterator seek time method: "
+		"addr=%p, name=\"%s\", method-addr=%p",
+		component_class,
+		bt_component_class_get_name(component_class),
+		method);
+
+end:
+	return ret;
+}
+
+int bt_component_class_filter_set_notification_iterator_next_batch_method(
+		struct bt_component_class *component_class,
+		bt_component_class_notification_iterator_next_batch_method method)
+{
+	struct bt_component_class_notification_iterator_methods *methods;
+	int ret = 0;
+
+	methods = get_iterator_methods_to_set(component_class,
+		BT_COMPONENT_CLASS_TYPE_FILTER, method);
+	if (!methods) {
+		ret = -1;
+		goto end;
+	}
+
+	methods->next_batch = method;
+	BT_LOGV("Set filter component class's notification iterator \"next batch\" method: "
+		"addr=%p, name=\"%s\", method-addr=%p",
+		component_class,
+		bt_component_class_get_name(component_class),
+		method);
+
+end:
+	return ret;
+}
+
 int bt_component_class_set_description(
 		struct bt_component_class *component_class,
 		const char *description)
@@ -789,6 +946,40 @@ end:
 	return ret;
 }
 
+int bt_component_class_set_trusted(
+		struct bt_component_class *component_class,
+		bt_bool trusted)
+{
+	int ret = 0;
+
+	if (!component_class) {
+		BT_LOGW_STR("Invalid parameter: component class is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	if (component_class->frozen) {
+		BT_LOGW("Invalid parameter: component class is frozen: "
+			"addr=%p, name=\"%s\", type=%s",
+			component_class,
+			bt_component_class_get_name(component_class),
+			bt_component_class_type_string(component_class->type));
+		ret = -1;
+		goto end;
+	}
+
+	component_class->trusted = trusted;
+	BT_LOGV("Set component class's trust: "
+		"addr=%p, name=\"%s\", type=%s, trusted=%d",
+		component_class,
+		bt_component_class_get_name(component_class),
+		bt_component_class_type_string(component_class->type),
+		trusted);
+
+end:
+	return ret;
+}
+
 const char *bt_component_class_get_name(
 		struct bt_component_class *component_class)
 {
@@ -818,6 +1009,12 @@ const char *bt_component_class_get_help(
 		component_class->help->str : NULL;
 }
 
+bt_bool bt_component_class_is_trusted(
+		struct bt_component_class *component_class)
+{
+	return component_class ? component_class->trusted : BT_FALSE;
+}
+
 BT_HIDDEN
 void bt_component_class_add_destroy_listener(struct bt_component_class *class,
 		bt_component_class_destroy_listener_func func, void *data)
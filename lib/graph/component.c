@@ -268,6 +268,7 @@ enum bt_component_status bt_component_create(
 	bt_object_init(component, bt_component_destroy);
 	component->class = bt_get(component_class);
 	component->destroy = component_destroy_funcs[type];
+	component->ready_fd = -1;
 	component->name = g_string_new(name);
 	if (!component->name) {
 		BT_LOGE_STR("Failed to allocate one GString.");
@@ -363,6 +364,51 @@ end:
 	return ret;
 }
 
+enum bt_component_status bt_private_component_set_ready_fd(
+		struct bt_private_component *private_component, int fd)
+{
+	struct bt_component *component =
+		bt_component_borrow_from_private(private_component);
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+
+	if (!component) {
+		BT_LOGW_STR("Invalid parameter: component is NULL.");
+		ret = BT_COMPONENT_STATUS_INVALID;
+		goto end;
+	}
+
+	if (fd < -1) {
+		BT_LOGW("Invalid parameter: invalid file descriptor: "
+			"comp-addr=%p, comp-name=\"%s\", fd=%d",
+			component, bt_component_get_name(component), fd);
+		ret = BT_COMPONENT_STATUS_INVALID;
+		goto end;
+	}
+
+	__atomic_store_n(&component->ready_fd, fd, __ATOMIC_RELAXED);
+	BT_LOGV("Set component's readiness file descriptor: "
+		"comp-addr=%p, comp-name=\"%s\", fd=%d",
+		component, bt_component_get_name(component), fd);
+
+end:
+	return ret;
+}
+
+int bt_component_get_ready_fd(struct bt_component *component)
+{
+	int fd = -1;
+
+	if (!component) {
+		BT_LOGW_STR("Invalid parameter: component is NULL.");
+		goto end;
+	}
+
+	fd = bt_component_get_ready_fd_no_check(component);
+
+end:
+	return fd;
+}
+
 BT_HIDDEN
 void bt_component_set_graph(struct bt_component *component,
 		struct bt_graph *graph)
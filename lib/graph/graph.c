@@ -40,6 +40,7 @@
 #include <babeltrace/values.h>
 #include <babeltrace/values-internal.h>
 #include <unistd.h>
+#include <errno.h>
 #include <glib.h>
 
 struct bt_graph_listener {
@@ -901,6 +902,49 @@ void bt_graph_notify_ports_disconnected(struct bt_graph *graph,
 	}
 }
 
+enum bt_graph_status bt_graph_set_threaded(struct bt_graph *graph,
+		bt_bool threaded)
+{
+	enum bt_graph_status ret = BT_GRAPH_STATUS_OK;
+
+	if (!graph) {
+		BT_LOGW_STR("Invalid parameter: graph is NULL.");
+		ret = BT_GRAPH_STATUS_INVALID;
+		goto end;
+	}
+
+	if (graph->connections->len > 0) {
+		BT_LOGW("Invalid parameter: graph already has connections: "
+			"addr=%p, conn-count=%u", graph,
+			graph->connections->len);
+		ret = BT_GRAPH_STATUS_INVALID;
+		goto end;
+	}
+
+	if (threaded) {
+		/*
+		 * Notifications and the objects they refer to cross
+		 * threads from now on.
+		 */
+		bt_ref_enable_atomic_mode();
+		if (!bt_ref_atomic_mode) {
+			BT_LOGE("Cannot make graph threaded: "
+				"cannot enable atomic reference counting: "
+				"addr=%p", graph);
+			ret = BT_GRAPH_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+	graph->threaded = threaded ? BT_TRUE : BT_FALSE;
+
+	BT_LOGV("Set graph's threaded mode: addr=%p, threaded=%d",
+		graph, graph->threaded);
+
+end:
+	return ret;
+}
+
 enum bt_graph_status bt_graph_cancel(struct bt_graph *graph)
 {
 	enum bt_graph_status ret = BT_GRAPH_STATUS_OK;
@@ -911,7 +955,8 @@ enum bt_graph_status bt_graph_cancel(struct bt_graph *graph)
 		goto end;
 	}
 
-	graph->canceled = BT_TRUE;
+	/* Worker threads read this flag concurrently */
+	__atomic_store_n(&graph->canceled, BT_TRUE, __ATOMIC_RELAXED);
 	BT_LOGV("Canceled graph: addr=%p", graph);
 
 end:
@@ -933,6 +978,86 @@ end:
 	return canceled;
 }
 
+enum bt_graph_status bt_graph_wait_ready(struct bt_graph *graph,
+		int64_t timeout_us)
+{
+	enum bt_graph_status status = BT_GRAPH_STATUS_AGAIN;
+	GPollFD *poll_fds = NULL;
+	guint poll_fd_count = 0;
+	gint timeout_ms;
+	guint i;
+	gint ret;
+
+	if (!graph) {
+		BT_LOGW_STR("Invalid parameter: graph is NULL.");
+		status = BT_GRAPH_STATUS_INVALID;
+		goto end;
+	}
+
+	if (bt_graph_is_canceled(graph)) {
+		BT_LOGV("Not waiting for a ready component: graph is canceled: "
+			"addr=%p", graph);
+		status = BT_GRAPH_STATUS_CANCELED;
+		goto end;
+	}
+
+	if (graph->components->len > 0) {
+		poll_fds = g_new0(GPollFD, graph->components->len);
+		if (!poll_fds) {
+			BT_LOGE_STR("Failed to allocate an array of GPollFD.");
+			status = BT_GRAPH_STATUS_NOMEM;
+			goto end;
+		}
+	}
+
+	for (i = 0; i < graph->components->len; i++) {
+		int fd = bt_component_get_ready_fd_no_check(
+			g_ptr_array_index(graph->components, i));
+
+		if (fd >= 0) {
+			poll_fds[poll_fd_count].fd = fd;
+			poll_fds[poll_fd_count].events = G_IO_IN;
+			poll_fd_count++;
+		}
+	}
+
+	if (timeout_us < 0) {
+		timeout_ms = -1;
+	} else {
+		timeout_ms = (gint) MIN((timeout_us + 999) / 1000,
+			(int64_t) G_MAXINT);
+	}
+
+	BT_LOGV("Waiting for a ready component: graph-addr=%p, "
+		"fd-count=%u, timeout-ms=%d", graph, poll_fd_count,
+		(int) timeout_ms);
+	ret = g_poll(poll_fds, poll_fd_count, timeout_ms);
+	if (ret < 0) {
+		if (errno != EINTR) {
+			BT_LOGE_ERRNO("Cannot wait for file descriptors",
+				": graph-addr=%p", graph);
+			status = BT_GRAPH_STATUS_ERROR;
+			goto end;
+		}
+
+		BT_LOGV("Wait for a ready component was interrupted: "
+			"graph-addr=%p", graph);
+	} else if (ret > 0) {
+		status = BT_GRAPH_STATUS_OK;
+	}
+
+	if (bt_graph_is_canceled(graph)) {
+		status = BT_GRAPH_STATUS_CANCELED;
+	}
+
+	BT_LOGV("Waited for a ready component: graph-addr=%p, status=%s",
+		graph, bt_graph_status_string(status));
+
+end:
+	g_free(poll_fds);
+	return status;
+}
+
 BT_HIDDEN
 void bt_graph_remove_connection(struct bt_graph *graph,
 		struct bt_connection *connection)
@@ -30,6 +30,7 @@
 
 #include <babeltrace/compiler-internal.h>
 #include <babeltrace/ref.h>
+#include <babeltrace/ref-internal.h>
 #include <babeltrace/ctf-ir/fields.h>
 #include <babeltrace/ctf-ir/field-types.h>
 #include <babeltrace/ctf-ir/field-types-internal.h>
@@ -56,10 +57,48 @@
 #include <babeltrace/graph/notification-discarded-elements-internal.h>
 #include <babeltrace/graph/port.h>
 #include <babeltrace/graph/graph-internal.h>
+#include <babeltrace/graph/notification-ring-internal.h>
 #include <babeltrace/types.h>
 #include <stdint.h>
 #include <inttypes.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <glib.h>
+
+/*
+ * Maximum number of notifications to get from the user's "next batch"
+ * method at once.
+ */
+#define NOTIF_BATCH_CAPACITY	64
+
+/*
+ * Maximum number of notifications between a worker thread and the
+ * consumer of its notification iterator (threaded graph).
+ */
+#define NOTIF_RING_CAPACITY	256
+
+/*
+ * Initial and maximum time a worker thread waits before calling the
+ * user's "next" method again when it returns
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN (µs).
+ */
+#define AGAIN_WAIT_MIN_US	100
+#define AGAIN_WAIT_MAX_US	10000
+
+/*
+ * In a threaded graph, the "next" method of the upstream component of
+ * a private connection notification iterator is called on a dedicated
+ * worker thread. The worker thread pushes the user notifications to a
+ * notification ring, and the consumer of the notification iterator
+ * pops them from its own thread, then does exactly what it would do
+ * with notifications returned directly by the user's method (automatic
+ * notifications, stream states, and the rest).
+ */
+struct bt_notification_iterator_worker {
+	pthread_t thread;
+	struct bt_notification_ring *ring; /* owned by this */
+	struct bt_notification_iterator_private_connection *iterator; /* weak */
+};
 
 struct discarded_elements_state {
 	struct bt_clock_value *cur_begin;
@@ -360,6 +399,32 @@ end:
 	return stream_state;
 }
 
+/*
+ * Stops the worker thread of a notification iterator, if any, waits
+ * for it to exit, and destroys its notification ring with the
+ * notifications it still contains.
+ */
+static
+void destroy_worker(
+		struct bt_notification_iterator_private_connection *iterator)
+{
+	struct bt_notification_iterator_worker *worker = iterator->worker;
+
+	if (!worker) {
+		return;
+	}
+
+	BT_LOGD("Stopping notification iterator's worker thread: "
+		"iter-addr=%p, worker-addr=%p", iterator, worker);
+	bt_notification_ring_stop(worker->ring);
+	pthread_join(worker->thread, NULL);
+	bt_notification_ring_destroy(worker->ring);
+	g_free(worker);
+	iterator->worker = NULL;
+	BT_LOGD("Stopped notification iterator's worker thread: "
+		"iter-addr=%p", iterator);
+}
+
 static
 void destroy_base_notification_iterator(struct bt_object *obj)
 {
@@ -393,6 +458,7 @@ void bt_private_connection_notification_iterator_destroy(struct bt_object *obj)
 	BT_LOGD("Destroying private connection notification iterator object: addr=%p",
 		iterator);
 	bt_private_connection_notification_iterator_finalize(iterator);
+	destroy_worker(iterator);
 
 	if (iterator->queue) {
 		struct bt_notification *notif;
@@ -474,6 +540,21 @@ void bt_private_connection_notification_iterator_finalize(
 
 	BT_LOGD("Finalizing notification iterator: addr=%p", iterator);
 
+	if (iterator->worker) {
+		if (pthread_equal(pthread_self(), iterator->worker->thread)) {
+			/*
+			 * The user's "next" method, on the worker
+			 * thread, finalizes its own notification
+			 * iterator: the worker thread cannot join
+			 * itself. Ask it to stop: the consumer
+			 * destroys it when it gets the final status.
+			 */
+			bt_notification_ring_stop(iterator->worker->ring);
+		} else {
+			destroy_worker(iterator);
+		}
+	}
+
 	if (iterator->state == BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ENDED) {
 		BT_LOGD("Updating notification iterator's state: "
 			"new-state=BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_FINALIZED_AND_ENDED");
@@ -677,14 +758,23 @@ enum bt_connection_status bt_private_connection_notification_iterator_create(
 	iterator->upstream_component = upstream_comp;
 	iterator->upstream_port = upstream_port;
 	iterator->connection = connection;
+	iterator->threaded = connection &&
+		bt_connection_borrow_graph(connection)->threaded;
+	iterator->track_streams = (iterator->subscription_mask &
+		~(BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_NOTIF_TYPE_EVENT |
+		BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_NOTIF_TYPE_INACTIVITY)) != 0;
+	iterator->validate_notifs =
+		!bt_component_class_is_trusted(upstream_comp->class);
 	iterator->state = BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_NON_INITIALIZED;
 	BT_LOGD("Created notification iterator: "
 		"upstream-comp-addr=%p, upstream-comp-name=\"%s\", "
 		"upstream-port-addr=%p, upstream-port-name=\"%s\", "
-		"conn-addr=%p, iter-addr=%p",
+		"conn-addr=%p, iter-addr=%p, track-streams=%d, "
+		"validate-notifs=%d",
 		upstream_comp, bt_component_get_name(upstream_comp),
 		upstream_port, bt_port_get_name(upstream_port),
-		connection, iterator);
+		connection, iterator, iterator->track_streams,
+		iterator->validate_notifs);
 
 	/* Move reference to user */
 	*user_iterator = iterator;
@@ -931,7 +1021,8 @@ void add_action_push_notif(
 		return;
 	}
 
-	action.payload.push_notif.notif = bt_get(notif);
+	bt_object_get_no_null_check(notif);
+	action.payload.push_notif.notif = notif;
 	add_action(iterator, &action);
 	BT_LOGV("Added \"push notification\" action: notif-addr=%p", notif);
 }
@@ -1425,6 +1516,14 @@ int handle_discarded_events(
 		goto update_state;
 	}
 
+	if (stream_state->discarded_events_state.cur_count == -1ULL) {
+		/*
+		 * Unknown previous count (after a seek operation):
+		 * restart counting from this packet.
+		 */
+		goto update_state;
+	}
+
 	if (next_count < stream_state->discarded_events_state.cur_count) {
 		BT_LOGW("Current value of packet's context field's `events_discarded` field is lesser than the previous value for the same stream: "
 			"not updating the stream state's current value: "
@@ -1880,17 +1979,61 @@ int enqueue_notification_and_automatic(
 	BT_LOGV("Enqueuing user notification and automatic notifications: "
 		"iter-addr=%p, notif-addr=%p", iterator, notif);
 
-	// TODO: Skip most of this if the iterator is only subscribed
-	//       to event/inactivity notifications.
+	if (!iterator->track_streams) {
+		/*
+		 * The user of this iterator is only subscribed to
+		 * event and/or inactivity notifications: it cannot
+		 * observe the automatic notifications nor the stream
+		 * states, so there's nothing to validate, track, or
+		 * generate.
+		 */
+		if (is_subscribed_to_notification_type(iterator,
+				notif->type)) {
+			bt_object_get_no_null_check(notif);
+			g_queue_push_head(iterator->queue, notif);
+			bt_notification_freeze(notif);
+		}
+
+		goto end;
+	}
 
 	/* Get the stream and packet referred by the notification */
 	switch (notif->type) {
 	case BT_NOTIFICATION_TYPE_EVENT:
+	{
+		struct stream_state *stream_state;
+
 		notif_event = bt_notification_event_borrow_event(notif);
 		assert(notif_event);
 		notif_packet = bt_event_borrow_packet(notif_event);
 		assert(notif_packet);
+		notif_stream = bt_packet_borrow_stream(notif_packet);
+		assert(notif_stream);
+
+		/*
+		 * Fast path: most of the notifications are events which
+		 * belong to the current packet of an active stream. Such
+		 * an event is valid and cannot cause the creation of
+		 * automatic notifications, so there's no need to
+		 * validate it and to go through the action list.
+		 */
+		stream_state = g_hash_table_lookup(iterator->stream_states,
+			notif_stream);
+		if (stream_state && !stream_state->is_ended &&
+				stream_state->cur_packet == notif_packet &&
+				iterator->actions->len == 0) {
+			if (is_subscribed_to_notification_type(iterator,
+					notif->type)) {
+				bt_object_get_no_null_check(notif);
+				g_queue_push_head(iterator->queue, notif);
+				bt_notification_freeze(notif);
+			}
+
+			goto end;
+		}
+
 		break;
+	}
 	case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
 		notif_stream =
 			bt_notification_stream_begin_borrow_stream(notif);
@@ -1938,8 +2081,9 @@ int enqueue_notification_and_automatic(
 		goto end;
 	}
 
-	if (!validate_notification(iterator, notif, notif_stream,
-			notif_packet)) {
+	if (iterator->validate_notifs &&
+			!validate_notification(iterator, notif, notif_stream,
+				notif_packet)) {
 		BT_LOGW_STR("Invalid notification.");
 		goto error;
 	}
@@ -2044,21 +2188,454 @@ end:
 	return ret;
 }
 
+/*
+ * Handles a notification returned by the user's "next" or "next batch"
+ * method: enqueues it with the appropriate automatic notifications.
+ * Steals the caller's reference.
+ */
 static
-enum bt_notification_iterator_status ensure_queue_has_notifications(
-		struct bt_notification_iterator_private_connection *iterator)
+int handle_user_notification(
+		struct bt_notification_iterator_private_connection *iterator,
+		struct bt_notification *notif)
+{
+	int ret = 0;
+
+	if (!notif) {
+		BT_LOGW_STR("User method returned BT_NOTIFICATION_ITERATOR_STATUS_OK, but notification is NULL.");
+		ret = -1;
+		goto end;
+	}
+
+	/*
+	 * Ignore some notifications which are always automatically
+	 * generated by the notification iterator to make sure they have
+	 * valid values.
+	 */
+	switch (notif->type) {
+	case BT_NOTIFICATION_TYPE_DISCARDED_PACKETS:
+	case BT_NOTIFICATION_TYPE_DISCARDED_EVENTS:
+		BT_LOGV("Ignoring discarded elements notification returned by notification iterator's \"next\" method: "
+			"notif-type=%s", bt_notification_type_string(notif->type));
+		goto end;
+	default:
+		break;
+	}
+
+	/*
+	 * We know the notification is valid. Before we push it to the
+	 * head of the queue, push the appropriate automatic
+	 * notifications if any.
+	 */
+	ret = enqueue_notification_and_automatic(iterator, notif);
+	if (ret) {
+		BT_LOGW("Cannot enqueue notification and automatic notifications.");
+	}
+
+end:
+	bt_object_put_ref(notif);
+	return ret;
+}
+
+/*
+ * Picks the "next" and "next batch" (if any) methods of the upstream
+ * component class of `iterator`.
+ */
+static
+void get_user_next_methods(
+		struct bt_notification_iterator_private_connection *iterator,
+		bt_component_class_notification_iterator_next_method *next_method,
+		bt_component_class_notification_iterator_next_batch_method *next_batch_method)
+{
+	assert(iterator->upstream_component);
+	assert(iterator->upstream_component->class);
+
+	switch (iterator->upstream_component->class->type) {
+	case BT_COMPONENT_CLASS_TYPE_SOURCE:
+	{
+		struct bt_component_class_source *source_class =
+			container_of(iterator->upstream_component->class,
+				struct bt_component_class_source, parent);
+
+		*next_method = source_class->methods.iterator.next;
+		*next_batch_method = source_class->methods.iterator.next_batch;
+		break;
+	}
+	case BT_COMPONENT_CLASS_TYPE_FILTER:
+	{
+		struct bt_component_class_filter *filter_class =
+			container_of(iterator->upstream_component->class,
+				struct bt_component_class_filter, parent);
+
+		*next_method = filter_class->methods.iterator.next;
+		*next_batch_method = filter_class->methods.iterator.next_batch;
+		break;
+	}
+	default:
+		abort();
+	}
+
+	assert(*next_method);
+}
+
+/*
+ * Calls the user's "next batch" method if available (preferred), or its
+ * "next" method otherwise.
+ *
+ * On success, `batch` contains `*count` notifications owned by the
+ * caller. Otherwise `*count` is 0.
+ */
+static
+enum bt_notification_iterator_status call_user_next_method(
+		struct bt_notification_iterator_private_connection *iterator,
+		bt_component_class_notification_iterator_next_method next_method,
+		bt_component_class_notification_iterator_next_batch_method next_batch_method,
+		struct bt_notification **batch, uint64_t *count)
 {
 	struct bt_private_connection_private_notification_iterator *priv_iterator =
 		bt_private_connection_private_notification_iterator_from_notification_iterator(iterator);
-	bt_component_class_notification_iterator_next_method next_method = NULL;
-	struct bt_notification_iterator_next_method_return next_return = {
-		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
-		.notification = NULL,
-	};
+	enum bt_notification_iterator_status status;
+
+	*count = 0;
+
+	if (next_batch_method) {
+		BT_LOGD_STR("Calling user's \"next batch\" method.");
+		status = next_batch_method(priv_iterator, batch,
+			NOTIF_BATCH_CAPACITY, count);
+	} else {
+		struct bt_notification_iterator_next_method_return next_return;
+
+		BT_LOGD_STR("Calling user's \"next\" method.");
+		next_return = next_method(priv_iterator);
+		status = next_return.status;
+		batch[0] = next_return.notification;
+		*count = 1;
+	}
+
+	BT_LOGD("User method returned: status=%s",
+		bt_notification_iterator_status_string(status));
+	if (status < 0) {
+		BT_LOGW_STR("User method failed.");
+	}
+
+	if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		/*
+		 * Only the BT_NOTIFICATION_ITERATOR_STATUS_OK status
+		 * transfers notifications: otherwise `batch` could
+		 * contain garbage.
+		 */
+		*count = 0;
+	} else if (*count == 0 || *count > NOTIF_BATCH_CAPACITY) {
+		BT_LOGW("User method returned BT_NOTIFICATION_ITERATOR_STATUS_OK, but notification count is invalid: "
+			"count=%" PRIu64, *count);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		*count = 0;
+	}
+
+	return status;
+}
+
+static inline
+bool is_finalized(struct bt_notification_iterator_private_connection *iterator)
+{
+	return iterator->state == BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_FINALIZED ||
+		iterator->state == BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_FINALIZED_AND_ENDED;
+}
+
+static
+void put_notifications(struct bt_notification **notifs, uint64_t count)
+{
+	uint64_t i;
+
+	for (i = 0; i < count; i++) {
+		bt_object_put_no_null_check(notifs[i]);
+	}
+}
+
+/*
+ * Handles the end of the user's iteration: enqueues the automatic
+ * notifications and marks the iterator as ended. Returns
+ * BT_NOTIFICATION_ITERATOR_STATUS_END if the queue is still empty
+ * after this.
+ */
+static
+enum bt_notification_iterator_status handle_user_end(
+		struct bt_notification_iterator_private_connection *iterator)
+{
 	enum bt_notification_iterator_status status =
 		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	if (handle_end(iterator)) {
+		BT_LOGW_STR("Cannot handle end of iteration.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		goto end;
+	}
+
+	assert(iterator->state ==
+		BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ACTIVE);
+	iterator->state = BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ENDED;
+
+	if (iterator->queue->length == 0) {
+		status = BT_NOTIFICATION_ITERATOR_STATUS_END;
+	}
+
+	BT_LOGD("Set new status: status=%s",
+		bt_notification_iterator_status_string(status));
+
+end:
+	return status;
+}
+
+/*
+ * Handles notifications returned by the user's method. Steals the
+ * references.
+ */
+static
+int handle_user_notifications(
+		struct bt_notification_iterator_private_connection *iterator,
+		struct bt_notification **notifs, uint64_t count)
+{
+	uint64_t i;
+	int ret = 0;
+
+	for (i = 0; i < count; i++) {
+		ret = handle_user_notification(iterator, notifs[i]);
+		if (ret) {
+			/* Put the remaining notifications */
+			put_notifications(&notifs[i + 1], count - i - 1);
+			break;
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * Waits at most `timeout_us` µs for the upstream component of
+ * `iterator` to be ready. Without a readiness file descriptor, this
+ * only sleeps.
+ */
+static
+void wait_upstream_ready(
+		struct bt_notification_iterator_private_connection *iterator,
+		gulong timeout_us)
+{
+	GPollFD poll_fd;
+	int fd = bt_component_get_ready_fd_no_check(
+		iterator->upstream_component);
+
+	if (fd < 0) {
+		g_usleep(timeout_us);
+		return;
+	}
+
+	poll_fd.fd = fd;
+	poll_fd.events = G_IO_IN;
+	poll_fd.revents = 0;
+	(void) g_poll(&poll_fd, 1, (gint) ((timeout_us + 999) / 1000));
+}
+
+static
+void *worker_thread_func(void *data)
+{
+	struct bt_notification_iterator_worker *worker = data;
+	struct bt_notification_iterator_private_connection *iterator =
+		worker->iterator;
+	bt_component_class_notification_iterator_next_method next_method = NULL;
+	bt_component_class_notification_iterator_next_batch_method next_batch_method = NULL;
+	struct bt_notification *batch[NOTIF_BATCH_CAPACITY];
+	enum bt_notification_iterator_status status;
+	gulong again_wait_us = AGAIN_WAIT_MIN_US;
+
+	BT_LOGD("Notification iterator's worker thread started: "
+		"iter-addr=%p, worker-addr=%p", iterator, worker);
+	get_user_next_methods(iterator, &next_method, &next_batch_method);
+
+	while (true) {
+		uint64_t count;
+		uint64_t i;
+
+		if (bt_notification_ring_producer_must_stop(worker->ring)) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+			break;
+		}
+
+		status = call_user_next_method(iterator, next_method,
+			next_batch_method, batch, &count);
+
+		if (is_finalized(iterator)) {
+			/*
+			 * The user's method finalized its own
+			 * notification iterator (see the same condition
+			 * in ensure_queue_has_notifications()).
+			 */
+			put_notifications(batch, count);
+			status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+			break;
+		}
+
+		if (status == BT_NOTIFICATION_ITERATOR_STATUS_AGAIN) {
+			/*
+			 * Nobody can call this method again later on
+			 * our behalf: wait a little, longer and longer
+			 * while the upstream component has nothing,
+			 * unless it signals that it is ready.
+			 */
+			wait_upstream_ready(iterator, again_wait_us);
+			again_wait_us = MIN(again_wait_us * 2,
+				AGAIN_WAIT_MAX_US);
+			continue;
+		}
+
+		if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			/* End of iteration or error */
+			break;
+		}
+
+		again_wait_us = AGAIN_WAIT_MIN_US;
+
+		for (i = 0; i < count; i++) {
+			/* Waits while the ring is full (backpressure) */
+			if (bt_notification_ring_push(worker->ring, batch[i])) {
+				put_notifications(&batch[i], count - i);
+				status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+				goto end;
+			}
+		}
+	}
+
+end:
+	bt_notification_ring_close(worker->ring, status);
+	BT_LOGD("Notification iterator's worker thread exits: "
+		"iter-addr=%p, worker-addr=%p, status=%s", iterator, worker,
+		bt_notification_iterator_status_string(status));
+	return NULL;
+}
+
+static
+struct bt_notification_iterator_worker *create_worker(
+		struct bt_notification_iterator_private_connection *iterator)
+{
+	struct bt_notification_iterator_worker *worker = NULL;
+	struct bt_graph *graph;
 	int ret;
 
+	assert(iterator->connection);
+	graph = bt_connection_borrow_graph(iterator->connection);
+	assert(graph);
+
+	/*
+	 * The worker thread and the consumer thread share objects:
+	 * bt_graph_set_threaded() must have enabled atomic reference
+	 * counting and object pool locking before any worker thread
+	 * exists.
+	 */
+	if (!bt_ref_atomic_mode) {
+		BT_LOGE("Cannot create notification iterator's worker thread: "
+			"atomic reference counting is disabled: "
+			"iter-addr=%p, graph-addr=%p", iterator, graph);
+		goto error;
+	}
+
+	BT_LOGD("Creating notification iterator's worker thread: "
+		"iter-addr=%p, graph-addr=%p", iterator, graph);
+	worker = g_new0(struct bt_notification_iterator_worker, 1);
+	if (!worker) {
+		BT_LOGE_STR("Failed to allocate one notification iterator worker.");
+		goto error;
+	}
+
+	worker->iterator = iterator;
+	worker->ring = bt_notification_ring_create(NOTIF_RING_CAPACITY,
+		&graph->canceled);
+	if (!worker->ring) {
+		BT_LOGE_STR("Cannot create notification ring.");
+		goto error;
+	}
+
+	ret = pthread_create(&worker->thread, NULL, worker_thread_func,
+		worker);
+	if (ret) {
+		BT_LOGE("Cannot create thread: ret=%d", ret);
+		goto error;
+	}
+
+	BT_LOGD("Created notification iterator's worker thread: "
+		"iter-addr=%p, worker-addr=%p", iterator, worker);
+	goto end;
+
+error:
+	if (worker) {
+		bt_notification_ring_destroy(worker->ring);
+		g_free(worker);
+		worker = NULL;
+	}
+
+end:
+	return worker;
+}
+
+/*
+ * Threaded version of the end of ensure_queue_has_notifications(): the
+ * user notifications come from the iterator's worker thread, which is
+ * started on the first call.
+ */
+static
+enum bt_notification_iterator_status ensure_queue_has_notifications_threaded(
+		struct bt_notification_iterator_private_connection *iterator)
+{
+	struct bt_notification *batch[NOTIF_BATCH_CAPACITY];
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	if (!iterator->worker) {
+		iterator->worker = create_worker(iterator);
+		if (!iterator->worker) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+	while (iterator->queue->length == 0) {
+		uint64_t count;
+
+		status = bt_notification_ring_pop(iterator->worker->ring,
+			batch, NOTIF_BATCH_CAPACITY, &count);
+		if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			/* The worker thread is done: reap it */
+			BT_LOGD("Notification iterator's worker thread is done: "
+				"iter-addr=%p, status=%s", iterator,
+				bt_notification_iterator_status_string(status));
+			destroy_worker(iterator);
+
+			if (is_finalized(iterator)) {
+				status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+			} else if (status == BT_NOTIFICATION_ITERATOR_STATUS_END) {
+				status = handle_user_end(iterator);
+			}
+
+			goto end;
+		}
+
+		if (handle_user_notifications(iterator, batch, count)) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+end:
+	return status;
+}
+
+static
+enum bt_notification_iterator_status ensure_queue_has_notifications(
+		struct bt_notification_iterator_private_connection *iterator)
+{
+	bt_component_class_notification_iterator_next_method next_method = NULL;
+	bt_component_class_notification_iterator_next_batch_method next_batch_method = NULL;
+	struct bt_notification *batch[NOTIF_BATCH_CAPACITY];
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
 	assert(iterator);
 	BT_LOGD("Ensuring that notification iterator's queue has at least one notification: "
 		"iter-addr=%p, queue-size=%u, iter-state=%s",
@@ -2091,54 +2668,29 @@ enum bt_notification_iterator_status ensure_queue_has_notifications(
 		break;
 	}
 
-	assert(iterator->upstream_component);
-	assert(iterator->upstream_component->class);
-
-	/* Pick the appropriate "next" method */
-	switch (iterator->upstream_component->class->type) {
-	case BT_COMPONENT_CLASS_TYPE_SOURCE:
-	{
-		struct bt_component_class_source *source_class =
-			container_of(iterator->upstream_component->class,
-				struct bt_component_class_source, parent);
-
-		assert(source_class->methods.iterator.next);
-		next_method = source_class->methods.iterator.next;
-		break;
+	if (iterator->threaded) {
+		status = ensure_queue_has_notifications_threaded(iterator);
+		goto end;
 	}
-	case BT_COMPONENT_CLASS_TYPE_FILTER:
-	{
-		struct bt_component_class_filter *filter_class =
-			container_of(iterator->upstream_component->class,
-				struct bt_component_class_filter, parent);
 
-		assert(filter_class->methods.iterator.next);
-		next_method = filter_class->methods.iterator.next;
-		break;
-	}
-	default:
-		abort();
-	}
+	get_user_next_methods(iterator, &next_method, &next_batch_method);
 
 	/*
-	 * Call the user's "next" method to get the next notification
+	 * Call the user's "next" method to get the next notification(s)
 	 * and status.
 	 */
-	assert(next_method);
-
 	while (iterator->queue->length == 0) {
-		BT_LOGD_STR("Calling user's \"next\" method.");
-		next_return = next_method(priv_iterator);
-		BT_LOGD("User method returned: status=%s",
-			bt_notification_iterator_status_string(next_return.status));
-		if (next_return.status < 0) {
-			BT_LOGW_STR("User method failed.");
-			status = next_return.status;
+		enum bt_notification_iterator_status user_status;
+		uint64_t count;
+
+		user_status = call_user_next_method(iterator, next_method,
+			next_batch_method, batch, &count);
+		if (user_status < 0) {
+			status = user_status;
 			goto end;
 		}
 
-		if (iterator->state == BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_FINALIZED ||
-				iterator->state == BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_FINALIZED_AND_ENDED) {
+		if (is_finalized(iterator)) {
 			/*
 			 * The user's "next" method, somehow, cancelled
 			 * its own notification iterator. This can
@@ -2148,78 +2700,21 @@ enum bt_notification_iterator_status ensure_queue_has_notifications(
 			 * created. In this case, said connection is
 			 * ended, and all its notification iterators are
 			 * finalized.
-			 *
-			 * Only bt_put() the returned notification if
-			 * the status is
-			 * BT_NOTIFICATION_ITERATOR_STATUS_OK because
-			 * otherwise this field could be garbage.
 			 */
-			if (next_return.status ==
-					BT_NOTIFICATION_ITERATOR_STATUS_OK) {
-				bt_put(next_return.notification);
-			}
-
+			put_notifications(batch, count);
 			status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
 			goto end;
 		}
 
-		switch (next_return.status) {
+		switch (user_status) {
 		case BT_NOTIFICATION_ITERATOR_STATUS_END:
-			ret = handle_end(iterator);
-			if (ret) {
-				BT_LOGW_STR("Cannot handle end of iteration.");
-				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
-				goto end;
-			}
-
-			assert(iterator->state ==
-				BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ACTIVE);
-			iterator->state = BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ENDED;
-
-			if (iterator->queue->length == 0) {
-				status = BT_NOTIFICATION_ITERATOR_STATUS_END;
-			}
-
-			BT_LOGD("Set new status: status=%s",
-				bt_notification_iterator_status_string(status));
+			status = handle_user_end(iterator);
 			goto end;
 		case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
 			status = BT_NOTIFICATION_ITERATOR_STATUS_AGAIN;
 			goto end;
 		case BT_NOTIFICATION_ITERATOR_STATUS_OK:
-			if (!next_return.notification) {
-				BT_LOGW_STR("User method returned BT_NOTIFICATION_ITERATOR_STATUS_OK, but notification is NULL.");
-				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
-				goto end;
-			}
-
-			/*
-			 * Ignore some notifications which are always
-			 * automatically generated by the notification
-			 * iterator to make sure they have valid values.
-			 */
-			switch (next_return.notification->type) {
-			case BT_NOTIFICATION_TYPE_DISCARDED_PACKETS:
-			case BT_NOTIFICATION_TYPE_DISCARDED_EVENTS:
-				BT_LOGV("Ignoring discarded elements notification returned by notification iterator's \"next\" method: "
-					"notif-type=%s",
-					bt_notification_type_string(next_return.notification->type));
-				BT_PUT(next_return.notification);
-				continue;
-			default:
-				break;
-			}
-
-			/*
-			 * We know the notification is valid. Before we
-			 * push it to the head of the queue, push the
-			 * appropriate automatic notifications if any.
-			 */
-			ret = enqueue_notification_and_automatic(iterator,
-				next_return.notification);
-			BT_PUT(next_return.notification);
-			if (ret) {
-				BT_LOGW("Cannot enqueue notification and automatic notifications.");
+			if (handle_user_notifications(iterator, batch, count)) {
 				status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
 				goto end;
 			}
@@ -2269,9 +2764,8 @@ bt_notification_iterator_next(struct bt_notification_iterator *iterator)
 		 */
 		assert(priv_conn_iter->queue->length > 0);
 		notif = g_queue_pop_tail(priv_conn_iter->queue);
-		bt_notification_iterator_replace_current_notification(
-			iterator, notif);
-		bt_put(notif);
+		bt_object_put_ref(iterator->current_notification);
+		iterator->current_notification = notif;
 		break;
 	}
 	case BT_NOTIFICATION_ITERATOR_TYPE_OUTPUT_PORT:
@@ -2340,6 +2834,252 @@ end:
 	return status;
 }
 
+enum bt_notification_iterator_status
+bt_notification_iterator_next_batch(struct bt_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	enum bt_notification_iterator_status status;
+	uint64_t i = 0;
+
+	if (!iterator) {
+		BT_LOGW_STR("Invalid parameter: notification iterator is NULL.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	if (!notifications) {
+		BT_LOGW_STR("Invalid parameter: notification array is NULL.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	if (capacity == 0) {
+		BT_LOGW_STR("Invalid parameter: capacity is 0.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	if (!count) {
+		BT_LOGW_STR("Invalid parameter: count is NULL.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	BT_LOGD("Notification iterator's \"next batch\": iter-addr=%p, "
+		"capacity=%" PRIu64, iterator, capacity);
+
+	switch (iterator->type) {
+	case BT_NOTIFICATION_ITERATOR_TYPE_PRIVATE_CONNECTION:
+	{
+		struct bt_notification_iterator_private_connection *priv_conn_iter =
+			(void *) iterator;
+
+		/*
+		 * Make sure that the iterator's queue contains at least
+		 * one notification, then move as many notifications as
+		 * possible from the tail of the queue to the user's
+		 * array without calling the upstream component again.
+		 */
+		status = ensure_queue_has_notifications(priv_conn_iter);
+		if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			goto end;
+		}
+
+		bt_notification_iterator_replace_current_notification(
+			iterator, NULL);
+		assert(priv_conn_iter->queue->length > 0);
+
+		while (i < capacity && priv_conn_iter->queue->length > 0) {
+			notifications[i] = g_queue_pop_tail(
+				priv_conn_iter->queue);
+			i++;
+		}
+
+		break;
+	}
+	case BT_NOTIFICATION_ITERATOR_TYPE_OUTPUT_PORT:
+		/*
+		 * The colander sink only gets one notification at a
+		 * time: move the current notification.
+		 */
+		status = bt_notification_iterator_next(iterator);
+		if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			goto end;
+		}
+
+		notifications[0] = bt_get(
+			bt_notification_iterator_borrow_current_notification(
+				iterator));
+		bt_notification_iterator_replace_current_notification(
+			iterator, NULL);
+		i = 1;
+		break;
+	default:
+		BT_LOGF("Unknown notification iterator type: addr=%p, type=%d",
+			iterator, iterator->type);
+		abort();
+	}
+
+	BT_LOGD("Got notifications from notification iterator: "
+		"iter-addr=%p, count=%" PRIu64, iterator, i);
+
+end:
+	if (count) {
+		*count = i;
+	}
+
+	return status;
+}
+
+static
+void reset_stream_state_discarded_elements(gpointer key, gpointer value,
+		gpointer user_data)
+{
+	struct stream_state *stream_state = value;
+
+	/*
+	 * After a seek operation, the next packet of a stream is not
+	 * necessarily the one which follows its current packet: forget
+	 * the discarded elements counters so that the skipped packets
+	 * and events are not reported as discarded.
+	 */
+	BT_PUT(stream_state->discarded_packets_state.cur_begin);
+	stream_state->discarded_packets_state.cur_count = -1ULL;
+	BT_PUT(stream_state->discarded_events_state.cur_begin);
+	stream_state->discarded_events_state.cur_count = -1ULL;
+}
+
+/*
+ * Removes the queued notifications which are made obsolete by a seek
+ * operation. Stream and packet beginning/end notifications are kept
+ * because the current stream states already reflect them.
+ */
+static
+void discard_queued_notifications(
+		struct bt_notification_iterator_private_connection *iterator)
+{
+	GList *link = iterator->queue->head;
+
+	while (link) {
+		GList *next = link->next;
+		struct bt_notification *notif = link->data;
+
+		switch (notif->type) {
+		case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
+		case BT_NOTIFICATION_TYPE_STREAM_END:
+		case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+		case BT_NOTIFICATION_TYPE_PACKET_END:
+			break;
+		default:
+			bt_put(notif);
+			g_queue_delete_link(iterator->queue, link);
+			break;
+		}
+
+		link = next;
+	}
+}
+
+enum bt_notification_iterator_status
+bt_notification_iterator_seek_time(struct bt_notification_iterator *iterator,
+		int64_t ns_from_epoch)
+{
+	struct bt_notification_iterator_private_connection *priv_conn_iter;
+	struct bt_private_connection_private_notification_iterator *priv_iterator;
+	bt_component_class_notification_iterator_seek_time_method
+		seek_time_method = NULL;
+	enum bt_notification_iterator_status status;
+
+	if (!iterator) {
+		BT_LOGW_STR("Invalid parameter: notification iterator is NULL.");
+		status = BT_NOTIFICATION_ITERATOR_STATUS_INVALID;
+		goto end;
+	}
+
+	if (iterator->type != BT_NOTIFICATION_ITERATOR_TYPE_PRIVATE_CONNECTION) {
+		BT_LOGW("Cannot seek notification iterator: unsupported iterator type: "
+			"addr=%p, type=%d", iterator, iterator->type);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED;
+		goto end;
+	}
+
+	priv_conn_iter = (void *) iterator;
+	priv_iterator =
+		bt_private_connection_private_notification_iterator_from_notification_iterator(
+			priv_conn_iter);
+
+	switch (priv_conn_iter->state) {
+	case BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ACTIVE:
+		break;
+	case BT_PRIVATE_CONNECTION_NOTIFICATION_ITERATOR_STATE_ENDED:
+		BT_LOGW("Cannot seek notification iterator: iterator is ended: "
+			"addr=%p", iterator);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_END;
+		goto end;
+	default:
+		BT_LOGW("Cannot seek notification iterator: iterator is finalized: "
+			"addr=%p", iterator);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+		goto end;
+	}
+
+	assert(priv_conn_iter->upstream_component);
+
+	switch (priv_conn_iter->upstream_component->class->type) {
+	case BT_COMPONENT_CLASS_TYPE_SOURCE:
+	{
+		struct bt_component_class_source *source_class =
+			container_of(priv_conn_iter->upstream_component->class,
+				struct bt_component_class_source, parent);
+
+		seek_time_method = source_class->methods.iterator.seek_time;
+		break;
+	}
+	case BT_COMPONENT_CLASS_TYPE_FILTER:
+	{
+		struct bt_component_class_filter *filter_class =
+			container_of(priv_conn_iter->upstream_component->class,
+				struct bt_component_class_filter, parent);
+
+		seek_time_method = filter_class->methods.iterator.seek_time;
+		break;
+	}
+	default:
+		abort();
+	}
+
+	if (!seek_time_method) {
+		BT_LOGD("Cannot seek notification iterator: upstream component class has no \"seek time\" method: "
+			"addr=%p", iterator);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED;
+		goto end;
+	}
+
+	/*
+	 * The notifications which the worker thread already got from
+	 * the upstream component are obsolete: the worker thread is
+	 * started again on the next "next" call.
+	 */
+	destroy_worker(priv_conn_iter);
+	BT_LOGD("Calling user's \"seek time\" method: addr=%p, "
+		"ns-from-epoch=%" PRId64, iterator, ns_from_epoch);
+	status = seek_time_method(priv_iterator, ns_from_epoch);
+	BT_LOGD("User method returned: status=%s",
+		bt_notification_iterator_status_string(status));
+	if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		goto end;
+	}
+
+	discard_queued_notifications(priv_conn_iter);
+	g_hash_table_foreach(priv_conn_iter->stream_states,
+		reset_stream_state_discarded_elements, NULL);
+	bt_notification_iterator_replace_current_notification(iterator, NULL);
+
+end:
+	return status;
+}
+
 struct bt_component *bt_private_connection_notification_iterator_get_component(
 		struct bt_notification_iterator *iterator)
 {
@@ -0,0 +1,342 @@
+/*
+ * notification-ring.c
+ *
+ * Babeltrace - Single-producer, single-consumer notification ring
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define BT_LOG_TAG "NOTIF-RING"
+#include <babeltrace/lib-logging-internal.h>
+
+#include <babeltrace/graph/notification-ring-internal.h>
+#include <babeltrace/graph/notification-iterator-internal.h>
+#include <babeltrace/ref.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include <assert.h>
+#include <glib.h>
+
+/*
+ * Period after which a blocked producer or consumer wakes up to check
+ * if the graph is canceled (ns).
+ */
+#define WAIT_PERIOD_NS	10000000
+
+/*
+ * The `head` and `tail` positions only increase: the index of a
+ * position within `notifs` is its value modulo `capacity`. The ring is
+ * empty when `tail == head` and full when `tail - head == capacity`.
+ *
+ * The producer publishes a notification with a sequentially consistent
+ * store of `tail`, and then checks `consumer_waiting`. The consumer
+ * sets `consumer_waiting` with a sequentially consistent store, and
+ * then checks `tail` again before it sleeps. This guarantees that
+ * either the producer sees that the consumer waits, or the consumer
+ * sees the new notification: a wake-up is never lost. The same goes
+ * for `head` and `producer_waiting`.
+ */
+
+static
+void wake_up(struct bt_notification_ring *ring)
+{
+	pthread_mutex_lock(&ring->lock);
+	pthread_cond_broadcast(&ring->cond);
+	pthread_mutex_unlock(&ring->lock);
+}
+
+/* Must be called with `ring->lock` held. */
+static
+void timed_wait(struct bt_notification_ring *ring)
+{
+	struct timespec abstime;
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_nsec += WAIT_PERIOD_NS;
+
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000;
+	}
+
+	(void) pthread_cond_timedwait(&ring->cond, &ring->lock, &abstime);
+}
+
+static inline
+bt_bool graph_is_canceled(struct bt_notification_ring *ring)
+{
+	return __atomic_load_n(ring->canceled, __ATOMIC_RELAXED);
+}
+
+BT_HIDDEN
+struct bt_notification_ring *bt_notification_ring_create(uint64_t capacity,
+		const bt_bool *canceled)
+{
+	struct bt_notification_ring *ring;
+
+	assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+	assert(canceled);
+	BT_LOGD("Creating notification ring: capacity=%" PRIu64, capacity);
+	ring = g_new0(struct bt_notification_ring, 1);
+	if (!ring) {
+		BT_LOGE_STR("Failed to allocate one notification ring.");
+		goto error;
+	}
+
+	ring->notifs = g_new0(struct bt_notification *, capacity);
+	if (!ring->notifs) {
+		BT_LOGE_STR("Failed to allocate the notifications of a notification ring.");
+		goto error;
+	}
+
+	ring->capacity = capacity;
+	ring->canceled = canceled;
+
+	if (pthread_mutex_init(&ring->lock, NULL)) {
+		BT_LOGE_STR("Failed to initialize a mutex.");
+		goto error;
+	}
+
+	if (pthread_cond_init(&ring->cond, NULL)) {
+		BT_LOGE_STR("Failed to initialize a condition variable.");
+		pthread_mutex_destroy(&ring->lock);
+		goto error;
+	}
+
+	BT_LOGD("Created notification ring: addr=%p", ring);
+	goto end;
+
+error:
+	if (ring) {
+		g_free(ring->notifs);
+		g_free(ring);
+		ring = NULL;
+	}
+
+end:
+	return ring;
+}
+
+BT_HIDDEN
+void bt_notification_ring_destroy(struct bt_notification_ring *ring)
+{
+	uint64_t pos;
+
+	if (!ring) {
+		return;
+	}
+
+	BT_LOGD("Destroying notification ring: addr=%p, notif-count=%" PRIu64,
+		ring, ring->tail - ring->head);
+
+	for (pos = ring->head; pos != ring->tail; pos++) {
+		bt_put(ring->notifs[pos & (ring->capacity - 1)]);
+	}
+
+	pthread_cond_destroy(&ring->cond);
+	pthread_mutex_destroy(&ring->lock);
+	g_free(ring->notifs);
+	g_free(ring);
+}
+
+BT_HIDDEN
+bt_bool bt_notification_ring_producer_must_stop(
+		struct bt_notification_ring *ring)
+{
+	return __atomic_load_n(&ring->stopping, __ATOMIC_ACQUIRE) ||
+		graph_is_canceled(ring);
+}
+
+/*
+ * Waits until the ring has some space for the producer. Returns 0 on
+ * success, or -1 if the producer must stop.
+ */
+static
+int wait_for_space(struct bt_notification_ring *ring, uint64_t tail)
+{
+	int ret = 0;
+
+	BT_LOGV("Notification ring is full: waiting: addr=%p", ring);
+	pthread_mutex_lock(&ring->lock);
+	__atomic_store_n(&ring->producer_waiting, BT_TRUE, __ATOMIC_SEQ_CST);
+
+	while (true) {
+		uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST);
+
+		if (tail - head < ring->capacity) {
+			ring->producer_head = head;
+			break;
+		}
+
+		if (bt_notification_ring_producer_must_stop(ring)) {
+			ret = -1;
+			break;
+		}
+
+		timed_wait(ring);
+	}
+
+	__atomic_store_n(&ring->producer_waiting, BT_FALSE, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&ring->lock);
+	return ret;
+}
+
+BT_HIDDEN
+int bt_notification_ring_push(struct bt_notification_ring *ring,
+		struct bt_notification *notif)
+{
+	uint64_t tail = ring->tail;
+	int ret = 0;
+
+	assert(notif);
+
+	if (tail - ring->producer_head == ring->capacity) {
+		ring->producer_head = __atomic_load_n(&ring->head,
+			__ATOMIC_ACQUIRE);
+
+		if (tail - ring->producer_head == ring->capacity) {
+			ret = wait_for_space(ring, tail);
+			if (ret) {
+				goto end;
+			}
+		}
+	}
+
+	ring->notifs[tail & (ring->capacity - 1)] = notif;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&ring->consumer_waiting, __ATOMIC_SEQ_CST)) {
+		wake_up(ring);
+	}
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+void bt_notification_ring_close(struct bt_notification_ring *ring,
+		enum bt_notification_iterator_status status)
+{
+	BT_LOGD("Closing notification ring: addr=%p, status=%s",
+		ring, bt_notification_iterator_status_string(status));
+	ring->close_status = status;
+	__atomic_store_n(&ring->closed, BT_TRUE, __ATOMIC_SEQ_CST);
+	wake_up(ring);
+}
+
+/*
+ * Waits until the ring has at least one notification for the consumer.
+ * Returns BT_NOTIFICATION_ITERATOR_STATUS_OK on success, or the status
+ * to return to the consumer.
+ */
+static
+enum bt_notification_iterator_status wait_for_notifs(
+		struct bt_notification_ring *ring, uint64_t head)
+{
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	BT_LOGV("Notification ring is empty: waiting: addr=%p", ring);
+	pthread_mutex_lock(&ring->lock);
+	__atomic_store_n(&ring->consumer_waiting, BT_TRUE, __ATOMIC_SEQ_CST);
+
+	while (true) {
+		/*
+		 * The producer pushes all its notifications before it
+		 * closes the ring: read `closed` before `tail`.
+		 */
+		bt_bool closed = __atomic_load_n(&ring->closed,
+			__ATOMIC_SEQ_CST);
+		uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST);
+
+		if (tail != head) {
+			ring->consumer_tail = tail;
+			break;
+		}
+
+		if (closed) {
+			status = ring->close_status;
+			break;
+		}
+
+		if (graph_is_canceled(ring)) {
+			status = BT_NOTIFICATION_ITERATOR_STATUS_CANCELED;
+			break;
+		}
+
+		timed_wait(ring);
+	}
+
+	__atomic_store_n(&ring->consumer_waiting, BT_FALSE, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&ring->lock);
+	return status;
+}
+
+BT_HIDDEN
+enum bt_notification_iterator_status bt_notification_ring_pop(
+		struct bt_notification_ring *ring,
+		struct bt_notification **notifs, uint64_t capacity,
+		uint64_t *count)
+{
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	uint64_t head = ring->head;
+	uint64_t i;
+
+	assert(capacity > 0);
+	*count = 0;
+
+	if (ring->consumer_tail == head) {
+		ring->consumer_tail = __atomic_load_n(&ring->tail,
+			__ATOMIC_ACQUIRE);
+
+		if (ring->consumer_tail == head) {
+			status = wait_for_notifs(ring, head);
+			if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+				goto end;
+			}
+		}
+	}
+
+	for (i = 0; i < capacity && head + i != ring->consumer_tail; i++) {
+		notifs[i] = ring->notifs[(head + i) & (ring->capacity - 1)];
+	}
+
+	*count = i;
+	__atomic_store_n(&ring->head, head + i, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&ring->producer_waiting, __ATOMIC_SEQ_CST)) {
+		wake_up(ring);
+	}
+
+end:
+	return status;
+}
+
+BT_HIDDEN
+void bt_notification_ring_stop(struct bt_notification_ring *ring)
+{
+	BT_LOGD("Stopping notification ring's producer: addr=%p", ring);
+	__atomic_store_n(&ring->stopping, BT_TRUE, __ATOMIC_SEQ_CST);
+	wake_up(ring);
+}
@@ -33,6 +33,7 @@
 #include <babeltrace/ctf-ir/event-class-internal.h>
 #include <babeltrace/ctf-ir/stream-class-internal.h>
 #include <babeltrace/ctf-ir/trace.h>
+#include <babeltrace/ctf-ir/trace-internal.h>
 #include <babeltrace/graph/clock-class-priority-map.h>
 #include <babeltrace/graph/clock-class-priority-map-internal.h>
 #include <babeltrace/graph/notification-event-internal.h>
@@ -40,11 +41,26 @@
 #include <stdbool.h>
 #include <inttypes.h>
 
-static
-void bt_notification_event_destroy(struct bt_object *obj)
+BT_HIDDEN
+struct bt_notification *bt_notification_event_new(
+		struct bt_stream_class *stream_class)
 {
 	struct bt_notification_event *notification =
-			(struct bt_notification_event *) obj;
+		g_new0(struct bt_notification_event, 1);
+
+	if (!notification) {
+		BT_LOGE_STR("Failed to allocate one event notification.");
+		return NULL;
+	}
+
+	return &notification->parent;
+}
+
+BT_HIDDEN
+void bt_notification_event_destroy(struct bt_notification *notif)
+{
+	struct bt_notification_event *notification = container_of(notif,
+		struct bt_notification_event, parent);
 
 	BT_LOGD("Destroying event notification: addr=%p", notification);
 	BT_LOGD_STR("Putting event.");
@@ -54,6 +70,33 @@ void bt_notification_event_destroy(struct bt_object *obj)
 	g_free(notification);
 }
 
+static
+void bt_notification_event_recycle(struct bt_object *obj)
+{
+	struct bt_notification_event *notification =
+			(struct bt_notification_event *) obj;
+	struct bt_stream_class *stream_class;
+	struct bt_event *event;
+
+	BT_LOGV("Recycling event notification: addr=%p", notification);
+	stream_class = bt_event_class_borrow_stream_class(
+		bt_event_borrow_event_class(notification->event));
+	assert(stream_class);
+	bt_object_put_no_null_check(notification->cc_prio_map);
+	notification->cc_prio_map = NULL;
+
+	/*
+	 * Put the event _after_ the notification is back in its pool:
+	 * this could be the last reference to the event, and therefore
+	 * (indirectly) to the stream class which owns the pool.
+	 */
+	event = notification->event;
+	notification->event = NULL;
+	bt_object_pool_recycle_object(&stream_class->event_notif_pool,
+		notification);
+	bt_object_put_no_null_check(event);
+}
+
 static
 bt_bool validate_clock_classes(struct bt_notification_event *notif)
 {
@@ -65,14 +108,11 @@ bt_bool validate_clock_classes(struct bt_notification_event *notif)
 	 */
 	bt_bool is_valid = BT_TRUE;
 
-	int trace_cc_count;
-	int cc_prio_map_cc_count;
-	size_t cc_prio_map_cc_i, trace_cc_i;
-	struct bt_clock_value *clock_value = NULL;
-	struct bt_clock_class *clock_class = NULL;
-	struct bt_event_class *event_class = NULL;
-	struct bt_stream_class *stream_class = NULL;
-	struct bt_trace *trace = NULL;
+	size_t cc_prio_map_cc_i;
+	struct bt_clock_class *clock_class;
+	struct bt_event_class *event_class;
+	struct bt_stream_class *stream_class;
+	struct bt_trace *trace;
 
 	event_class = bt_event_borrow_event_class(notif->event);
 	assert(event_class);
@@ -80,24 +120,15 @@ bt_bool validate_clock_classes(struct bt_notification_event *notif)
 	assert(stream_class);
 	trace = bt_stream_class_borrow_trace(stream_class);
 	assert(trace);
-	trace_cc_count = bt_trace_get_clock_class_count(trace);
-	assert(trace_cc_count >= 0);
-	cc_prio_map_cc_count =
-		bt_clock_class_priority_map_get_clock_class_count(
-			notif->cc_prio_map);
-	assert(cc_prio_map_cc_count >= 0);
-
-	for (cc_prio_map_cc_i = 0; cc_prio_map_cc_i < cc_prio_map_cc_count;
-			cc_prio_map_cc_i++) {
-		bt_bool found_in_trace = BT_FALSE;
 
-		clock_class =
-			bt_clock_class_priority_map_get_clock_class_by_index(
-				notif->cc_prio_map, cc_prio_map_cc_i);
+	for (cc_prio_map_cc_i = 0;
+			cc_prio_map_cc_i < notif->cc_prio_map->entries->len;
+			cc_prio_map_cc_i++) {
+		clock_class = g_ptr_array_index(notif->cc_prio_map->entries,
+			cc_prio_map_cc_i);
 		assert(clock_class);
-		clock_value = bt_event_get_clock_value(notif->event,
-			clock_class);
-		if (!clock_value) {
+
+		if (!bt_event_borrow_clock_value(notif->event, clock_class)) {
 			BT_LOGW("Event has no clock value for a clock class which exists in the notification's clock class priority map: "
 				"notif-addr=%p, event-addr=%p, "
 				"event-class-addr=%p, event-class-name=\"%s\", "
@@ -113,22 +144,7 @@ bt_bool validate_clock_classes(struct bt_notification_event *notif)
 			goto end;
 		}
 
-		for (trace_cc_i = 0; trace_cc_i < trace_cc_count;
-				trace_cc_i++) {
-			struct bt_clock_class *trace_clock_class =
-				bt_trace_get_clock_class_by_index(trace,
-					trace_cc_i);
-
-			assert(trace_clock_class);
-			bt_put(trace_clock_class);
-
-			if (trace_clock_class == clock_class) {
-				found_in_trace = BT_TRUE;
-				break;
-			}
-		}
-
-		if (!found_in_trace) {
+		if (!bt_trace_has_clock_class(trace, clock_class)) {
 			BT_LOGW("A clock class found in the event notification's clock class priority map does not exist in the notification's event's trace: "
 				"notif-addr=%p, trace-addr=%p, "
 				"trace-name=\"%s\", cc-prio-map-addr=%p, "
@@ -139,14 +155,9 @@ bt_bool validate_clock_classes(struct bt_notification_event *notif)
 			is_valid = BT_FALSE;
 			goto end;
 		}
-
-		BT_PUT(clock_value);
-		BT_PUT(clock_class);
 	}
 
 end:
-	bt_put(clock_value);
-	bt_put(clock_class);
 	return is_valid;
 }
 
@@ -167,6 +178,7 @@ struct bt_notification *bt_notification_event_create(struct bt_event *event,
 		struct bt_clock_class_priority_map *cc_prio_map)
 {
 	struct bt_notification_event *notification = NULL;
+	struct bt_clock_class_priority_map *empty_cc_prio_map = NULL;
 	struct bt_event_class *event_class;
 
 	if (!event) {
@@ -174,11 +186,10 @@ struct bt_notification *bt_notification_event_create(struct bt_event *event,
 		goto error;
 	}
 
-	if (cc_prio_map) {
+	if (!cc_prio_map) {
 		/* Function's reference, released at the end */
-		bt_get(cc_prio_map);
-	} else {
-		cc_prio_map = bt_clock_class_priority_map_create();
+		empty_cc_prio_map = bt_clock_class_priority_map_create();
+		cc_prio_map = empty_cc_prio_map;
 		if (!cc_prio_map) {
 			BT_LOGE_STR("Cannot create empty clock class priority map.");
 			goto error;
@@ -218,16 +229,19 @@ struct bt_notification *bt_notification_event_create(struct bt_event *event,
 		goto error;
 	}
 
-	notification = g_new0(struct bt_notification_event, 1);
+	notification = (void *) bt_object_pool_create_object(
+		&bt_event_class_borrow_stream_class(event_class)->event_notif_pool);
 	if (!notification) {
-		BT_LOGE_STR("Failed to allocate one event notification.");
+		BT_LOGE_STR("Cannot create event notification from pool.");
 		goto error;
 	}
 
 	bt_notification_init(&notification->parent, BT_NOTIFICATION_TYPE_EVENT,
-		bt_notification_event_destroy);
-	notification->event = bt_get(event);
-	notification->cc_prio_map = bt_get(cc_prio_map);
+		bt_notification_event_recycle);
+	bt_object_get_no_null_check(event);
+	notification->event = event;
+	bt_object_get_no_null_check(cc_prio_map);
+	notification->cc_prio_map = cc_prio_map;
 	if (!validate_clock_classes(notification)) {
 		BT_LOGW("Invalid event: invalid clock class: "
 			"event-addr=%p, event-class-addr=%p, "
@@ -257,7 +271,7 @@ error:
 	BT_PUT(notification);
 
 end:
-	bt_put(cc_prio_map);
+	bt_put(empty_cc_prio_map);
 	return &notification->parent;
 }
 
@@ -34,6 +34,7 @@ void bt_notification_init(struct bt_notification *notification,
 	assert(type > BT_NOTIFICATION_TYPE_ALL &&
 			type < BT_NOTIFICATION_TYPE_NR);
 	notification->type = type;
+	notification->frozen = BT_FALSE;
 	bt_object_init(&notification->base, release);
 }
 
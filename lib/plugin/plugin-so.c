@@ -230,6 +230,54 @@ void bt_plugin_so_destroy_spec_data(struct bt_plugin *plugin)
 	plugin->spec_data = NULL;
 }
 
+/*
+ * Sets the optional notification iterator methods of `methods` which
+ * are not NULL to the source or filter component class `comp_class`.
+ */
+static
+int set_optional_notification_iterator_methods(
+		struct bt_component_class *comp_class,
+		struct bt_component_class_notification_iterator_methods *methods)
+{
+	int (*set_seek_time_method)(struct bt_component_class *,
+		bt_component_class_notification_iterator_seek_time_method);
+	int (*set_next_batch_method)(struct bt_component_class *,
+		bt_component_class_notification_iterator_next_batch_method);
+	int ret = 0;
+
+	if (bt_component_class_get_type(comp_class) ==
+			BT_COMPONENT_CLASS_TYPE_SOURCE) {
+		set_seek_time_method =
+			bt_component_class_source_set_notification_iterator_seek_time_method;
+		set_next_batch_method =
+			bt_component_class_source_set_notification_iterator_next_batch_method;
+	} else {
+		set_seek_time_method =
+			bt_component_class_filter_set_notification_iterator_seek_time_method;
+		set_next_batch_method =
+			bt_component_class_filter_set_notification_iterator_next_batch_method;
+	}
+
+	if (methods->seek_time) {
+		ret = set_seek_time_method(comp_class, methods->seek_time);
+		if (ret) {
+			BT_LOGE_STR("Cannot set component class's notification iterator seek time method.");
+			goto end;
+		}
+	}
+
+	if (methods->next_batch) {
+		ret = set_next_batch_method(comp_class, methods->next_batch);
+		if (ret) {
+			BT_LOGE_STR("Cannot set component class's notification iterator \"next batch\" method.");
+			goto end;
+		}
+	}
+
+end:
+	return ret;
+}
+
 /*
  * This function does the following:
  *
@@ -283,6 +331,7 @@ enum bt_plugin_status bt_plugin_so_init(
 		bt_component_class_port_connected_method port_connected_method;
 		bt_component_class_port_disconnected_method port_disconnected_method;
 		struct bt_component_class_notification_iterator_methods iterator_methods;
+		bt_bool trusted;
 	};
 
 	enum bt_plugin_status status = BT_PLUGIN_STATUS_OK;
@@ -466,6 +515,18 @@ enum bt_plugin_status bt_plugin_so_init(
 					cc_full_descr->iterator_methods.finalize =
 						cur_cc_descr_attr->value.notif_iter_finalize_method;
 					break;
+				case BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_SEEK_TIME_METHOD:
+					cc_full_descr->iterator_methods.seek_time =
+						cur_cc_descr_attr->value.notif_iter_seek_time_method;
+					break;
+				case BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_NOTIF_ITER_NEXT_BATCH_METHOD:
+					cc_full_descr->iterator_methods.next_batch =
+						cur_cc_descr_attr->value.notif_iter_next_batch_method;
+					break;
+				case BT_PLUGIN_COMPONENT_CLASS_DESCRIPTOR_ATTRIBUTE_TYPE_TRUSTED:
+					cc_full_descr->trusted =
+						cur_cc_descr_attr->value.trusted;
+					break;
 				default:
 					/*
 					 * WARN-level logging because
@@ -595,6 +656,17 @@ enum bt_plugin_status bt_plugin_so_init(
 			}
 		}
 
+		if (cc_full_descr->trusted) {
+			ret = bt_component_class_set_trusted(comp_class,
+				BT_TRUE);
+			if (ret) {
+				BT_LOGE_STR("Cannot set component class's trust.");
+				status = BT_PLUGIN_STATUS_ERROR;
+				BT_PUT(comp_class);
+				goto end;
+			}
+		}
+
 		if (cc_full_descr->init_method) {
 			ret = bt_component_class_set_init_method(comp_class,
 				cc_full_descr->init_method);
@@ -686,6 +758,14 @@ enum bt_plugin_status bt_plugin_so_init(
 					goto end;
 				}
 			}
+
+			ret = set_optional_notification_iterator_methods(
+				comp_class, &cc_full_descr->iterator_methods);
+			if (ret) {
+				status = BT_PLUGIN_STATUS_ERROR;
+				BT_PUT(comp_class);
+				goto end;
+			}
 			break;
 		case BT_COMPONENT_CLASS_TYPE_FILTER:
 			if (cc_full_descr->iterator_methods.init) {
@@ -711,6 +791,14 @@ enum bt_plugin_status bt_plugin_so_init(
 					goto end;
 				}
 			}
+
+			ret = set_optional_notification_iterator_methods(
+				comp_class, &cc_full_descr->iterator_methods);
+			if (ret) {
+				status = BT_PLUGIN_STATUS_ERROR;
+				BT_PUT(comp_class);
+				goto end;
+			}
 			break;
 		case BT_COMPONENT_CLASS_TYPE_SINK:
 			break;
@@ -29,10 +29,24 @@
 
 #include <babeltrace/ref-internal.h>
 #include <babeltrace/object-internal.h>
+#include <stdbool.h>
+
+BT_HIDDEN
+bool bt_ref_atomic_mode;
+
+BT_HIDDEN
+void bt_ref_enable_atomic_mode(void)
+{
+	if (!bt_ref_atomic_mode) {
+		BT_LOGI_STR("Enabling atomic reference counting.");
+		bt_ref_atomic_mode = true;
+	}
+}
 
 void *bt_get(void *ptr)
 {
 	struct bt_object *obj = ptr;
+	unsigned long old_count;
 
 	if (unlikely(!obj)) {
 		goto end;
@@ -42,17 +56,22 @@ void *bt_get(void *ptr)
 		goto end;
 	}
 
-	if (unlikely(obj->parent && bt_object_get_ref_count(obj) == 0)) {
+	old_count = bt_ref_get(&obj->ref_count);
+	BT_LOGV("Incremented object's reference count: %lu -> %lu: "
+		"addr=%p, cur-count=%lu, new-count=%lu",
+		old_count, old_count + 1, ptr, old_count, old_count + 1);
+
+	/*
+	 * The thread which takes the count from 0 to 1, and only this
+	 * one, also takes a reference on the parent. The parent cannot
+	 * be released in the meantime: a child with a count of 0 is
+	 * only reachable through its parent, which the caller owns.
+	 */
+	if (unlikely(obj->parent && old_count == 0)) {
 		BT_LOGV("Incrementing object's parent's reference count: "
 			"addr=%p, parent-addr=%p", ptr, obj->parent);
 		bt_get(obj->parent);
 	}
-	BT_LOGV("Incrementing object's reference count: %lu -> %lu: "
-		"addr=%p, cur-count=%lu, new-count=%lu",
-		obj->ref_count.count, obj->ref_count.count + 1,
-		ptr,
-		obj->ref_count.count, obj->ref_count.count + 1);
-	bt_ref_get(&obj->ref_count);
 
 end:
 	return obj;
@@ -75,10 +94,8 @@ void bt_put(void *ptr)
 			ptr);
 	}
 
-	BT_LOGV("Decrementing object's reference count: %lu -> %lu: "
-		"addr=%p, cur-count=%lu, new-count=%lu",
-		obj->ref_count.count, obj->ref_count.count - 1,
-		ptr,
-		obj->ref_count.count, obj->ref_count.count - 1);
+	BT_LOGV("Decrementing object's reference count: "
+		"addr=%p, cur-count=%lu",
+		ptr, obj->ref_count.count);
 	bt_ref_put(&obj->ref_count);
 }
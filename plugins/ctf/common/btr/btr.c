@@ -49,31 +49,136 @@
 #define BITS_TO_BYTES_CEIL(_x)		DIV8((_x) + 7)
 #define IN_BYTE_OFFSET(_at)		((_at) & 7)
 
-/* A visit stack entry */
-struct stack_entry {
+/*
+ * Decode program instruction types.
+ *
+ * A field type is compiled once into a flat decode program (see
+ * compile_field_type()). Nested structure and array field types are
+ * inlined in the program of their parent, so that a field type with a
+ * static layout is decoded as a straight sequence of basic field
+ * reads. Sequence and variant field types need dynamic information
+ * which is queried to the user during the decoding process.
+ */
+enum btr_instr_type {
+	/* Read an integer, enumeration, or floating point number field */
+	BTR_INSTR_READ_BASIC,
+
+	/* Read a string field */
+	BTR_INSTR_READ_STRING,
+
+	/* Begin a structure field */
+	BTR_INSTR_BEGIN_STRUCT,
+
+	/* End a structure field */
+	BTR_INSTR_END_STRUCT,
+
+	/* Begin an array field (static length) */
+	BTR_INSTR_BEGIN_ARRAY,
+
+	/* Begin a sequence field (length queried to the user) */
+	BTR_INSTR_BEGIN_SEQUENCE,
+
+	/* Loop to the next element of an array/sequence field, or end it */
+	BTR_INSTR_END_ARRAY,
+
+	/* Begin a variant field (selected field type queried to the user) */
+	BTR_INSTR_BEGIN_VARIANT,
+
+	/* End a variant field */
+	BTR_INSTR_END_VARIANT,
+};
+
+/* Decode program instruction */
+struct btr_instr {
+	enum btr_instr_type type;
+
 	/*
-	 * Current type of base field, one of:
-	 *
-	 *   * Structure
-	 *   * Array
-	 *   * Sequence
-	 *   * Variant
-	 *
-	 * Owned by this.
+	 * Field type of this instruction (weak: owned by the root field
+	 * type of the program).
 	 */
-	struct bt_field_type *base_type;
+	struct bt_field_type *field_type;
+
+	/* Alignment of the field (bits), always at least 1 */
+	unsigned int alignment;
+
+	union {
+		/* BTR_INSTR_READ_BASIC */
+		struct {
+			/* Field type ID of field_type */
+			enum bt_field_type_id id;
+
+			/* Size of the field (bits) */
+			unsigned int size;
+
+			/* Byte order of the field */
+			enum bt_byte_order bo;
+
+			/* True if the integer field type is signed */
+			bool is_signed;
+
+			/*
+			 * True if the field's size is 8, 16, 32, or 64
+			 * bits: such a field can be read with a single
+			 * load when it starts on a byte boundary.
+			 */
+			bool native_size;
+		} basic;
+
+		/* BTR_INSTR_BEGIN_ARRAY and BTR_INSTR_BEGIN_SEQUENCE */
+		struct {
+			/* Length of the array field (-1 for a sequence) */
+			int64_t length;
+
+			/* Index of the corresponding BTR_INSTR_END_ARRAY */
+			size_t end_pc;
+
+			/*
+			 * True if the element field type is an 8-bit
+			 * integer field type: the elements can be
+			 * passed at once to the `byte_array` user
+			 * function when they start on a byte boundary.
+			 */
+			bool bytes;
+		} begin_array;
+
+		/* BTR_INSTR_END_ARRAY */
+		struct {
+			/* Index of the corresponding BTR_INSTR_BEGIN_* */
+			size_t begin_pc;
+		} end_array;
+	} u;
+};
+
+/* Decode program of a field type */
+struct btr_program {
+	/* Compiled field type (owned by this) */
+	struct bt_field_type *field_type;
 
-	/* Length of base field (always 1 for variant types) */
-	int64_t base_len;
+	/* Instructions (struct btr_instr) */
+	GArray *instrs;
+};
+
+/* A visit stack entry: a running decode program */
+struct stack_entry {
+	/* Running program (weak: owned by the BTR) */
+	struct btr_program *program;
 
-	/* Lndex of next field to read */
-	int64_t index;
+	/* Index of the next instruction to execute */
+	size_t pc;
 };
 
 /* Visit stack */
 struct stack {
-	/* Entries (struct stack_entry *) (top is last element) */
-	GPtrArray *entries;
+	/* Entries (struct stack_entry) (top is last element) */
+	GArray *entries;
+
+	/*
+	 * Remaining elements of the array and sequence fields being
+	 * decoded (int64_t) (top is last element). The array/sequence
+	 * fields of all the running programs are nested, so one stack
+	 * is enough.
+	 */
+	GArray *loops;
 };
 
 /* Reading states */
@@ -83,6 +188,8 @@ enum btr_state {
 	BTR_STATE_ALIGN_COMPOUND,
 	BTR_STATE_READ_BASIC_BEGIN,
 	BTR_STATE_READ_BASIC_CONTINUE,
+	BTR_STATE_ALIGN_BYTES,
+	BTR_STATE_READ_BYTES,
 	BTR_STATE_DONE,
 };
 
@@ -91,8 +198,15 @@ struct bt_btr {
 	/* Bisit stack */
 	struct stack *stack;
 
-	/* Current basic field type */
-	struct bt_field_type *cur_basic_field_type;
+	/*
+	 * Current basic field instruction, or current
+	 * BTR_INSTR_BEGIN_ARRAY/BTR_INSTR_BEGIN_SEQUENCE instruction
+	 * in the BTR_STATE_*_BYTES states (weak)
+	 */
+	struct btr_instr *cur_instr;
+
+	/* Alignment (bits) of the current compound field */
+	unsigned int cur_compound_alignment;
 
 	/* Current state */
 	enum btr_state state;
@@ -112,6 +226,20 @@ struct bt_btr {
 	/* Current byte order (copied to last_bo after a successful read) */
 	enum bt_byte_order cur_bo;
 
+	/*
+	 * Cache of decode programs of frozen field types: field type
+	 * (weak: owned by the program) to struct btr_program (owned by
+	 * this).
+	 */
+	GHashTable *programs;
+
+	/*
+	 * Decode programs of field types which are not frozen yet, and
+	 * therefore could change: only valid until the next call to
+	 * bt_btr_start() (struct btr_program, owned by this).
+	 */
+	GPtrArray *tmp_programs;
+
 	/* Stitch buffer infos */
 	struct {
 		/* Stitch buffer */
@@ -169,6 +297,10 @@ const char *btr_state_string(enum btr_state state)
 		return "BTR_STATE_READ_BASIC_BEGIN";
 	case BTR_STATE_READ_BASIC_CONTINUE:
 		return "BTR_STATE_READ_BASIC_CONTINUE";
+	case BTR_STATE_ALIGN_BYTES:
+		return "BTR_STATE_ALIGN_BYTES";
+	case BTR_STATE_READ_BYTES:
+		return "BTR_STATE_READ_BYTES";
 	case BTR_STATE_DONE:
 		return "BTR_STATE_DONE";
 	default:
@@ -176,13 +308,31 @@ const char *btr_state_string(enum btr_state state)
 	}
 }
 
-static
-void stack_entry_free_func(gpointer data)
+static inline
+const char *btr_instr_type_string(enum btr_instr_type type)
 {
-	struct stack_entry *entry = data;
-
-	BT_PUT(entry->base_type);
-	g_free(entry);
+	switch (type) {
+	case BTR_INSTR_READ_BASIC:
+		return "BTR_INSTR_READ_BASIC";
+	case BTR_INSTR_READ_STRING:
+		return "BTR_INSTR_READ_STRING";
+	case BTR_INSTR_BEGIN_STRUCT:
+		return "BTR_INSTR_BEGIN_STRUCT";
+	case BTR_INSTR_END_STRUCT:
+		return "BTR_INSTR_END_STRUCT";
+	case BTR_INSTR_BEGIN_ARRAY:
+		return "BTR_INSTR_BEGIN_ARRAY";
+	case BTR_INSTR_BEGIN_SEQUENCE:
+		return "BTR_INSTR_BEGIN_SEQUENCE";
+	case BTR_INSTR_END_ARRAY:
+		return "BTR_INSTR_END_ARRAY";
+	case BTR_INSTR_BEGIN_VARIANT:
+		return "BTR_INSTR_BEGIN_VARIANT";
+	case BTR_INSTR_END_VARIANT:
+		return "BTR_INSTR_END_VARIANT";
+	default:
+		return "(unknown)";
+	}
 }
 
 static
@@ -196,9 +346,15 @@ struct stack *stack_new(void)
 		goto error;
 	}
 
-	stack->entries = g_ptr_array_new_with_free_func(stack_entry_free_func);
+	stack->entries = g_array_new(FALSE, FALSE, sizeof(struct stack_entry));
 	if (!stack->entries) {
-		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		BT_LOGE_STR("Failed to allocate a GArray.");
+		goto error;
+	}
+
+	stack->loops = g_array_new(FALSE, FALSE, sizeof(int64_t));
+	if (!stack->loops) {
+		BT_LOGE_STR("Failed to allocate a GArray.");
 		goto error;
 	}
 
@@ -206,8 +362,11 @@ struct stack *stack_new(void)
 	return stack;
 
 error:
-	g_free(stack);
+	if (stack && stack->entries) {
+		g_array_free(stack->entries, TRUE);
+	}
 
+	g_free(stack);
 	return NULL;
 }
 
@@ -219,97 +378,34 @@ void stack_destroy(struct stack *stack)
 	}
 
 	BT_LOGD("Destroying stack: addr=%p", stack);
-	g_ptr_array_free(stack->entries, TRUE);
-	g_free(stack);
-}
 
-static inline
-int64_t get_compound_field_type_length(struct bt_btr *btr,
-		struct bt_field_type *field_type)
-{
-	int64_t length;
+	if (stack->entries) {
+		g_array_free(stack->entries, TRUE);
+	}
 
-	switch (bt_field_type_get_type_id(field_type)) {
-	case BT_FIELD_TYPE_ID_STRUCT:
-		length = (int64_t) bt_field_type_structure_get_field_count(
-			field_type);
-		break;
-	case BT_FIELD_TYPE_ID_VARIANT:
-		/* Variant field types always "contain" a single type */
-		length = 1;
-		break;
-	case BT_FIELD_TYPE_ID_ARRAY:
-		length = bt_field_type_array_get_length(field_type);
-		break;
-	case BT_FIELD_TYPE_ID_SEQUENCE:
-		length = btr->user.cbs.query.get_sequence_length(field_type,
-			btr->user.data);
-		break;
-	default:
-		BT_LOGW("Cannot get field type's field count: btr-addr=%p, "
-			"ft-addr=%p, ft-id=%s",
-			btr, field_type,
-			bt_field_type_id_string(
-				bt_field_type_get_type_id(field_type)));
-		length = BT_BTR_STATUS_ERROR;
+	if (stack->loops) {
+		g_array_free(stack->loops, TRUE);
 	}
 
-	return length;
+	g_free(stack);
 }
 
 static
-int stack_push(struct stack *stack, struct bt_field_type *base_type,
-	size_t base_len)
+void stack_push(struct stack *stack, struct btr_program *program)
 {
-	int ret = 0;
-	struct stack_entry *entry;
+	struct stack_entry entry = {
+		.program = program,
+		.pc = 0,
+	};
 
 	assert(stack);
-	assert(base_type);
-
-	BT_LOGV("Pushing field type on stack: stack-addr=%p, "
-		"ft-addr=%p, ft-id=%s, base-length=%zu, "
+	assert(program);
+	BT_LOGV("Pushing program on stack: stack-addr=%p, "
+		"program-addr=%p, ft-addr=%p, "
 		"stack-size-before=%u, stack-size-after=%u",
-		stack, base_type, bt_field_type_id_string(
-			bt_field_type_get_type_id(base_type)),
-		base_len, stack->entries->len, stack->entries->len + 1);
-	entry = g_new0(struct stack_entry, 1);
-	if (!entry) {
-		BT_LOGE("Failed to allocate one stack entry: stack-addr=%p",
-			stack);
-		ret = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	entry->base_type = base_type;
-	bt_get(entry->base_type);
-	entry->base_len = base_len;
-	g_ptr_array_add(stack->entries, entry);
-
-end:
-	return ret;
-}
-
-static
-int stack_push_with_len(struct bt_btr *btr,
-		struct bt_field_type *base_type)
-{
-	int ret = 0;
-	int64_t base_len = get_compound_field_type_length(btr, base_type);
-
-	if (base_len < 0) {
-		BT_LOGW("Cannot get compound field type's field count: "
-			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, base_type, bt_field_type_id_string(
-				bt_field_type_get_type_id(base_type)));
-		ret = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	ret = stack_push(btr->stack, base_type, (size_t) base_len);
-
-end:
-	return ret;
+		stack, program, program->field_type,
+		stack->entries->len, stack->entries->len + 1);
+	g_array_append_val(stack->entries, entry);
 }
 
 static inline
@@ -328,7 +424,7 @@ void stack_pop(struct stack *stack)
 	BT_LOGV("Popping from stack: "
 		"stack-addr=%p, stack-size-before=%u, stack-size-after=%u",
 		stack, stack->entries->len, stack->entries->len - 1);
-	g_ptr_array_remove_index(stack->entries, stack->entries->len - 1);
+	g_array_set_size(stack->entries, stack->entries->len - 1);
 }
 
 static inline
@@ -341,11 +437,8 @@ static
 void stack_clear(struct stack *stack)
 {
 	assert(stack);
-
-	if (!stack_empty(stack)) {
-		g_ptr_array_remove_range(stack->entries, 0, stack_size(stack));
-	}
-
+	g_array_set_size(stack->entries, 0);
+	g_array_set_size(stack->loops, 0);
 	assert(stack_empty(stack));
 }
 
@@ -355,7 +448,29 @@ struct stack_entry *stack_top(struct stack *stack)
 	assert(stack);
 	assert(stack_size(stack));
 
-	return g_ptr_array_index(stack->entries, stack->entries->len - 1);
+	return &g_array_index(stack->entries, struct stack_entry,
+		stack->entries->len - 1);
+}
+
+static inline
+void stack_push_loop(struct stack *stack, int64_t length)
+{
+	g_array_append_val(stack->loops, length);
+}
+
+static inline
+int64_t *stack_top_loop(struct stack *stack)
+{
+	assert(stack->loops->len > 0);
+
+	return &g_array_index(stack->loops, int64_t, stack->loops->len - 1);
+}
+
+static inline
+void stack_pop_loop(struct stack *stack)
+{
+	assert(stack->loops->len > 0);
+	g_array_set_size(stack->loops, stack->loops->len - 1);
 }
 
 static inline
@@ -453,6 +568,283 @@ int get_basic_field_type_size(struct bt_btr *btr,
 	return size;
 }
 
+static inline
+int get_field_type_alignment(struct bt_field_type *field_type)
+{
+	int alignment = bt_field_type_get_alignment(field_type);
+
+	/*
+	 * 0 means "undefined" for variants; what we really want is 1
+	 * (always aligned)
+	 */
+	if (alignment == 0) {
+		alignment = 1;
+	}
+
+	return alignment;
+}
+
+static
+int compile_field_type(struct bt_btr *btr, struct bt_field_type *field_type,
+		GArray *instrs)
+{
+	int ret = 0;
+	struct btr_instr instr = { 0 };
+	enum bt_field_type_id type_id = bt_field_type_get_type_id(field_type);
+
+	instr.field_type = field_type;
+	ret = get_field_type_alignment(field_type);
+	if (ret < 0) {
+		BT_LOGW("Cannot get field type's alignment: "
+			"btr-addr=%p, ft-addr=%p, ft-id=%s",
+			btr, field_type, bt_field_type_id_string(type_id));
+		goto end;
+	}
+
+	instr.alignment = (unsigned int) ret;
+	ret = 0;
+
+	switch (type_id) {
+	case BT_FIELD_TYPE_ID_INTEGER:
+	case BT_FIELD_TYPE_ID_FLOAT:
+	case BT_FIELD_TYPE_ID_ENUM:
+	{
+		struct bt_field_type *int_field_type = NULL;
+		int size = get_basic_field_type_size(btr, field_type);
+
+		if (size < 1) {
+			BT_LOGW("Cannot get basic field type's size: "
+				"btr-addr=%p, ft-addr=%p",
+				btr, field_type);
+			ret = -1;
+			goto end;
+		}
+
+		instr.type = BTR_INSTR_READ_BASIC;
+		instr.u.basic.id = type_id;
+		instr.u.basic.size = (unsigned int) size;
+
+		if (type_id == BT_FIELD_TYPE_ID_ENUM) {
+			/*
+			 * The actual byte order and signedness are the
+			 * ones of the supporting integer type.
+			 */
+			int_field_type =
+				bt_field_type_enumeration_get_container_type(
+					field_type);
+			assert(int_field_type);
+		} else {
+			int_field_type = bt_get(field_type);
+		}
+
+		instr.u.basic.bo = bt_field_type_get_byte_order(
+			int_field_type);
+		instr.u.basic.native_size = size == 8 || size == 16 ||
+			size == 32 || size == 64;
+
+		if (type_id != BT_FIELD_TYPE_ID_FLOAT) {
+			instr.u.basic.is_signed =
+				bt_field_type_integer_is_signed(
+					int_field_type);
+		}
+
+		bt_put(int_field_type);
+		g_array_append_val(instrs, instr);
+		break;
+	}
+	case BT_FIELD_TYPE_ID_STRING:
+		instr.type = BTR_INSTR_READ_STRING;
+		g_array_append_val(instrs, instr);
+		break;
+	case BT_FIELD_TYPE_ID_STRUCT:
+	{
+		int64_t i;
+		int64_t count = bt_field_type_structure_get_field_count(
+			field_type);
+
+		instr.type = BTR_INSTR_BEGIN_STRUCT;
+		g_array_append_val(instrs, instr);
+
+		for (i = 0; i < count; i++) {
+			struct bt_field_type *member_type = NULL;
+
+			ret = bt_field_type_structure_get_field_by_index(
+				field_type, NULL, &member_type, i);
+			if (ret) {
+				BT_LOGW("Cannot get structure field type's field: "
+					"btr-addr=%p, ft-addr=%p, index=%" PRId64,
+					btr, field_type, i);
+				goto end;
+			}
+
+			/* The structure field type keeps its member alive */
+			bt_put(member_type);
+			ret = compile_field_type(btr, member_type, instrs);
+			if (ret) {
+				goto end;
+			}
+		}
+
+		instr.type = BTR_INSTR_END_STRUCT;
+		g_array_append_val(instrs, instr);
+		break;
+	}
+	case BT_FIELD_TYPE_ID_ARRAY:
+	case BT_FIELD_TYPE_ID_SEQUENCE:
+	{
+		struct bt_field_type *elem_type;
+		size_t begin_pc = instrs->len;
+
+		if (type_id == BT_FIELD_TYPE_ID_ARRAY) {
+			instr.type = BTR_INSTR_BEGIN_ARRAY;
+			instr.u.begin_array.length =
+				bt_field_type_array_get_length(field_type);
+			elem_type = bt_field_type_array_get_element_type(
+				field_type);
+		} else {
+			instr.type = BTR_INSTR_BEGIN_SEQUENCE;
+			instr.u.begin_array.length = -1;
+			elem_type = bt_field_type_sequence_get_element_type(
+				field_type);
+		}
+
+		/*
+		 * Elements of an 8-bit integer type which is aligned
+		 * on more than 8 bits are padded: they are not
+		 * contiguous bytes.
+		 */
+		assert(elem_type);
+		instr.u.begin_array.bytes =
+			bt_field_type_get_type_id(elem_type) ==
+				BT_FIELD_TYPE_ID_INTEGER &&
+			bt_field_type_integer_get_size(elem_type) == 8 &&
+			bt_field_type_get_alignment(elem_type) <= 8;
+		g_array_append_val(instrs, instr);
+
+		/* The array/sequence field type keeps its element type alive */
+		bt_put(elem_type);
+		ret = compile_field_type(btr, elem_type, instrs);
+		if (ret) {
+			goto end;
+		}
+
+		g_array_index(instrs, struct btr_instr,
+			begin_pc).u.begin_array.end_pc = instrs->len;
+		instr.type = BTR_INSTR_END_ARRAY;
+		instr.u.end_array.begin_pc = begin_pc;
+		g_array_append_val(instrs, instr);
+		break;
+	}
+	case BT_FIELD_TYPE_ID_VARIANT:
+		/*
+		 * The selected field type is only known when decoding:
+		 * its own program is executed between those two
+		 * instructions.
+		 */
+		instr.type = BTR_INSTR_BEGIN_VARIANT;
+		g_array_append_val(instrs, instr);
+		instr.type = BTR_INSTR_END_VARIANT;
+		g_array_append_val(instrs, instr);
+		break;
+	default:
+		BT_LOGW("Cannot compile field type: unknown field type ID: "
+			"btr-addr=%p, ft-addr=%p, ft-id=%s",
+			btr, field_type, bt_field_type_id_string(type_id));
+		ret = -1;
+		goto end;
+	}
+
+end:
+	return ret;
+}
+
+static
+void program_destroy(struct btr_program *program)
+{
+	if (!program) {
+		return;
+	}
+
+	BT_LOGD("Destroying decode program: addr=%p, ft-addr=%p",
+		program, program->field_type);
+	bt_put(program->field_type);
+
+	if (program->instrs) {
+		g_array_free(program->instrs, TRUE);
+	}
+
+	g_free(program);
+}
+
+static
+struct btr_program *program_create(struct bt_btr *btr,
+		struct bt_field_type *field_type)
+{
+	struct btr_program *program;
+
+	BT_LOGD("Compiling field type: btr-addr=%p, ft-addr=%p, ft-id=%s",
+		btr, field_type, bt_field_type_id_string(
+			bt_field_type_get_type_id(field_type)));
+	program = g_new0(struct btr_program, 1);
+	if (!program) {
+		BT_LOGE_STR("Failed to allocate one decode program.");
+		goto error;
+	}
+
+	program->field_type = bt_get(field_type);
+	program->instrs = g_array_new(FALSE, TRUE, sizeof(struct btr_instr));
+	if (!program->instrs) {
+		BT_LOGE_STR("Failed to allocate a GArray.");
+		goto error;
+	}
+
+	if (compile_field_type(btr, field_type, program->instrs)) {
+		BT_LOGW("Cannot compile field type: btr-addr=%p, ft-addr=%p",
+			btr, field_type);
+		goto error;
+	}
+
+	BT_LOGD("Compiled field type: btr-addr=%p, ft-addr=%p, "
+		"program-addr=%p, instr-count=%u",
+		btr, field_type, program, program->instrs->len);
+	return program;
+
+error:
+	program_destroy(program);
+	return NULL;
+}
+
+/*
+ * Returns the decode program of `field_type`, compiling it if needed.
+ * The returned program is owned by the BTR.
+ */
+static
+struct btr_program *get_program(struct bt_btr *btr,
+		struct bt_field_type *field_type)
+{
+	struct btr_program *program;
+
+	program = g_hash_table_lookup(btr->programs, field_type);
+	if (program) {
+		goto end;
+	}
+
+	program = program_create(btr, field_type);
+	if (!program) {
+		goto end;
+	}
+
+	if (field_type->frozen) {
+		/* A frozen field type cannot change: keep its program */
+		g_hash_table_insert(btr->programs, field_type, program);
+	} else {
+		g_ptr_array_add(btr->tmp_programs, program);
+	}
+
+end:
+	return program;
+}
+
 static
 void stitch_reset(struct bt_btr *btr)
 {
@@ -553,6 +945,109 @@ enum bt_btr_status read_signed_bitfield(const uint8_t *buf, size_t at,
 	return status;
 }
 
+/*
+ * Reads an unsigned integer of `size` bits (8, 16, 32, or 64) starting
+ * at the byte `addr` with a single load.
+ */
+static inline
+uint64_t read_byte_aligned_unsigned(const uint8_t *addr, unsigned int size,
+		enum bt_byte_order bo)
+{
+	bool le = bo == BT_BYTE_ORDER_LITTLE_ENDIAN;
+
+	switch (size) {
+	case 8:
+		return *addr;
+	case 16:
+	{
+		uint16_t v;
+
+		memcpy(&v, addr, sizeof(v));
+		return le ? GUINT16_FROM_LE(v) : GUINT16_FROM_BE(v);
+	}
+	case 32:
+	{
+		uint32_t v;
+
+		memcpy(&v, addr, sizeof(v));
+		return le ? GUINT32_FROM_LE(v) : GUINT32_FROM_BE(v);
+	}
+	case 64:
+	{
+		uint64_t v;
+
+		memcpy(&v, addr, sizeof(v));
+		return le ? GUINT64_FROM_LE(v) : GUINT64_FROM_BE(v);
+	}
+	default:
+		abort();
+	}
+}
+
+static inline
+int64_t sign_extend(uint64_t v, unsigned int size)
+{
+	switch (size) {
+	case 8:
+		return (int64_t) (int8_t) v;
+	case 16:
+		return (int64_t) (int16_t) v;
+	case 32:
+		return (int64_t) (int32_t) v;
+	case 64:
+		return (int64_t) v;
+	default:
+		abort();
+	}
+}
+
+static inline
+bool can_read_byte_aligned(struct btr_instr *instr, size_t at)
+{
+	return instr->u.basic.native_size && IN_BYTE_OFFSET(at) == 0;
+}
+
+/*
+ * Reads the unsigned bit array of the basic field of `instr` at `at`
+ * within `buf`, using a single load when possible.
+ */
+static inline
+enum bt_btr_status read_instr_unsigned(struct btr_instr *instr,
+		const uint8_t *buf, size_t at, uint64_t *v)
+{
+	if (can_read_byte_aligned(instr, at)) {
+		*v = read_byte_aligned_unsigned(&buf[DIV8(at)],
+			instr->u.basic.size, instr->u.basic.bo);
+		BT_LOGV("Read byte-aligned unsigned integer: cur=%zu, "
+			"size=%u, bo=%s, val=%" PRIu64, at,
+			instr->u.basic.size,
+			bt_byte_order_string(instr->u.basic.bo), *v);
+		return BT_BTR_STATUS_OK;
+	}
+
+	return read_unsigned_bitfield(buf, at, instr->u.basic.size,
+		instr->u.basic.bo, v);
+}
+
+static inline
+enum bt_btr_status read_instr_signed(struct btr_instr *instr,
+		const uint8_t *buf, size_t at, int64_t *v)
+{
+	if (can_read_byte_aligned(instr, at)) {
+		*v = sign_extend(read_byte_aligned_unsigned(&buf[DIV8(at)],
+			instr->u.basic.size, instr->u.basic.bo),
+			instr->u.basic.size);
+		BT_LOGV("Read byte-aligned signed integer: cur=%zu, "
+			"size=%u, bo=%s, val=%" PRId64, at,
+			instr->u.basic.size,
+			bt_byte_order_string(instr->u.basic.bo), *v);
+		return BT_BTR_STATUS_OK;
+	}
+
+	return read_signed_bitfield(buf, at, instr->u.basic.size,
+		instr->u.basic.bo, v);
+}
+
 typedef enum bt_btr_status (* read_basic_and_call_cb_t)(struct bt_btr *,
 		const uint8_t *, size_t);
 
@@ -610,17 +1105,13 @@ static
 enum bt_btr_status read_basic_float_and_call_cb(struct bt_btr *btr,
 		const uint8_t *buf, size_t at)
 {
-	int ret;
 	double dblval;
-	int64_t field_size;
-	enum bt_byte_order bo;
+	struct btr_instr *instr = btr->cur_instr;
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 
-	field_size = get_basic_field_type_size(btr, btr->cur_basic_field_type);
-	bo = bt_field_type_get_byte_order(btr->cur_basic_field_type);
-	btr->cur_bo = bo;
+	btr->cur_bo = instr->u.basic.bo;
 
-	switch (field_size) {
+	switch (instr->u.basic.size) {
 	case 32:
 	{
 		uint64_t v;
@@ -629,13 +1120,7 @@ enum bt_btr_status read_basic_float_and_call_cb(struct bt_btr *btr,
 			float f;
 		} f32;
 
-		ret = bt_field_type_floating_point_get_mantissa_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 24);
-		ret = bt_field_type_floating_point_get_exponent_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 8);
-		status = read_unsigned_bitfield(buf, at, field_size, bo, &v);
+		status = read_instr_unsigned(instr, buf, at, &v);
 		if (status != BT_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read unsigned 32-bit bit array for floating point number field: "
 				"btr-addr=%p, status=%s",
@@ -654,14 +1139,7 @@ enum bt_btr_status read_basic_float_and_call_cb(struct bt_btr *btr,
 			double d;
 		} f64;
 
-		ret = bt_field_type_floating_point_get_mantissa_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 53);
-		ret = bt_field_type_floating_point_get_exponent_digits(
-			btr->cur_basic_field_type);
-		assert(ret == 11);
-		status = read_unsigned_bitfield(buf, at, field_size, bo,
-			&f64.u);
+		status = read_instr_unsigned(instr, buf, at, &f64.u);
 		if (status != BT_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read unsigned 64-bit bit array for floating point number field: "
 				"btr-addr=%p, status=%s",
@@ -686,7 +1164,7 @@ enum bt_btr_status read_basic_float_and_call_cb(struct bt_btr *btr,
 	if (btr->user.cbs.types.floating_point) {
 		BT_LOGV("Calling user function (floating point number).");
 		status = btr->user.cbs.types.floating_point(dblval,
-			btr->cur_basic_field_type, btr->user.data);
+			instr->field_type, btr->user.data);
 		BT_LOGV("User function returned: status=%s",
 			bt_btr_status_string(status));
 		if (status != BT_BTR_STATUS_OK) {
@@ -699,40 +1177,23 @@ end:
 	return status;
 }
 
-static inline
-enum bt_btr_status read_basic_int_and_call(struct bt_btr *btr,
-		const uint8_t *buf, size_t at,
-		struct bt_field_type *int_type,
-		struct bt_field_type *orig_type)
+static
+enum bt_btr_status read_basic_int_and_call_cb(struct bt_btr *btr,
+		const uint8_t *buf, size_t at)
 {
-	bt_bool signd;
-	int64_t field_size;
-	enum bt_byte_order bo;
+	struct btr_instr *instr = btr->cur_instr;
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 
-	signd = bt_field_type_integer_is_signed(int_type);
-	field_size = get_basic_field_type_size(btr, int_type);
-	if (field_size < 1) {
-		BT_LOGW("Cannot get integer field type's size: "
-			"btr=%p, at=%zu, ft-addr=%p",
-			btr, at, int_type);
-		status = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	bo = bt_field_type_get_byte_order(int_type);
-
 	/*
-	 * Update current byte order now because we could be reading
-	 * the integer value of an enumeration type, and thus we know
-	 * here the actual supporting integer type's byte order.
+	 * Update current byte order now: for an enumeration field, this
+	 * is the byte order of its supporting integer type.
 	 */
-	btr->cur_bo = bo;
+	btr->cur_bo = instr->u.basic.bo;
 
-	if (signd) {
+	if (instr->u.basic.is_signed) {
 		int64_t v;
 
-		status = read_signed_bitfield(buf, at, field_size, bo, &v);
+		status = read_instr_signed(instr, buf, at, &v);
 		if (status != BT_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read signed bit array for signed integer field: "
 				"btr-addr=%p, status=%s",
@@ -743,7 +1204,7 @@ enum bt_btr_status read_basic_int_and_call(struct bt_btr *btr,
 		if (btr->user.cbs.types.signed_int) {
 			BT_LOGV("Calling user function (signed integer).");
 			status = btr->user.cbs.types.signed_int(v,
-				btr->cur_basic_field_type, btr->user.data);
+				instr->field_type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_btr_status_string(status));
 			if (status != BT_BTR_STATUS_OK) {
@@ -755,7 +1216,7 @@ enum bt_btr_status read_basic_int_and_call(struct bt_btr *btr,
 	} else {
 		uint64_t v;
 
-		status = read_unsigned_bitfield(buf, at, field_size, bo, &v);
+		status = read_instr_unsigned(instr, buf, at, &v);
 		if (status != BT_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read unsigned bit array for unsigned integer field: "
 				"btr-addr=%p, status=%s",
@@ -766,7 +1227,7 @@ enum bt_btr_status read_basic_int_and_call(struct bt_btr *btr,
 		if (btr->user.cbs.types.unsigned_int) {
 			BT_LOGV("Calling user function (unsigned integer).");
 			status = btr->user.cbs.types.unsigned_int(v,
-				btr->cur_basic_field_type, btr->user.data);
+				instr->field_type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_btr_status_string(status));
 			if (status != BT_BTR_STATUS_OK) {
@@ -781,30 +1242,6 @@ end:
 	return status;
 }
 
-static
-enum bt_btr_status read_basic_int_and_call_cb(struct bt_btr *btr,
-		const uint8_t *buf, size_t at)
-{
-	return read_basic_int_and_call(btr, buf, at, btr->cur_basic_field_type,
-		btr->cur_basic_field_type);
-}
-
-static
-enum bt_btr_status read_basic_enum_and_call_cb(struct bt_btr *btr,
-		const uint8_t *buf, size_t at)
-{
-	struct bt_field_type *int_field_type;
-	enum bt_btr_status status = BT_BTR_STATUS_OK;
-
-	int_field_type = bt_field_type_enumeration_get_container_type(
-		btr->cur_basic_field_type);
-	assert(int_field_type);
-	status = read_basic_int_and_call(btr, buf, at,
-		int_field_type, btr->cur_basic_field_type);
-	bt_put(int_field_type);
-	return status;
-}
-
 static inline
 enum bt_btr_status read_basic_type_and_call_continue(struct bt_btr *btr,
 		read_basic_and_call_cb_t read_basic_and_call_cb)
@@ -820,15 +1257,7 @@ enum bt_btr_status read_basic_type_and_call_continue(struct bt_btr *btr,
 		goto end;
 	}
 
-	field_size = get_basic_field_type_size(btr, btr->cur_basic_field_type);
-	if (field_size < 1) {
-		BT_LOGW("Cannot get basic field type's size: "
-			"btr-addr=%p, ft-addr=%p",
-			btr, btr->cur_basic_field_type);
-		status = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
-
+	field_size = btr->cur_instr->u.basic.size;
 	available = available_bits(btr);
 	needed_bits = field_size - btr->stitch.at;
 	BT_LOGV("Continuing basic field decoding: "
@@ -843,20 +1272,14 @@ enum bt_btr_status read_basic_type_and_call_continue(struct bt_btr *btr,
 		if (status != BT_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read basic field: "
 				"btr-addr=%p, ft-addr=%p, status=%s",
-				btr, btr->cur_basic_field_type,
+				btr, btr->cur_instr->field_type,
 				bt_btr_status_string(status));
 			goto end;
 		}
 
-		if (stack_empty(btr->stack)) {
-			/* Root is a basic type */
-			btr->state = BTR_STATE_DONE;
-		} else {
-			/* Go to next field */
-			stack_top(btr->stack)->index++;
-			btr->state = BTR_STATE_NEXT_FIELD;
-			btr->last_bo = btr->cur_bo;
-		}
+		/* Go to next field */
+		btr->state = BTR_STATE_NEXT_FIELD;
+		btr->last_bo = btr->cur_bo;
 		goto end;
 	}
 
@@ -875,7 +1298,6 @@ enum bt_btr_status read_basic_type_and_call_begin(struct bt_btr *btr,
 {
 	size_t available;
 	int64_t field_size;
-	enum bt_byte_order bo;
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 
 	if (!at_least_one_bit_left(btr)) {
@@ -884,17 +1306,8 @@ enum bt_btr_status read_basic_type_and_call_begin(struct bt_btr *btr,
 		goto end;
 	}
 
-	field_size = get_basic_field_type_size(btr, btr->cur_basic_field_type);
-	if (field_size < 1) {
-		BT_LOGW("Cannot get basic field type's size: "
-			"btr-addr=%p, ft-addr=%p",
-			btr, btr->cur_basic_field_type);
-		status = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	bo = bt_field_type_get_byte_order(btr->cur_basic_field_type);
-	status = validate_contiguous_bo(btr, bo);
+	field_size = btr->cur_instr->u.basic.size;
+	status = validate_contiguous_bo(btr, btr->cur_instr->u.basic.bo);
 	if (status != BT_BTR_STATUS_OK) {
 		/* validate_contiguous_bo() logs errors */
 		goto end;
@@ -910,23 +1323,16 @@ enum bt_btr_status read_basic_type_and_call_begin(struct bt_btr *btr,
 		if (status != BT_BTR_STATUS_OK) {
 			BT_LOGW("Cannot read basic field: "
 				"btr-addr=%p, ft-addr=%p, status=%s",
-				btr, btr->cur_basic_field_type,
+				btr, btr->cur_instr->field_type,
 				bt_btr_status_string(status));
 			goto end;
 		}
 
 		consume_bits(btr, field_size);
 
-		if (stack_empty(btr->stack)) {
-			/* Root is a basic type */
-			btr->state = BTR_STATE_DONE;
-		} else {
-			/* Go to next field */
-			stack_top(btr->stack)->index++;
-			btr->state = BTR_STATE_NEXT_FIELD;
-			btr->last_bo = btr->cur_bo;
-		}
-
+		/* Go to next field */
+		btr->state = BTR_STATE_NEXT_FIELD;
+		btr->last_bo = btr->cur_bo;
 		goto end;
 	}
 
@@ -940,53 +1346,6 @@ end:
 	return status;
 }
 
-static inline
-enum bt_btr_status read_basic_int_type_and_call_begin(
-		struct bt_btr *btr)
-{
-	return read_basic_type_and_call_begin(btr, read_basic_int_and_call_cb);
-}
-
-static inline
-enum bt_btr_status read_basic_int_type_and_call_continue(
-		struct bt_btr *btr)
-{
-	return read_basic_type_and_call_continue(btr,
-		read_basic_int_and_call_cb);
-}
-
-static inline
-enum bt_btr_status read_basic_float_type_and_call_begin(
-		struct bt_btr *btr)
-{
-	return read_basic_type_and_call_begin(btr,
-		read_basic_float_and_call_cb);
-}
-
-static inline
-enum bt_btr_status read_basic_float_type_and_call_continue(
-		struct bt_btr *btr)
-{
-	return read_basic_type_and_call_continue(btr,
-		read_basic_float_and_call_cb);
-}
-
-static inline
-enum bt_btr_status read_basic_enum_type_and_call_begin(
-		struct bt_btr *btr)
-{
-	return read_basic_type_and_call_begin(btr,
-		read_basic_enum_and_call_cb);
-}
-
-static inline
-enum bt_btr_status read_basic_enum_type_and_call_continue(
-		struct bt_btr *btr)
-{
-	return read_basic_type_and_call_continue(btr,
-		read_basic_enum_and_call_cb);
-}
-
 static inline
 enum bt_btr_status read_basic_string_type_and_call(
 		struct bt_btr *btr, bool begin)
@@ -995,6 +1354,7 @@ enum bt_btr_status read_basic_string_type_and_call(
 	const uint8_t *result;
 	size_t available_bytes;
 	const uint8_t *first_chr;
+	struct bt_field_type *field_type = btr->cur_instr->field_type;
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 
 	if (!at_least_one_bit_left(btr)) {
@@ -1013,7 +1373,7 @@ enum bt_btr_status read_basic_string_type_and_call(
 	if (begin && btr->user.cbs.types.string_begin) {
 		BT_LOGV("Calling user function (string, beginning).");
 		status = btr->user.cbs.types.string_begin(
-			btr->cur_basic_field_type, btr->user.data);
+			field_type, btr->user.data);
 		BT_LOGV("User function returned: status=%s",
 			bt_btr_status_string(status));
 		if (status != BT_BTR_STATUS_OK) {
@@ -1029,7 +1389,7 @@ enum bt_btr_status read_basic_string_type_and_call(
 			BT_LOGV("Calling user function (substring).");
 			status = btr->user.cbs.types.string(
 				(const char *) first_chr,
-				available_bytes, btr->cur_basic_field_type,
+				available_bytes, field_type,
 				btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_btr_status_string(status));
@@ -1052,7 +1412,7 @@ enum bt_btr_status read_basic_string_type_and_call(
 			BT_LOGV("Calling user function (substring).");
 			status = btr->user.cbs.types.string(
 				(const char *) first_chr,
-				result_len, btr->cur_basic_field_type,
+				result_len, field_type,
 				btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_btr_status_string(status));
@@ -1067,7 +1427,7 @@ enum bt_btr_status read_basic_string_type_and_call(
 		if (btr->user.cbs.types.string_end) {
 			BT_LOGV("Calling user function (string, end).");
 			status = btr->user.cbs.types.string_end(
-				btr->cur_basic_field_type, btr->user.data);
+				field_type, btr->user.data);
 			BT_LOGV("User function returned: status=%s",
 				bt_btr_status_string(status));
 			if (status != BT_BTR_STATUS_OK) {
@@ -1080,15 +1440,9 @@ enum bt_btr_status read_basic_string_type_and_call(
 
 		consume_bits(btr, BYTES_TO_BITS(result_len + 1));
 
-		if (stack_empty(btr->stack)) {
-			/* Root is a basic type */
-			btr->state = BTR_STATE_DONE;
-		} else {
-			/* Go to next field */
-			stack_top(btr->stack)->index++;
-			btr->state = BTR_STATE_NEXT_FIELD;
-			btr->last_bo = btr->cur_bo;
-		}
+		/* Go to next field */
+		btr->state = BTR_STATE_NEXT_FIELD;
+		btr->last_bo = btr->cur_bo;
 	}
 
 end:
@@ -1100,28 +1454,27 @@ enum bt_btr_status read_basic_begin_state(struct bt_btr *btr)
 {
 	enum bt_btr_status status;
 
-	assert(btr->cur_basic_field_type);
+	assert(btr->cur_instr);
+
+	if (btr->cur_instr->type == BTR_INSTR_READ_STRING) {
+		return read_basic_string_type_and_call(btr, true);
+	}
 
-	switch (bt_field_type_get_type_id(btr->cur_basic_field_type)) {
+	switch (btr->cur_instr->u.basic.id) {
 	case BT_FIELD_TYPE_ID_INTEGER:
-		status = read_basic_int_type_and_call_begin(btr);
-		break;
-	case BT_FIELD_TYPE_ID_FLOAT:
-		status = read_basic_float_type_and_call_begin(btr);
-		break;
 	case BT_FIELD_TYPE_ID_ENUM:
-		status = read_basic_enum_type_and_call_begin(btr);
+		status = read_basic_type_and_call_begin(btr,
+			read_basic_int_and_call_cb);
 		break;
-	case BT_FIELD_TYPE_ID_STRING:
-		status = read_basic_string_type_and_call(btr, true);
+	case BT_FIELD_TYPE_ID_FLOAT:
+		status = read_basic_type_and_call_begin(btr,
+			read_basic_float_and_call_cb);
 		break;
 	default:
 		BT_LOGF("Unknown basic field type ID: "
 			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, btr->cur_basic_field_type,
-			bt_field_type_id_string(
-				bt_field_type_get_type_id(
-					btr->cur_basic_field_type)));
+			btr, btr->cur_instr->field_type,
+			bt_field_type_id_string(btr->cur_instr->u.basic.id));
 		abort();
 	}
 
@@ -1133,28 +1486,27 @@ enum bt_btr_status read_basic_continue_state(struct bt_btr *btr)
 {
 	enum bt_btr_status status;
 
-	assert(btr->cur_basic_field_type);
+	assert(btr->cur_instr);
 
-	switch (bt_field_type_get_type_id(btr->cur_basic_field_type)) {
+	if (btr->cur_instr->type == BTR_INSTR_READ_STRING) {
+		return read_basic_string_type_and_call(btr, false);
+	}
+
+	switch (btr->cur_instr->u.basic.id) {
 	case BT_FIELD_TYPE_ID_INTEGER:
-		status = read_basic_int_type_and_call_continue(btr);
-		break;
-	case BT_FIELD_TYPE_ID_FLOAT:
-		status = read_basic_float_type_and_call_continue(btr);
-		break;
 	case BT_FIELD_TYPE_ID_ENUM:
-		status = read_basic_enum_type_and_call_continue(btr);
+		status = read_basic_type_and_call_continue(btr,
+			read_basic_int_and_call_cb);
 		break;
-	case BT_FIELD_TYPE_ID_STRING:
-		status = read_basic_string_type_and_call(btr, false);
+	case BT_FIELD_TYPE_ID_FLOAT:
+		status = read_basic_type_and_call_continue(btr,
+			read_basic_float_and_call_cb);
 		break;
 	default:
 		BT_LOGF("Unknown basic field type ID: "
 			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, btr->cur_basic_field_type,
-			bt_field_type_id_string(
-				bt_field_type_get_type_id(
-					btr->cur_basic_field_type)));
+			btr, btr->cur_instr->field_type,
+			bt_field_type_id_string(btr->cur_instr->u.basic.id));
 		abort();
 	}
 
@@ -1172,32 +1524,11 @@ size_t bits_to_skip_to_align_to(struct bt_btr *btr, size_t align)
 
 static inline
 enum bt_btr_status align_type_state(struct bt_btr *btr,
-		struct bt_field_type *field_type, enum btr_state next_state)
+		unsigned int field_alignment, enum btr_state next_state)
 {
-	int field_alignment;
 	size_t skip_bits;
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 
-	/* Get field's alignment */
-	field_alignment = bt_field_type_get_alignment(field_type);
-	if (field_alignment < 0) {
-		BT_LOGW("Cannot get field type's alignment: "
-			"btr-addr=%p, ft-addr=%p, ft-id=%s",
-			btr, field_type,
-			bt_field_type_id_string(
-				bt_field_type_get_type_id(field_type)));
-		status = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
-
-	/*
-	 * 0 means "undefined" for variants; what we really want is 1
-	 * (always aligned)
-	 */
-	if (field_alignment == 0) {
-		field_alignment = 1;
-	}
-
 	/* Compute how many bits we need to skip */
 	skip_bits = bits_to_skip_to_align_to(btr, field_alignment);
 
@@ -1233,43 +1564,150 @@ end:
 }
 
 static inline
-bool is_compound_type(struct bt_field_type *field_type)
+enum bt_btr_status call_compound_begin(struct bt_btr *btr,
+		struct bt_field_type *field_type)
 {
-	enum bt_field_type_id id = bt_field_type_get_type_id(field_type);
+	enum bt_btr_status status = BT_BTR_STATUS_OK;
+
+	if (btr->user.cbs.types.compound_begin) {
+		BT_LOGV("Calling user function (compound, begin).");
+		status = btr->user.cbs.types.compound_begin(
+			field_type, btr->user.data);
+		BT_LOGV("User function returned: status=%s",
+			bt_btr_status_string(status));
+		if (status != BT_BTR_STATUS_OK) {
+			BT_LOGW("User function failed: btr-addr=%p, status=%s",
+				btr, bt_btr_status_string(status));
+		}
+	}
 
-	return id == BT_FIELD_TYPE_ID_STRUCT || id == BT_FIELD_TYPE_ID_ARRAY ||
-		id == BT_FIELD_TYPE_ID_SEQUENCE || id == BT_FIELD_TYPE_ID_VARIANT;
+	return status;
 }
 
 static inline
-enum bt_btr_status next_field_state(struct bt_btr *btr)
+enum bt_btr_status call_compound_end(struct bt_btr *btr,
+		struct bt_field_type *field_type)
 {
-	int ret;
-	struct stack_entry *top;
-	struct bt_field_type *next_field_type = NULL;
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 
-	if (stack_empty(btr->stack)) {
+	if (btr->user.cbs.types.compound_end) {
+		BT_LOGV("Calling user function (compound, end).");
+		status = btr->user.cbs.types.compound_end(
+			field_type, btr->user.data);
+		BT_LOGV("User function returned: status=%s",
+			bt_btr_status_string(status));
+		if (status != BT_BTR_STATUS_OK) {
+			BT_LOGW("User function failed: btr-addr=%p, status=%s",
+				btr, bt_btr_status_string(status));
+		}
+	}
+
+	return status;
+}
+
+static
+enum bt_btr_status begin_variant(struct bt_btr *btr,
+		struct btr_instr *instr)
+{
+	struct bt_field_type *selected_type;
+	struct btr_program *program;
+	enum bt_btr_status status;
+
+	status = call_compound_begin(btr, instr->field_type);
+	if (status != BT_BTR_STATUS_OK) {
+		goto end;
+	}
+
+	/* Variant types are dynamic: query the user, he should know! */
+	selected_type = btr->user.cbs.query.get_variant_type(
+		instr->field_type, btr->user.data);
+	if (!selected_type) {
+		BT_LOGW("Cannot get the selected field type of variant field: "
+			"btr-addr=%p, ft-addr=%p", btr, instr->field_type);
+		status = BT_BTR_STATUS_ERROR;
+		goto end;
+	}
+
+	program = get_program(btr, selected_type);
+	bt_put(selected_type);
+	if (!program) {
+		status = BT_BTR_STATUS_ERROR;
+		goto end;
+	}
+
+	/* Execute the selected field type's program, then END_VARIANT */
+	stack_push(btr->stack, program);
+	btr->cur_compound_alignment = instr->alignment;
+	btr->state = BTR_STATE_ALIGN_COMPOUND;
+
+end:
+	return status;
+}
+
+/*
+ * Passes all the elements of the current array/sequence field of 8-bit
+ * integers to the `byte_array` user function if they start on a byte
+ * boundary and are all within the current buffer, marking the loop of
+ * its BTR_INSTR_END_ARRAY instruction as done. Otherwise, the elements
+ * are decoded one by one, as usual.
+ */
+static inline
+enum bt_btr_status read_bytes_state(struct bt_btr *btr)
+{
+	struct btr_instr *instr = btr->cur_instr;
+	int64_t *remaining = stack_top_loop(btr->stack);
+	size_t at = buf_at_from_addr(btr);
+	enum bt_btr_status status = BT_BTR_STATUS_OK;
+
+	/* Next state is the same in any case: execute END_ARRAY */
+	btr->state = BTR_STATE_NEXT_FIELD;
+
+	if (at % 8 != 0 ||
+			(uint64_t) *remaining > available_bits(btr) / 8) {
+		BT_LOGV("Cannot pass array/sequence field's elements at once: "
+			"btr-addr=%p, ft-addr=%p, buf-at=%zu, "
+			"remaining-elems=%" PRId64 ", available-size=%zu",
+			btr, instr->field_type, at, *remaining,
+			available_bits(btr));
 		goto end;
 	}
 
-	top = stack_top(btr->stack);
+	assert(btr->buf.addr);
+	BT_LOGV("Calling user function (byte array): length=%" PRId64,
+		*remaining);
+	status = btr->user.cbs.types.byte_array(&btr->buf.addr[at / 8],
+		(size_t) *remaining, instr->field_type, btr->user.data);
+	BT_LOGV("User function returned: status=%s",
+		bt_btr_status_string(status));
+	if (status != BT_BTR_STATUS_OK) {
+		BT_LOGW("User function failed: btr-addr=%p, status=%s",
+			btr, bt_btr_status_string(status));
+		goto end;
+	}
 
-	/* Are we done with this base type? */
-	while (top->index == top->base_len) {
-		if (btr->user.cbs.types.compound_end) {
-			BT_LOGV("Calling user function (compound, end).");
-			status = btr->user.cbs.types.compound_end(
-				top->base_type, btr->user.data);
-			BT_LOGV("User function returned: status=%s",
-				bt_btr_status_string(status));
-			if (status != BT_BTR_STATUS_OK) {
-				BT_LOGW("User function failed: btr-addr=%p, status=%s",
-					btr, bt_btr_status_string(status));
-				goto end;
-			}
-		}
+	consume_bits(btr, *remaining * 8);
+	*remaining = 0;
+
+	/* The next field, if any, also starts on a byte boundary */
+	btr->last_bo = BT_BYTE_ORDER_UNKNOWN;
+
+end:
+	return status;
+}
+
+static inline
+enum bt_btr_status next_field_state(struct bt_btr *btr)
+{
+	struct stack_entry *top;
+	struct btr_instr *instr;
+	int64_t *remaining;
+	enum bt_btr_status status = BT_BTR_STATUS_OK;
+
+	assert(!stack_empty(btr->stack));
+	top = stack_top(btr->stack);
 
+	/* Are we done with this program? */
+	while (top->pc == top->program->instrs->len) {
 		stack_pop(btr->stack);
 
 		/* Are we done with the root type? */
@@ -1279,89 +1717,91 @@ enum bt_btr_status next_field_state(struct bt_btr *btr)
 		}
 
 		top = stack_top(btr->stack);
-		top->index++;
 	}
 
-	/* Get next field's type */
-	switch (bt_field_type_get_type_id(top->base_type)) {
-	case BT_FIELD_TYPE_ID_STRUCT:
-		ret = bt_field_type_structure_get_field_by_index(
-			top->base_type, NULL, &next_field_type,
-			top->index);
-		if (ret) {
-			next_field_type = NULL;
-		}
-		break;
-	case BT_FIELD_TYPE_ID_ARRAY:
-		next_field_type =
-			bt_field_type_array_get_element_type(
-				top->base_type);
-		break;
-	case BT_FIELD_TYPE_ID_SEQUENCE:
-		next_field_type =
-			bt_field_type_sequence_get_element_type(
-				top->base_type);
+	instr = &g_array_index(top->program->instrs, struct btr_instr,
+		top->pc);
+	BT_LOGV("Executing instruction: btr-addr=%p, program-addr=%p, "
+		"pc=%zu, instr-type=%s, ft-addr=%p",
+		btr, top->program, top->pc,
+		btr_instr_type_string(instr->type), instr->field_type);
+	top->pc++;
+
+	switch (instr->type) {
+	case BTR_INSTR_READ_BASIC:
+	case BTR_INSTR_READ_STRING:
+		btr->cur_instr = instr;
+		btr->state = BTR_STATE_ALIGN_BASIC;
 		break;
-	case BT_FIELD_TYPE_ID_VARIANT:
-		/* Variant types are dynamic: query the user, he should know! */
-		next_field_type =
-			btr->user.cbs.query.get_variant_type(
-				top->base_type, btr->user.data);
+	case BTR_INSTR_BEGIN_STRUCT:
+		status = call_compound_begin(btr, instr->field_type);
+		btr->cur_compound_alignment = instr->alignment;
+		btr->state = BTR_STATE_ALIGN_COMPOUND;
 		break;
-	default:
+	case BTR_INSTR_END_STRUCT:
+	case BTR_INSTR_END_VARIANT:
+		status = call_compound_end(btr, instr->field_type);
 		break;
-	}
+	case BTR_INSTR_BEGIN_ARRAY:
+	case BTR_INSTR_BEGIN_SEQUENCE:
+	{
+		int64_t length = instr->u.begin_array.length;
 
-	if (!next_field_type) {
-		BT_LOGW("Cannot get the field type of the next field: "
-			"btr-addr=%p, base-ft-addr=%p, base-ft-id=%s, "
-			"index=%" PRId64,
-			btr, top->base_type,
-			bt_field_type_id_string(
-				bt_field_type_get_type_id(top->base_type)),
-			top->index);
-		status = BT_BTR_STATUS_ERROR;
-		goto end;
-	}
+		status = call_compound_begin(btr, instr->field_type);
+		if (status != BT_BTR_STATUS_OK) {
+			goto end;
+		}
 
-	if (is_compound_type(next_field_type)) {
-		if (btr->user.cbs.types.compound_begin) {
-			BT_LOGV("Calling user function (compound, begin).");
-			status = btr->user.cbs.types.compound_begin(
-				next_field_type, btr->user.data);
-			BT_LOGV("User function returned: status=%s",
-				bt_btr_status_string(status));
-			if (status != BT_BTR_STATUS_OK) {
-				BT_LOGW("User function failed: btr-addr=%p, status=%s",
-					btr, bt_btr_status_string(status));
+		if (instr->type == BTR_INSTR_BEGIN_SEQUENCE) {
+			length = btr->user.cbs.query.get_sequence_length(
+				instr->field_type, btr->user.data);
+			if (length < 0) {
+				BT_LOGW("Cannot get sequence field's length: "
+					"btr-addr=%p, ft-addr=%p",
+					btr, instr->field_type);
+				status = BT_BTR_STATUS_ERROR;
 				goto end;
 			}
 		}
 
-		ret = stack_push_with_len(btr, next_field_type);
-		if (ret) {
-			/* stack_push_with_len() logs errors */
-			status = BT_BTR_STATUS_ERROR;
-			goto end;
+		/* Jump to END_ARRAY which loops over the elements */
+		stack_push_loop(btr->stack, length);
+		top->pc = instr->u.begin_array.end_pc;
+		btr->cur_compound_alignment = instr->alignment;
+
+		if (instr->u.begin_array.bytes && length > 0 &&
+				btr->user.cbs.types.byte_array) {
+			btr->cur_instr = instr;
+			btr->state = BTR_STATE_ALIGN_BYTES;
+		} else {
+			btr->state = BTR_STATE_ALIGN_COMPOUND;
 		}
 
-		/* Next state: align a compound type */
-		btr->state = BTR_STATE_ALIGN_COMPOUND;
-	} else {
-		/* Replace current basic field type */
-		BT_LOGV("Replacing current basic field type: "
-			"btr-addr=%p, cur-basic-ft-addr=%p, "
-			"next-basic-ft-addr=%p",
-			btr, btr->cur_basic_field_type, next_field_type);
-		BT_MOVE(btr->cur_basic_field_type, next_field_type);
-
-		/* Next state: align a basic type */
-		btr->state = BTR_STATE_ALIGN_BASIC;
+		break;
 	}
+	case BTR_INSTR_END_ARRAY:
+		remaining = stack_top_loop(btr->stack);
 
-end:
-	BT_PUT(next_field_type);
+		if (*remaining > 0) {
+			/* Next element */
+			(*remaining)--;
+			top->pc = instr->u.end_array.begin_pc + 1;
+			break;
+		}
+
+		stack_pop_loop(btr->stack);
+		status = call_compound_end(btr, instr->field_type);
+		break;
+	case BTR_INSTR_BEGIN_VARIANT:
+		status = begin_variant(btr, instr);
+		break;
+	default:
+		BT_LOGF("Unknown decode instruction type: btr-addr=%p, "
+			"instr-type=%d", btr, instr->type);
+		abort();
+	}
 
+end:
 	return status;
 }
 
@@ -1378,11 +1818,11 @@ enum bt_btr_status handle_state(struct bt_btr *btr)
 		status = next_field_state(btr);
 		break;
 	case BTR_STATE_ALIGN_BASIC:
-		status = align_type_state(btr, btr->cur_basic_field_type,
+		status = align_type_state(btr, btr->cur_instr->alignment,
 			BTR_STATE_READ_BASIC_BEGIN);
 		break;
 	case BTR_STATE_ALIGN_COMPOUND:
-		status = align_type_state(btr, stack_top(btr->stack)->base_type,
+		status = align_type_state(btr, btr->cur_compound_alignment,
 			BTR_STATE_NEXT_FIELD);
 		break;
 	case BTR_STATE_READ_BASIC_BEGIN:
@@ -1391,6 +1831,13 @@ enum bt_btr_status handle_state(struct bt_btr *btr)
 	case BTR_STATE_READ_BASIC_CONTINUE:
 		status = read_basic_continue_state(btr);
 		break;
+	case BTR_STATE_ALIGN_BYTES:
+		status = align_type_state(btr, btr->cur_compound_alignment,
+			BTR_STATE_READ_BYTES);
+		break;
+	case BTR_STATE_READ_BYTES:
+		status = read_bytes_state(btr);
+		break;
 	case BTR_STATE_DONE:
 		break;
 	}
@@ -1419,6 +1866,24 @@ struct bt_btr *bt_btr_create(struct bt_btr_cbs cbs, void *data)
 		goto end;
 	}
 
+	btr->programs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+		NULL, (GDestroyNotify) program_destroy);
+	if (!btr->programs) {
+		BT_LOGE_STR("Failed to allocate a GHashTable.");
+		bt_btr_destroy(btr);
+		btr = NULL;
+		goto end;
+	}
+
+	btr->tmp_programs = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) program_destroy);
+	if (!btr->tmp_programs) {
+		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		bt_btr_destroy(btr);
+		btr = NULL;
+		goto end;
+	}
+
 	btr->state = BTR_STATE_NEXT_FIELD;
 	btr->user.cbs = cbs;
 	btr->user.data = data;
@@ -1435,7 +1900,15 @@ void bt_btr_destroy(struct bt_btr *btr)
 	}
 
 	BT_LOGD("Destroying BTR: addr=%p", btr);
-	BT_PUT(btr->cur_basic_field_type);
+
+	if (btr->programs) {
+		g_hash_table_destroy(btr->programs);
+	}
+
+	if (btr->tmp_programs) {
+		g_ptr_array_free(btr->tmp_programs, TRUE);
+	}
+
 	g_free(btr);
 }
 
@@ -1444,7 +1917,11 @@ void reset(struct bt_btr *btr)
 {
 	BT_LOGD("Resetting BTR: addr=%p", btr);
 	stack_clear(btr->stack);
-	BT_PUT(btr->cur_basic_field_type);
+	btr->cur_instr = NULL;
+	if (btr->tmp_programs->len > 0) {
+		g_ptr_array_remove_range(btr->tmp_programs, 0,
+			btr->tmp_programs->len);
+	}
 	stitch_reset(btr);
 	btr->buf.addr = NULL;
 	btr->last_bo = BT_BYTE_ORDER_UNKNOWN;
@@ -1465,6 +1942,8 @@ size_t bt_btr_start(struct bt_btr *btr,
 	size_t offset, size_t packet_offset, size_t sz,
 	enum bt_btr_status *status)
 {
+	struct btr_program *program;
+
 	assert(btr);
 	assert(BYTES_TO_BITS(sz) >= offset);
 	reset(btr);
@@ -1481,39 +1960,17 @@ size_t bt_btr_start(struct bt_btr *btr,
 		"packet-offset=%zu",
 		btr, type, buf, sz, offset, packet_offset);
 
-	/* Set root type */
-	if (is_compound_type(type)) {
-		/* Compound type: push on visit stack */
-		int stack_ret;
-
-		if (btr->user.cbs.types.compound_begin) {
-			BT_LOGV("Calling user function (compound, begin).");
-			*status = btr->user.cbs.types.compound_begin(
-				type, btr->user.data);
-			BT_LOGV("User function returned: status=%s",
-				bt_btr_status_string(*status));
-			if (*status != BT_BTR_STATUS_OK) {
-				BT_LOGW("User function failed: btr-addr=%p, status=%s",
-					btr, bt_btr_status_string(*status));
-				goto end;
-			}
-		}
-
-		stack_ret = stack_push_with_len(btr, type);
-		if (stack_ret) {
-			/* stack_push_with_len() logs errors */
-			*status = BT_BTR_STATUS_ERROR;
-			goto end;
-		}
-
-		btr->state = BTR_STATE_ALIGN_COMPOUND;
-	} else {
-		/* Basic type: set as current basic type */
-		btr->cur_basic_field_type = type;
-		bt_get(btr->cur_basic_field_type);
-		btr->state = BTR_STATE_ALIGN_BASIC;
+	/* Set root program */
+	program = get_program(btr, type);
+	if (!program) {
+		/* get_program() logs errors */
+		*status = BT_BTR_STATUS_ERROR;
+		goto end;
 	}
 
+	stack_push(btr->stack, program);
+	btr->state = BTR_STATE_NEXT_FIELD;
+
 	/* Run the machine! */
 	BT_LOGV_STR("Running the state machine.");
 
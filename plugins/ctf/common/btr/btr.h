@@ -233,6 +233,33 @@ struct bt_btr_cbs {
 		 */
 		enum bt_btr_status (* compound_end)(
 				struct bt_field_type *type, void *data);
+
+		/**
+		 * Called, between a call to
+		 * bt_btr_cbs::types::compound_begin() and a call to
+		 * bt_btr_cbs::types::compound_end(), with all the
+		 * elements of an array or sequence type of which the
+		 * element type is an 8-bit integer type aligned on at
+		 * most 8 bits, instead of one integer callback function
+		 * call per element.
+		 *
+		 * The type reader only calls this when the elements
+		 * start on a byte boundary and are all within the
+		 * current buffer: \p bytes points within this buffer.
+		 * Otherwise, or if this is \c NULL, the elements are
+		 * decoded one by one.
+		 *
+		 * @param bytes		Elements (one byte each)
+		 * @param len		Number of elements
+		 * @param type		Array or sequence type (weak
+		 *			reference)
+		 * @param data		User data
+		 * @returns		#BT_BTR_STATUS_OK or
+		 *			#BT_BTR_STATUS_ERROR
+		 */
+		enum bt_btr_status (* byte_array)(const uint8_t *bytes,
+				size_t len, struct bt_field_type *type,
+				void *data);
 	} types;
 
 	/**
@@ -35,6 +35,7 @@
 #include <string.h>
 #include <babeltrace/babeltrace.h>
 #include <babeltrace/ctf-ir/field-types-internal.h>
+#include <babeltrace/ctf-ir/fields-internal.h>
 #include <babeltrace/ctf-ir/field-path-internal.h>
 #include <glib.h>
 #include <stdlib.h>
@@ -136,7 +137,8 @@ struct bt_notif_iter {
 	 *
 	 * This is set when a dynamic scope field is first created by
 	 * btr_compound_begin_cb(). It points to one of the fields in
-	 * dscopes below.
+	 * dscopes below. If the pointed field already exists, it is
+	 * decoded in place instead.
 	 */
 	struct bt_field **cur_dscope_field;
 
@@ -150,6 +152,13 @@ struct bt_notif_iter {
 	/* Current packet (NULL if not created yet) */
 	struct bt_packet *packet;
 
+	/*
+	 * Current event (NULL if not created yet). The event context
+	 * and payload fields are decoded directly into this event's
+	 * own fields.
+	 */
+	struct bt_event *event;
+
 	/* Current stream (NULL if not set yet) */
 	struct bt_stream *stream;
 
@@ -168,6 +177,16 @@ struct bt_notif_iter {
 		struct bt_field *event_payload;
 	} dscopes;
 
+	/*
+	 * Reset event header and stream event context fields of the
+	 * last emitted event, to decode the next event's header and
+	 * stream event context into (owned by this).
+	 */
+	struct {
+		struct bt_field *stream_event_header;
+		struct bt_field *stream_event_context;
+	} spare_dscopes;
+
 	/*
 	 * Special field overrides.
 	 *
@@ -202,6 +221,13 @@ struct bt_notif_iter {
 
 		/* Position of the last event header from addr (bits) */
 		size_t last_eh_at;
+
+		/*
+		 * Object keeping the bytes of the buffer alive (owned by
+		 * this), or NULL if the medium cannot provide one: string
+		 * fields can only refer to the buffer if it exists.
+		 */
+		void *owner;
 	} buf;
 
 	/* Binary type reader */
@@ -482,6 +508,15 @@ enum bt_notif_iter_status request_medium_bytes(
 		/* New medium buffer address */
 		notit->buf.addr = buffer_addr;
 
+		/* New medium buffer owner */
+		BT_PUT(notit->buf.owner);
+
+		if (notit->medium.medops.get_buffer_owner) {
+			notit->buf.owner =
+				notit->medium.medops.get_buffer_owner(
+					notit->medium.data);
+		}
+
 		BT_LOGV("User function returned new bytes: "
 			"packet-offset=%zu, cur=%zu, size=%zu, addr=%p",
 			notit->buf.packet_offset, notit->buf.at,
@@ -556,7 +591,18 @@ enum bt_notif_iter_status read_dscope_begin_state(
 	enum bt_btr_status btr_status;
 	size_t consumed_bits;
 
-	bt_put(*dscope_field);
+	if (*dscope_field) {
+		struct bt_field_type *field_type =
+			bt_field_get_type(*dscope_field);
+
+		/* Only decode in place a field of the same type */
+		if (field_type != dscope_field_type) {
+			BT_PUT(*dscope_field);
+		}
+
+		bt_put(field_type);
+	}
+
 	notit->cur_dscope_field = dscope_field;
 	BT_LOGV("Starting BTR: notit-addr=%p, btr-addr=%p, ft-addr=%p",
 		notit, notit->btr, dscope_field_type);
@@ -656,6 +702,8 @@ void put_event_dscopes(struct bt_notif_iter *notit)
 	BT_PUT(notit->dscopes.event_context);
 	BT_LOGV_STR("Putting event payload field.");
 	BT_PUT(notit->dscopes.event_payload);
+	BT_LOGV_STR("Putting event.");
+	BT_PUT(notit->event);
 }
 
 static
@@ -1213,6 +1261,8 @@ enum bt_notif_iter_status read_event_header_begin_state(
 	}
 
 	put_event_dscopes(notit);
+	BT_MOVE(notit->dscopes.stream_event_header,
+		notit->spare_dscopes.stream_event_header);
 	BT_LOGV("Decoding event header field: "
 		"notit-addr=%p, stream-class-addr=%p, "
 		"stream-class-name=\"%s\", stream-class-id=%" PRId64 ", "
@@ -1420,6 +1470,34 @@ enum bt_notif_iter_status after_event_header_state(
 		goto end;
 	}
 
+	/*
+	 * Create the event now (most probably a recycled one) so that
+	 * its context and payload fields are decoded in place. Its
+	 * header and stream event context fields are the ones which
+	 * were just decoded: create_event() sets them.
+	 */
+	BT_PUT(notit->event);
+	notit->event = bt_event_create_with_flags(notit->meta.event_class,
+		BT_EVENT_CREATE_FLAG_NO_HEADER |
+		BT_EVENT_CREATE_FLAG_NO_STREAM_EVENT_CONTEXT);
+	if (!notit->event) {
+		BT_LOGE("Cannot create event: "
+			"notit-addr=%p, event-class-addr=%p, "
+			"event-class-name=\"%s\", "
+			"event-class-id=%" PRId64,
+			notit, notit->meta.event_class,
+			bt_event_class_get_name(notit->meta.event_class),
+			bt_event_class_get_id(notit->meta.event_class));
+		status = BT_NOTIF_ITER_STATUS_ERROR;
+		goto end;
+	}
+
+	BT_PUT(notit->dscopes.event_context);
+	notit->dscopes.event_context =
+		bt_event_get_event_context(notit->event);
+	BT_PUT(notit->dscopes.event_payload);
+	notit->dscopes.event_payload =
+		bt_event_get_event_payload(notit->event);
 	notit->state = STATE_DSCOPE_STREAM_EVENT_CONTEXT_BEGIN;
 
 end:
@@ -1448,6 +1526,8 @@ enum bt_notif_iter_status read_stream_event_context_begin_state(
 		bt_stream_class_get_name(notit->meta.stream_class),
 		bt_stream_class_get_id(notit->meta.stream_class),
 		stream_event_context_type);
+	BT_MOVE(notit->dscopes.stream_event_context,
+		notit->spare_dscopes.stream_event_context);
 	status = read_dscope_begin_state(notit, stream_event_context_type,
 		STATE_DSCOPE_EVENT_CONTEXT_BEGIN,
 		STATE_DSCOPE_STREAM_EVENT_CONTEXT_CONTINUE,
@@ -1718,6 +1798,7 @@ void bt_notif_iter_reset(struct bt_notif_iter *notit)
 	notit->buf.at = 0;
 	notit->buf.last_eh_at = SIZE_MAX;
 	notit->buf.packet_offset = 0;
+	BT_PUT(notit->buf.owner);
 	notit->state = STATE_INIT;
 	notit->cur_content_size = -1;
 	notit->cur_packet_size = -1;
@@ -1778,6 +1859,10 @@ end:
 	return ret;
 }
 
+/*
+ * Returns the next field to fill within the current base field. The
+ * returned reference is borrowed: the base field owns the next field.
+ */
 static
 struct bt_field *get_next_field(struct bt_notif_iter *notit)
 {
@@ -1790,22 +1875,29 @@ struct bt_field *get_next_field(struct bt_notif_iter *notit)
 	index = stack_top(notit->stack)->index;
 	base_field = stack_top(notit->stack)->base;
 	assert(base_field);
-	base_type = bt_field_get_type(base_field);
+	base_type = bt_field_borrow_type(base_field);
 	assert(base_type);
 
 	switch (bt_field_type_get_type_id(base_type)) {
 	case BT_FIELD_TYPE_ID_STRUCT:
-		next_field = bt_field_structure_get_field_by_index(
+		next_field = bt_field_structure_borrow_field_by_index(
 			base_field, index);
 		break;
 	case BT_FIELD_TYPE_ID_ARRAY:
+		/*
+		 * Those getters can create the next field: the base
+		 * field keeps a reference to it.
+		 */
 		next_field = bt_field_array_get_field(base_field, index);
+		bt_put(next_field);
 		break;
 	case BT_FIELD_TYPE_ID_SEQUENCE:
 		next_field = bt_field_sequence_get_field(base_field, index);
+		bt_put(next_field);
 		break;
 	case BT_FIELD_TYPE_ID_VARIANT:
 		next_field = bt_field_variant_get_current_field(base_field);
+		bt_put(next_field);
 		break;
 	default:
 		BT_LOGF("Unknown base field type ID: "
@@ -1816,7 +1908,6 @@ struct bt_field *get_next_field(struct bt_notif_iter *notit)
 		abort();
 	}
 
-	BT_PUT(base_type);
 	return next_field;
 }
 
@@ -1824,14 +1915,14 @@ static
 void update_clock_state(uint64_t *state,
 		struct bt_field *value_field)
 {
-	struct bt_field_type *value_type = NULL;
+	struct bt_field_type *value_type;
 	uint64_t requested_new_value;
 	uint64_t requested_new_value_mask;
 	uint64_t cur_value_masked;
 	int requested_new_value_size;
 	int ret;
 
-	value_type = bt_field_get_type(value_field);
+	value_type = bt_field_borrow_type(value_field);
 	assert(value_type);
 	assert(bt_field_type_is_integer(value_type));
 	requested_new_value_size =
@@ -1871,7 +1962,6 @@ void update_clock_state(uint64_t *state,
 end:
 	BT_LOGV("Updated clock's value from integer field's value: "
 		"value=%" PRIu64, *state);
-	bt_put(value_type);
 }
 
 static
@@ -1880,13 +1970,13 @@ enum bt_btr_status update_clock(struct bt_notif_iter *notit,
 {
 	gboolean clock_class_found;
 	uint64_t *clock_state = NULL;
-	struct bt_field_type *int_field_type = NULL;
+	struct bt_field_type *int_field_type;
 	enum bt_btr_status ret = BT_BTR_STATUS_OK;
-	struct bt_clock_class *clock_class = NULL;
+	struct bt_clock_class *clock_class;
 
-	int_field_type = bt_field_get_type(int_field);
+	int_field_type = bt_field_borrow_type(int_field);
 	assert(int_field_type);
-	clock_class = bt_field_type_integer_get_mapped_clock_class(
+	clock_class = bt_field_type_integer_borrow_mapped_clock_class(
 		int_field_type);
 	if (likely(!clock_class)) {
 		goto end;
@@ -1914,8 +2004,6 @@ enum bt_btr_status update_clock(struct bt_notif_iter *notit,
 		bt_clock_class_get_name(clock_class), *clock_state);
 	update_clock_state(clock_state, int_field);
 end:
-	bt_put(int_field_type);
-	bt_put(clock_class);
 	return ret;
 }
 
@@ -1943,20 +2031,19 @@ enum bt_btr_status btr_unsigned_int_common(uint64_t value,
 	if (!field) {
 		BT_LOGW("Cannot get next field: notit-addr=%p", notit);
 		status = BT_BTR_STATUS_ERROR;
-		goto end_no_put;
+		goto end;
 	}
 
 	switch(bt_field_type_get_type_id(type)) {
 	case BT_FIELD_TYPE_ID_INTEGER:
 		/* Integer field is created field */
-		BT_MOVE(int_field, field);
-		bt_get(type);
+		int_field = field;
 		break;
 	case BT_FIELD_TYPE_ID_ENUM:
+		/* The enumeration field owns its container field */
 		int_field = bt_field_enumeration_get_container(field);
 		assert(int_field);
-		type = bt_field_get_type(int_field);
-		assert(type);
+		bt_put(int_field);
 		break;
 	default:
 		BT_LOGF("Unexpected field type ID: "
@@ -1972,10 +2059,8 @@ enum bt_btr_status btr_unsigned_int_common(uint64_t value,
 	assert(ret == 0);
 	stack_top(notit->stack)->index++;
 	*out_int_field = int_field;
-	BT_PUT(field);
-	BT_PUT(type);
 
-end_no_put:
+end:
 	return status;
 }
 
@@ -1997,7 +2082,8 @@ enum bt_btr_status btr_timestamp_end_cb(void *value,
 			&field);
 
 	/* Set as the current packet's timestamp_end field. */
-	BT_MOVE(notit->cur_timestamp_end, field);
+	BT_PUT(notit->cur_timestamp_end);
+	notit->cur_timestamp_end = bt_get(field);
 	return status;
 }
 
@@ -2031,7 +2117,6 @@ enum bt_btr_status btr_unsigned_int_cb(uint64_t value,
 	}
 
 	status = update_clock(notit, field);
-	BT_PUT(field);
 end:
 	return status;
 }
@@ -2059,20 +2144,19 @@ enum bt_btr_status btr_signed_int_cb(int64_t value,
 	if (!field) {
 		BT_LOGW("Cannot get next field: notit-addr=%p", notit);
 		status = BT_BTR_STATUS_ERROR;
-		goto end_no_put;
+		goto end;
 	}
 
 	switch(bt_field_type_get_type_id(type)) {
 	case BT_FIELD_TYPE_ID_INTEGER:
 		/* Integer field is created field */
-		BT_MOVE(int_field, field);
-		bt_get(type);
+		int_field = field;
 		break;
 	case BT_FIELD_TYPE_ID_ENUM:
+		/* The enumeration field owns its container field */
 		int_field = bt_field_enumeration_get_container(field);
 		assert(int_field);
-		type = bt_field_get_type(int_field);
-		assert(type);
+		bt_put(int_field);
 		break;
 	default:
 		BT_LOGF("Unexpected field type ID: "
@@ -2088,11 +2172,8 @@ enum bt_btr_status btr_signed_int_cb(int64_t value,
 	assert(!ret);
 	stack_top(notit->stack)->index++;
 	status = update_clock(notit, int_field);
-	BT_PUT(field);
-	BT_PUT(int_field);
-	BT_PUT(type);
 
-end_no_put:
+end:
 	return status;
 }
 
@@ -2126,7 +2207,6 @@ enum bt_btr_status btr_floating_point_cb(double value,
 	stack_top(notit->stack)->index++;
 
 end:
-	BT_PUT(field);
 	return status;
 }
 
@@ -2170,9 +2250,10 @@ enum bt_btr_status btr_string_begin_cb(
 	/*
 	 * Initialize string field payload to an empty string since in the
 	 * case of a length 0 string the btr_string_cb won't be called and
-	 * we will end up with an unset string payload.
+	 * we will end up with an unset string payload. A static empty
+	 * string needs no copy.
 	 */
-	ret = bt_field_string_set_value(field, "");
+	ret = bt_field_string_set_borrowed_value(field, "", 0, NULL);
 	if (ret) {
 		BT_LOGE("Cannot initialize string field's value to an empty string: "
 			"notit-addr=%p, field-addr=%p, ret=%d",
@@ -2182,8 +2263,6 @@ enum bt_btr_status btr_string_begin_cb(
 	}
 
 end:
-	BT_PUT(field);
-
 	return status;
 }
 
@@ -2194,6 +2273,7 @@ enum bt_btr_status btr_string_cb(const char *value,
 	enum bt_btr_status status = BT_BTR_STATUS_OK;
 	struct bt_field *field = NULL;
 	struct bt_notif_iter *notit = data;
+	const uint8_t *value_end;
 	int ret;
 
 	BT_LOGV("String (substring) function called from BTR: "
@@ -2208,6 +2288,31 @@ enum bt_btr_status btr_string_cb(const char *value,
 	field = stack_top(notit->stack)->base;
 	assert(field);
 
+	/*
+	 * If this substring is the complete string, that is, if it's
+	 * the first one and its null character follows it within the
+	 * current buffer, make the field refer to it instead of copying
+	 * it, provided the medium can keep the buffer alive.
+	 */
+	value_end = (const uint8_t *) value + len;
+
+	if (notit->buf.owner &&
+			value_end < notit->buf.addr + notit->buf.sz &&
+			*value_end == '\0' &&
+			bt_field_string_get_value(field)[0] == '\0') {
+		ret = bt_field_string_set_borrowed_value(field, value, len,
+			notit->buf.owner);
+		if (ret) {
+			BT_LOGE("Cannot set string field's borrowed value: "
+				"notit-addr=%p, field-addr=%p, "
+				"string-length=%zu, ret=%d",
+				notit, field, len, ret);
+			status = BT_BTR_STATUS_ERROR;
+		}
+
+		goto end;
+	}
+
 	/* Append current string */
 	ret = bt_field_string_append_len(field, value, len);
 	if (ret) {
@@ -2260,18 +2365,12 @@ enum bt_btr_status btr_compound_begin_cb(
 
 	/* Create field */
 	if (stack_empty(notit->stack)) {
-		/* Root: create dynamic scope field */
-		*notit->cur_dscope_field = bt_field_create(type);
-		field = *notit->cur_dscope_field;
-
-		/*
-		 * Field will be put at the end of this function
-		 * (stack_push() will take one reference, but this
-		 * reference is lost upon the equivalent stack_pop()
-		 * later), so also get it for our context to own it.
-		 */
-		bt_get(*notit->cur_dscope_field);
+		/* Root: create dynamic scope field if needed */
+		if (!*notit->cur_dscope_field) {
+			*notit->cur_dscope_field = bt_field_create(type);
+		}
 
+		field = *notit->cur_dscope_field;
 		if (!field) {
 			BT_LOGE("Cannot create compound field: "
 				"notit-addr=%p, ft-addr=%p, ft-id=%s",
@@ -2305,8 +2404,6 @@ enum bt_btr_status btr_compound_begin_cb(
 	}
 
 end:
-	BT_PUT(field);
-
 	return status;
 }
 
@@ -2334,6 +2431,92 @@ enum bt_btr_status btr_compound_end_cb(
 	return BT_BTR_STATUS_OK;
 }
 
+static
+enum bt_btr_status btr_byte_array_cb(const uint8_t *bytes,
+		size_t len, struct bt_field_type *type, void *data)
+{
+	enum bt_btr_status status = BT_BTR_STATUS_OK;
+	struct bt_notif_iter *notit = data;
+	struct bt_field_type *elem_type;
+	struct bt_field *field;
+	bool is_signed;
+	size_t i;
+	int ret;
+
+	BT_LOGV("Byte array function called from BTR: "
+		"notit-addr=%p, btr-addr=%p, ft-addr=%p, "
+		"ft-id=%s, length=%zu",
+		notit, notit->btr, type,
+		bt_field_type_id_string(
+			bt_field_type_get_type_id(type)),
+		len);
+
+	/* Get array/sequence field */
+	field = stack_top(notit->stack)->base;
+	assert(field);
+
+	if (bt_field_type_get_type_id(type) == BT_FIELD_TYPE_ID_ARRAY) {
+		elem_type = bt_field_type_array_get_element_type(type);
+	} else {
+		elem_type = bt_field_type_sequence_get_element_type(type);
+	}
+
+	/* The array/sequence field type keeps its element type alive */
+	assert(elem_type);
+	bt_put(elem_type);
+	is_signed = bt_field_type_integer_is_signed(elem_type);
+
+	/*
+	 * If the medium can keep the buffer alive, make the field refer
+	 * to the elements instead of creating one integer field per
+	 * element, unless an element could update a clock value or is
+	 * overridden.
+	 */
+	if (notit->buf.owner &&
+			!bt_field_type_integer_borrow_mapped_clock_class(
+				elem_type) &&
+			!g_hash_table_lookup(notit->field_overrides,
+				elem_type)) {
+		if (bt_field_type_get_type_id(type) ==
+				BT_FIELD_TYPE_ID_ARRAY) {
+			ret = bt_field_array_set_borrowed_bytes(field, bytes,
+				notit->buf.owner);
+		} else {
+			ret = bt_field_sequence_set_borrowed_bytes(field, bytes,
+				notit->buf.owner);
+		}
+
+		if (ret) {
+			BT_LOGE("Cannot set array/sequence field's borrowed bytes: "
+				"notit-addr=%p, field-addr=%p, length=%zu, "
+				"ret=%d", notit, field, len, ret);
+			status = BT_BTR_STATUS_ERROR;
+		}
+
+		stack_top(notit->stack)->index = len;
+		goto end;
+	}
+
+	/* Otherwise set the elements in one go */
+	for (i = 0; i < len; i++) {
+		if (is_signed) {
+			status = btr_signed_int_cb((int8_t) bytes[i],
+				elem_type, data);
+		} else {
+			status = btr_unsigned_int_cb(bytes[i], elem_type,
+				data);
+		}
+
+		if (status != BT_BTR_STATUS_OK) {
+			/* btr_*_int_cb() logs errors */
+			goto end;
+		}
+	}
+
+end:
+	return status;
+}
+
 static
 struct bt_field *resolve_field(struct bt_notif_iter *notit,
 		struct bt_field_path *path)
@@ -2582,6 +2765,21 @@ end:
 	return ret;
 }
 
+static
+int set_event_scope_keep_spare(struct bt_event *event,
+		struct bt_field *field, struct bt_field **spare_field,
+		struct bt_field *(*get_func)(struct bt_event *),
+		int (*set_func)(struct bt_event *, struct bt_field *))
+{
+	/*
+	 * Keep the event's current (reset) field to decode the next
+	 * event's scope into it.
+	 */
+	BT_PUT(*spare_field);
+	*spare_field = get_func(event);
+	return set_func(event, field);
+}
+
 static
 struct bt_event *create_event(struct bt_notif_iter *notit)
 {
@@ -2596,22 +2794,20 @@ struct bt_event *create_event(struct bt_notif_iter *notit)
 		bt_event_class_get_name(notit->meta.event_class),
 		bt_event_class_get_id(notit->meta.event_class));
 
-	/* Create event object. */
-	event = bt_event_create(notit->meta.event_class);
-	if (!event) {
-		BT_LOGE("Cannot create event: "
-			"notit-addr=%p, event-class-addr=%p, "
-			"event-class-name=\"%s\", "
-			"event-class-id=%" PRId64,
-			notit, notit->meta.event_class,
-			bt_event_class_get_name(notit->meta.event_class),
-			bt_event_class_get_id(notit->meta.event_class));
-		goto error;
-	}
-
-	/* Set header, stream event context, context, and payload fields. */
-	ret = bt_event_set_header(event,
-		notit->dscopes.stream_event_header);
+	/*
+	 * The event object was created after decoding the event
+	 * header, and its context and payload fields are already
+	 * decoded.
+	 */
+	assert(notit->event);
+	event = notit->event;
+	notit->event = NULL;
+
+	/* Set header and stream event context fields. */
+	ret = set_event_scope_keep_spare(event,
+		notit->dscopes.stream_event_header,
+		&notit->spare_dscopes.stream_event_header,
+		bt_event_get_header, bt_event_set_header);
 	if (ret) {
 		BT_LOGE("Cannot set event's header field: "
 			"notit-addr=%p, event-addr=%p, event-class-addr=%p, "
@@ -2624,22 +2820,11 @@ struct bt_event *create_event(struct bt_notif_iter *notit)
 		goto error;
 	}
 
-	ret = bt_event_set_stream_event_context(event,
-		notit->dscopes.stream_event_context);
-	if (ret) {
-		BT_LOGE("Cannot set event's context field: "
-			"notit-addr=%p, event-addr=%p, event-class-addr=%p, "
-			"event-class-name=\"%s\", "
-			"event-class-id=%" PRId64 ", field-addr=%p",
-			notit, event, notit->meta.event_class,
-			bt_event_class_get_name(notit->meta.event_class),
-			bt_event_class_get_id(notit->meta.event_class),
-			notit->dscopes.stream_event_context);
-		goto error;
-	}
-
-	ret = bt_event_set_event_context(event,
-		notit->dscopes.event_context);
+	ret = set_event_scope_keep_spare(event,
+		notit->dscopes.stream_event_context,
+		&notit->spare_dscopes.stream_event_context,
+		bt_event_get_stream_event_context,
+		bt_event_set_stream_event_context);
 	if (ret) {
 		BT_LOGE("Cannot set event's stream event context field: "
 			"notit-addr=%p, event-addr=%p, event-class-addr=%p, "
@@ -2648,21 +2833,7 @@ struct bt_event *create_event(struct bt_notif_iter *notit)
 			notit, event, notit->meta.event_class,
 			bt_event_class_get_name(notit->meta.event_class),
 			bt_event_class_get_id(notit->meta.event_class),
-			notit->dscopes.event_context);
-		goto error;
-	}
-
-	ret = bt_event_set_event_payload(event,
-		notit->dscopes.event_payload);
-	if (ret) {
-		BT_LOGE("Cannot set event's payload field: "
-			"notit-addr=%p, event-addr=%p, event-class-addr=%p, "
-			"event-class-name=\"%s\", "
-			"event-class-id=%" PRId64 ", field-addr=%p",
-			notit, event, notit->meta.event_class,
-			bt_event_class_get_name(notit->meta.event_class),
-			bt_event_class_get_id(notit->meta.event_class),
-			notit->dscopes.event_payload);
+			notit->dscopes.stream_event_context);
 		goto error;
 	}
 
@@ -2931,6 +3102,11 @@ void notify_event(struct bt_notif_iter *notit,
 	}
 	*notification = ret;
 end:
+	/*
+	 * Drop our references to the event's fields so that they can
+	 * be recycled with the event.
+	 */
+	put_event_dscopes(notit);
 	BT_PUT(event);
 }
 
@@ -2998,6 +3174,7 @@ struct bt_notif_iter *bt_notif_iter_create(struct bt_trace *trace,
 			.string_end = btr_string_end_cb,
 			.compound_begin = btr_compound_begin_cb,
 			.compound_end = btr_compound_end_cb,
+			.byte_array = btr_byte_array_cb,
 		},
 		.query = {
 			.get_sequence_length = btr_get_sequence_length_cb,
@@ -3080,6 +3257,9 @@ void bt_notif_iter_destroy(struct bt_notif_iter *notit)
 	BT_PUT(notit->stream);
 	BT_PUT(notit->cur_timestamp_end);
 	put_all_dscopes(notit);
+	BT_PUT(notit->spare_dscopes.stream_event_header);
+	BT_PUT(notit->spare_dscopes.stream_event_context);
+	BT_PUT(notit->buf.owner);
 
 	BT_LOGD("Destroying CTF plugin notification iterator: addr=%p", notit);
 
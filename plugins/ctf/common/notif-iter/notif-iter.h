@@ -229,6 +229,23 @@ struct bt_notif_iter_medium_ops {
 	struct bt_stream * (* get_stream)(
 			struct bt_stream_class *stream_class,
 			uint64_t stream_id, void *data);
+
+	/**
+	 * Returns a new reference to an object which keeps the bytes of
+	 * the last buffer returned by request_bytes() valid and
+	 * unchanged for as long as it exists.
+	 *
+	 * This *optional* method lets the notification iterator create
+	 * string fields which refer to the bytes of the buffer instead
+	 * of copying them (see bt_field_string_set_borrowed_value()).
+	 * It must return \c NULL if the medium cannot guarantee this,
+	 * for example because it reuses its buffer.
+	 *
+	 * @param data		User data
+	 * @returns		New reference to the buffer's owner, or
+	 *			\c NULL
+	 */
+	void * (* get_buffer_owner)(void *data);
 };
 
 /** CTF notification iterator. */
@@ -30,94 +30,251 @@
 #include <glib.h>
 #include <inttypes.h>
 #include <babeltrace/compat/mman-internal.h>
+#include <babeltrace/compat/fcntl-internal.h>
+#include <babeltrace/compat/unistd-internal.h>
 #include <babeltrace/endian-internal.h>
 #include <babeltrace/babeltrace.h>
 #include <babeltrace/common-internal.h>
+#include <babeltrace/object-internal.h>
 #include "file.h"
 #include "metadata.h"
 #include "../common/notif-iter/notif-iter.h"
 #include <assert.h>
 #include "data-stream-file.h"
+#include "index-cache.h"
 #include <string.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
 
 #define BT_LOG_TAG "PLUGIN-CTF-FS-SRC-DS"
 #include "logging.h"
 
+/*
+ * Memory mapping of a window of a data stream file. It is unmapped
+ * when its last reference is put: the data stream file holds one while
+ * it is the current window, and each field which refers to its bytes
+ * holds one.
+ */
+struct ctf_fs_ds_file_mapping {
+	struct bt_object base;
+	void *addr;
+	size_t len;
+};
+
+static
+void ds_file_mapping_destroy(struct bt_object *obj)
+{
+	struct ctf_fs_ds_file_mapping *mapping = (void *) obj;
+
+	BT_LOGV("Unmapping data stream file window: addr=%p, size=%zu",
+		mapping->addr, mapping->len);
+
+	if (bt_munmap(mapping->addr, mapping->len)) {
+		BT_LOGE_ERRNO("Cannot memory-unmap file",
+			": address=%p, size=%zu", mapping->addr, mapping->len);
+	}
+
+	g_free(mapping);
+}
+
 static inline
-size_t remaining_mmap_bytes(struct ctf_fs_ds_file *ds_file)
+size_t remaining_window_bytes(struct ctf_fs_ds_file *ds_file)
+{
+	if (!ds_file->window_addr) {
+		return 0;
+	}
+
+	return ds_file->window_len - ds_file->request_offset;
+}
+
+static
+void ds_file_release_window(struct ctf_fs_ds_file *ds_file)
+{
+	if (!ds_file || !ds_file->window_addr) {
+		return;
+	}
+
+	/*
+	 * The read buffer is reused for the next window, while the
+	 * memory mapping remains until nothing refers to its bytes.
+	 */
+	BT_PUT(ds_file->mapping);
+	ds_file->window_addr = NULL;
+}
+
+/*
+ * Asks the system to start reading the window which follows the
+ * current one while the current one is decoded.
+ */
+static
+void ds_file_prefetch_next_window(struct ctf_fs_ds_file *ds_file)
 {
-	return ds_file->mmap_len - ds_file->request_offset;
+	off_t next_offset = ds_file->window_offset + ds_file->window_len;
+
+	if (!ds_file->config.read_ahead ||
+			next_offset >= ds_file->file->size) {
+		return;
+	}
+
+	(void) bt_posix_fadvise(fileno(ds_file->file->fp), next_offset,
+		MIN(ds_file->file->size - next_offset,
+			ds_file->window_max_len),
+		BT_POSIX_FADV_WILLNEED);
 }
 
 static
-int ds_file_munmap(struct ctf_fs_ds_file *ds_file)
+int ds_file_map_window(struct ctf_fs_ds_file *ds_file)
 {
 	int ret = 0;
+	struct ctf_fs_ds_file_mapping *mapping;
 
-	if (!ds_file || !ds_file->mmap_addr) {
+	mapping = g_new0(struct ctf_fs_ds_file_mapping, 1);
+	if (!mapping) {
+		BT_LOGE_STR("Failed to allocate a data stream file mapping.");
+		ret = -1;
 		goto end;
 	}
 
-	if (bt_munmap(ds_file->mmap_addr, ds_file->mmap_len)) {
-		BT_LOGE_ERRNO("Cannot memory-unmap file",
-			": address=%p, size=%zu, file_path=\"%s\", file=%p",
-			ds_file->mmap_addr, ds_file->mmap_len,
-			ds_file->file ? ds_file->file->path->str : "NULL",
-			ds_file->file ? ds_file->file->fp : NULL);
+	mapping->addr = bt_mmap((void *) 0, ds_file->window_len,
+			PROT_READ, MAP_PRIVATE, fileno(ds_file->file->fp),
+			ds_file->window_offset);
+	if (mapping->addr == MAP_FAILED) {
+		BT_LOGE("Cannot memory-map address (size %zu) of file \"%s\" (%p) at offset %jd: %s",
+				ds_file->window_len, ds_file->file->path->str,
+				ds_file->file->fp, (intmax_t) ds_file->window_offset,
+				strerror(errno));
+		g_free(mapping);
 		ret = -1;
 		goto end;
 	}
 
-	ds_file->mmap_addr = NULL;
+	mapping->len = ds_file->window_len;
+	bt_object_init(mapping, ds_file_mapping_destroy);
+	ds_file->mapping = mapping;
+	ds_file->window_addr = mapping->addr;
+
+	if (ds_file->config.read_ahead) {
+		(void) bt_posix_madvise(ds_file->window_addr,
+			ds_file->window_len, BT_POSIX_MADV_SEQUENTIAL);
+
+		if (!ds_file->config.mmap_whole_file) {
+			/*
+			 * Start reading the whole window now instead of
+			 * faulting its pages in one by one.
+			 */
+			(void) bt_posix_madvise(ds_file->window_addr,
+				ds_file->window_len, BT_POSIX_MADV_WILLNEED);
+		}
+	}
+
+end:
+	return ret;
+}
+
+static
+int ds_file_read_window(struct ctf_fs_ds_file *ds_file)
+{
+	size_t len = 0;
+	int ret = 0;
+
+	if (!ds_file->read_buf) {
+		ds_file->read_buf = g_malloc(ds_file->window_max_len);
+		if (!ds_file->read_buf) {
+			BT_LOGE("Failed to allocate read buffer: size=%zu",
+				ds_file->window_max_len);
+			ret = -1;
+			goto end;
+		}
+	}
+
+	while (len < ds_file->window_len) {
+		ssize_t read_ret = bt_pread(fileno(ds_file->file->fp),
+			ds_file->read_buf + len, ds_file->window_len - len,
+			ds_file->window_offset + len);
+
+		if (read_ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			BT_LOGE_ERRNO("Cannot read file",
+				": size=%zu, file_path=\"%s\", file=%p, offset=%jd",
+				ds_file->window_len - len,
+				ds_file->file->path->str, ds_file->file->fp,
+				(intmax_t) (ds_file->window_offset + len));
+			ret = -1;
+			goto end;
+		}
+
+		if (read_ret == 0) {
+			BT_LOGE("Unexpected end of file: file_path=\"%s\", "
+				"file=%p, offset=%jd",
+				ds_file->file->path->str, ds_file->file->fp,
+				(intmax_t) (ds_file->window_offset + len));
+			ret = -1;
+			goto end;
+		}
+
+		len += (size_t) read_ret;
+	}
+
+	ds_file->window_addr = ds_file->read_buf;
 
 end:
 	return ret;
 }
 
 static
-enum bt_notif_iter_medium_status ds_file_mmap_next(
+enum bt_notif_iter_medium_status ds_file_window_next(
 		struct ctf_fs_ds_file *ds_file)
 {
 	enum bt_notif_iter_medium_status ret =
 			BT_NOTIF_ITER_MEDIUM_STATUS_OK;
 
-	/* Unmap old region */
-	if (ds_file->mmap_addr) {
-		if (ds_file_munmap(ds_file)) {
-			goto error;
-		}
+	/* Release old window */
+	if (ds_file->window_addr) {
+		ds_file_release_window(ds_file);
 
 		/*
-		 * mmap_len is guaranteed to be page-aligned except on the
-		 * last mapping where it may not be possible (since the file's
+		 * window_len is guaranteed to be page-aligned except on the
+		 * last window where it may not be possible (since the file's
 		 * size itself may not be a page multiple).
 		 */
-		ds_file->mmap_offset += ds_file->mmap_len;
+		ds_file->window_offset += ds_file->window_len;
 		ds_file->request_offset = 0;
 	}
 
-	ds_file->mmap_len = MIN(ds_file->file->size - ds_file->mmap_offset,
-			ds_file->mmap_max_len);
-	if (ds_file->mmap_len == 0) {
+	ds_file->window_len = MIN(ds_file->file->size - ds_file->window_offset,
+			ds_file->window_max_len);
+	if (ds_file->window_len == 0) {
 		ret = BT_NOTIF_ITER_MEDIUM_STATUS_EOF;
 		goto end;
 	}
-	/* Map new region */
-	assert(ds_file->mmap_len);
-	ds_file->mmap_addr = bt_mmap((void *) 0, ds_file->mmap_len,
-			PROT_READ, MAP_PRIVATE, fileno(ds_file->file->fp),
-			ds_file->mmap_offset);
-	if (ds_file->mmap_addr == MAP_FAILED) {
-		BT_LOGE("Cannot memory-map address (size %zu) of file \"%s\" (%p) at offset %jd: %s",
-				ds_file->mmap_len, ds_file->file->path->str,
-				ds_file->file->fp, (intmax_t) ds_file->mmap_offset,
-				strerror(errno));
-		goto error;
+
+	/* Get new window */
+	assert(ds_file->window_len);
+
+	switch (ds_file->config.medium) {
+	case CTF_FS_DS_FILE_MEDIUM_MMAP:
+		if (ds_file_map_window(ds_file)) {
+			goto error;
+		}
+		break;
+	case CTF_FS_DS_FILE_MEDIUM_READ:
+		if (ds_file_read_window(ds_file)) {
+			goto error;
+		}
+		break;
+	default:
+		abort();
 	}
 
+	ds_file_prefetch_next_window(ds_file);
 	goto end;
 error:
-	ds_file_munmap(ds_file);
+	ds_file_release_window(ds_file);
 	ret = BT_NOTIF_ITER_MEDIUM_STATUS_ERROR;
 end:
 	return ret;
@@ -136,32 +293,32 @@ enum bt_notif_iter_medium_status medop_request_bytes(
 		goto end;
 	}
 
-	/* Check if we have at least one memory-mapped byte left */
-	if (remaining_mmap_bytes(ds_file) == 0) {
+	/* Check if we have at least one byte left in the current window */
+	if (remaining_window_bytes(ds_file) == 0) {
 		/* Are we at the end of the file? */
-		if (ds_file->mmap_offset >= ds_file->file->size) {
+		if (ds_file->window_offset >= ds_file->file->size) {
 			BT_LOGD("Reached end of file \"%s\" (%p)",
 				ds_file->file->path->str, ds_file->file->fp);
 			status = BT_NOTIF_ITER_MEDIUM_STATUS_EOF;
 			goto end;
 		}
 
-		status = ds_file_mmap_next(ds_file);
+		status = ds_file_window_next(ds_file);
 		switch (status) {
 		case BT_NOTIF_ITER_MEDIUM_STATUS_OK:
 			break;
 		case BT_NOTIF_ITER_MEDIUM_STATUS_EOF:
 			goto end;
 		default:
-			BT_LOGE("Cannot memory-map next region of file \"%s\" (%p)",
+			BT_LOGE("Cannot get next window of file \"%s\" (%p)",
 					ds_file->file->path->str,
 					ds_file->file->fp);
 			goto error;
 		}
 	}
 
-	*buffer_sz = MIN(remaining_mmap_bytes(ds_file), request_sz);
-	*buffer_addr = ((uint8_t *) ds_file->mmap_addr) + ds_file->request_offset;
+	*buffer_sz = MIN(remaining_window_bytes(ds_file), request_sz);
+	*buffer_addr = ((uint8_t *) ds_file->window_addr) + ds_file->request_offset;
 	ds_file->request_offset += *buffer_sz;
 	goto end;
 
@@ -172,6 +329,14 @@ end:
 	return status;
 }
 
+static
+void *medop_get_buffer_owner(void *data)
+{
+	struct ctf_fs_ds_file *ds_file = data;
+
+	return bt_get(ds_file->mapping);
+}
+
 static
 struct bt_stream *medop_get_stream(
 		struct bt_stream_class *stream_class, uint64_t stream_id,
@@ -219,33 +384,38 @@ enum bt_notif_iter_medium_status medop_seek(
 
 	/*
 	 * Determine whether or not the destination is contained within the
-	 * current mapping.
+	 * current window.
 	 */
-	if (ds_file->mmap_addr && (offset < ds_file->mmap_offset ||
-			offset >= ds_file->mmap_offset + ds_file->mmap_len)) {
-		int unmap_ret;
-		off_t offset_in_mapping = offset % bt_common_get_page_size();
+	if (!ds_file->window_addr || offset < ds_file->window_offset ||
+			offset >= ds_file->window_offset + ds_file->window_len) {
+		off_t offset_in_window = offset % bt_common_get_page_size();
 
 		BT_LOGD("Medium seek request cannot be accomodated by the current "
-				"file mapping: offset=%jd, mmap-offset=%jd, "
-				"mmap-len=%zu", offset, ds_file->mmap_offset,
-				ds_file->mmap_len);
-		unmap_ret = ds_file_munmap(ds_file);
-		if (unmap_ret) {
-			ret = BT_NOTIF_ITER_MEDIUM_STATUS_ERROR;
-			goto end;
+				"file window: offset=%jd, window-offset=%jd, "
+				"window-len=%zu", offset, ds_file->window_offset,
+				ds_file->window_len);
+		ds_file_release_window(ds_file);
+
+		if (offset == file_size) {
+			/* Nothing left to read: do not get a new window */
+			ds_file->window_offset = offset;
+			ds_file->window_len = 0;
+			ds_file->request_offset = 0;
+			ret = BT_NOTIF_ITER_MEDIUM_STATUS_EOF;
+			goto set_end_reached;
 		}
 
-		ds_file->mmap_offset = offset - offset_in_mapping;
-		ds_file->request_offset = offset_in_mapping;
-		ret = ds_file_mmap_next(ds_file);
+		ds_file->window_offset = offset - offset_in_window;
+		ds_file->request_offset = offset_in_window;
+		ret = ds_file_window_next(ds_file);
 		if (ret != BT_NOTIF_ITER_MEDIUM_STATUS_OK) {
 			goto end;
 		}
 	} else {
-		ds_file->request_offset = offset - ds_file->mmap_offset;
+		ds_file->request_offset = offset - ds_file->window_offset;
 	}
 
+set_end_reached:
 	ds_file->end_reached = (offset == file_size);
 end:
 	return ret;
@@ -256,6 +426,7 @@ struct bt_notif_iter_medium_ops ctf_fs_ds_file_medops = {
 	.request_bytes = medop_request_bytes,
 	.get_stream = medop_get_stream,
 	.seek = medop_seek,
+	.get_buffer_owner = medop_get_buffer_owner,
 };
 
 static
@@ -421,11 +592,130 @@ end:
 	return ret;
 }
 
+/*
+ * Builds an index from `file_entry_count` LTTng packet indexes of
+ * `file_index_entry_size` bytes each (struct ctf_packet_index, big
+ * endian) starting at `file_pos`.
+ */
+static
+struct ctf_fs_ds_index *build_index_from_packet_indexes(
+		struct ctf_fs_ds_file *ds_file, const char *file_pos,
+		size_t file_index_entry_size, size_t file_entry_count)
+{
+	int ret;
+	struct ctf_fs_ds_index *index = NULL;
+	struct ctf_fs_ds_index_entry *index_entry = NULL;
+	uint64_t total_packets_size = 0;
+	size_t i;
+	struct bt_clock_class *timestamp_begin_cc = NULL;
+	struct bt_clock_class *timestamp_end_cc = NULL;
+	bool has_stream_instance_id = file_index_entry_size >=
+		offsetof(struct ctf_packet_index, stream_instance_id) +
+		sizeof(uint64_t);
+
+	if (file_index_entry_size <
+			offsetof(struct ctf_packet_index, events_discarded)) {
+		BT_LOGW("Invalid packet index entry size: size=%zu",
+			file_index_entry_size);
+		goto error;
+	}
+
+	ret = get_ds_file_packet_bounds_clock_classes(ds_file,
+			&timestamp_begin_cc, &timestamp_end_cc);
+	if (ret) {
+		BT_LOGD_STR("Cannot get clock classes of \"timestamp_begin\" "
+				"and \"timestamp_end\" fields");
+		goto error;
+	}
+
+	index = ctf_fs_ds_index_create(file_entry_count);
+	if (!index) {
+		goto error;
+	}
+
+	index_entry = (struct ctf_fs_ds_index_entry *) &g_array_index(
+			index->entries, struct ctf_fs_ds_index_entry, 0);
+	for (i = 0; i < file_entry_count; i++) {
+		struct ctf_packet_index *file_index =
+				(struct ctf_packet_index *) file_pos;
+		uint64_t packet_size = be64toh(file_index->packet_size);
+
+		if (packet_size % CHAR_BIT) {
+			BT_LOGW("Invalid packet size encountered in LTTng trace index file");
+			goto error;
+		}
+
+		/* Convert size in bits to bytes. */
+		packet_size /= CHAR_BIT;
+		index_entry->packet_size = packet_size;
+
+		index_entry->offset = be64toh(file_index->offset);
+		if (i != 0 && index_entry->offset < (index_entry - 1)->offset) {
+			BT_LOGW("Invalid, non-monotonic, packet offset encountered in LTTng trace index file: "
+				"previous offset=%" PRIu64 ", current offset=%" PRIu64,
+				(index_entry - 1)->offset, index_entry->offset);
+			goto error;
+		}
+
+		index_entry->timestamp_begin = be64toh(file_index->timestamp_begin);
+		index_entry->timestamp_end = be64toh(file_index->timestamp_end);
+		if (index_entry->timestamp_end < index_entry->timestamp_begin) {
+			BT_LOGW("Invalid packet time bounds encountered in LTTng trace index file (begin > end): "
+				"timestamp_begin=%" PRIu64 "timestamp_end=%" PRIu64,
+				index_entry->timestamp_begin,
+				index_entry->timestamp_end);
+			goto error;
+		}
+
+		/* Convert the packet's bound to nanoseconds since Epoch. */
+		ret = convert_cycles_to_ns(timestamp_begin_cc,
+				index_entry->timestamp_begin,
+				&index_entry->timestamp_begin_ns);
+		if (ret) {
+			BT_LOGD_STR("Failed to convert raw timestamp to nanoseconds since Epoch during index parsing");
+			goto error;
+		}
+		ret = convert_cycles_to_ns(timestamp_end_cc,
+				index_entry->timestamp_end,
+				&index_entry->timestamp_end_ns);
+		if (ret) {
+			BT_LOGD_STR("Failed to convert raw timestamp to nanoseconds since Epoch during LTTng trace index parsing");
+			goto error;
+		}
+
+		if (has_stream_instance_id) {
+			index_entry->stream_instance_id =
+				be64toh(file_index->stream_instance_id);
+		} else {
+			index_entry->stream_instance_id = -1ULL;
+		}
+
+		total_packets_size += packet_size;
+		file_pos += file_index_entry_size;
+		index_entry++;
+	}
+
+	/* Validate that the index addresses the complete stream. */
+	if (ds_file->file->size != total_packets_size) {
+		BT_LOGW("Invalid LTTng trace index file; indexed size != stream file size: "
+			"file-size=%" PRIu64 ", total-packets-size=%" PRIu64,
+			ds_file->file->size, total_packets_size);
+		goto error;
+	}
+end:
+	bt_put(timestamp_begin_cc);
+	bt_put(timestamp_end_cc);
+	return index;
+error:
+	ctf_fs_ds_index_destroy(index);
+	index = NULL;
+	goto end;
+}
+
 static
 struct ctf_fs_ds_index *build_index_from_idx_file(
 		struct ctf_fs_ds_file *ds_file)
 {
-	int ret;
 	gchar *directory = NULL;
 	gchar *basename = NULL;
 	GString *index_basename = NULL;
@@ -435,25 +725,12 @@ struct ctf_fs_ds_index *build_index_from_idx_file(
 	const char *mmap_begin = NULL, *file_pos = NULL;
 	const struct ctf_packet_index_file_hdr *header = NULL;
 	struct ctf_fs_ds_index *index = NULL;
-	struct ctf_fs_ds_index_entry *index_entry = NULL;
-	uint64_t total_packets_size = 0;
 	size_t file_index_entry_size;
 	size_t file_entry_count;
-	size_t i;
-	struct bt_clock_class *timestamp_begin_cc = NULL;
-	struct bt_clock_class *timestamp_end_cc = NULL;
 
 	BT_LOGD("Building index from .idx file of stream file %s",
 			ds_file->file->path->str);
 
-	ret = get_ds_file_packet_bounds_clock_classes(ds_file,
-			&timestamp_begin_cc, &timestamp_end_cc);
-	if (ret) {
-		BT_LOGD_STR("Cannot get clock classes of \"timestamp_begin\" "
-				"and \"timestamp_end\" fields");
-		goto error;
-	}
-
 	/* Look for index file in relative path index/name.idx. */
 	basename = g_path_get_basename(ds_file->file->path->str);
 	if (!basename) {
@@ -508,6 +785,11 @@ struct ctf_fs_ds_index *build_index_from_idx_file(
 	}
 
 	file_index_entry_size = be32toh(header->packet_index_len);
+	if (file_index_entry_size == 0) {
+		BT_LOGW_STR("Invalid LTTng trace index: index entry size is 0");
+		goto error;
+	}
+
 	file_entry_count = (filesize - sizeof(*header)) / file_index_entry_size;
 	if ((filesize - sizeof(*header)) % file_index_entry_size) {
 		BT_LOGW("Invalid LTTng trace index: the index's size after the header "
@@ -517,85 +799,183 @@ struct ctf_fs_ds_index *build_index_from_idx_file(
 		goto error;
 	}
 
-	index = ctf_fs_ds_index_create(file_entry_count);
+	index = build_index_from_packet_indexes(ds_file, file_pos,
+		file_index_entry_size, file_entry_count);
 	if (!index) {
 		goto error;
 	}
+end:
+	g_free(directory);
+	g_free(basename);
+	g_free(index_file_path);
+	if (index_basename) {
+		g_string_free(index_basename, TRUE);
+	}
+	if (mapped_file) {
+		g_mapped_file_unref(mapped_file);
+	}
+	return index;
+error:
+	ctf_fs_ds_index_destroy(index);
+	index = NULL;
+	goto end;
+}
 
-	index_entry = (struct ctf_fs_ds_index_entry *) &g_array_index(
-			index->entries, struct ctf_fs_ds_index_entry, 0);
-	for (i = 0; i < file_entry_count; i++) {
-		struct ctf_packet_index *file_index =
-				(struct ctf_packet_index *) file_pos;
-		uint64_t packet_size = be64toh(file_index->packet_size);
+/*
+ * Returns the path of the index cache file of `ds_file` within
+ * `cache_dir`. The cache file name is a checksum of the data stream
+ * file's path, so that a single cache directory can hold the index
+ * cache files of many traces.
+ */
+static
+gchar *get_index_cache_file_path(struct ctf_fs_ds_file *ds_file,
+		const char *cache_dir)
+{
+	gchar *checksum;
+	gchar *basename = NULL;
+	gchar *path = NULL;
 
-		if (packet_size % CHAR_BIT) {
-			BT_LOGW("Invalid packet size encountered in LTTng trace index file");
-			goto error;
-		}
+	checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA1,
+		ds_file->file->path->str, -1);
+	if (!checksum) {
+		BT_LOGE_STR("Cannot compute checksum of data stream file path.");
+		goto end;
+	}
 
-		/* Convert size in bits to bytes. */
-		packet_size /= CHAR_BIT;
-		index_entry->packet_size = packet_size;
+	basename = g_strconcat(checksum, CTF_FS_INDEX_CACHE_SUFFIX, NULL);
+	if (!basename) {
+		BT_LOGE_STR("Cannot allocate index cache file basename.");
+		goto end;
+	}
 
-		index_entry->offset = be64toh(file_index->offset);
-		if (i != 0 && index_entry->offset < (index_entry - 1)->offset) {
-			BT_LOGW("Invalid, non-monotonic, packet offset encountered in LTTng trace index file: "
-				"previous offset=%" PRIu64 ", current offset=%" PRIu64,
-				(index_entry - 1)->offset, index_entry->offset);
-			goto error;
-		}
+	path = g_build_filename(cache_dir, basename, NULL);
 
-		index_entry->timestamp_begin = be64toh(file_index->timestamp_begin);
-		index_entry->timestamp_end = be64toh(file_index->timestamp_end);
-		if (index_entry->timestamp_end < index_entry->timestamp_begin) {
-			BT_LOGW("Invalid packet time bounds encountered in LTTng trace index file (begin > end): "
-				"timestamp_begin=%" PRIu64 "timestamp_end=%" PRIu64,
-				index_entry->timestamp_begin,
-				index_entry->timestamp_end);
-			goto error;
-		}
+end:
+	g_free(checksum);
+	g_free(basename);
+	return path;
+}
 
-		/* Convert the packet's bound to nanoseconds since Epoch. */
-		ret = convert_cycles_to_ns(timestamp_begin_cc,
-				index_entry->timestamp_begin,
-				&index_entry->timestamp_begin_ns);
-		if (ret) {
-			BT_LOGD_STR("Failed to convert raw timestamp to nanoseconds since Epoch during index parsing");
-			goto error;
-		}
-		ret = convert_cycles_to_ns(timestamp_end_cc,
-				index_entry->timestamp_end,
-				&index_entry->timestamp_end_ns);
-		if (ret) {
-			BT_LOGD_STR("Failed to convert raw timestamp to nanoseconds since Epoch during LTTng trace index parsing");
-			goto error;
-		}
+/* Sets `*mtime` to the modification time (ns from Epoch) of `ds_file` */
+static
+int get_ds_file_mtime(struct ctf_fs_ds_file *ds_file, int64_t *mtime)
+{
+	struct stat st;
+	int ret;
 
-		total_packets_size += packet_size;
-		file_pos += file_index_entry_size;
-		index_entry++;
+	ret = fstat(fileno(ds_file->file->fp), &st);
+	if (ret) {
+		BT_LOGE_ERRNO("Cannot get data stream file's status",
+			": path=\"%s\"", ds_file->file->path->str);
+		goto end;
 	}
 
-	/* Validate that the index addresses the complete stream. */
-	if (ds_file->file->size != total_packets_size) {
-		BT_LOGW("Invalid LTTng trace index file; indexed size != stream file size: "
-			"file-size=%" PRIu64 ", total-packets-size=%" PRIu64,
-			ds_file->file->size, total_packets_size);
+	/*
+	 * Whole seconds are not enough: a data stream file which is
+	 * rewritten with the same size within the same second (a live
+	 * session flushing a stream file) would match a stale cache file.
+	 */
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+	*mtime = (int64_t) st.st_mtim.tv_sec * INT64_C(1000000000) +
+		(int64_t) st.st_mtim.tv_nsec;
+#else
+	*mtime = (int64_t) st.st_mtime * INT64_C(1000000000);
+#endif
+
+end:
+	return ret;
+}
+
+static
+struct ctf_fs_ds_index *build_index_from_cache_file(
+		struct ctf_fs_ds_file *ds_file, const char *cache_file_path,
+		int64_t mtime)
+{
+	GMappedFile *mapped_file = NULL;
+	gsize filesize;
+	const char *mmap_begin;
+	const char *path;
+	const struct ctf_fs_index_cache_hdr *header;
+	struct ctf_fs_ds_index *index = NULL;
+	size_t path_len;
+	size_t file_index_entry_size;
+	uint64_t file_entry_count;
+
+	BT_LOGD("Building index from index cache file: "
+		"ds-file-path=\"%s\", cache-file-path=\"%s\"",
+		ds_file->file->path->str, cache_file_path);
+	mapped_file = g_mapped_file_new(cache_file_path, FALSE, NULL);
+	if (!mapped_file) {
+		BT_LOGD("Cannot map index cache file: path=\"%s\"",
+			cache_file_path);
 		goto error;
 	}
-end:
-	g_free(directory);
-	g_free(basename);
-	g_free(index_file_path);
-	if (index_basename) {
-		g_string_free(index_basename, TRUE);
+
+	filesize = g_mapped_file_get_length(mapped_file);
+	if (filesize < sizeof(*header)) {
+		BT_LOGW("Invalid index cache file: "
+			"file size (%zu bytes) < header size (%zu bytes)",
+			filesize, sizeof(*header));
+		goto error;
+	}
+
+	mmap_begin = g_mapped_file_get_contents(mapped_file);
+	header = (const struct ctf_fs_index_cache_hdr *) mmap_begin;
+	if (be32toh(header->magic) != CTF_FS_INDEX_CACHE_MAGIC ||
+			be32toh(header->version) != CTF_FS_INDEX_CACHE_VERSION) {
+		BT_LOGW("Invalid index cache file: unexpected magic number or version: "
+			"path=\"%s\"", cache_file_path);
+		goto error;
+	}
+
+	if (be64toh(header->file_size) != ds_file->file->size ||
+			(int64_t) be64toh(header->file_mtime) != mtime) {
+		BT_LOGD("Stale index cache file: path=\"%s\"",
+			cache_file_path);
+		goto error;
+	}
+
+	path_len = be32toh(header->path_len);
+	file_index_entry_size = be32toh(header->packet_index_len);
+	file_entry_count = be64toh(header->packet_index_count);
+	path = mmap_begin + sizeof(*header);
+	if (path_len == 0 || file_index_entry_size == 0 ||
+			path_len > filesize - sizeof(*header) ||
+			file_entry_count != (filesize - sizeof(*header) -
+				path_len) / file_index_entry_size ||
+			(filesize - sizeof(*header) - path_len) %
+				file_index_entry_size) {
+		BT_LOGW("Invalid index cache file: inconsistent sizes: "
+			"path=\"%s\"", cache_file_path);
+		goto error;
+	}
+
+	if (path[path_len - 1] != '\0' ||
+			strcmp(path, ds_file->file->path->str) != 0) {
+		BT_LOGD("Index cache file is not for this data stream file: "
+			"path=\"%s\"", cache_file_path);
+		goto error;
+	}
+
+	/*
+	 * The entries are copied rather than used in place: cached
+	 * entries hold raw clock values which are converted with the
+	 * trace's current clock classes, and the mapping is released
+	 * right away instead of being held for each data stream file
+	 * of the trace.
+	 */
+	index = build_index_from_packet_indexes(ds_file, path + path_len,
+		file_index_entry_size, (size_t) file_entry_count);
+	if (!index) {
+		goto error;
 	}
+
+	BT_LOGD("Built index from index cache file: path=\"%s\", "
+		"entry-count=%" PRIu64, cache_file_path, file_entry_count);
+end:
 	if (mapped_file) {
 		g_mapped_file_unref(mapped_file);
 	}
-	bt_put(timestamp_begin_cc);
-	bt_put(timestamp_end_cc);
 	return index;
 error:
 	ctf_fs_ds_index_destroy(index);
@@ -603,8 +983,146 @@ error:
 	goto end;
 }
 
+/*
+ * Writes `index` to the index cache file `cache_file_path`. The file is
+ * first written to a temporary file which is then renamed, so that a
+ * concurrent reader never sees a partial cache file.
+ *
+ * Failing to write the cache is not an error: the index is simply
+ * built again next time.
+ */
+static
+void write_index_cache_file(struct ctf_fs_ds_file *ds_file,
+		struct ctf_fs_ds_index *index, const char *cache_file_path,
+		int64_t mtime)
+{
+	struct ctf_fs_index_cache_hdr header;
+	gchar *cache_dir = NULL;
+	gchar *tmp_path = NULL;
+	FILE *fp = NULL;
+	const char *path = ds_file->file->path->str;
+	size_t path_len = strlen(path) + 1;
+	size_t i;
+
+	cache_dir = g_path_get_dirname(cache_file_path);
+	if (!cache_dir || g_mkdir_with_parents(cache_dir, 0755)) {
+		BT_LOGW("Cannot create index cache directory: path=\"%s\"",
+			cache_dir);
+		goto error;
+	}
+
+	tmp_path = g_strdup_printf("%s.%ld.tmp", cache_file_path,
+		(long) getpid());
+	if (!tmp_path) {
+		BT_LOGE_STR("Cannot allocate temporary index cache file path.");
+		goto error;
+	}
+
+	fp = fopen(tmp_path, "wb");
+	if (!fp) {
+		BT_LOGW_ERRNO("Cannot open temporary index cache file",
+			": path=\"%s\"", tmp_path);
+		goto error;
+	}
+
+	header.magic = htobe32(CTF_FS_INDEX_CACHE_MAGIC);
+	header.version = htobe32(CTF_FS_INDEX_CACHE_VERSION);
+	header.file_size = htobe64((uint64_t) ds_file->file->size);
+	header.file_mtime = (int64_t) htobe64((uint64_t) mtime);
+	header.path_len = htobe32((uint32_t) path_len);
+	header.packet_index_len = htobe32(sizeof(struct ctf_packet_index));
+	header.packet_index_count = htobe64(index->entries->len);
+
+	if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+			fwrite(path, path_len, 1, fp) != 1) {
+		goto write_error;
+	}
+
+	for (i = 0; i < index->entries->len; i++) {
+		struct ctf_fs_ds_index_entry *entry = &g_array_index(
+			index->entries, struct ctf_fs_ds_index_entry, i);
+		struct ctf_packet_index file_index = { 0 };
+
+		file_index.offset = htobe64(entry->offset);
+		file_index.packet_size = htobe64(entry->packet_size *
+			CHAR_BIT);
+		file_index.timestamp_begin = htobe64(entry->timestamp_begin);
+		file_index.timestamp_end = htobe64(entry->timestamp_end);
+		file_index.stream_instance_id =
+			htobe64(entry->stream_instance_id);
+
+		if (fwrite(&file_index, sizeof(file_index), 1, fp) != 1) {
+			goto write_error;
+		}
+	}
+
+	if (fclose(fp)) {
+		fp = NULL;
+		goto write_error;
+	}
+
+	fp = NULL;
+
+	if (rename(tmp_path, cache_file_path)) {
+		BT_LOGW_ERRNO("Cannot rename temporary index cache file",
+			": tmp-path=\"%s\", path=\"%s\"", tmp_path,
+			cache_file_path);
+		goto error;
+	}
+
+	BT_LOGD("Wrote index cache file: ds-file-path=\"%s\", "
+		"cache-file-path=\"%s\", entry-count=%u",
+		path, cache_file_path, index->entries->len);
+	goto end;
+
+write_error:
+	BT_LOGW_ERRNO("Cannot write temporary index cache file",
+		": path=\"%s\"", tmp_path);
+
+error:
+	if (fp) {
+		fclose(fp);
+	}
+
+	if (tmp_path) {
+		(void) g_unlink(tmp_path);
+	}
+
+end:
+	g_free(cache_dir);
+	g_free(tmp_path);
+}
+
+static
+uint64_t get_packet_header_stream_instance_id(
+		struct bt_field *packet_header)
+{
+	struct bt_field *stream_instance_id_field = NULL;
+	uint64_t stream_instance_id = -1ULL;
+
+	if (!packet_header) {
+		goto end;
+	}
+
+	stream_instance_id_field = bt_field_structure_get_field_by_name(
+		packet_header, "stream_instance_id");
+	if (!stream_instance_id_field) {
+		goto end;
+	}
+
+	if (bt_field_unsigned_integer_get_value(stream_instance_id_field,
+			&stream_instance_id)) {
+		stream_instance_id = -1ULL;
+	}
+
+end:
+	bt_put(stream_instance_id_field);
+	return stream_instance_id;
+}
+
 static
 int init_index_entry(struct ctf_fs_ds_index_entry *entry,
+		struct bt_field *packet_header,
 		struct bt_field *packet_context, off_t packet_size,
 		off_t packet_offset)
 {
@@ -628,6 +1146,8 @@ int init_index_entry(struct ctf_fs_ds_index_entry *entry,
 
 	assert(packet_size >= 0);
 	entry->packet_size = packet_size;
+	entry->stream_instance_id = get_packet_header_stream_instance_id(
+		packet_header);
 
 	ret = bt_field_unsigned_integer_get_value(timestamp_begin,
 			&entry->timestamp_begin);
@@ -671,6 +1191,7 @@ struct ctf_fs_ds_index *build_index_from_stream_file(
 	int ret;
 	struct ctf_fs_ds_index *index = NULL;
 	enum bt_notif_iter_status iter_status;
+	struct bt_field *packet_header = NULL;
 	struct bt_field *packet_context = NULL;
 
 	BT_LOGD("Indexing stream file %s", ds_file->file->path->str);
@@ -687,7 +1208,8 @@ struct ctf_fs_ds_index *build_index_from_stream_file(
 		struct ctf_fs_ds_index_entry *entry;
 
 		iter_status = bt_notif_iter_get_packet_header_context_fields(
-				ds_file->notif_iter, NULL, &packet_context);
+				ds_file->notif_iter, &packet_header,
+				&packet_context);
 		if (iter_status != BT_NOTIF_ITER_STATUS_OK) {
 			if (iter_status == BT_NOTIF_ITER_STATUS_EOF) {
 				break;
@@ -736,7 +1258,7 @@ struct ctf_fs_ds_index *build_index_from_stream_file(
 			goto error;
 		}
 
-		ret = init_index_entry(entry, packet_context,
+		ret = init_index_entry(entry, packet_header, packet_context,
 				current_packet_size_bytes,
 				current_packet_offset);
 		if (ret) {
@@ -745,6 +1267,7 @@ struct ctf_fs_ds_index *build_index_from_stream_file(
 
 		iter_status = bt_notif_iter_seek(ds_file->notif_iter,
 				next_packet_offset);
+		BT_PUT(packet_header);
 		BT_PUT(packet_context);
 	} while (iter_status == BT_NOTIF_ITER_STATUS_OK);
 
@@ -752,6 +1275,7 @@ struct ctf_fs_ds_index *build_index_from_stream_file(
 		goto error;
 	}
 end:
+	bt_put(packet_header);
 	bt_put(packet_context);
 	return index;
 error:
@@ -760,6 +1284,15 @@ error:
 	goto end;
 }
 
+BT_HIDDEN
+void ctf_fs_ds_file_config_init(struct ctf_fs_ds_file_config *config)
+{
+	config->medium = CTF_FS_DS_FILE_MEDIUM_MMAP;
+	config->window_size = bt_common_get_page_size() * 2048;
+	config->mmap_whole_file = false;
+	config->read_ahead = true;
+}
+
 BT_HIDDEN
 struct ctf_fs_ds_file *ctf_fs_ds_file_create(
 		struct ctf_fs_trace *ctf_fs_trace,
@@ -793,7 +1326,22 @@ struct ctf_fs_ds_file *ctf_fs_ds_file_create(
 		goto error;
 	}
 
-	ds_file->mmap_max_len = page_size * 2048;
+	ds_file->config = ctf_fs_trace->ds_file_config;
+	ds_file->window_max_len = ds_file->config.window_size;
+
+	if (ds_file->config.medium == CTF_FS_DS_FILE_MEDIUM_MMAP &&
+			ds_file->config.mmap_whole_file) {
+		/* Round up to the page size: one window for the file */
+		ds_file->window_max_len = MAX(ds_file->window_max_len,
+			((size_t) ds_file->file->size + page_size - 1) &
+				~(page_size - 1));
+	}
+
+	if (ds_file->config.read_ahead &&
+			ds_file->config.medium == CTF_FS_DS_FILE_MEDIUM_READ) {
+		(void) bt_posix_fadvise(fileno(ds_file->file->fp), 0, 0,
+			BT_POSIX_FADV_SEQUENTIAL);
+	}
 
 	goto end;
 
@@ -808,19 +1356,40 @@ end:
 
 BT_HIDDEN
 struct ctf_fs_ds_index *ctf_fs_ds_file_build_index(
-		struct ctf_fs_ds_file *ds_file)
+		struct ctf_fs_ds_file *ds_file, const char *index_cache_dir)
 {
 	struct ctf_fs_ds_index *index;
+	gchar *cache_file_path = NULL;
+	int64_t mtime;
 
 	index = build_index_from_idx_file(ds_file);
 	if (index) {
 		goto end;
 	}
 
+	if (index_cache_dir && get_ds_file_mtime(ds_file, &mtime) == 0) {
+		cache_file_path = get_index_cache_file_path(ds_file,
+			index_cache_dir);
+	}
+
+	if (cache_file_path) {
+		index = build_index_from_cache_file(ds_file, cache_file_path,
+			mtime);
+		if (index) {
+			goto end;
+		}
+	}
+
 	BT_LOGD("Failed to build index from .index file; "
 		"falling back to stream indexing.");
 	index = build_index_from_stream_file(ds_file);
+	if (index && cache_file_path) {
+		write_index_cache_file(ds_file, index, cache_file_path,
+			mtime);
+	}
+
 end:
+	g_free(cache_file_path);
 	return index;
 }
 
@@ -833,7 +1402,8 @@ void ctf_fs_ds_file_destroy(struct ctf_fs_ds_file *ds_file)
 
 	bt_put(ds_file->cc_prio_map);
 	bt_put(ds_file->stream);
-	(void) ds_file_munmap(ds_file);
+	ds_file_release_window(ds_file);
+	g_free(ds_file->read_buf);
 
 	if (ds_file->file) {
 		ctf_fs_file_destroy(ds_file->file);
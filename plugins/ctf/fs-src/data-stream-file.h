@@ -36,6 +36,7 @@ struct ctf_fs_component;
 struct ctf_fs_file;
 struct ctf_fs_trace;
 struct ctf_fs_ds_file;
+struct ctf_fs_ds_file_mapping;
 
 struct ctf_fs_ds_index_entry {
 	/* Position, in bytes, of the packet from the beginning of the file. */
@@ -55,6 +56,12 @@ struct ctf_fs_ds_index_entry {
 	 * (in ns since EPOCH).
 	 */
 	int64_t timestamp_begin_ns, timestamp_end_ns;
+
+	/*
+	 * Extracted from the packet header (-1ULL means none or
+	 * unknown).
+	 */
+	uint64_t stream_instance_id;
 };
 
 struct ctf_fs_ds_index {
@@ -84,6 +91,41 @@ struct ctf_fs_ds_file_info {
 	uint64_t begin_ns;
 };
 
+/* How the data of a data stream file is accessed */
+enum ctf_fs_ds_file_medium {
+	/* Memory-map windows of the file */
+	CTF_FS_DS_FILE_MEDIUM_MMAP,
+
+	/* Read windows of the file into a buffer */
+	CTF_FS_DS_FILE_MEDIUM_READ,
+};
+
+/* Data stream file reading configuration */
+struct ctf_fs_ds_file_config {
+	enum ctf_fs_ds_file_medium medium;
+
+	/*
+	 * Size of a window of the file (bytes), that is, of a memory
+	 * mapping or of the read buffer. This value must be
+	 * page-aligned.
+	 */
+	size_t window_size;
+
+	/*
+	 * True to memory-map a whole data stream file at once instead
+	 * of windows of window_size bytes (CTF_FS_DS_FILE_MEDIUM_MMAP
+	 * only).
+	 */
+	bool mmap_whole_file;
+
+	/*
+	 * True to advise the system that files are read sequentially
+	 * and to prefetch the next window while the current one is
+	 * decoded.
+	 */
+	bool read_ahead;
+};
+
 struct ctf_fs_ds_file {
 	/* Owned by this */
 	struct ctf_fs_file *file;
@@ -97,26 +139,46 @@ struct ctf_fs_ds_file {
 	/* Weak */
 	struct bt_notif_iter *notif_iter;
 
-	void *mmap_addr;
+	struct ctf_fs_ds_file_config config;
+
+	/*
+	 * Address of the current window: a memory mapping
+	 * (CTF_FS_DS_FILE_MEDIUM_MMAP) or read_buf
+	 * (CTF_FS_DS_FILE_MEDIUM_READ). NULL if there's no current
+	 * window.
+	 */
+	void *window_addr;
 
 	/*
-	 * Max length of chunk to mmap() when updating the current mapping.
+	 * Memory mapping of the current window (owned by this), or NULL
+	 * if there's no current window or if the medium is
+	 * CTF_FS_DS_FILE_MEDIUM_READ. Fields of the events of this file
+	 * can refer to its bytes and keep it alive (see
+	 * bt_notif_iter_medium_ops::get_buffer_owner()).
+	 */
+	struct ctf_fs_ds_file_mapping *mapping;
+
+	/*
+	 * Max length of a window when updating the current window.
 	 * This value must be page-aligned.
 	 */
-	size_t mmap_max_len;
+	size_t window_max_len;
 
-	/* Length of the current mapping. Never exceeds the file's length. */
-	size_t mmap_len;
+	/* Length of the current window. Never exceeds the file's length. */
+	size_t window_len;
 
-	/* Offset in the file where the current mapping starts. */
-	off_t mmap_offset;
+	/* Offset in the file where the current window starts. */
+	off_t window_offset;
 
 	/*
-	 * Offset, in the current mapping, of the address to return on the next
-	 * request.
+	 * Offset, in the current window, of the address to return on the
+	 * next request.
 	 */
 	off_t request_offset;
 
+	/* Read buffer (window_max_len bytes), owned by this */
+	uint8_t *read_buf;
+
 	bool end_reached;
 };
 
@@ -141,11 +203,14 @@ struct bt_notification_iterator_next_method_return ctf_fs_ds_file_next(
 
 BT_HIDDEN
 struct ctf_fs_ds_index *ctf_fs_ds_file_build_index(
-		struct ctf_fs_ds_file *ds_file);
+		struct ctf_fs_ds_file *ds_file, const char *index_cache_dir);
 
 BT_HIDDEN
 void ctf_fs_ds_index_destroy(struct ctf_fs_ds_index *index);
 
+BT_HIDDEN
+void ctf_fs_ds_file_config_init(struct ctf_fs_ds_file_config *config);
+
 extern struct bt_notif_iter_medium_ops ctf_fs_ds_file_medops;
 
 #endif /* CTF_FS_DS_FILE_H */
@@ -32,7 +32,10 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <pthread.h>
 #include "fs.h"
+#include "index-cache.h"
 #include "metadata.h"
 #include "data-stream-file.h"
 #include "file.h"
@@ -136,6 +139,177 @@ end:
 	return next_ret;
 }
 
+enum bt_notification_iterator_status ctf_fs_iterator_next_batch(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct ctf_fs_notif_iter_data *notif_iter_data =
+		bt_private_connection_private_notification_iterator_get_user_data(iterator);
+	enum bt_notification_iterator_status status =
+		notif_iter_data->pending_status;
+	uint64_t i = 0;
+
+	if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		/* Status deferred by the previous call */
+		notif_iter_data->pending_status =
+			BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		goto end;
+	}
+
+	while (i < capacity) {
+		struct bt_notification_iterator_next_method_return next_ret =
+			ctf_fs_iterator_next(iterator);
+
+		if (next_ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			if (i == 0) {
+				status = next_ret.status;
+			} else {
+				/*
+				 * Deliver the notifications we have
+				 * first: ctf_fs_iterator_next() must
+				 * not be called again after the end.
+				 */
+				notif_iter_data->pending_status =
+					next_ret.status;
+			}
+
+			break;
+		}
+
+		notifications[i] = next_ret.notification;
+		i++;
+	}
+
+end:
+	*count = i;
+	return status;
+}
+
+/*
+ * Returns the index of the first entry of `index` of which the end time
+ * is greater than or equal to `ns_from_epoch`, or -1 if there's none.
+ */
+static
+gint find_index_entry_ending_after(struct ctf_fs_ds_index *index,
+		int64_t ns_from_epoch)
+{
+	guint low = 0;
+	guint high = index->entries->len;
+
+	/* Index entries are sorted by time within a data stream file */
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+		struct ctf_fs_ds_index_entry *entry = &g_array_index(
+			index->entries, struct ctf_fs_ds_index_entry, mid);
+
+		if (entry->timestamp_end_ns < ns_from_epoch) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low < index->entries->len ? (gint) low : -1;
+}
+
+enum bt_notification_iterator_status ctf_fs_iterator_seek_time(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		int64_t ns_from_epoch)
+{
+	struct ctf_fs_notif_iter_data *notif_iter_data =
+		bt_private_connection_private_notification_iterator_get_user_data(iterator);
+	GPtrArray *ds_file_infos = notif_iter_data->ds_file_group->ds_file_infos;
+	enum bt_notification_iterator_status ret =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	enum bt_notif_iter_status iter_status;
+	size_t ds_file_info_index = 0;
+	off_t offset = -1;
+	size_t i;
+
+	/*
+	 * Start with the last data stream file which begins before the
+	 * requested time: the files of a group are sorted by beginning
+	 * time. The beginning times are not negative: all the files
+	 * begin after a negative requested time.
+	 */
+	for (i = 1; i < ds_file_infos->len; i++) {
+		struct ctf_fs_ds_file_info *ds_file_info =
+			g_ptr_array_index(ds_file_infos, i);
+
+		if (ns_from_epoch < 0 ||
+				ds_file_info->begin_ns > (uint64_t) ns_from_epoch) {
+			break;
+		}
+
+		ds_file_info_index = i;
+	}
+
+	for (i = ds_file_info_index; i < ds_file_infos->len; i++) {
+		struct ctf_fs_ds_file_info *ds_file_info =
+			g_ptr_array_index(ds_file_infos, i);
+		gint entry_index;
+
+		if (!ds_file_info->index) {
+			/*
+			 * Without an index, the best we can do is to
+			 * start decoding at the beginning of the file.
+			 */
+			offset = 0;
+			break;
+		}
+
+		entry_index = find_index_entry_ending_after(
+			ds_file_info->index, ns_from_epoch);
+		if (entry_index >= 0) {
+			offset = g_array_index(ds_file_info->index->entries,
+				struct ctf_fs_ds_index_entry, entry_index).offset;
+			break;
+		}
+	}
+
+	if (i == ds_file_infos->len) {
+		/*
+		 * All the packets of the group end before the requested
+		 * time: position the iterator at the end of the last
+		 * file.
+		 */
+		i = ds_file_infos->len - 1;
+	}
+
+	BT_LOGD("Seeking data stream file group: ns-from-epoch=%" PRId64 ", "
+		"ds-file-info-index=%zu, offset=%jd",
+		ns_from_epoch, i, (intmax_t) offset);
+
+	if (!notif_iter_data->ds_file ||
+			i != notif_iter_data->ds_file_info_index) {
+		notif_iter_data->ds_file_info_index = i;
+		if (notif_iter_data_set_current_ds_file(notif_iter_data)) {
+			ret = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+	if (offset < 0) {
+		offset = notif_iter_data->ds_file->file->size;
+	}
+
+	iter_status = bt_notif_iter_seek(notif_iter_data->notif_iter, offset);
+	if (iter_status != BT_NOTIF_ITER_STATUS_OK &&
+			iter_status != BT_NOTIF_ITER_STATUS_EOF) {
+		BT_LOGE("Cannot seek data stream file: path=\"%s\", offset=%jd",
+			notif_iter_data->ds_file->file->path->str,
+			(intmax_t) offset);
+		ret = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		goto end;
+	}
+
+	notif_iter_data->pending_status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+end:
+	return ret;
+}
+
 void ctf_fs_iterator_finalize(struct bt_private_connection_private_notification_iterator *it)
 {
 	void *notif_iter_data =
@@ -214,6 +388,10 @@ void ctf_fs_destroy(struct ctf_fs_component *ctf_fs)
 		g_ptr_array_free(ctf_fs->port_data, TRUE);
 	}
 
+	if (ctf_fs->index_config.cache_dir) {
+		g_string_free(ctf_fs->index_config.cache_dir, TRUE);
+	}
+
 	g_free(ctf_fs);
 }
 
@@ -236,6 +414,10 @@ void ctf_fs_trace_destroy(struct ctf_fs_trace *ctf_fs_trace)
 		g_string_free(ctf_fs_trace->name, TRUE);
 	}
 
+	if (ctf_fs_trace->index_cache_dir) {
+		g_string_free(ctf_fs_trace->index_cache_dir, TRUE);
+	}
+
 	if (ctf_fs_trace->metadata) {
 		ctf_fs_metadata_fini(ctf_fs_trace->metadata);
 		g_free(ctf_fs_trace->metadata);
@@ -603,23 +785,107 @@ end:
 	return ret;
 }
 
+/* Result of the scan of a single data stream file */
+struct ds_file_scan {
+	/* Owned by this */
+	GString *path;
+
+	/* ID of the stream class of the file's first packet */
+	int64_t stream_class_id;
+
+	/* Stream instance ID of the file's first packet; -1ULL means none */
+	uint64_t stream_instance_id;
+
+	/* Beginning time of the file's first packet (ns); -1ULL means none */
+	uint64_t begin_ns;
+
+	/* Owned by this; NULL if the file could not be indexed */
+	struct ctf_fs_ds_index *index;
+
+	/* 0 if the file was successfully scanned */
+	int ret;
+};
+
+/* Shared state of the data stream file scan workers */
+struct ds_file_scan_pool {
+	/* Weak */
+	struct ctf_fs_trace *ctf_fs_trace;
+
+	/* Weak, may be NULL */
+	struct ctf_fs_metadata_config *metadata_config;
+
+	/* Array of struct ds_file_scan *, weak */
+	GPtrArray *scans;
+
+	/* Index, within scans, of the next file to scan (protected by lock) */
+	guint next_scan;
+
+	pthread_mutex_t lock;
+};
+
 static
-int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
-		const char *path)
+void ds_file_scan_destroy(struct ds_file_scan *scan)
+{
+	if (!scan) {
+		return;
+	}
+
+	if (scan->path) {
+		g_string_free(scan->path, TRUE);
+	}
+
+	ctf_fs_ds_index_destroy(scan->index);
+	g_free(scan);
+}
+
+static
+struct ds_file_scan *ds_file_scan_create(const char *path)
+{
+	struct ds_file_scan *scan = g_new0(struct ds_file_scan, 1);
+
+	if (!scan) {
+		goto error;
+	}
+
+	scan->path = g_string_new(path);
+	if (!scan->path) {
+		goto error;
+	}
+
+	scan->stream_class_id = -1;
+	scan->stream_instance_id = -1ULL;
+	scan->begin_ns = -1ULL;
+	scan->ret = -1;
+	goto end;
+
+error:
+	ds_file_scan_destroy(scan);
+	scan = NULL;
+
+end:
+	return scan;
+}
+
+/*
+ * Reads the first packet's header and context of a data stream file
+ * and builds its index.
+ *
+ * This only uses the CTF IR objects of `ctf_fs_trace`, and only sets
+ * plain data within `scan`, so that scans using different CTF FS
+ * traces can run concurrently.
+ */
+static
+void scan_ds_file(struct ctf_fs_trace *ctf_fs_trace, struct ds_file_scan *scan)
 {
 	struct bt_field *packet_header_field = NULL;
 	struct bt_field *packet_context_field = NULL;
 	struct bt_stream_class *stream_class = NULL;
-	uint64_t stream_instance_id = -1ULL;
-	uint64_t begin_ns = -1ULL;
-	struct ctf_fs_ds_file_group *ds_file_group = NULL;
-	bool add_group = false;
-	int ret;
-	size_t i;
 	struct ctf_fs_ds_file *ds_file = NULL;
-	struct ctf_fs_ds_index *index = NULL;
 	struct bt_notif_iter *notif_iter = NULL;
+	const char *path = scan->path->str;
+	int ret;
 
+	BT_LOGD("Scanning data stream file: path=\"%s\"", path);
 	notif_iter = bt_notif_iter_create(ctf_fs_trace->metadata->trace,
 		bt_common_get_page_size() * 8, ctf_fs_ds_file_medops, NULL);
 	if (!notif_iter) {
@@ -640,9 +906,9 @@ int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
 		goto error;
 	}
 
-	stream_instance_id = get_packet_header_stream_instance_id(ctf_fs_trace,
-		packet_header_field);
-	begin_ns = get_packet_context_timestamp_begin_ns(ctf_fs_trace,
+	scan->stream_instance_id = get_packet_header_stream_instance_id(
+		ctf_fs_trace, packet_header_field);
+	scan->begin_ns = get_packet_context_timestamp_begin_ns(ctf_fs_trace,
 		packet_context_field);
 	stream_class = ctf_utils_stream_class_from_packet_header(
 		ctf_fs_trace->metadata->trace, packet_header_field);
@@ -650,12 +916,240 @@ int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
 		goto error;
 	}
 
-	index = ctf_fs_ds_file_build_index(ds_file);
-	if (!index) {
+	scan->stream_class_id = bt_stream_class_get_id(stream_class);
+	if (scan->stream_class_id < 0) {
+		BT_LOGE("Cannot get stream class's ID (`%s`).", path);
+		goto error;
+	}
+
+	scan->index = ctf_fs_ds_file_build_index(ds_file,
+		ctf_fs_trace->index_cache_dir ?
+			ctf_fs_trace->index_cache_dir->str : NULL);
+	if (!scan->index) {
 		BT_LOGW("Failed to index CTF stream file \'%s\'",
 			ds_file->file->path->str);
 	}
 
+	scan->ret = 0;
+	goto end;
+
+error:
+	scan->ret = -1;
+
+end:
+	ctf_fs_ds_file_destroy(ds_file);
+
+	if (notif_iter) {
+		bt_notif_iter_destroy(notif_iter);
+	}
+
+	bt_put(packet_header_field);
+	bt_put(packet_context_field);
+	bt_put(stream_class);
+}
+
+/*
+ * Creates a CTF FS trace which only contains its own CTF IR trace,
+ * decoded from the metadata file of `ctf_fs_trace`.
+ */
+static
+struct ctf_fs_trace *create_scan_trace(struct ctf_fs_trace *ctf_fs_trace,
+		struct ctf_fs_metadata_config *metadata_config)
+{
+	struct ctf_fs_trace *scan_trace = g_new0(struct ctf_fs_trace, 1);
+
+	if (!scan_trace) {
+		goto error;
+	}
+
+	scan_trace->path = g_string_new(ctf_fs_trace->path->str);
+	if (!scan_trace->path) {
+		goto error;
+	}
+
+	scan_trace->name = g_string_new(ctf_fs_trace->name->str);
+	if (!scan_trace->name) {
+		goto error;
+	}
+
+	if (ctf_fs_trace->index_cache_dir) {
+		scan_trace->index_cache_dir = g_string_new(
+			ctf_fs_trace->index_cache_dir->str);
+		if (!scan_trace->index_cache_dir) {
+			goto error;
+		}
+	}
+
+	scan_trace->ds_file_config = ctf_fs_trace->ds_file_config;
+	scan_trace->metadata = g_new0(struct ctf_fs_metadata, 1);
+	if (!scan_trace->metadata) {
+		goto error;
+	}
+
+	if (ctf_fs_metadata_set_trace(scan_trace, metadata_config)) {
+		goto error;
+	}
+
+	goto end;
+
+error:
+	ctf_fs_trace_destroy(scan_trace);
+	scan_trace = NULL;
+
+end:
+	return scan_trace;
+}
+
+static
+struct ds_file_scan *ds_file_scan_pool_next(struct ds_file_scan_pool *pool)
+{
+	struct ds_file_scan *scan = NULL;
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (pool->next_scan < pool->scans->len) {
+		scan = g_ptr_array_index(pool->scans, pool->next_scan);
+		pool->next_scan++;
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+	return scan;
+}
+
+static
+void *ds_file_scan_worker(void *data)
+{
+	struct ds_file_scan_pool *pool = data;
+	struct ctf_fs_trace *scan_trace;
+	struct ds_file_scan *scan;
+
+	/*
+	 * CTF IR objects are not thread-safe: each worker decodes the
+	 * trace's metadata again to work with its own CTF IR trace.
+	 * If this fails, this worker does not scan anything; the
+	 * remaining workers scan all the files.
+	 */
+	scan_trace = create_scan_trace(pool->ctf_fs_trace,
+		pool->metadata_config);
+	if (!scan_trace) {
+		BT_LOGE("Cannot create data stream file scan worker's trace: "
+			"trace-path=\"%s\"", pool->ctf_fs_trace->path->str);
+		goto end;
+	}
+
+	while ((scan = ds_file_scan_pool_next(pool))) {
+		scan_ds_file(scan_trace, scan);
+	}
+
+end:
+	ctf_fs_trace_destroy(scan_trace);
+	return NULL;
+}
+
+/*
+ * Scans all the data stream files of `scans`, with at most `jobs`
+ * concurrent workers.
+ */
+static
+void scan_ds_files(struct ctf_fs_trace *ctf_fs_trace,
+		struct ctf_fs_metadata_config *metadata_config,
+		GPtrArray *scans, unsigned int jobs)
+{
+	struct ds_file_scan_pool pool = {
+		.ctf_fs_trace = ctf_fs_trace,
+		.metadata_config = metadata_config,
+		.scans = scans,
+		.next_scan = 0,
+	};
+	pthread_t *threads = NULL;
+	unsigned int thread_count = 0;
+	unsigned int i;
+	struct ds_file_scan *scan;
+
+	if (jobs > scans->len) {
+		jobs = scans->len;
+	}
+
+	if (jobs <= 1) {
+		/* Serial scan with the trace's own CTF IR objects */
+		goto serial;
+	}
+
+	if (pthread_mutex_init(&pool.lock, NULL)) {
+		BT_LOGW_STR("Cannot initialize mutex: scanning data stream files serially.");
+		goto serial;
+	}
+
+	threads = g_new0(pthread_t, jobs);
+	if (!threads) {
+		BT_LOGE_STR("Failed to allocate thread array.");
+		goto join;
+	}
+
+	BT_LOGD("Scanning data stream files in parallel: trace-path=\"%s\", "
+		"file-count=%u, jobs=%u", ctf_fs_trace->path->str,
+		scans->len, jobs);
+
+	for (i = 0; i < jobs; i++) {
+		if (pthread_create(&threads[thread_count], NULL,
+				ds_file_scan_worker, &pool)) {
+			BT_LOGW("Cannot create data stream file scan worker: "
+				"index=%u", i);
+			break;
+		}
+
+		thread_count++;
+	}
+
+join:
+	for (i = 0; i < thread_count; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	g_free(threads);
+	pthread_mutex_destroy(&pool.lock);
+
+serial:
+	/*
+	 * Scan what's left (everything if there's no worker) in this
+	 * thread. At this point, all the workers are done.
+	 */
+	for (; pool.next_scan < scans->len; pool.next_scan++) {
+		scan = g_ptr_array_index(scans, pool.next_scan);
+		scan_ds_file(ctf_fs_trace, scan);
+	}
+}
+
+static
+int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
+		struct ds_file_scan *scan)
+{
+	struct bt_stream_class *stream_class = NULL;
+	uint64_t stream_instance_id = scan->stream_instance_id;
+	uint64_t begin_ns = scan->begin_ns;
+	struct ctf_fs_ds_file_group *ds_file_group = NULL;
+	bool add_group = false;
+	const char *path = scan->path->str;
+	int ret;
+	size_t i;
+
+	if (scan->ret) {
+		goto error;
+	}
+
+	/*
+	 * The scan could have been performed with another CTF IR
+	 * trace: find the equivalent stream class by ID.
+	 */
+	stream_class = bt_trace_get_stream_class_by_id(
+		ctf_fs_trace->metadata->trace, scan->stream_class_id);
+	if (!stream_class) {
+		BT_LOGE("Cannot find stream class: trace-path=\"%s\", "
+			"stream-class-id=%" PRId64, ctf_fs_trace->path->str,
+			scan->stream_class_id);
+		goto error;
+	}
+
 	if (begin_ns == -1ULL) {
 		/*
 		 * No beggining timestamp to sort the stream files
@@ -680,9 +1174,9 @@ int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
 		}
 
 		ret = ctf_fs_ds_file_group_add_ds_file_info(ds_file_group,
-			path, begin_ns, index);
+			path, begin_ns, scan->index);
 		/* Ownership of index is transferred. */
-		index = NULL;
+		scan->index = NULL;
 		if (ret) {
 			goto error;
 		}
@@ -719,8 +1213,8 @@ int add_ds_file_to_ds_file_group(struct ctf_fs_trace *ctf_fs_trace,
 	}
 
 	ret = ctf_fs_ds_file_group_add_ds_file_info(ds_file_group, path,
-		begin_ns, index);
-	index = NULL;
+		begin_ns, scan->index);
+	scan->index = NULL;
 	if (ret) {
 		goto error;
 	}
@@ -736,28 +1230,29 @@ end:
 		g_ptr_array_add(ctf_fs_trace->ds_file_groups, ds_file_group);
 	}
 
-	ctf_fs_ds_file_destroy(ds_file);
-
-	if (notif_iter) {
-		bt_notif_iter_destroy(notif_iter);
-	}
-
-	ctf_fs_ds_index_destroy(index);
-	bt_put(packet_header_field);
-	bt_put(packet_context_field);
 	bt_put(stream_class);
 	return ret;
 }
 
 static
-int create_ds_file_groups(struct ctf_fs_trace *ctf_fs_trace)
+int create_ds_file_groups(struct ctf_fs_trace *ctf_fs_trace,
+		struct ctf_fs_metadata_config *metadata_config,
+		unsigned int index_jobs)
 {
 	int ret = 0;
 	const char *basename;
 	GError *error = NULL;
 	GDir *dir = NULL;
+	GPtrArray *scans = NULL;
 	size_t i;
 
+	scans = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) ds_file_scan_destroy);
+	if (!scans) {
+		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		goto error;
+	}
+
 	/* Check each file in the path directory, except specific ones */
 	dir = g_dir_open(ctf_fs_trace->path->str, 0, &error);
 	if (!dir) {
@@ -769,6 +1264,7 @@ int create_ds_file_groups(struct ctf_fs_trace *ctf_fs_trace)
 
 	while ((basename = g_dir_read_name(dir))) {
 		struct ctf_fs_file *file;
+		struct ds_file_scan *scan;
 
 		if (!strcmp(basename, CTF_FS_METADATA_FILENAME)) {
 			/* Ignore the metadata stream. */
@@ -815,16 +1311,36 @@ int create_ds_file_groups(struct ctf_fs_trace *ctf_fs_trace)
 			continue;
 		}
 
-		ret = add_ds_file_to_ds_file_group(ctf_fs_trace,
-			file->path->str);
+		scan = ds_file_scan_create(file->path->str);
+		ctf_fs_file_destroy(file);
+		if (!scan) {
+			BT_LOGE_STR("Cannot create data stream file scan.");
+			goto error;
+		}
+
+		g_ptr_array_add(scans, scan);
+	}
+
+	/*
+	 * Reading the first packet's header and context of each data
+	 * stream file and building its index is the costly part: do
+	 * it in parallel.
+	 */
+	scan_ds_files(ctf_fs_trace, metadata_config, scans, index_jobs);
+
+	/*
+	 * Group the data stream files serially, in directory order, so
+	 * that the result does not depend on the scan order.
+	 */
+	for (i = 0; i < scans->len; i++) {
+		struct ds_file_scan *scan = g_ptr_array_index(scans, i);
+
+		ret = add_ds_file_to_ds_file_group(ctf_fs_trace, scan);
 		if (ret) {
 			BT_LOGE("Cannot add stream file `%s` to stream file group",
-				file->path->str);
-			ctf_fs_file_destroy(file);
+				scan->path->str);
 			goto error;
 		}
-
-		ctf_fs_file_destroy(file);
 	}
 
 	/*
@@ -879,6 +1395,10 @@ end:
 		g_error_free(error);
 	}
 
+	if (scans) {
+		g_ptr_array_free(scans, TRUE);
+	}
+
 	return ret;
 }
 
@@ -921,9 +1441,12 @@ end:
 
 BT_HIDDEN
 struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
-		struct ctf_fs_metadata_config *metadata_config)
+		struct ctf_fs_metadata_config *metadata_config,
+		struct ctf_fs_index_config *index_config,
+		struct ctf_fs_ds_file_config *ds_file_config)
 {
 	struct ctf_fs_trace *ctf_fs_trace;
+	unsigned int index_jobs = 0;
 	int ret;
 
 	ctf_fs_trace = g_new0(struct ctf_fs_trace, 1);
@@ -941,6 +1464,34 @@ struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
 		goto error;
 	}
 
+	if (index_config && index_config->cache) {
+		if (index_config->cache_dir) {
+			ctf_fs_trace->index_cache_dir = g_string_new(
+				index_config->cache_dir->str);
+		} else {
+			ctf_fs_trace->index_cache_dir = g_string_new(path);
+			if (ctf_fs_trace->index_cache_dir) {
+				g_string_append(ctf_fs_trace->index_cache_dir,
+					G_DIR_SEPARATOR_S
+					CTF_FS_INDEX_CACHE_DEFAULT_DIR);
+			}
+		}
+
+		if (!ctf_fs_trace->index_cache_dir) {
+			goto error;
+		}
+	}
+
+	if (index_config) {
+		index_jobs = index_config->jobs;
+	}
+
+	if (ds_file_config) {
+		ctf_fs_trace->ds_file_config = *ds_file_config;
+	} else {
+		ctf_fs_ds_file_config_init(&ctf_fs_trace->ds_file_config);
+	}
+
 	ctf_fs_trace->metadata = g_new0(struct ctf_fs_metadata, 1);
 	if (!ctf_fs_trace->metadata) {
 		goto error;
@@ -957,7 +1508,8 @@ struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
 		goto error;
 	}
 
-	ret = create_ds_file_groups(ctf_fs_trace);
+	ret = create_ds_file_groups(ctf_fs_trace, metadata_config,
+		index_jobs ? index_jobs : bt_common_get_cpu_count());
 	if (ret) {
 		goto error;
 	}
@@ -1205,7 +1757,8 @@ int create_ctf_fs_traces(struct ctf_fs_component *ctf_fs,
 		GString *trace_name = tn_node->data;
 
 		ctf_fs_trace = ctf_fs_trace_create(trace_path->str,
-				trace_name->str, &ctf_fs->metadata_config);
+				trace_name->str, &ctf_fs->metadata_config,
+				&ctf_fs->index_config, &ctf_fs->ds_file_config);
 		if (!ctf_fs_trace) {
 			BT_LOGE("Cannot create trace for `%s`.",
 				trace_path->str);
@@ -1279,6 +1832,7 @@ struct ctf_fs_component *ctf_fs_create(struct bt_private_component *priv_comp,
 	 * private component should also exist.
 	 */
 	ctf_fs->priv_comp = priv_comp;
+	ctf_fs_ds_file_config_init(&ctf_fs->ds_file_config);
 	value = bt_value_map_get(params, "path");
 	if (!bt_value_is_string(value)) {
 		goto error;
@@ -1311,6 +1865,150 @@ struct ctf_fs_component *ctf_fs_create(struct bt_private_component *priv_comp,
 		BT_PUT(value);
 	}
 
+	value = bt_value_map_get(params, "index-jobs");
+	if (value) {
+		int64_t index_jobs;
+
+		if (!bt_value_is_integer(value)) {
+			BT_LOGE("index-jobs should be an integer");
+			goto error;
+		}
+		value_ret = bt_value_integer_get(value, &index_jobs);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+		BT_PUT(value);
+
+		if (index_jobs < 1 || index_jobs > UINT_MAX) {
+			BT_LOGE("index-jobs should be greater than 0: "
+				"value=%" PRId64, index_jobs);
+			goto error;
+		}
+
+		ctf_fs->index_config.jobs = (unsigned int) index_jobs;
+	}
+
+	value = bt_value_map_get(params, "index-cache");
+	if (value) {
+		bt_bool cache;
+
+		if (!bt_value_is_bool(value)) {
+			BT_LOGE("index-cache should be a boolean");
+			goto error;
+		}
+		value_ret = bt_value_bool_get(value, &cache);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+		BT_PUT(value);
+		ctf_fs->index_config.cache = cache;
+	}
+
+	value = bt_value_map_get(params, "index-cache-dir");
+	if (value) {
+		const char *cache_dir;
+
+		if (!bt_value_is_string(value)) {
+			BT_LOGE("index-cache-dir should be a string");
+			goto error;
+		}
+		value_ret = bt_value_string_get(value, &cache_dir);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+		ctf_fs->index_config.cache_dir = g_string_new(cache_dir);
+		BT_PUT(value);
+		if (!ctf_fs->index_config.cache_dir) {
+			goto error;
+		}
+
+		/* Setting a cache directory enables the cache */
+		ctf_fs->index_config.cache = true;
+	}
+
+	value = bt_value_map_get(params, "data-medium");
+	if (value) {
+		const char *medium;
+
+		if (!bt_value_is_string(value)) {
+			BT_LOGE("data-medium should be a string");
+			goto error;
+		}
+		value_ret = bt_value_string_get(value, &medium);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+
+		if (strcmp(medium, "mmap") == 0) {
+			ctf_fs->ds_file_config.medium =
+				CTF_FS_DS_FILE_MEDIUM_MMAP;
+		} else if (strcmp(medium, "read") == 0) {
+			ctf_fs->ds_file_config.medium =
+				CTF_FS_DS_FILE_MEDIUM_READ;
+		} else {
+			BT_LOGE("data-medium should be `mmap` or `read`: "
+				"value=\"%s\"", medium);
+			BT_PUT(value);
+			goto error;
+		}
+
+		BT_PUT(value);
+	}
+
+	value = bt_value_map_get(params, "data-window-size");
+	if (value) {
+		int64_t window_size;
+		const size_t page_size = bt_common_get_page_size();
+
+		if (!bt_value_is_integer(value)) {
+			BT_LOGE("data-window-size should be an integer");
+			goto error;
+		}
+		value_ret = bt_value_integer_get(value, &window_size);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+		BT_PUT(value);
+
+		if (window_size < 1 || window_size > SIZE_MAX - page_size) {
+			BT_LOGE("Invalid data-window-size: value=%" PRId64,
+				window_size);
+			goto error;
+		}
+
+		/* Round up to the page size */
+		ctf_fs->ds_file_config.window_size =
+			((size_t) window_size + page_size - 1) &
+				~(page_size - 1);
+	}
+
+	value = bt_value_map_get(params, "mmap-whole-file");
+	if (value) {
+		bt_bool whole_file;
+
+		if (!bt_value_is_bool(value)) {
+			BT_LOGE("mmap-whole-file should be a boolean");
+			goto error;
+		}
+		value_ret = bt_value_bool_get(value, &whole_file);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+		BT_PUT(value);
+
+		if (whole_file && sizeof(void *) < 8) {
+			/*
+			 * Whole data stream files quickly exhaust the
+			 * address space of a 32-bit process.
+			 */
+			BT_LOGW_STR("Ignoring mmap-whole-file parameter: only supported on 64-bit hosts.");
+		} else {
+			ctf_fs->ds_file_config.mmap_whole_file = whole_file;
+		}
+	}
+
+	value = bt_value_map_get(params, "read-ahead");
+	if (value) {
+		bt_bool read_ahead;
+
+		if (!bt_value_is_bool(value)) {
+			BT_LOGE("read-ahead should be a boolean");
+			goto error;
+		}
+		value_ret = bt_value_bool_get(value, &read_ahead);
+		assert(value_ret == BT_VALUE_STATUS_OK);
+		BT_PUT(value);
+		ctf_fs->ds_file_config.read_ahead = read_ahead;
+	}
+
 	ctf_fs->port_data = g_ptr_array_new_with_free_func(port_data_destroy);
 	if (!ctf_fs->port_data) {
 		goto error;
@@ -59,6 +59,29 @@ struct ctf_fs_metadata {
 	int bo;
 };
 
+/* Data stream file indexing configuration */
+struct ctf_fs_index_config {
+	/*
+	 * Maximum number of threads which scan the data stream files
+	 * of a trace at initialization; 0 means one per online
+	 * processor.
+	 */
+	unsigned int jobs;
+
+	/*
+	 * True to read and write the index cache files of data stream
+	 * files which do not have an LTTng index file.
+	 */
+	bool cache;
+
+	/*
+	 * Owned by this. Index cache directory; NULL means the
+	 * CTF_FS_INDEX_CACHE_DEFAULT_DIR directory within each trace's
+	 * directory.
+	 */
+	GString *cache_dir;
+};
+
 struct ctf_fs_component {
 	/* Weak, guaranteed to exist */
 	struct bt_private_component *priv_comp;
@@ -70,6 +93,10 @@ struct ctf_fs_component {
 	GPtrArray *traces;
 
 	struct ctf_fs_metadata_config metadata_config;
+
+	struct ctf_fs_index_config index_config;
+
+	struct ctf_fs_ds_file_config ds_file_config;
 };
 
 struct ctf_fs_trace {
@@ -87,6 +114,11 @@ struct ctf_fs_trace {
 
 	/* Owned by this */
 	GString *name;
+
+	/* Owned by this; NULL means no index cache */
+	GString *index_cache_dir;
+
+	struct ctf_fs_ds_file_config ds_file_config;
 };
 
 struct ctf_fs_ds_file_group {
@@ -131,6 +163,13 @@ struct ctf_fs_notif_iter_data {
 
 	/* Owned by this */
 	struct bt_notif_iter *notif_iter;
+
+	/*
+	 * Status to return on the next call to ctf_fs_iterator_next_batch()
+	 * when the previous call got notifications before this status
+	 * (BT_NOTIFICATION_ITERATOR_STATUS_OK if none).
+	 */
+	enum bt_notification_iterator_status pending_status;
 };
 
 BT_HIDDEN
@@ -148,7 +187,9 @@ struct bt_component_class_query_method_return ctf_fs_query(
 
 BT_HIDDEN
 struct ctf_fs_trace *ctf_fs_trace_create(const char *path, const char *name,
-		struct ctf_fs_metadata_config *config);
+		struct ctf_fs_metadata_config *config,
+		struct ctf_fs_index_config *index_config,
+		struct ctf_fs_ds_file_config *ds_file_config);
 
 BT_HIDDEN
 void ctf_fs_trace_destroy(struct ctf_fs_trace *trace);
@@ -170,4 +211,15 @@ BT_HIDDEN
 struct bt_notification_iterator_next_method_return ctf_fs_iterator_next(
 		struct bt_private_connection_private_notification_iterator *iterator);
 
+BT_HIDDEN
+enum bt_notification_iterator_status ctf_fs_iterator_next_batch(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
+BT_HIDDEN
+enum bt_notification_iterator_status ctf_fs_iterator_seek_time(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		int64_t ns_from_epoch);
+
 #endif /* BABELTRACE_PLUGIN_CTF_FS_H */
@@ -0,0 +1,74 @@
+#ifndef CTF_FS_INDEX_CACHE_H
+#define CTF_FS_INDEX_CACHE_H
+
+/*
+ * Copyright 2017 - EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+#include "lttng-index.h"
+
+/*
+ * An index cache file contains the packet index of a single data
+ * stream file which was built by reading all its packet headers and
+ * contexts. Its layout is:
+ *
+ * 1. A struct ctf_fs_index_cache_hdr.
+ * 2. The path of the data stream file (`path_len` bytes, including
+ *    the terminating null character).
+ * 3. `packet_index_count` struct ctf_packet_index (see lttng-index.h).
+ *
+ * The cache file of a data stream file is valid as long as the path,
+ * the size, and the modification time of the data stream file are the
+ * same as the ones recorded in the header.
+ */
+#define CTF_FS_INDEX_CACHE_MAGIC	0xC1F1DCCA
+#define CTF_FS_INDEX_CACHE_VERSION	1
+
+/* Suffix of index cache file names */
+#define CTF_FS_INDEX_CACHE_SUFFIX	".idx"
+
+/* Default index cache directory, within a trace directory */
+#define CTF_FS_INDEX_CACHE_DEFAULT_DIR	".babeltrace-index-cache"
+
+/*
+ * Header at the beginning of each index cache file.
+ * All integer fields are stored in big endian.
+ */
+struct ctf_fs_index_cache_hdr {
+	uint32_t magic;
+	uint32_t version;
+	/* size of the data stream file, in bytes. */
+	uint64_t file_size;
+	/*
+	 * modification time of the data stream file, in nanoseconds since
+	 * Epoch (whole seconds on platforms without sub-second
+	 * modification times).
+	 */
+	int64_t file_mtime;
+	/* length of the path which follows this header, in bytes. */
+	uint32_t path_len;
+	/* size of struct ctf_packet_index, in bytes. */
+	uint32_t packet_index_len;
+	uint64_t packet_index_count;
+} __attribute__((__packed__));
+
+#endif /* CTF_FS_INDEX_CACHE_H */
@@ -949,7 +949,9 @@ struct bt_notification *create_notif_from_line(
 	}
 
 	assert(ep_field);
-	event = bt_event_create(dmesg_comp->event_class);
+	event = bt_event_create_with_flags(dmesg_comp->event_class,
+		BT_EVENT_CREATE_FLAG_NO_HEADER |
+		BT_EVENT_CREATE_FLAG_NO_EVENT_PAYLOAD);
 	if (!event) {
 		BT_LOGE_STR("Cannot create event object.");
 		goto error;
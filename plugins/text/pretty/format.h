@@ -0,0 +1,181 @@
+#ifndef BABELTRACE_PLUGIN_TEXT_PRETTY_FORMAT_H
+#define BABELTRACE_PLUGIN_TEXT_PRETTY_FORMAT_H
+
+/*
+ * BabelTrace - CTF Text Output Plug-in number formatting
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Those functions append numbers to a GString exactly like the
+ * corresponding printf() conversions, without parsing a format string
+ * or going through varargs. Digits are written backwards at the end of
+ * a stack buffer which is then appended in one go.
+ */
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <glib.h>
+
+/* Large enough for the 22 octal digits of UINT64_MAX */
+#define PRETTY_FORMAT_BUF_LEN	24
+
+static const char pretty_format_digit_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/*
+ * Writes the decimal digits of `v`, at least `width` of them (padded
+ * with zeros), ending at `end`. Returns the first written character.
+ */
+static inline
+char *pretty_format_dec(char *end, uint64_t v, unsigned int width)
+{
+	char *p = end;
+
+	while (v >= 100) {
+		const char *pair = &pretty_format_digit_pairs[(v % 100) * 2];
+
+		v /= 100;
+		*--p = pair[1];
+		*--p = pair[0];
+	}
+
+	if (v >= 10) {
+		const char *pair = &pretty_format_digit_pairs[v * 2];
+
+		*--p = pair[1];
+		*--p = pair[0];
+	} else {
+		*--p = (char) ('0' + v);
+	}
+
+	while ((unsigned int) (end - p) < width) {
+		*--p = '0';
+	}
+
+	return p;
+}
+
+/* Equivalent of `%0<width>` PRIu64 (`width` of 0 means no padding) */
+static inline
+void pretty_append_uint_pad(GString *str, uint64_t v, unsigned int width)
+{
+	char buf[PRETTY_FORMAT_BUF_LEN];
+	char *end = buf + sizeof(buf);
+	char *p;
+
+	if (width > sizeof(buf)) {
+		g_string_append_printf(str, "%0*" PRIu64, (int) width, v);
+		return;
+	}
+
+	p = pretty_format_dec(end, v, width);
+	g_string_append_len(str, p, end - p);
+}
+
+/* Equivalent of `%` PRIu64 */
+static inline
+void pretty_append_uint(GString *str, uint64_t v)
+{
+	pretty_append_uint_pad(str, v, 0);
+}
+
+/* Equivalent of `%` PRId64 */
+static inline
+void pretty_append_int(GString *str, int64_t v)
+{
+	char buf[PRETTY_FORMAT_BUF_LEN];
+	char *end = buf + sizeof(buf);
+	char *p;
+
+	if (v < 0) {
+		/* Negating as unsigned also works for INT64_MIN */
+		p = pretty_format_dec(end, -(uint64_t) v, 0);
+		*--p = '-';
+	} else {
+		p = pretty_format_dec(end, (uint64_t) v, 0);
+	}
+
+	g_string_append_len(str, p, end - p);
+}
+
+/* Equivalent of `%` PRIX64 */
+static inline
+void pretty_append_hex(GString *str, uint64_t v)
+{
+	static const char digits[] = "0123456789ABCDEF";
+	char buf[PRETTY_FORMAT_BUF_LEN];
+	char *end = buf + sizeof(buf);
+	char *p = end;
+
+	do {
+		*--p = digits[v & 0xf];
+		v >>= 4;
+	} while (v);
+
+	g_string_append_len(str, p, end - p);
+}
+
+/* Equivalent of `%` PRIo64 */
+static inline
+void pretty_append_oct(GString *str, uint64_t v)
+{
+	char buf[PRETTY_FORMAT_BUF_LEN];
+	char *end = buf + sizeof(buf);
+	char *p = end;
+
+	do {
+		*--p = (char) ('0' + (v & 0x7));
+		v >>= 3;
+	} while (v);
+
+	g_string_append_len(str, p, end - p);
+}
+
+/*
+ * Equivalent of `%g`.
+ *
+ * Shortest round-trip floating point number formatting is not worth
+ * reimplementing here: this only avoids g_string_append_printf()'s
+ * temporary heap allocation.
+ */
+static inline
+void pretty_append_double(GString *str, double v)
+{
+	char buf[32];
+	int len;
+
+	len = snprintf(buf, sizeof(buf), "%g", v);
+	if (len < 0 || (size_t) len >= sizeof(buf)) {
+		g_string_append_printf(str, "%g", v);
+		return;
+	}
+
+	g_string_append_len(str, buf, len);
+}
+
+#endif /* BABELTRACE_PLUGIN_TEXT_PRETTY_FORMAT_H */
@@ -34,10 +34,15 @@
 #include <plugins-common.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <unistd.h>
 #include <glib.h>
 #include <assert.h>
 
 #include "pretty.h"
+#include "writer.h"
+
+/* Maximum number of notifications to get from the input iterator at once */
+#define NOTIF_BATCH_CAPACITY	64
 
 GQuark stream_packet_context_quarks[STREAM_PACKET_CONTEXT_QUARKS_LEN];
 
@@ -65,6 +70,7 @@ const char *plugin_options[] = {
 	"field-loglevel",
 	"field-emf",
 	"field-callsite",
+	"writer-thread",
 };
 
 static
@@ -72,6 +78,14 @@ void destroy_pretty_data(struct pretty_component *pretty)
 {
 	bt_put(pretty->input_iterator);
 
+	if (pretty->writer) {
+		if (pretty_flush(pretty, true)) {
+			perror("write output file");
+		}
+
+		pretty_writer_destroy(pretty->writer);
+	}
+
 	if (pretty->string) {
 		(void) g_string_free(pretty->string, TRUE);
 	}
@@ -80,6 +94,14 @@ void destroy_pretty_data(struct pretty_component *pretty)
 		(void) g_string_free(pretty->tmp_string, TRUE);
 	}
 
+	if (pretty->discarded_string) {
+		(void) g_string_free(pretty->discarded_string, TRUE);
+	}
+
+	if (pretty->struct_infos) {
+		g_hash_table_destroy(pretty->struct_infos);
+	}
+
 	if (pretty->out != stdout) {
 		int ret;
 
@@ -101,7 +123,7 @@ struct pretty_component *create_pretty(void)
 	if (!pretty) {
 		goto end;
 	}
-	pretty->string = g_string_new("");
+	pretty->string = g_string_sized_new(PRETTY_OUTPUT_FLUSH_SIZE);
 	if (!pretty->string) {
 		goto error;
 	}
@@ -109,6 +131,15 @@ struct pretty_component *create_pretty(void)
 	if (!pretty->tmp_string) {
 		goto error;
 	}
+	pretty->discarded_string = g_string_new("");
+	if (!pretty->discarded_string) {
+		goto error;
+	}
+	pretty->struct_infos = g_hash_table_new_full(g_direct_hash,
+		g_direct_equal, NULL, pretty_destroy_struct_info);
+	if (!pretty->struct_infos) {
+		goto error;
+	}
 end:
 	return pretty;
 
@@ -189,12 +220,14 @@ void pretty_port_connected(
 BT_HIDDEN
 enum bt_component_status pretty_consume(struct bt_private_component *component)
 {
-	enum bt_component_status ret;
-	struct bt_notification *notification = NULL;
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_notification *notifications[NOTIF_BATCH_CAPACITY];
 	struct bt_notification_iterator *it;
 	struct pretty_component *pretty =
 		bt_private_component_get_user_data(component);
 	enum bt_notification_iterator_status it_ret;
+	uint64_t count = 0;
+	uint64_t i;
 
 	if (unlikely(pretty->error)) {
 		ret = BT_COMPONENT_STATUS_ERROR;
@@ -202,29 +235,48 @@ enum bt_component_status pretty_consume(struct bt_private_component *component)
 	}
 
 	it = pretty->input_iterator;
-	it_ret = bt_notification_iterator_next(it);
+	it_ret = bt_notification_iterator_next_batch(it, notifications,
+		NOTIF_BATCH_CAPACITY, &count);
 
 	switch (it_ret) {
 	case BT_NOTIFICATION_ITERATOR_STATUS_END:
 		ret = BT_COMPONENT_STATUS_END;
 		BT_PUT(pretty->input_iterator);
-		goto end;
+		goto flush;
 	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
 		ret = BT_COMPONENT_STATUS_AGAIN;
-		goto end;
+		goto flush;
 	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
 		break;
 	default:
 		ret = BT_COMPONENT_STATUS_ERROR;
+		goto flush;
+	}
+
+	for (i = 0; i < count; i++) {
+		assert(notifications[i]);
+
+		if (ret == BT_COMPONENT_STATUS_OK) {
+			ret = handle_notification(pretty, notifications[i]);
+		}
+
+		bt_put(notifications[i]);
+	}
+
+	if (ret == BT_COMPONENT_STATUS_OK && !pretty->out_is_tty) {
+		/*
+		 * Keep accumulating lines: pretty_print_event() writes
+		 * the output buffer once it's large enough.
+		 */
 		goto end;
 	}
 
-	notification = bt_notification_iterator_get_notification(it);
-	assert(notification);
-	ret = handle_notification(pretty, notification);
+flush:
+	if (pretty_flush(pretty, true)) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+	}
 
 end:
-	bt_put(notification);
 	return ret;
 }
 
@@ -463,6 +515,13 @@ enum bt_component_status apply_params(struct pretty_component *pretty,
 	}
 	pretty->options.verbose = value;
 
+	value = false;		/* Default. */
+	ret = apply_one_bool("writer-thread", params, &value, NULL);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto end;
+	}
+	pretty->options.writer_thread = value;
+
 	/* Names. */
 	ret = apply_one_string("name-default", params, &str);
 	if (ret != BT_COMPONENT_STATUS_OK) {
@@ -757,6 +816,14 @@ enum bt_component_status pretty_init(
 	}
 
 	set_use_colors(pretty);
+	pretty->out_is_tty = isatty(fileno(pretty->out));
+	pretty->writer = pretty_writer_create(pretty->out,
+		pretty->options.writer_thread);
+	if (!pretty->writer) {
+		ret = BT_COMPONENT_STATUS_NOMEM;
+		goto error;
+	}
+
 	ret = bt_private_component_set_user_data(component, pretty);
 	if (ret != BT_COMPONENT_STATUS_OK) {
 		goto error;
@@ -70,6 +70,40 @@ struct pretty_options {
 	bool clock_gmt;
 	enum pretty_color_option color;
 	bool verbose;
+	bool writer_thread;
+};
+
+/*
+ * Size from which the output buffer is written: lines accumulate in
+ * the output buffer until then, so that the output file is written in
+ * large chunks.
+ */
+#define PRETTY_OUTPUT_FLUSH_SIZE	(256 * 1024)
+
+struct pretty_writer;
+
+/*
+ * Wall clock time formatting cache, see
+ * pretty_update_wall_clock_cache().
+ */
+struct pretty_wall_clock_cache {
+	/*
+	 * Formatted date (with the clock-date option) and time, up to
+	 * the nanoseconds, of the second `prefix_sec` from the epoch.
+	 */
+	bool prefix_valid;
+	uint64_t prefix_sec;
+	char prefix[32];
+	size_t prefix_len;
+
+	/*
+	 * Offset (seconds) of the printed time from the time since the
+	 * epoch during the minute `offset_local_minute` (minutes from
+	 * the epoch, in printed time).
+	 */
+	bool offset_valid;
+	int64_t offset;
+	int64_t offset_local_minute;
 };
 
 struct pretty_component {
@@ -78,8 +112,17 @@ struct pretty_component {
 	FILE *out, *err;
 	int depth;	/* nesting, used for tabulation alignment. */
 	bool start_line;
-	GString *string;
+	GString *string;	/* Output buffer, holds complete lines. */
 	GString *tmp_string;
+	GString *discarded_string;
+	struct pretty_writer *writer;
+	bool out_is_tty;
+
+	/*
+	 * Structure field type (owned by this) to
+	 * struct pretty_struct_info.
+	 */
+	GHashTable *struct_infos;
 	struct bt_value *plugin_opt_map;	/* Temporary parameter map. */
 	bool use_colors;
 	bool error;
@@ -91,6 +134,7 @@ struct pretty_component {
 	uint64_t delta_real_timestamp;
 
 	bool negative_timestamp_warning_done;
+	struct pretty_wall_clock_cache wall_clock_cache;
 };
 
 enum stream_packet_context_quarks_enum {
@@ -124,6 +168,16 @@ void pretty_port_connected(
 BT_HIDDEN
 void pretty_finalize(struct bt_private_component *component);
 
+BT_HIDDEN
+void pretty_destroy_struct_info(void *data);
+
+/*
+ * Writes the content of the output buffer, also flushing the output
+ * file if `sync` is true. Returns a negative value on error.
+ */
+BT_HIDDEN
+int pretty_flush(struct pretty_component *pretty, bool sync);
+
 BT_HIDDEN
 enum bt_component_status pretty_print_event(struct pretty_component *pretty,
 		struct bt_notification *event_notif);
@@ -133,4 +187,13 @@ enum bt_component_status pretty_print_discarded_elements(
 		struct pretty_component *pretty,
 		struct bt_notification *notif);
 
+/*
+ * Sets the prefix of the wall clock time cache of `pretty` to the
+ * formatted date and time of `sec` seconds from the epoch. Returns a
+ * negative value if the time cannot be computed.
+ */
+BT_HIDDEN
+int pretty_update_wall_clock_cache(struct pretty_component *pretty,
+		uint64_t sec);
+
 #endif /* BABELTRACE_PLUGIN_TEXT_PRETTY_PRETTY_H */
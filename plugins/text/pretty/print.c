@@ -30,10 +30,14 @@
 #include <babeltrace/babeltrace.h>
 #include <babeltrace/bitfield-internal.h>
 #include <babeltrace/common-internal.h>
+#include <babeltrace/compiler-internal.h>
 #include <babeltrace/compat/time-internal.h>
 #include <inttypes.h>
 #include <ctype.h>
+#include <string.h>
 #include "pretty.h"
+#include "writer.h"
+#include "format.h"
 
 #define NSEC_PER_SEC 1000000000LL
 
@@ -52,6 +56,25 @@ struct timestamp {
 	uint64_t clock_value;	/* In cycles. */
 };
 
+/* Printing data of a structure field type's member */
+struct pretty_struct_member {
+	GQuark name_quark;
+
+	/* Name followed with ` = `, with colors if they are used */
+	char *name_equal;
+	size_t name_equal_len;
+};
+
+/*
+ * Printing data of a structure field type, computed the first time a
+ * field of this type is printed.
+ */
+struct pretty_struct_info {
+	struct bt_field_type *type;	/* Owned by this */
+	int64_t nr_members;
+	struct pretty_struct_member members[];
+};
+
 static
 enum bt_component_status print_field(struct pretty_component *pretty,
 		struct bt_field *field, bool print_names,
@@ -61,10 +84,12 @@ static
 void print_name_equal(struct pretty_component *pretty, const char *name)
 {
 	if (pretty->use_colors) {
-		g_string_append_printf(pretty->string, "%s%s%s = ", COLOR_NAME,
-			name, COLOR_RST);
+		g_string_append(pretty->string, COLOR_NAME);
+		g_string_append(pretty->string, name);
+		g_string_append(pretty->string, COLOR_RST " = ");
 	} else {
-		g_string_append_printf(pretty->string, "%s = ", name);
+		g_string_append(pretty->string, name);
+		g_string_append(pretty->string, " = ");
 	}
 }
 
@@ -72,10 +97,12 @@ static
 void print_field_name_equal(struct pretty_component *pretty, const char *name)
 {
 	if (pretty->use_colors) {
-		g_string_append_printf(pretty->string, "%s%s%s = ",
-			COLOR_FIELD_NAME, name, COLOR_RST);
+		g_string_append(pretty->string, COLOR_FIELD_NAME);
+		g_string_append(pretty->string, name);
+		g_string_append(pretty->string, COLOR_RST " = ");
 	} else {
-		g_string_append_printf(pretty->string, "%s = ", name);
+		g_string_append(pretty->string, name);
+		g_string_append(pretty->string, " = ");
 	}
 }
 
@@ -102,7 +129,7 @@ void print_timestamp_cycles(struct pretty_component *pretty,
 		return;
 	}
 
-	g_string_append_printf(pretty->string, "%020" PRIu64, cycles);
+	pretty_append_uint_pad(pretty->string, cycles, 20);
 
 	if (pretty->last_cycles_timestamp != -1ULL) {
 		pretty->delta_cycles = cycles - pretty->last_cycles_timestamp;
@@ -110,8 +137,180 @@ void print_timestamp_cycles(struct pretty_component *pretty,
 	pretty->last_cycles_timestamp = cycles;
 }
 
+/*
+ * Returns the number of days from 1970-01-01 to the given proleptic
+ * Gregorian calendar date (`month` is 1 to 12), using Howard Hinnant's
+ * days_from_civil() algorithm.
+ */
+static
+int64_t days_from_civil(int64_t year, unsigned int month, unsigned int day)
+{
+	int64_t era;
+	unsigned int yoe, doy, doe;
+
+	year -= month <= 2;
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = (unsigned int) (year - era * 400);
+	doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int64_t) doe - 719468;
+}
+
+/* Inverse of days_from_civil() */
+static
+void civil_from_days(int64_t days, int64_t *year, unsigned int *month,
+		unsigned int *day)
+{
+	int64_t era;
+	unsigned int doe, yoe, doy, mp;
+
+	days += 719468;
+	era = (days >= 0 ? days : days - 146096) / 146097;
+	doe = (unsigned int) (days - era * 146097);
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+	*day = doy - (153 * mp + 2) / 5 + 1;
+	*month = mp < 10 ? mp + 3 : mp - 9;
+	*year = (int64_t) yoe + era * 400 + (*month <= 2);
+}
+
+/* Writes the `width` last decimal digits of `v` at `p`, returns the end */
+static
+char *put_digits(char *p, uint64_t v, unsigned int width)
+{
+	char *end = p + width;
+
+	while (width > 0) {
+		p[--width] = (char) ('0' + v % 10);
+		v /= 10;
+	}
+
+	return end;
+}
+
+/*
+ * Sets the prefix of the wall clock time cache of `pretty` to the
+ * formatted date (with the clock-date option), hours, minutes, and
+ * seconds of `sec` seconds from the epoch, followed with the dot
+ * preceding the nanoseconds.
+ *
+ * The offset from the epoch which localtime_r() (or gmtime_r(), which
+ * also honors the leap seconds of a "right/" time zone) gives is
+ * reused for the following seconds of the same minute: time zone
+ * transitions only happen on whole minutes since 1970. This makes the
+ * C library, with its locks and time zone state checks, work at most
+ * once per minute of events.
+ *
+ * Returns a negative value if the time cannot be computed.
+ */
+BT_HIDDEN
+int pretty_update_wall_clock_cache(struct pretty_component *pretty,
+		uint64_t sec)
+{
+	struct pretty_wall_clock_cache *cache = &pretty->wall_clock_cache;
+	int64_t year, local_sec, days, sec_of_day;
+	unsigned int month, day, hour, minute, second;
+	char *p;
+
+	/* Large values are not worth bothering with overflows */
+	if (!cache->offset_valid || sec > INT64_MAX / 2) {
+		goto slow;
+	}
+
+	local_sec = (int64_t) sec + cache->offset;
+	if (local_sec < 0 || local_sec / 60 != cache->offset_local_minute) {
+		goto slow;
+	}
+
+	days = local_sec / 86400;
+	sec_of_day = local_sec % 86400;
+
+	civil_from_days(days, &year, &month, &day);
+	hour = sec_of_day / 3600;
+	minute = sec_of_day / 60 % 60;
+	second = sec_of_day % 60;
+	goto format;
+
+slow:
+	{
+		struct tm tm;
+		time_t time_s = (time_t) sec;
+
+		if (!pretty->options.clock_gmt) {
+			struct tm *res;
+
+			res = bt_localtime_r(&time_s, &tm);
+			if (!res) {
+				// TODO: log instead
+				fprintf(stderr, "[warning] Unable to get localtime.\n");
+				return -1;
+			}
+		} else {
+			struct tm *res;
+
+			res = bt_gmtime_r(&time_s, &tm);
+			if (!res) {
+				// TODO: log instead
+				fprintf(stderr, "[warning] Unable to get gmtime.\n");
+				return -1;
+			}
+		}
+
+		year = (int64_t) tm.tm_year + 1900;
+		month = tm.tm_mon + 1;
+		day = tm.tm_mday;
+		hour = tm.tm_hour;
+		minute = tm.tm_min;
+		second = tm.tm_sec;
+
+		/*
+		 * A leap second (time zone with leap seconds) is not
+		 * part of a regular minute: do not reuse its offset.
+		 */
+		local_sec = days_from_civil(year, month, day) * 86400 +
+			hour * 3600 + minute * 60 + second;
+		cache->offset_valid = sec <= INT64_MAX / 2 && second < 60 &&
+			local_sec >= 0;
+		if (cache->offset_valid) {
+			cache->offset = local_sec - (int64_t) sec;
+			cache->offset_local_minute = local_sec / 60;
+		}
+	}
+
+format:
+	if (pretty->options.clock_date && (year < 1000 || year > 9999)) {
+		/* strftime()'s "%Y" is not four digits then */
+		// TODO: log instead
+		fprintf(stderr, "[warning] Unable to print ascii time.\n");
+		return -1;
+	}
+
+	p = cache->prefix;
+
+	if (pretty->options.clock_date) {
+		p = put_digits(p, year, 4);
+		*p++ = '-';
+		p = put_digits(p, month, 2);
+		*p++ = '-';
+		p = put_digits(p, day, 2);
+		*p++ = ' ';
+	}
+
+	p = put_digits(p, hour, 2);
+	*p++ = ':';
+	p = put_digits(p, minute, 2);
+	*p++ = ':';
+	p = put_digits(p, second, 2);
+	*p++ = '.';
+	cache->prefix_len = p - cache->prefix;
+	cache->prefix_sec = sec;
+	cache->prefix_valid = true;
+	return 0;
+}
+
 static
-void print_timestamp_wall(struct pretty_component *pretty,
+void print_timestamp_wall(struct pretty_component *pretty, GString *str,
 		struct bt_clock_value *clock_value)
 {
 	int ret;
@@ -121,14 +320,14 @@ void print_timestamp_wall(struct pretty_component *pretty,
 	bool is_negative;
 
 	if (!clock_value) {
-		g_string_append(pretty->string, "??:??:??.?????????");
+		g_string_append(str, "??:??:??.?????????");
 		return;
 	}
 
 	ret = bt_clock_value_get_value_ns_from_epoch(clock_value, &ts_nsec);
 	if (ret) {
 		// TODO: log, this is unexpected
-		g_string_append(pretty->string, "Error");
+		g_string_append(str, "Error");
 		return;
 	}
 
@@ -167,8 +366,8 @@ void print_timestamp_wall(struct pretty_component *pretty,
 	}
 
 	if (!pretty->options.clock_seconds) {
-		struct tm tm;
-		time_t time_s = (time_t) ts_sec_abs;
+		struct pretty_wall_clock_cache *cache =
+			&pretty->wall_clock_cache;
 
 		if (is_negative && !pretty->negative_timestamp_warning_done) {
 			// TODO: log instead
@@ -177,50 +376,28 @@ void print_timestamp_wall(struct pretty_component *pretty,
 			goto seconds;
 		}
 
-		if (!pretty->options.clock_gmt) {
-			struct tm *res;
-
-			res = bt_localtime_r(&time_s, &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to get localtime.\n");
-				goto seconds;
-			}
-		} else {
-			struct tm *res;
-
-			res = bt_gmtime_r(&time_s, &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to get gmtime.\n");
-				goto seconds;
-			}
-		}
-		if (pretty->options.clock_date) {
-			char timestr[26];
-			size_t res;
-
-			/* Print date and time */
-			res = strftime(timestr, sizeof(timestr),
-					"%Y-%m-%d ", &tm);
-			if (!res) {
-				// TODO: log instead
-				fprintf(stderr, "[warning] Unable to print ascii time.\n");
+		/*
+		 * Consecutive events are almost always within the same
+		 * second: only the nanoseconds change then.
+		 */
+		if (!cache->prefix_valid || cache->prefix_sec != ts_sec_abs) {
+			if (pretty_update_wall_clock_cache(pretty, ts_sec_abs)) {
 				goto seconds;
 			}
-
-			g_string_append(pretty->string, timestr);
 		}
 
-		/* Print time in HH:MM:SS.ns */
-		g_string_append_printf(pretty->string,
-			"%02d:%02d:%02d.%09" PRIu64, tm.tm_hour, tm.tm_min,
-			tm.tm_sec, ts_nsec_abs);
+		/* Print [date and] time in HH:MM:SS.ns */
+		g_string_append_len(str, cache->prefix, cache->prefix_len);
+		pretty_append_uint_pad(str, ts_nsec_abs, 9);
 		goto end;
 	}
 seconds:
-	g_string_append_printf(pretty->string, "%s%" PRId64 ".%09" PRIu64,
-		is_negative ? "-" : "", ts_sec_abs, ts_nsec_abs);
+	if (is_negative) {
+		g_string_append_c(str, '-');
+	}
+	pretty_append_uint(str, ts_sec_abs);
+	g_string_append_c(str, '.');
+	pretty_append_uint_pad(str, ts_nsec_abs, 9);
 end:
 	return;
 }
@@ -282,7 +459,7 @@ enum bt_component_status print_event_timestamp(struct pretty_component *pretty,
 		struct bt_clock_value *clock_value =
 			bt_event_get_clock_value(event, clock_class);
 
-		print_timestamp_wall(pretty, clock_value);
+		print_timestamp_wall(pretty, pretty->string, clock_value);
 		bt_put(clock_value);
 	}
 	if (pretty->use_colors) {
@@ -304,8 +481,9 @@ enum bt_component_status print_event_timestamp(struct pretty_component *pretty,
 				g_string_append(pretty->string,
 					"+??????????\?\?) "); /* Not a trigraph. */
 			} else {
-				g_string_append_printf(pretty->string,
-					"+%012" PRIu64, pretty->delta_cycles);
+				g_string_append_c(pretty->string, '+');
+				pretty_append_uint_pad(pretty->string,
+					pretty->delta_cycles, 12);
 			}
 		} else {
 			if (pretty->delta_real_timestamp != -1ULL) {
@@ -314,9 +492,11 @@ enum bt_component_status print_event_timestamp(struct pretty_component *pretty,
 				delta = pretty->delta_real_timestamp;
 				delta_sec = delta / NSEC_PER_SEC;
 				delta_nsec = delta % NSEC_PER_SEC;
-				g_string_append_printf(pretty->string,
-					"+%" PRIu64 ".%09" PRIu64,
-					delta_sec, delta_nsec);
+				g_string_append_c(pretty->string, '+');
+				pretty_append_uint(pretty->string, delta_sec);
+				g_string_append_c(pretty->string, '.');
+				pretty_append_uint_pad(pretty->string,
+					delta_nsec, 9);
 			} else {
 				g_string_append(pretty->string, "+?.?????????");
 			}
@@ -474,7 +654,9 @@ enum bt_component_status print_event_header(struct pretty_component *pretty,
 			}
 			if (bt_value_integer_get(vpid_value, &value)
 					== BT_VALUE_STATUS_OK) {
-				g_string_append_printf(pretty->string, "(%" PRId64 ")", value);
+				g_string_append_c(pretty->string, '(');
+				pretty_append_int(pretty->string, value);
+				g_string_append_c(pretty->string, ')');
 			}
 			bt_put(vpid_value);
 			dom_print = 1;
@@ -518,8 +700,9 @@ enum bt_component_status print_event_header(struct pretty_component *pretty,
 			}
 
 			g_string_append(pretty->string, log_level_str);
-			g_string_append_printf(
-				pretty->string, " (%d)", (int) log_level);
+			g_string_append(pretty->string, " (");
+			pretty_append_int(pretty->string, (int64_t) log_level);
+			g_string_append_c(pretty->string, ')');
 			dom_print = 1;
 		}
 	}
@@ -640,7 +823,8 @@ enum bt_component_status print_integer(struct pretty_component *pretty,
 		g_string_append(pretty->string, "0b");
 		v.u = _bt_piecewise_lshift(v.u, 64 - len);
 		for (bitnr = 0; bitnr < len; bitnr++) {
-			g_string_append_printf(pretty->string, "%u", (v.u & (1ULL << 63)) ? 1 : 0);
+			g_string_append_c(pretty->string,
+				(v.u & (1ULL << 63)) ? '1' : '0');
 			v.u = _bt_piecewise_lshift(v.u, 1);
 		}
 		break;
@@ -665,15 +849,16 @@ enum bt_component_status print_integer(struct pretty_component *pretty,
 			}
 		}
 
-		g_string_append_printf(pretty->string, "0%" PRIo64, v.u);
+		g_string_append_c(pretty->string, '0');
+		pretty_append_oct(pretty->string, v.u);
 		break;
 	}
 	case BT_INTEGER_BASE_DECIMAL:
 	case BT_INTEGER_BASE_UNSPECIFIED:
 		if (!signedness) {
-			g_string_append_printf(pretty->string, "%" PRIu64, v.u);
+			pretty_append_uint(pretty->string, v.u);
 		} else {
-			g_string_append_printf(pretty->string, "%" PRId64, v.s);
+			pretty_append_int(pretty->string, v.s);
 		}
 		break;
 	case BT_INTEGER_BASE_HEXADECIMAL:
@@ -692,7 +877,8 @@ enum bt_component_status print_integer(struct pretty_component *pretty,
 			v.u &= ((uint64_t) 1 << rounded_len) - 1;
 		}
 
-		g_string_append_printf(pretty->string, "0x%" PRIX64, v.u);
+		g_string_append(pretty->string, "0x");
+		pretty_append_hex(pretty->string, v.u);
 		break;
 	}
 	default:
@@ -710,68 +896,80 @@ end:
 static
 void print_escape_string(struct pretty_component *pretty, const char *str)
 {
-	int i;
+	/* First character not appended yet */
+	const char *run = str;
+	const char *p;
 
 	g_string_append_c(pretty->string, '"');
 
-	for (i = 0; i < strlen(str); i++) {
+	/*
+	 * Standard characters are appended in runs, up to the next
+	 * character to escape.
+	 */
+	for (p = str; *p != '\0'; p++) {
+		const char *esc = NULL;
+
 		/* Escape sequences not recognized by iscntrl(). */
-		switch (str[i]) {
+		switch (*p) {
 		case '\\':
-			g_string_append(pretty->string, "\\\\");
-			continue;
+			esc = "\\\\";
+			break;
 		case '\'':
-			g_string_append(pretty->string, "\\\'");
-			continue;
+			esc = "\\\'";
+			break;
 		case '\"':
-			g_string_append(pretty->string, "\\\"");
-			continue;
+			esc = "\\\"";
+			break;
 		case '\?':
-			g_string_append(pretty->string, "\\\?");
-			continue;
-		}
+			esc = "\\\?";
+			break;
+		default:
+			/* Standard characters. */
+			if (!iscntrl(*p)) {
+				continue;
+			}
 
-		/* Standard characters. */
-		if (!iscntrl(str[i])) {
-			g_string_append_c(pretty->string, str[i]);
-			continue;
+			switch (*p) {
+			case '\a':
+				esc = "\\a";
+				break;
+			case '\b':
+				esc = "\\b";
+				break;
+			case '\e':
+				esc = "\\e";
+				break;
+			case '\f':
+				esc = "\\f";
+				break;
+			case '\n':
+				esc = "\\n";
+				break;
+			case '\r':
+				esc = "\\r";
+				break;
+			case '\t':
+				esc = "\\t";
+				break;
+			case '\v':
+				esc = "\\v";
+				break;
+			}
 		}
 
-		switch (str[i]) {
-		case '\0':
-			g_string_append(pretty->string, "\\0");
-			break;
-		case '\a':
-			g_string_append(pretty->string, "\\a");
-			break;
-		case '\b':
-			g_string_append(pretty->string, "\\b");
-			break;
-		case '\e':
-			g_string_append(pretty->string, "\\e");
-			break;
-		case '\f':
-			g_string_append(pretty->string, "\\f");
-			break;
-		case '\n':
-			g_string_append(pretty->string, "\\n");
-			break;
-		case '\r':
-			g_string_append(pretty->string, "\\r");
-			break;
-		case '\t':
-			g_string_append(pretty->string, "\\t");
-			break;
-		case '\v':
-			g_string_append(pretty->string, "\\v");
-			break;
-		default:
+		g_string_append_len(pretty->string, run, p - run);
+
+		if (esc) {
+			g_string_append(pretty->string, esc);
+		} else {
 			/* Unhandled control-sequence, print as hex. */
-			g_string_append_printf(pretty->string, "\\x%02x", str[i]);
-			break;
+			g_string_append_printf(pretty->string, "\\x%02x", *p);
 		}
+
+		run = p + 1;
 	}
 
+	g_string_append_len(pretty->string, run, p - run);
 	g_string_append_c(pretty->string, '"');
 }
 
@@ -783,9 +981,15 @@ enum bt_component_status print_enum(struct pretty_component *pretty,
 	struct bt_field *container_field = NULL;
 	struct bt_field_type *enumeration_field_type = NULL;
 	struct bt_field_type *container_field_type = NULL;
-	struct bt_field_type_enumeration_mapping_iterator *iter = NULL;
-	int nr_mappings = 0;
+	const char *local_names[8];
+	const char **names = local_names;
+	int64_t nr_mappings;
+	int64_t i;
 	int is_signed;
+	union {
+		int64_t _signed;
+		uint64_t _unsigned;
+	} value;
 
 	enumeration_field_type = bt_field_get_type(field);
 	if (!enumeration_field_type) {
@@ -808,29 +1012,51 @@ enum bt_component_status print_enum(struct pretty_component *pretty,
 		goto end;
 	}
 	if (is_signed) {
-		int64_t value;
-
 		if (bt_field_signed_integer_get_value(container_field,
-				&value)) {
+				&value._signed)) {
 			ret = BT_COMPONENT_STATUS_ERROR;
 			goto end;
 		}
-		iter = bt_field_type_enumeration_find_mappings_by_signed_value(
-				enumeration_field_type, value);
+		nr_mappings =
+			bt_field_type_enumeration_get_mapping_names_by_signed_value(
+				enumeration_field_type, value._signed, names,
+				BT_ARRAY_SIZE(local_names));
 	} else {
-		uint64_t value;
-
 		if (bt_field_unsigned_integer_get_value(container_field,
-				&value)) {
+				&value._unsigned)) {
 			ret = BT_COMPONENT_STATUS_ERROR;
 			goto end;
 		}
-		iter = bt_field_type_enumeration_find_mappings_by_unsigned_value(
-				enumeration_field_type, value);
+		nr_mappings =
+			bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+				enumeration_field_type, value._unsigned, names,
+				BT_ARRAY_SIZE(local_names));
+	}
+	if (nr_mappings < 0) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+	if ((uint64_t) nr_mappings > BT_ARRAY_SIZE(local_names)) {
+		/* Rare: more matching mappings than the local array */
+		names = g_new(const char *, nr_mappings);
+		if (!names) {
+			ret = BT_COMPONENT_STATUS_NOMEM;
+			goto end;
+		}
+		if (is_signed) {
+			nr_mappings =
+				bt_field_type_enumeration_get_mapping_names_by_signed_value(
+					enumeration_field_type, value._signed,
+					names, nr_mappings);
+		} else {
+			nr_mappings =
+				bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+					enumeration_field_type, value._unsigned,
+					names, nr_mappings);
+		}
 	}
 	g_string_append(pretty->string, "( ");
-	ret = bt_field_type_enumeration_mapping_iterator_next(iter);
-	if (ret) {
+	if (nr_mappings == 0) {
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_UNKNOWN);
 		}
@@ -838,30 +1064,18 @@ enum bt_component_status print_enum(struct pretty_component *pretty,
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_RST);
 		}
-		goto skip_loop;
 	}
-	for (;;) {
-		const char *mapping_name;
-
-		if (bt_field_type_enumeration_mapping_iterator_get_signed(
-				iter, &mapping_name, NULL, NULL) < 0) {
-			ret = BT_COMPONENT_STATUS_ERROR;
-			goto end;
-		}
-		if (nr_mappings++)
+	for (i = 0; i < nr_mappings; i++) {
+		if (i > 0)
 			g_string_append(pretty->string, ", ");
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_ENUM_MAPPING_NAME);
 		}
-		print_escape_string(pretty, mapping_name);
+		print_escape_string(pretty, names[i]);
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_RST);
 		}
-		if (bt_field_type_enumeration_mapping_iterator_next(iter) < 0) {
-			break;
-		}
 	}
-skip_loop:
 	g_string_append(pretty->string, " : container = ");
 	ret = print_integer(pretty, container_field);
 	if (ret != BT_COMPONENT_STATUS_OK) {
@@ -869,7 +1083,9 @@ skip_loop:
 	}
 	g_string_append(pretty->string, " )");
 end:
-	bt_put(iter);
+	if (names != local_names) {
+		g_free(names);
+	}
 	bt_put(container_field_type);
 	bt_put(container_field);
 	bt_put(enumeration_field_type);
@@ -877,11 +1093,10 @@ end:
 }
 
 static
-int filter_field_name(struct pretty_component *pretty, const char *field_name,
+int filter_field_name(struct pretty_component *pretty, GQuark field_quark,
 		GQuark *filter_fields, int filter_array_len)
 {
 	int i;
-	GQuark field_quark = g_quark_try_string(field_name);
 
 	if (!field_quark || pretty->options.verbose) {
 		return 1;
@@ -895,30 +1110,112 @@ int filter_field_name(struct pretty_component *pretty, const char *field_name,
 	return 1;
 }
 
+BT_HIDDEN
+void pretty_destroy_struct_info(void *data)
+{
+	struct pretty_struct_info *info = data;
+	int64_t i;
+
+	if (!info) {
+		return;
+	}
+
+	for (i = 0; i < info->nr_members; i++) {
+		g_free(info->members[i].name_equal);
+	}
+
+	bt_put(info->type);
+	g_free(info);
+}
+
+/*
+ * Returns the printing data of the structure field type `struct_type`,
+ * creating it if it does not exist yet.
+ *
+ * `struct_type` is frozen, so that its members never change once this
+ * data exists.
+ */
+static
+struct pretty_struct_info *get_struct_info(struct pretty_component *pretty,
+		struct bt_field_type *struct_type)
+{
+	struct pretty_struct_info *info;
+	int64_t nr_members;
+	int64_t i;
+
+	info = g_hash_table_lookup(pretty->struct_infos, struct_type);
+	if (info) {
+		goto end;
+	}
+
+	nr_members = bt_field_type_structure_get_field_count(struct_type);
+	if (nr_members < 0) {
+		goto end;
+	}
+
+	info = g_malloc0(sizeof(*info) +
+		nr_members * sizeof(struct pretty_struct_member));
+	if (!info) {
+		goto end;
+	}
+
+	info->type = bt_get(struct_type);
+	info->nr_members = nr_members;
+
+	for (i = 0; i < nr_members; i++) {
+		struct pretty_struct_member *member = &info->members[i];
+		const char *field_name;
+
+		if (bt_field_type_structure_get_field_by_index(struct_type,
+				&field_name, NULL, i) < 0) {
+			goto error;
+		}
+
+		member->name_quark = g_quark_try_string(field_name);
+
+		if (pretty->use_colors) {
+			member->name_equal = g_strdup_printf("%s%s%s = ",
+				COLOR_FIELD_NAME, field_name, COLOR_RST);
+		} else {
+			member->name_equal = g_strdup_printf("%s = ",
+				field_name);
+		}
+
+		if (!member->name_equal) {
+			goto error;
+		}
+
+		member->name_equal_len = strlen(member->name_equal);
+	}
+
+	g_hash_table_insert(pretty->struct_infos, struct_type, info);
+	goto end;
+
+error:
+	pretty_destroy_struct_info(info);
+	info = NULL;
+
+end:
+	return info;
+}
+
 static
 enum bt_component_status print_struct_field(struct pretty_component *pretty,
 		struct bt_field *_struct,
-		struct bt_field_type *struct_type,
+		struct pretty_struct_member *member,
 		int i, bool print_names, int *nr_printed_fields,
 		GQuark *filter_fields, int filter_array_len)
 {
 	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
-	const char *field_name;
 	struct bt_field *field = NULL;
-	struct bt_field_type *field_type = NULL;;
 
 	field = bt_field_structure_get_field_by_index(_struct, i);
 	if (!field) {
 		ret = BT_COMPONENT_STATUS_ERROR;
 		goto end;
 	}
-	if (bt_field_type_structure_get_field_by_index(struct_type,
-			&field_name, &field_type, i) < 0) {
-		ret = BT_COMPONENT_STATUS_ERROR;
-		goto end;
-	}
 
-	if (filter_fields && !filter_field_name(pretty, field_name,
+	if (filter_fields && !filter_field_name(pretty, member->name_quark,
 				filter_fields, filter_array_len)) {
 		ret = BT_COMPONENT_STATUS_OK;
 		goto end;
@@ -930,12 +1227,12 @@ enum bt_component_status print_struct_field(struct pretty_component *pretty,
 		g_string_append(pretty->string, " ");
 	}
 	if (print_names) {
-		print_field_name_equal(pretty, field_name);
+		g_string_append_len(pretty->string, member->name_equal,
+			member->name_equal_len);
 	}
 	ret = print_field(pretty, field, print_names, NULL, 0);
 	*nr_printed_fields += 1;
 end:
-	bt_put(field_type);
 	bt_put(field);
 	return ret;
 }
@@ -947,6 +1244,7 @@ enum bt_component_status print_struct(struct pretty_component *pretty,
 {
 	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
 	struct bt_field_type *struct_type = NULL;
+	struct pretty_struct_info *info;
 	int nr_fields, i, nr_printed_fields;
 
 	struct_type = bt_field_get_type(_struct);
@@ -954,16 +1252,17 @@ enum bt_component_status print_struct(struct pretty_component *pretty,
 		ret = BT_COMPONENT_STATUS_ERROR;
 		goto end;
 	}
-	nr_fields = bt_field_type_structure_get_field_count(struct_type);
-	if (nr_fields < 0) {
+	info = get_struct_info(pretty, struct_type);
+	if (!info) {
 		ret = BT_COMPONENT_STATUS_ERROR;
 		goto end;
 	}
+	nr_fields = (int) info->nr_members;
 	g_string_append(pretty->string, "{");
 	pretty->depth++;
 	nr_printed_fields = 0;
 	for (i = 0; i < nr_fields; i++) {
-		ret = print_struct_field(pretty, _struct, struct_type, i,
+		ret = print_struct_field(pretty, _struct, &info->members[i], i,
 				print_names, &nr_printed_fields, filter_fields,
 				filter_array_len);
 		if (ret != BT_COMPONENT_STATUS_OK) {
@@ -992,7 +1291,9 @@ enum bt_component_status print_array_field(struct pretty_component *pretty,
 			g_string_append(pretty->string, " ");
 		}
 		if (print_names) {
-			g_string_append_printf(pretty->string, "[%" PRIu64 "] = ", i);
+			g_string_append_c(pretty->string, '[');
+			pretty_append_uint(pretty->string, i);
+			g_string_append(pretty->string, "] = ");
 		}
 	}
 	field = bt_field_array_get_field(array, i);
@@ -1103,7 +1404,9 @@ enum bt_component_status print_sequence_field(struct pretty_component *pretty,
 			g_string_append(pretty->string, " ");
 		}
 		if (print_names) {
-			g_string_append_printf(pretty->string, "[%" PRIu64 "] = ", i);
+			g_string_append_c(pretty->string, '[');
+			pretty_append_uint(pretty->string, i);
+			g_string_append(pretty->string, "] = ");
 		}
 	}
 	field = bt_field_sequence_get_field(seq, i);
@@ -1288,7 +1591,7 @@ enum bt_component_status print_field(struct pretty_component *pretty,
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_NUMBER_VALUE);
 		}
-		g_string_append_printf(pretty->string, "%g", v);
+		pretty_append_double(pretty->string, v);
 		if (pretty->use_colors) {
 			g_string_append(pretty->string, COLOR_RST);
 		}
@@ -1464,20 +1767,16 @@ end:
 	return ret;
 }
 
-static
-int flush_buf(struct pretty_component *pretty)
+BT_HIDDEN
+int pretty_flush(struct pretty_component *pretty, bool sync)
 {
-	int ret = 0;
-
-	if (pretty->string->len == 0) {
-		goto end;
-	}
+	int ret;
 
-	if (fwrite(pretty->string->str, pretty->string->len, 1, pretty->out) != 1) {
+	ret = pretty_writer_write(pretty->writer, &pretty->string);
+	if (sync && pretty_writer_sync(pretty->writer)) {
 		ret = -1;
 	}
 
-end:
 	return ret;
 }
 
@@ -1490,11 +1789,12 @@ enum bt_component_status pretty_print_event(struct pretty_component *pretty,
 		bt_notification_event_get_event(event_notif);
 	struct bt_clock_class_priority_map *cc_prio_map =
 		bt_notification_event_get_clock_class_priority_map(event_notif);
+	/* The output buffer can already contain previous lines */
+	gsize line_offset = pretty->string->len;
 
 	assert(event);
 	assert(cc_prio_map);
 	pretty->start_line = true;
-	g_string_assign(pretty->string, "");
 	ret = print_event_header(pretty, event, cc_prio_map);
 	if (ret != BT_COMPONENT_STATUS_OK) {
 		goto end;
@@ -1528,12 +1828,19 @@ enum bt_component_status pretty_print_event(struct pretty_component *pretty,
 	}
 
 	g_string_append_c(pretty->string, '\n');
-	if (flush_buf(pretty)) {
-		ret = BT_COMPONENT_STATUS_ERROR;
-		goto end;
+	if (pretty->string->len >= PRETTY_OUTPUT_FLUSH_SIZE) {
+		if (pretty_flush(pretty, false)) {
+			ret = BT_COMPONENT_STATUS_ERROR;
+			goto end;
+		}
 	}
 
 end:
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		/* Drop the partial line */
+		g_string_truncate(pretty->string, line_offset);
+	}
+
 	bt_put(event);
 	bt_put(cc_prio_map);
 	return ret;
@@ -1597,8 +1904,14 @@ enum bt_component_status pretty_print_discarded_elements(
 
 	/*
 	 * Print to standard error stream to remain backward compatible
-	 * with Babeltrace 1.
+	 * with Babeltrace 1. Write the buffered lines first so that
+	 * this warning follows them when both streams are the same
+	 * terminal.
 	 */
+	if (pretty_flush(pretty, true)) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+	}
+
 	fprintf(stderr,
 		"%s%sWARNING%s%s: Tracer discarded %" PRId64 " %s%s between [",
 		bt_common_color_fg_yellow(),
@@ -1607,21 +1920,21 @@ enum bt_component_status pretty_print_discarded_elements(
 		bt_common_color_fg_yellow(),
 		count, is_discarded_events ? "event" : "packet",
 		count == 1 ? "" : "s");
-	g_string_assign(pretty->string, "");
+	g_string_assign(pretty->discarded_string, "");
 	clock_value = is_discarded_events ?
 		bt_notification_discarded_events_get_begin_clock_value(notif) :
 		bt_notification_discarded_packets_get_begin_clock_value(notif);
-	print_timestamp_wall(pretty, clock_value);
+	print_timestamp_wall(pretty, pretty->discarded_string, clock_value);
 	BT_PUT(clock_value);
-	fprintf(stderr, "%s] and [", pretty->string->str);
-	g_string_assign(pretty->string, "");
+	fprintf(stderr, "%s] and [", pretty->discarded_string->str);
+	g_string_assign(pretty->discarded_string, "");
 	clock_value = is_discarded_events ?
 		bt_notification_discarded_events_get_end_clock_value(notif) :
 		bt_notification_discarded_packets_get_end_clock_value(notif);
-	print_timestamp_wall(pretty, clock_value);
+	print_timestamp_wall(pretty, pretty->discarded_string, clock_value);
 	BT_PUT(clock_value);
 	fprintf(stderr, "%s] in trace \"%s\" ",
-		pretty->string->str, trace_name);
+		pretty->discarded_string->str, trace_name);
 
 	if (trace_uuid) {
 		fprintf(stderr,
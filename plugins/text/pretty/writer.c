@@ -0,0 +1,239 @@
+/*
+ * writer.c
+ *
+ * Babeltrace CTF Text Output Plugin Output Writer
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <glib.h>
+
+#include "writer.h"
+
+struct pretty_writer {
+	FILE *out;	/* Not owned by this */
+	bool threaded;
+
+	/* The members below are only used by a threaded writer */
+	pthread_t thread;
+	pthread_mutex_t lock;
+
+	/* Signaled when `pending` or `stop` changes */
+	pthread_cond_t cond;
+
+	/*
+	 * Buffer to write or being written by the writer thread, or
+	 * NULL when the writer thread is idle. Protected by `lock`.
+	 */
+	GString *pending;
+
+	/* Empty buffer to give back to the caller, protected by `lock` */
+	GString *spare;
+
+	/* True to make the writer thread exit, protected by `lock` */
+	bool stop;
+
+	/* True if a write failed, protected by `lock` */
+	bool error;
+};
+
+static
+int write_buf(FILE *out, GString *buf)
+{
+	if (buf->len == 0) {
+		return 0;
+	}
+
+	if (fwrite(buf->str, buf->len, 1, out) != 1) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static
+void *writer_thread_func(void *data)
+{
+	struct pretty_writer *writer = data;
+
+	pthread_mutex_lock(&writer->lock);
+
+	while (true) {
+		GString *buf;
+		int ret;
+
+		while (!writer->pending && !writer->stop) {
+			pthread_cond_wait(&writer->cond, &writer->lock);
+		}
+
+		if (!writer->pending) {
+			/* Stopped and nothing left to write */
+			break;
+		}
+
+		buf = writer->pending;
+		pthread_mutex_unlock(&writer->lock);
+		ret = write_buf(writer->out, buf);
+		g_string_truncate(buf, 0);
+		pthread_mutex_lock(&writer->lock);
+
+		if (ret) {
+			writer->error = true;
+		}
+
+		writer->spare = buf;
+		writer->pending = NULL;
+		pthread_cond_broadcast(&writer->cond);
+	}
+
+	pthread_mutex_unlock(&writer->lock);
+	return NULL;
+}
+
+/* Waits for the writer thread to be idle; `writer->lock` is held */
+static
+void wait_idle(struct pretty_writer *writer)
+{
+	while (writer->pending) {
+		pthread_cond_wait(&writer->cond, &writer->lock);
+	}
+}
+
+BT_HIDDEN
+struct pretty_writer *pretty_writer_create(FILE *out, bool threaded)
+{
+	struct pretty_writer *writer = g_new0(struct pretty_writer, 1);
+
+	if (!writer) {
+		goto end;
+	}
+
+	writer->out = out;
+
+	if (!threaded) {
+		goto end;
+	}
+
+	writer->spare = g_string_new(NULL);
+	if (!writer->spare) {
+		goto error;
+	}
+
+	pthread_mutex_init(&writer->lock, NULL);
+	pthread_cond_init(&writer->cond, NULL);
+
+	if (pthread_create(&writer->thread, NULL, writer_thread_func, writer)) {
+		pthread_cond_destroy(&writer->cond);
+		pthread_mutex_destroy(&writer->lock);
+		g_string_free(writer->spare, TRUE);
+		goto error;
+	}
+
+	writer->threaded = true;
+	goto end;
+
+error:
+	g_free(writer);
+	writer = NULL;
+
+end:
+	return writer;
+}
+
+BT_HIDDEN
+int pretty_writer_write(struct pretty_writer *writer, GString **buf)
+{
+	int ret = 0;
+
+	if ((*buf)->len == 0) {
+		goto end;
+	}
+
+	if (!writer->threaded) {
+		ret = write_buf(writer->out, *buf);
+		g_string_truncate(*buf, 0);
+		goto end;
+	}
+
+	pthread_mutex_lock(&writer->lock);
+	wait_idle(writer);
+
+	if (writer->error) {
+		ret = -1;
+	}
+
+	writer->pending = *buf;
+	*buf = writer->spare;
+	writer->spare = NULL;
+	pthread_cond_broadcast(&writer->cond);
+	pthread_mutex_unlock(&writer->lock);
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+int pretty_writer_sync(struct pretty_writer *writer)
+{
+	int ret = 0;
+
+	if (writer->threaded) {
+		pthread_mutex_lock(&writer->lock);
+		wait_idle(writer);
+
+		if (writer->error) {
+			ret = -1;
+		}
+
+		pthread_mutex_unlock(&writer->lock);
+	}
+
+	if (fflush(writer->out)) {
+		ret = -1;
+	}
+
+	return ret;
+}
+
+BT_HIDDEN
+void pretty_writer_destroy(struct pretty_writer *writer)
+{
+	if (!writer) {
+		return;
+	}
+
+	if (writer->threaded) {
+		pthread_mutex_lock(&writer->lock);
+		writer->stop = true;
+		pthread_cond_broadcast(&writer->cond);
+		pthread_mutex_unlock(&writer->lock);
+		pthread_join(writer->thread, NULL);
+		pthread_cond_destroy(&writer->cond);
+		pthread_mutex_destroy(&writer->lock);
+		g_string_free(writer->spare, TRUE);
+	}
+
+	(void) fflush(writer->out);
+	g_free(writer);
+}
@@ -0,0 +1,72 @@
+#ifndef BABELTRACE_PLUGIN_TEXT_PRETTY_WRITER_H
+#define BABELTRACE_PLUGIN_TEXT_PRETTY_WRITER_H
+
+/*
+ * BabelTrace - CTF Text Output Plug-in output writer
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <glib.h>
+#include <babeltrace/babeltrace-internal.h>
+
+/*
+ * A writer writes whole output buffers to a file.
+ *
+ * A threaded writer owns a writer thread and a spare buffer: writing
+ * swaps the caller's buffer with the spare one and the writer thread
+ * writes the former while the caller fills the latter. The caller only
+ * waits when the writer thread is still busy with the previous buffer.
+ */
+struct pretty_writer;
+
+/*
+ * Creates a writer which writes to `out` (not owned), with its own
+ * writer thread if `threaded` is true.
+ */
+BT_HIDDEN
+struct pretty_writer *pretty_writer_create(FILE *out, bool threaded);
+
+/*
+ * Writes the content of `*buf`, leaving an empty buffer in `*buf`
+ * (possibly another one).
+ *
+ * Returns a negative value if this or a previous write failed.
+ */
+BT_HIDDEN
+int pretty_writer_write(struct pretty_writer *writer, GString **buf);
+
+/*
+ * Waits for the pending write, if any, to be done and flushes the
+ * output file.
+ *
+ * Returns a negative value if a previous write or the flush failed.
+ */
+BT_HIDDEN
+int pretty_writer_sync(struct pretty_writer *writer);
+
+/* Syncs, then destroys `writer`, stopping its writer thread, if any. */
+BT_HIDDEN
+void pretty_writer_destroy(struct pretty_writer *writer);
+
+#endif /* BABELTRACE_PLUGIN_TEXT_PRETTY_WRITER_H */
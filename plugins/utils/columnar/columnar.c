@@ -0,0 +1,1410 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define BT_LOG_TAG "PLUGIN-UTILS-COLUMNAR-SINK"
+#include "logging.h"
+
+#include <babeltrace/babeltrace.h>
+#include <babeltrace/babeltrace-internal.h>
+#include <plugins-common.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <assert.h>
+#include <errno.h>
+#include <float.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "columnar.h"
+
+/* Maximum number of notifications to get from the input iterator at once */
+#define NOTIF_BATCH_CAPACITY	64
+
+#define DEFAULT_CHUNK_SIZE	65536
+
+#define TIMESTAMP_COLUMN_NAME	"timestamp"
+
+/* How a field type maps to columns */
+enum ft_kind {
+	/* No column: compound field types other than structures */
+	FT_KIND_SKIPPED,
+
+	/* One column per member, recursively */
+	FT_KIND_STRUCT,
+
+	/* One column */
+	FT_KIND_COLUMN,
+};
+
+static const uint8_t zero_padding[8];
+
+static
+const char *type_name(enum columnar_type type)
+{
+	switch (type) {
+	case COLUMNAR_TYPE_U8:
+		return "u8";
+	case COLUMNAR_TYPE_U16:
+		return "u16";
+	case COLUMNAR_TYPE_U32:
+		return "u32";
+	case COLUMNAR_TYPE_U64:
+		return "u64";
+	case COLUMNAR_TYPE_S8:
+		return "s8";
+	case COLUMNAR_TYPE_S16:
+		return "s16";
+	case COLUMNAR_TYPE_S32:
+		return "s32";
+	case COLUMNAR_TYPE_S64:
+		return "s64";
+	case COLUMNAR_TYPE_F32:
+		return "f32";
+	case COLUMNAR_TYPE_F64:
+		return "f64";
+	case COLUMNAR_TYPE_STRING:
+		return "string";
+	case COLUMNAR_TYPE_DELTA_S64:
+		return "delta-s64";
+	default:
+		return "unknown";
+	}
+}
+
+static
+bool type_is_signed(enum columnar_type type)
+{
+	return type >= COLUMNAR_TYPE_S8 && type <= COLUMNAR_TYPE_S64;
+}
+
+static
+bool type_is_float(enum columnar_type type)
+{
+	return type == COLUMNAR_TYPE_F32 || type == COLUMNAR_TYPE_F64;
+}
+
+/* Size of a value of a fixed-width column type */
+static
+size_t type_width(enum columnar_type type)
+{
+	switch (type) {
+	case COLUMNAR_TYPE_U8:
+	case COLUMNAR_TYPE_S8:
+		return 1;
+	case COLUMNAR_TYPE_U16:
+	case COLUMNAR_TYPE_S16:
+		return 2;
+	case COLUMNAR_TYPE_U32:
+	case COLUMNAR_TYPE_S32:
+	case COLUMNAR_TYPE_F32:
+		return 4;
+	default:
+		return 8;
+	}
+}
+
+/* Returns the column type of an integer field type */
+static
+enum columnar_type get_int_column_type(struct bt_field_type *int_ft)
+{
+	int size = bt_field_type_integer_get_size(int_ft);
+	bool is_signed = bt_field_type_integer_is_signed(int_ft);
+
+	if (size <= 8) {
+		return is_signed ? COLUMNAR_TYPE_S8 : COLUMNAR_TYPE_U8;
+	} else if (size <= 16) {
+		return is_signed ? COLUMNAR_TYPE_S16 : COLUMNAR_TYPE_U16;
+	} else if (size <= 32) {
+		return is_signed ? COLUMNAR_TYPE_S32 : COLUMNAR_TYPE_U32;
+	} else {
+		return is_signed ? COLUMNAR_TYPE_S64 : COLUMNAR_TYPE_U64;
+	}
+}
+
+/*
+ * Returns whether or not `elem_ft`, the element field type of an array
+ * or sequence field type, makes it a text field type (written as a
+ * string column).
+ */
+static
+bool is_text_element_type(struct bt_field_type *elem_ft)
+{
+	enum bt_string_encoding encoding;
+
+	if (bt_field_type_get_type_id(elem_ft) != BT_FIELD_TYPE_ID_INTEGER) {
+		return false;
+	}
+
+	encoding = bt_field_type_integer_get_encoding(elem_ft);
+	if (encoding != BT_STRING_ENCODING_UTF8 &&
+			encoding != BT_STRING_ENCODING_ASCII) {
+		return false;
+	}
+
+	return bt_field_type_integer_get_size(elem_ft) == CHAR_BIT &&
+		bt_field_type_get_alignment(elem_ft) == CHAR_BIT;
+}
+
+/*
+ * Returns how the field type `ft` maps to columns, setting `*type` to
+ * its column type if it's FT_KIND_COLUMN.
+ */
+static
+enum ft_kind get_ft_kind(struct bt_field_type *ft, enum columnar_type *type)
+{
+	enum ft_kind kind = FT_KIND_SKIPPED;
+	struct bt_field_type *sub_ft = NULL;
+
+	switch (bt_field_type_get_type_id(ft)) {
+	case BT_FIELD_TYPE_ID_INTEGER:
+		*type = get_int_column_type(ft);
+		kind = FT_KIND_COLUMN;
+		break;
+	case BT_FIELD_TYPE_ID_ENUM:
+		sub_ft = bt_field_type_enumeration_get_container_type(ft);
+		assert(sub_ft);
+		*type = get_int_column_type(sub_ft);
+		kind = FT_KIND_COLUMN;
+		break;
+	case BT_FIELD_TYPE_ID_FLOAT:
+		*type = bt_field_type_floating_point_get_mantissa_digits(ft) <=
+			FLT_MANT_DIG &&
+			bt_field_type_floating_point_get_exponent_digits(ft) <= 8 ?
+			COLUMNAR_TYPE_F32 : COLUMNAR_TYPE_F64;
+		kind = FT_KIND_COLUMN;
+		break;
+	case BT_FIELD_TYPE_ID_STRING:
+		*type = COLUMNAR_TYPE_STRING;
+		kind = FT_KIND_COLUMN;
+		break;
+	case BT_FIELD_TYPE_ID_STRUCT:
+		kind = FT_KIND_STRUCT;
+		break;
+	case BT_FIELD_TYPE_ID_ARRAY:
+		sub_ft = bt_field_type_array_get_element_type(ft);
+		assert(sub_ft);
+		goto text;
+	case BT_FIELD_TYPE_ID_SEQUENCE:
+		sub_ft = bt_field_type_sequence_get_element_type(ft);
+		assert(sub_ft);
+		goto text;
+	default:
+		break;
+	}
+
+	goto end;
+
+text:
+	if (is_text_element_type(sub_ft)) {
+		*type = COLUMNAR_TYPE_STRING;
+		kind = FT_KIND_COLUMN;
+	}
+
+end:
+	bt_put(sub_ft);
+	return kind;
+}
+
+/* Appends `name` to `str`, replacing the characters unsafe in a file name */
+static
+void append_sanitized(GString *str, const char *name)
+{
+	const char *p;
+
+	for (p = name; *p; p++) {
+		if (g_ascii_isalnum(*p) || *p == '_' || *p == '-' ||
+				*p == '.') {
+			g_string_append_c(str, *p);
+		} else {
+			g_string_append_c(str, '_');
+		}
+	}
+}
+
+static
+void destroy_column(struct columnar_column *column)
+{
+	if (!column) {
+		return;
+	}
+
+	if (column->name) {
+		g_string_free(column->name, TRUE);
+	}
+
+	if (column->path) {
+		g_string_free(column->path, TRUE);
+	}
+
+	if (column->data) {
+		g_byte_array_free(column->data, TRUE);
+	}
+
+	if (column->blob) {
+		g_byte_array_free(column->blob, TRUE);
+	}
+
+	g_free(column);
+}
+
+/* Returns whether or not a column of `ec` has the file path `path` */
+static
+bool column_path_exists(struct columnar_event_class *ec, const char *path)
+{
+	guint i;
+
+	for (i = 0; i < ec->columns->len; i++) {
+		struct columnar_column *column =
+			g_ptr_array_index(ec->columns, i);
+
+		if (strcmp(column->path->str, path) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Adds a column named `name` of type `type` to `ec` and creates its
+ * (empty) column file.
+ */
+static
+int add_column(struct columnar_event_class *ec, const char *name,
+		enum columnar_type type)
+{
+	struct columnar_column *column = g_new0(struct columnar_column, 1);
+	unsigned int suffix = 0;
+	FILE *fp;
+	int ret = 0;
+
+	if (!column) {
+		BT_LOGE_STR("Failed to allocate one column.");
+		goto error;
+	}
+
+	column->type = type;
+	column->name = g_string_new(name);
+	column->path = g_string_new(NULL);
+	column->data = g_byte_array_new();
+	if (!column->name || !column->path || !column->data) {
+		BT_LOGE_STR("Failed to allocate one column.");
+		goto error;
+	}
+
+	if (type == COLUMNAR_TYPE_STRING) {
+		column->blob = g_byte_array_new();
+		if (!column->blob) {
+			BT_LOGE_STR("Failed to allocate one column.");
+			goto error;
+		}
+	}
+
+	/* Sanitizing can make two field paths have the same file name */
+	do {
+		g_string_assign(column->path, ec->dir_path->str);
+		g_string_append_c(column->path, G_DIR_SEPARATOR);
+		append_sanitized(column->path, name);
+
+		if (suffix > 0) {
+			g_string_append_printf(column->path, "-%u", suffix);
+		}
+
+		g_string_append(column->path, ".col");
+		suffix++;
+	} while (column_path_exists(ec, column->path->str));
+
+	/* Truncate any column file of a previous run */
+	fp = g_fopen(column->path->str, "wb");
+	if (!fp) {
+		BT_LOGE("Cannot create column file: path=\"%s\", errno=%d",
+			column->path->str, errno);
+		goto error;
+	}
+
+	fclose(fp);
+	g_ptr_array_add(ec->columns, column);
+	goto end;
+
+error:
+	destroy_column(column);
+	ret = -1;
+
+end:
+	return ret;
+}
+
+/*
+ * Adds the columns of the field type `ft` of which the field path is
+ * `path` to `ec`, and describes them (or the skipped fields) in
+ * `schema`.
+ */
+static
+int add_field_type_columns(struct columnar_event_class *ec, GString *path,
+		struct bt_field_type *ft, GString *schema)
+{
+	enum columnar_type type;
+	int64_t count;
+	uint64_t i;
+	int ret = 0;
+
+	switch (get_ft_kind(ft, &type)) {
+	case FT_KIND_COLUMN:
+		ret = add_column(ec, path->str, type);
+		if (ret) {
+			goto end;
+		}
+
+		g_string_append_printf(schema, "column %s %s\n",
+			type_name(type), path->str);
+		break;
+	case FT_KIND_STRUCT:
+		count = bt_field_type_structure_get_field_count(ft);
+		assert(count >= 0);
+
+		for (i = 0; i < count; i++) {
+			struct bt_field_type *member_ft = NULL;
+			const char *member_name;
+			const gsize path_len = path->len;
+
+			ret = bt_field_type_structure_get_field_by_index(ft,
+				&member_name, &member_ft, i);
+			assert(ret == 0);
+			g_string_append_c(path, '.');
+			g_string_append(path, member_name);
+			ret = add_field_type_columns(ec, path, member_ft,
+				schema);
+			g_string_truncate(path, path_len);
+			bt_put(member_ft);
+			if (ret) {
+				goto end;
+			}
+		}
+		break;
+	case FT_KIND_SKIPPED:
+		g_string_append_printf(schema, "skipped %s\n", path->str);
+		break;
+	}
+
+end:
+	return ret;
+}
+
+/* Adds the columns of the scope field type `ft` (may be NULL) to `ec` */
+static
+int add_scope_columns(struct columnar_event_class *ec,
+		const char *scope_name, struct bt_field_type *ft,
+		GString *schema)
+{
+	GString *path;
+	int ret = 0;
+
+	if (!ft) {
+		goto end;
+	}
+
+	path = g_string_new(scope_name);
+	if (!path) {
+		ret = -1;
+		goto end;
+	}
+
+	ret = add_field_type_columns(ec, path, ft, schema);
+	g_string_free(path, TRUE);
+
+end:
+	return ret;
+}
+
+static
+void destroy_event_class(struct columnar_event_class *ec)
+{
+	if (!ec) {
+		return;
+	}
+
+	if (ec->columns) {
+		g_ptr_array_free(ec->columns, TRUE);
+	}
+
+	if (ec->dir_path) {
+		g_string_free(ec->dir_path, TRUE);
+	}
+
+	bt_put(ec->event_class);
+	g_free(ec);
+}
+
+static
+int write_schema(struct columnar_event_class *ec, GString *schema)
+{
+	GString *path = g_string_new(ec->dir_path->str);
+	int ret = 0;
+
+	if (!path) {
+		ret = -1;
+		goto end;
+	}
+
+	g_string_append_c(path, G_DIR_SEPARATOR);
+	g_string_append(path, "schema");
+
+	if (!g_file_set_contents(path->str, schema->str, schema->len, NULL)) {
+		BT_LOGE("Cannot write schema file: path=\"%s\"", path->str);
+		ret = -1;
+	}
+
+	g_string_free(path, TRUE);
+
+end:
+	return ret;
+}
+
+/*
+ * Creates the columns of `event_class` from its field types and those
+ * of its stream class, as well as its directory, its schema file, and
+ * its empty column files.
+ */
+static
+struct columnar_event_class *create_event_class(struct columnar *columnar,
+		struct bt_event_class *event_class)
+{
+	struct columnar_event_class *ec = g_new0(struct columnar_event_class, 1);
+	struct bt_stream_class *stream_class = NULL;
+	struct bt_trace *trace = NULL;
+	struct bt_field_type *ft = NULL;
+	GString *schema = NULL;
+	const char *name;
+	const char *trace_name = NULL;
+
+	if (!ec) {
+		BT_LOGE_STR("Failed to allocate one event class.");
+		goto error;
+	}
+
+	ec->event_class = bt_get(event_class);
+	ec->columns = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) destroy_column);
+	ec->dir_path = g_string_new(columnar->path->str);
+	schema = g_string_new(NULL);
+	if (!ec->columns || !ec->dir_path || !schema) {
+		BT_LOGE_STR("Failed to allocate one event class.");
+		goto error;
+	}
+
+	stream_class = bt_event_class_get_stream_class(event_class);
+	assert(stream_class);
+	trace = bt_stream_class_get_trace(stream_class);
+	if (trace) {
+		trace_name = bt_trace_get_name(trace);
+	}
+
+	name = bt_event_class_get_name(event_class);
+	if (!name) {
+		name = "";
+	}
+
+	/*
+	 * Prefix the directory name with an index: different traces can
+	 * have event classes with the same name.
+	 */
+	g_string_append_printf(ec->dir_path, "%c%" PRIu64 "-",
+		G_DIR_SEPARATOR, columnar->next_dir_index);
+	append_sanitized(ec->dir_path, name);
+	columnar->next_dir_index++;
+
+	if (g_mkdir_with_parents(ec->dir_path->str, 0755)) {
+		BT_LOGE("Cannot create event class directory: path=\"%s\", errno=%d",
+			ec->dir_path->str, errno);
+		goto error;
+	}
+
+	g_string_append_printf(schema,
+		"version %d\nname %s\nid %" PRId64 "\nstream-class-id %" PRId64 "\ntrace %s\n",
+		COLUMNAR_FORMAT_VERSION, name,
+		bt_event_class_get_id(event_class),
+		bt_stream_class_get_id(stream_class),
+		trace_name ? trace_name : "");
+
+	if (add_column(ec, TIMESTAMP_COLUMN_NAME, COLUMNAR_TYPE_DELTA_S64)) {
+		goto error;
+	}
+
+	g_string_append_printf(schema, "column %s %s\n",
+		type_name(COLUMNAR_TYPE_DELTA_S64), TIMESTAMP_COLUMN_NAME);
+
+	ft = bt_stream_class_get_event_context_type(stream_class);
+	if (add_scope_columns(ec, "stream.event.context", ft, schema)) {
+		goto error;
+	}
+
+	BT_PUT(ft);
+	ft = bt_event_class_get_context_type(event_class);
+	if (add_scope_columns(ec, "event.context", ft, schema)) {
+		goto error;
+	}
+
+	BT_PUT(ft);
+	ft = bt_event_class_get_payload_type(event_class);
+	if (add_scope_columns(ec, "event.fields", ft, schema)) {
+		goto error;
+	}
+
+	if (write_schema(ec, schema)) {
+		goto error;
+	}
+
+	BT_LOGD("Created event class columns: name=\"%s\", dir-path=\"%s\", "
+		"column-count=%u", name, ec->dir_path->str, ec->columns->len);
+	goto end;
+
+error:
+	destroy_event_class(ec);
+	ec = NULL;
+
+end:
+	if (schema) {
+		g_string_free(schema, TRUE);
+	}
+
+	bt_put(ft);
+	bt_put(trace);
+	bt_put(stream_class);
+	return ec;
+}
+
+static
+void update_min_max_u(struct columnar_column *column, uint64_t v)
+{
+	if (!column->has_min_max) {
+		column->min.u = v;
+		column->max.u = v;
+		column->has_min_max = true;
+	} else if (v < column->min.u) {
+		column->min.u = v;
+	} else if (v > column->max.u) {
+		column->max.u = v;
+	}
+}
+
+static
+void update_min_max_s(struct columnar_column *column, int64_t v)
+{
+	if (!column->has_min_max) {
+		column->min.s = v;
+		column->max.s = v;
+		column->has_min_max = true;
+	} else if (v < column->min.s) {
+		column->min.s = v;
+	} else if (v > column->max.s) {
+		column->max.s = v;
+	}
+}
+
+static
+void update_min_max_f(struct columnar_column *column, double v)
+{
+	if (isnan(v)) {
+		return;
+	}
+
+	if (!column->has_min_max) {
+		column->min.f = v;
+		column->max.f = v;
+		column->has_min_max = true;
+	} else if (v < column->min.f) {
+		column->min.f = v;
+	} else if (v > column->max.f) {
+		column->max.f = v;
+	}
+}
+
+/* Appends the integer `v`, narrowed to the width of `column` */
+static
+void append_int_value(struct columnar_column *column, uint64_t v)
+{
+	union {
+		uint8_t u8;
+		uint16_t u16;
+		uint32_t u32;
+		uint64_t u64;
+	} value;
+	size_t width = type_width(column->type);
+
+	switch (width) {
+	case 1:
+		value.u8 = (uint8_t) v;
+		break;
+	case 2:
+		value.u16 = (uint16_t) v;
+		break;
+	case 4:
+		value.u32 = (uint32_t) v;
+		break;
+	default:
+		value.u64 = v;
+		break;
+	}
+
+	g_byte_array_append(column->data, (const guint8 *) &value, width);
+
+	if (type_is_signed(column->type)) {
+		update_min_max_s(column, (int64_t) v);
+	} else {
+		update_min_max_u(column, v);
+	}
+}
+
+static
+void append_float_value(struct columnar_column *column, double v)
+{
+	if (column->type == COLUMNAR_TYPE_F32) {
+		float f = (float) v;
+
+		g_byte_array_append(column->data, (const guint8 *) &f,
+			sizeof(f));
+		update_min_max_f(column, f);
+	} else {
+		g_byte_array_append(column->data, (const guint8 *) &v,
+			sizeof(v));
+		update_min_max_f(column, v);
+	}
+}
+
+static
+void append_string_value(struct columnar_column *column, const char *str,
+		size_t len)
+{
+	const uint64_t offset = column->blob->len;
+
+	g_byte_array_append(column->data, (const guint8 *) &offset,
+		sizeof(offset));
+	g_byte_array_append(column->blob, (const guint8 *) str, len);
+	g_byte_array_append(column->blob, (const guint8 *) "", 1);
+	update_min_max_u(column, len);
+}
+
+static
+void append_timestamp_value(struct columnar_column *column, int64_t v)
+{
+	int64_t delta = 0;
+
+	if (column->data->len == 0) {
+		column->base = v;
+	} else {
+		delta = (int64_t) ((uint64_t) v - (uint64_t) column->last);
+	}
+
+	g_byte_array_append(column->data, (const guint8 *) &delta,
+		sizeof(delta));
+	column->last = v;
+	update_min_max_s(column, v);
+}
+
+/*
+ * Appends the text of the array or sequence field `field` of which the
+ * elements are 8-bit characters to `column`, up to the first null
+ * character, like the text.pretty sink does.
+ */
+static
+void append_text_value(struct columnar_column *column,
+		struct bt_field *field, struct bt_field_type *ft)
+{
+	const bool is_seq = bt_field_type_get_type_id(ft) ==
+		BT_FIELD_TYPE_ID_SEQUENCE;
+	const uint8_t *bytes;
+	GByteArray *tmp = NULL;
+	uint64_t len = 0;
+	uint64_t i;
+
+	if (is_seq) {
+		struct bt_field *length_field =
+			bt_field_sequence_get_length(field);
+
+		if (!length_field || bt_field_unsigned_integer_get_value(
+				length_field, &len)) {
+			len = 0;
+		}
+
+		bt_put(length_field);
+		bytes = bt_field_sequence_get_borrowed_bytes(field);
+	} else {
+		int64_t array_len = bt_field_type_array_get_length(ft);
+
+		len = array_len > 0 ? (uint64_t) array_len : 0;
+		bytes = bt_field_array_get_borrowed_bytes(field);
+	}
+
+	if (!bytes && len > 0) {
+		/* Not borrowed: gather the element values */
+		tmp = g_byte_array_sized_new(len);
+		if (!tmp) {
+			len = 0;
+			goto append;
+		}
+
+		for (i = 0; i < len; i++) {
+			struct bt_field *elem = is_seq ?
+				bt_field_sequence_get_field(field, i) :
+				bt_field_array_get_field(field, i);
+			uint64_t v = 0;
+			uint8_t c;
+
+			if (elem) {
+				(void) bt_field_unsigned_integer_get_value(
+					elem, &v);
+				bt_put(elem);
+			}
+
+			c = (uint8_t) v;
+			g_byte_array_append(tmp, &c, 1);
+		}
+
+		bytes = tmp->data;
+	}
+
+	if (bytes) {
+		const uint8_t *nul = memchr(bytes, '\0', len);
+
+		if (nul) {
+			len = nul - bytes;
+		}
+	}
+
+append:
+	append_string_value(column, (const char *) bytes, len);
+
+	if (tmp) {
+		g_byte_array_free(tmp, TRUE);
+	}
+}
+
+/*
+ * Appends the value of `field` (NULL or not set: default value), of
+ * which the type is `ft`, to `column`.
+ */
+static
+void append_column_value(struct columnar_column *column,
+		struct bt_field *field, struct bt_field_type *ft)
+{
+	struct bt_field *container = NULL;
+	struct bt_field *int_field = field;
+	enum bt_field_type_id type_id = bt_field_type_get_type_id(ft);
+
+	if (field && !bt_field_is_set(field)) {
+		field = NULL;
+		int_field = NULL;
+	}
+
+	if (type_id == BT_FIELD_TYPE_ID_ENUM && field) {
+		container = bt_field_enumeration_get_container(field);
+		int_field = container;
+	}
+
+	if (column->type == COLUMNAR_TYPE_STRING) {
+		if (!field) {
+			append_string_value(column, "", 0);
+		} else if (type_id == BT_FIELD_TYPE_ID_STRING) {
+			const char *str = bt_field_string_get_value(field);
+
+			if (!str) {
+				str = "";
+			}
+
+			append_string_value(column, str, strlen(str));
+		} else {
+			append_text_value(column, field, ft);
+		}
+	} else if (type_is_float(column->type)) {
+		double v = 0.;
+
+		if (field && bt_field_floating_point_get_value(field, &v)) {
+			v = 0.;
+		}
+
+		append_float_value(column, v);
+	} else if (type_is_signed(column->type)) {
+		int64_t v = 0;
+
+		if (int_field && bt_field_signed_integer_get_value(int_field,
+				&v)) {
+			v = 0;
+		}
+
+		append_int_value(column, (uint64_t) v);
+	} else {
+		uint64_t v = 0;
+
+		if (int_field && bt_field_unsigned_integer_get_value(int_field,
+				&v)) {
+			v = 0;
+		}
+
+		append_int_value(column, v);
+	}
+
+	bt_put(container);
+}
+
+/*
+ * Appends the values of `field` (may be NULL), of which the type is
+ * `ft`, to the columns of `ec`, starting at column `*index`, walking
+ * `ft` exactly like add_field_type_columns() does.
+ */
+static
+void append_field_values(struct columnar_event_class *ec, guint *index,
+		struct bt_field_type *ft, struct bt_field *field)
+{
+	enum columnar_type type;
+	int64_t count;
+	uint64_t i;
+
+	switch (get_ft_kind(ft, &type)) {
+	case FT_KIND_COLUMN:
+		assert(*index < ec->columns->len);
+		append_column_value(g_ptr_array_index(ec->columns, *index),
+			field, ft);
+		(*index)++;
+		break;
+	case FT_KIND_STRUCT:
+		count = bt_field_type_structure_get_field_count(ft);
+		assert(count >= 0);
+
+		for (i = 0; i < count; i++) {
+			struct bt_field_type *member_ft = NULL;
+			struct bt_field *member = NULL;
+			int ret;
+
+			ret = bt_field_type_structure_get_field_by_index(ft,
+				NULL, &member_ft, i);
+			assert(ret == 0);
+
+			if (field) {
+				member = bt_field_structure_get_field_by_index(
+					field, i);
+			}
+
+			append_field_values(ec, index, member_ft, member);
+			bt_put(member);
+			bt_put(member_ft);
+		}
+		break;
+	case FT_KIND_SKIPPED:
+		break;
+	}
+}
+
+static
+void append_scope_values(struct columnar_event_class *ec, guint *index,
+		struct bt_field_type *ft, struct bt_field *field)
+{
+	if (ft) {
+		append_field_values(ec, index, ft, field);
+	}
+}
+
+/*
+ * Returns the timestamp (ns from Epoch) of `event`, the event of
+ * `notif`, or `prev_ts` if it has none.
+ */
+static
+int64_t get_event_timestamp(struct bt_notification *notif,
+		struct bt_event *event, int64_t prev_ts)
+{
+	struct bt_clock_class_priority_map *cc_prio_map;
+	struct bt_clock_class *clock_class = NULL;
+	struct bt_clock_value *clock_value = NULL;
+	int64_t ts = prev_ts;
+
+	cc_prio_map = bt_notification_event_get_clock_class_priority_map(notif);
+	if (!cc_prio_map ||
+			bt_clock_class_priority_map_get_clock_class_count(
+				cc_prio_map) == 0) {
+		goto end;
+	}
+
+	clock_class = bt_clock_class_priority_map_get_highest_priority_clock_class(
+		cc_prio_map);
+	if (!clock_class) {
+		goto end;
+	}
+
+	clock_value = bt_event_get_clock_value(event, clock_class);
+	if (!clock_value ||
+			bt_clock_value_get_value_ns_from_epoch(clock_value,
+				&ts)) {
+		ts = prev_ts;
+	}
+
+end:
+	bt_put(clock_value);
+	bt_put(clock_class);
+	bt_put(cc_prio_map);
+	return ts;
+}
+
+/* Writes the current chunk of `column` (`count` values) to its file */
+static
+int write_column_chunk(struct columnar_column *column, uint64_t count)
+{
+	struct columnar_chunk_header header = { 0 };
+	struct columnar_chunk_footer footer = { 0 };
+	uint64_t data_size = column->data->len;
+	uint64_t last_offset = 0;
+	size_t padding;
+	FILE *fp;
+	int ret = 0;
+
+	if (column->type == COLUMNAR_TYPE_STRING) {
+		last_offset = column->blob->len;
+		data_size += sizeof(last_offset) + column->blob->len;
+	}
+
+	padding = (8 - (data_size & 7)) & 7;
+	data_size += padding;
+
+	header.magic = COLUMNAR_CHUNK_HEADER_MAGIC;
+	header.version = COLUMNAR_FORMAT_VERSION;
+	header.type = column->type;
+	header.byte_order = G_BYTE_ORDER == G_LITTLE_ENDIAN ?
+		COLUMNAR_BYTE_ORDER_LE : COLUMNAR_BYTE_ORDER_BE;
+	header.count = count;
+	header.data_size = data_size;
+
+	if (column->type == COLUMNAR_TYPE_DELTA_S64) {
+		header.base = column->base;
+	}
+
+	if (column->has_min_max) {
+		footer.min = column->min;
+		footer.max = column->max;
+	} else if (type_is_float(column->type)) {
+		footer.min.f = NAN;
+		footer.max.f = NAN;
+	}
+
+	footer.chunk_size = sizeof(header) + data_size + sizeof(footer);
+	footer.magic = COLUMNAR_CHUNK_FOOTER_MAGIC;
+
+	fp = g_fopen(column->path->str, "ab");
+	if (!fp) {
+		BT_LOGE("Cannot open column file: path=\"%s\", errno=%d",
+			column->path->str, errno);
+		ret = -1;
+		goto end;
+	}
+
+	if (fwrite(&header, sizeof(header), 1, fp) != 1) {
+		goto write_error;
+	}
+
+	if (column->data->len > 0 && fwrite(column->data->data,
+			column->data->len, 1, fp) != 1) {
+		goto write_error;
+	}
+
+	if (column->type == COLUMNAR_TYPE_STRING) {
+		if (fwrite(&last_offset, sizeof(last_offset), 1, fp) != 1) {
+			goto write_error;
+		}
+
+		if (column->blob->len > 0 && fwrite(column->blob->data,
+				column->blob->len, 1, fp) != 1) {
+			goto write_error;
+		}
+	}
+
+	if (padding > 0 && fwrite(zero_padding, padding, 1, fp) != 1) {
+		goto write_error;
+	}
+
+	if (fwrite(&footer, sizeof(footer), 1, fp) != 1) {
+		goto write_error;
+	}
+
+	goto close;
+
+write_error:
+	BT_LOGE("Cannot write column file: path=\"%s\", errno=%d",
+		column->path->str, errno);
+	ret = -1;
+
+close:
+	if (fclose(fp)) {
+		BT_LOGE("Cannot close column file: path=\"%s\", errno=%d",
+			column->path->str, errno);
+		ret = -1;
+	}
+
+end:
+	g_byte_array_set_size(column->data, 0);
+
+	if (column->blob) {
+		g_byte_array_set_size(column->blob, 0);
+	}
+
+	column->has_min_max = false;
+	return ret;
+}
+
+/* Writes the current chunk of all the columns of `ec`, if not empty */
+static
+int flush_event_class(struct columnar_event_class *ec)
+{
+	guint i;
+	int ret = 0;
+
+	if (ec->row_count == 0) {
+		goto end;
+	}
+
+	for (i = 0; i < ec->columns->len; i++) {
+		if (write_column_chunk(g_ptr_array_index(ec->columns, i),
+				ec->row_count)) {
+			ret = -1;
+		}
+	}
+
+	BT_LOGV("Wrote chunk: dir-path=\"%s\", row-count=%" PRIu64,
+		ec->dir_path->str, ec->row_count);
+	ec->row_count = 0;
+
+end:
+	return ret;
+}
+
+static
+int flush_all(struct columnar *columnar)
+{
+	GHashTableIter iter;
+	gpointer value;
+	int ret = 0;
+
+	g_hash_table_iter_init(&iter, columnar->event_classes);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		if (flush_event_class(value)) {
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+static
+int handle_event_notification(struct columnar *columnar,
+		struct bt_notification *notif)
+{
+	struct bt_event *event = bt_notification_event_get_event(notif);
+	struct bt_event_class *event_class = NULL;
+	struct bt_stream_class *stream_class = NULL;
+	struct columnar_event_class *ec;
+	struct columnar_column *ts_column;
+	struct bt_field_type *ft = NULL;
+	struct bt_field *field = NULL;
+	guint index = 1;
+	int ret = 0;
+
+	assert(event);
+	event_class = bt_event_get_class(event);
+	assert(event_class);
+	ec = columnar->last_event_class;
+
+	if (!ec || ec->event_class != event_class) {
+		ec = g_hash_table_lookup(columnar->event_classes, event_class);
+		if (!ec) {
+			ec = create_event_class(columnar, event_class);
+			if (!ec) {
+				ret = -1;
+				goto end;
+			}
+
+			g_hash_table_insert(columnar->event_classes,
+				event_class, ec);
+		}
+
+		columnar->last_event_class = ec;
+	}
+
+	ts_column = g_ptr_array_index(ec->columns, 0);
+	append_timestamp_value(ts_column, get_event_timestamp(notif, event,
+		ts_column->last));
+
+	stream_class = bt_event_class_get_stream_class(event_class);
+	assert(stream_class);
+	ft = bt_stream_class_get_event_context_type(stream_class);
+	field = bt_event_get_stream_event_context(event);
+	append_scope_values(ec, &index, ft, field);
+	BT_PUT(field);
+	BT_PUT(ft);
+	ft = bt_event_class_get_context_type(event_class);
+	field = bt_event_get_event_context(event);
+	append_scope_values(ec, &index, ft, field);
+	BT_PUT(field);
+	BT_PUT(ft);
+	ft = bt_event_class_get_payload_type(event_class);
+	field = bt_event_get_event_payload(event);
+	append_scope_values(ec, &index, ft, field);
+	assert(index == ec->columns->len);
+	ec->row_count++;
+
+	if (ec->row_count == columnar->chunk_size) {
+		ret = flush_event_class(ec);
+	}
+
+end:
+	bt_put(field);
+	bt_put(ft);
+	bt_put(stream_class);
+	bt_put(event_class);
+	bt_put(event);
+	return ret;
+}
+
+static
+void destroy_columnar_data(struct columnar *columnar)
+{
+	if (!columnar) {
+		return;
+	}
+
+	bt_put(columnar->notif_iter);
+
+	if (columnar->event_classes) {
+		g_hash_table_destroy(columnar->event_classes);
+	}
+
+	if (columnar->path) {
+		g_string_free(columnar->path, TRUE);
+	}
+
+	g_free(columnar);
+}
+
+void columnar_finalize(struct bt_private_component *component)
+{
+	struct columnar *columnar;
+
+	assert(component);
+	columnar = bt_private_component_get_user_data(component);
+	assert(columnar);
+
+	/* Write what's left if the graph did not end normally */
+	(void) flush_all(columnar);
+	destroy_columnar_data(columnar);
+}
+
+static
+enum bt_component_status apply_params(struct columnar *columnar,
+		struct bt_value *params)
+{
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_value *path = NULL;
+	struct bt_value *chunk_size = NULL;
+	const char *path_str;
+
+	path = bt_value_map_get(params, "path");
+	if (!bt_value_is_string(path)) {
+		BT_LOGE_STR("Missing or invalid `path` parameter: expecting a string.");
+		ret = BT_COMPONENT_STATUS_INVALID;
+		goto end;
+	}
+
+	(void) bt_value_string_get(path, &path_str);
+	g_string_assign(columnar->path, path_str);
+
+	chunk_size = bt_value_map_get(params, "chunk-size");
+	if (chunk_size) {
+		int64_t val;
+
+		if (!bt_value_is_integer(chunk_size)) {
+			BT_LOGE_STR("Invalid `chunk-size` parameter: expecting an integer.");
+			ret = BT_COMPONENT_STATUS_INVALID;
+			goto end;
+		}
+
+		(void) bt_value_integer_get(chunk_size, &val);
+		if (val <= 0) {
+			BT_LOGE("Invalid `chunk-size` parameter: expecting a positive integer: "
+				"value=%" PRId64, val);
+			ret = BT_COMPONENT_STATUS_INVALID;
+			goto end;
+		}
+
+		columnar->chunk_size = (uint64_t) val;
+	}
+
+	if (g_mkdir_with_parents(columnar->path->str, 0755)) {
+		BT_LOGE("Cannot create output directory: path=\"%s\", errno=%d",
+			columnar->path->str, errno);
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+end:
+	bt_put(chunk_size);
+	bt_put(path);
+	return ret;
+}
+
+enum bt_component_status columnar_init(struct bt_private_component *component,
+		struct bt_value *params, UNUSED_VAR void *init_method_data)
+{
+	enum bt_component_status ret;
+	struct columnar *columnar = g_new0(struct columnar, 1);
+
+	if (!columnar) {
+		ret = BT_COMPONENT_STATUS_NOMEM;
+		goto end;
+	}
+
+	columnar->chunk_size = DEFAULT_CHUNK_SIZE;
+	columnar->path = g_string_new(NULL);
+	columnar->event_classes = g_hash_table_new_full(g_direct_hash,
+		g_direct_equal, NULL, (GDestroyNotify) destroy_event_class);
+	if (!columnar->path || !columnar->event_classes) {
+		ret = BT_COMPONENT_STATUS_NOMEM;
+		goto error;
+	}
+
+	ret = apply_params(columnar, params);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto error;
+	}
+
+	ret = bt_private_component_sink_add_input_private_port(component,
+		"in", NULL, NULL);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto error;
+	}
+
+	ret = bt_private_component_set_user_data(component, columnar);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto error;
+	}
+
+	goto end;
+
+error:
+	destroy_columnar_data(columnar);
+
+end:
+	return ret;
+}
+
+void columnar_port_connected(
+		struct bt_private_component *component,
+		struct bt_private_port *self_port,
+		struct bt_port *other_port)
+{
+	struct columnar *columnar;
+	struct bt_notification_iterator *iterator;
+	struct bt_private_connection *connection;
+	enum bt_connection_status conn_status;
+	static const enum bt_notification_type notif_types[] = {
+		BT_NOTIFICATION_TYPE_EVENT,
+		BT_NOTIFICATION_TYPE_SENTINEL,
+	};
+
+	columnar = bt_private_component_get_user_data(component);
+	assert(columnar);
+	connection = bt_private_port_get_private_connection(self_port);
+	assert(connection);
+	conn_status = bt_private_connection_create_notification_iterator(
+		connection, notif_types, &iterator);
+	if (conn_status != BT_CONNECTION_STATUS_OK) {
+		columnar->error = true;
+		goto end;
+	}
+
+	BT_MOVE(columnar->notif_iter, iterator);
+
+end:
+	bt_put(connection);
+}
+
+enum bt_component_status columnar_consume(
+		struct bt_private_component *component)
+{
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_notification *notifs[NOTIF_BATCH_CAPACITY];
+	struct columnar *columnar;
+	enum bt_notification_iterator_status it_ret;
+	uint64_t notif_count = 0;
+	uint64_t i;
+
+	columnar = bt_private_component_get_user_data(component);
+	assert(columnar);
+
+	if (unlikely(columnar->error)) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+	if (unlikely(!columnar->notif_iter)) {
+		ret = BT_COMPONENT_STATUS_END;
+		goto end;
+	}
+
+	it_ret = bt_notification_iterator_next_batch(columnar->notif_iter,
+		notifs, NOTIF_BATCH_CAPACITY, &notif_count);
+	if (it_ret < 0) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+	switch (it_ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		ret = BT_COMPONENT_STATUS_AGAIN;
+		goto end;
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+		ret = flush_all(columnar) ? BT_COMPONENT_STATUS_ERROR :
+			BT_COMPONENT_STATUS_END;
+		BT_PUT(columnar->notif_iter);
+		goto end;
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		for (i = 0; i < notif_count; i++) {
+			assert(notifs[i]);
+
+			if (ret == BT_COMPONENT_STATUS_OK &&
+					bt_notification_get_type(notifs[i]) ==
+					BT_NOTIFICATION_TYPE_EVENT &&
+					handle_event_notification(columnar,
+						notifs[i])) {
+				ret = BT_COMPONENT_STATUS_ERROR;
+			}
+
+			bt_put(notifs[i]);
+		}
+		break;
+	default:
+		break;
+	}
+
+end:
+	return ret;
+}
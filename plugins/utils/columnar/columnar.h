@@ -0,0 +1,109 @@
+#ifndef BABELTRACE_PLUGINS_UTILS_COLUMNAR_H
+#define BABELTRACE_PLUGINS_UTILS_COLUMNAR_H
+
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <glib.h>
+#include <babeltrace/babeltrace.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "format.h"
+
+/* One column file of an event class */
+struct columnar_column {
+	/* Field path, for example `event.fields.prev_comm` */
+	GString *name;
+
+	/* Path of the column file */
+	GString *path;
+
+	enum columnar_type type;
+
+	/*
+	 * Values of the current chunk: fixed-width numbers, deltas, or
+	 * string offsets (without the last one).
+	 */
+	GByteArray *data;
+
+	/* String blob of the current chunk (string columns only) */
+	GByteArray *blob;
+
+	/* Statistics of the current chunk */
+	union columnar_value min;
+	union columnar_value max;
+	bool has_min_max;
+
+	/* COLUMNAR_TYPE_DELTA_S64 only: first and last values of the chunk */
+	int64_t base;
+	int64_t last;
+};
+
+/* Columns of an event class, and the state of its current chunk */
+struct columnar_event_class {
+	/* Owned by this */
+	struct bt_event_class *event_class;
+
+	/* Directory of the column files */
+	GString *dir_path;
+
+	/* Array of struct columnar_column *, owned by this */
+	GPtrArray *columns;
+
+	/* Number of rows of the current chunk */
+	uint64_t row_count;
+};
+
+struct columnar {
+	struct bt_notification_iterator *notif_iter;
+
+	/* Output directory */
+	GString *path;
+
+	/* Maximum number of rows of a chunk */
+	uint64_t chunk_size;
+
+	/*
+	 * struct bt_event_class * (weak) -> struct columnar_event_class *
+	 * (owned by this).
+	 */
+	GHashTable *event_classes;
+
+	/* Event class of the previous event, to skip the lookup */
+	struct columnar_event_class *last_event_class;
+
+	/* Index of the next event class directory */
+	uint64_t next_dir_index;
+	bool error;
+};
+
+enum bt_component_status columnar_init(struct bt_private_component *component,
+		struct bt_value *params, void *init_method_data);
+void columnar_finalize(struct bt_private_component *component);
+void columnar_port_connected(struct bt_private_component *component,
+		struct bt_private_port *self_port,
+		struct bt_port *other_port);
+enum bt_component_status columnar_consume(
+		struct bt_private_component *component);
+
+#endif /* BABELTRACE_PLUGINS_UTILS_COLUMNAR_H */
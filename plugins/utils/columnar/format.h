@@ -0,0 +1,127 @@
+#ifndef BABELTRACE_PLUGINS_UTILS_COLUMNAR_FORMAT_H
+#define BABELTRACE_PLUGINS_UTILS_COLUMNAR_FORMAT_H
+
+/*
+ * Babeltrace - Columnar sink on-disk format
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * This header only depends on <stdint.h> so that readers of column
+ * files can include it as is.
+ *
+ * A column file is a sequence of chunks. A chunk is:
+ *
+ * 1. A chunk header (struct columnar_chunk_header).
+ * 2. `data_size` bytes of data (see below), a multiple of 8.
+ * 3. A chunk footer (struct columnar_chunk_footer).
+ *
+ * All the multi-byte numbers of a chunk, including the ones of its
+ * header and footer, have the byte order `byte_order` of its header.
+ * All the column files of the same event class have the same number of
+ * chunks, and their chunk N all have the same value count: row I of
+ * chunk N in one column file is the same event as row I of chunk N in
+ * another.
+ *
+ * Chunk data, by column type:
+ *
+ * Fixed-width numbers (COLUMNAR_TYPE_U8 to COLUMNAR_TYPE_F64):
+ *     `count` values, then zero padding.
+ *
+ * COLUMNAR_TYPE_STRING:
+ *     `count + 1` uint64_t offsets, then the string blob, then zero
+ *     padding. Value I is the null-terminated string at offset
+ *     `offsets[I]` of the blob: its length is
+ *     `offsets[I + 1] - offsets[I] - 1`.
+ *
+ * COLUMNAR_TYPE_DELTA_S64:
+ *     `count` int64_t deltas, the first one being 0. Value I is `base`
+ *     plus the sum of the deltas 0 to I.
+ *
+ * Because the header and the data sizes are multiples of 8, the data of
+ * a memory-mapped column file is naturally aligned. With numpy, for
+ * example, the values of the first chunk of an unsigned 32-bit column
+ * are `numpy.frombuffer(buf, numpy.uint32, count, 32)`.
+ */
+
+#include <stdint.h>
+
+#define COLUMNAR_CHUNK_HEADER_MAGIC	UINT32_C(0x43435442)	/* "BTCC" (LE) */
+#define COLUMNAR_CHUNK_FOOTER_MAGIC	UINT32_C(0x46435442)	/* "BTCF" (LE) */
+#define COLUMNAR_FORMAT_VERSION		1
+
+enum columnar_type {
+	COLUMNAR_TYPE_U8 =		1,
+	COLUMNAR_TYPE_U16 =		2,
+	COLUMNAR_TYPE_U32 =		3,
+	COLUMNAR_TYPE_U64 =		4,
+	COLUMNAR_TYPE_S8 =		5,
+	COLUMNAR_TYPE_S16 =		6,
+	COLUMNAR_TYPE_S32 =		7,
+	COLUMNAR_TYPE_S64 =		8,
+	COLUMNAR_TYPE_F32 =		9,
+	COLUMNAR_TYPE_F64 =		10,
+	COLUMNAR_TYPE_STRING =		11,
+	COLUMNAR_TYPE_DELTA_S64 =	12,
+};
+
+enum columnar_byte_order {
+	COLUMNAR_BYTE_ORDER_LE =	0,
+	COLUMNAR_BYTE_ORDER_BE =	1,
+};
+
+/* 32 bytes */
+struct columnar_chunk_header {
+	uint32_t magic;		/* COLUMNAR_CHUNK_HEADER_MAGIC */
+	uint8_t version;	/* COLUMNAR_FORMAT_VERSION */
+	uint8_t type;		/* enum columnar_type */
+	uint8_t byte_order;	/* enum columnar_byte_order */
+	uint8_t reserved;
+	uint64_t count;		/* Number of values */
+	uint64_t data_size;	/* Size of the data (bytes), padding included */
+	int64_t base;		/* COLUMNAR_TYPE_DELTA_S64 only, 0 otherwise */
+};
+
+/*
+ * Minimum or maximum value of a chunk:
+ *
+ * * `u`: unsigned integer columns, and string columns (string lengths)
+ * * `s`: signed integer and COLUMNAR_TYPE_DELTA_S64 columns (values,
+ *   not deltas)
+ * * `f`: floating point number columns (not a number values ignored)
+ */
+union columnar_value {
+	uint64_t u;
+	int64_t s;
+	double f;
+};
+
+/* 32 bytes */
+struct columnar_chunk_footer {
+	union columnar_value min;
+	union columnar_value max;
+	uint64_t chunk_size;	/* Header, data, and footer size (bytes) */
+	uint32_t magic;		/* COLUMNAR_CHUNK_FOOTER_MAGIC */
+	uint32_t reserved;
+};
+
+#endif /* BABELTRACE_PLUGINS_UTILS_COLUMNAR_FORMAT_H */
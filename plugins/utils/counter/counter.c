@@ -30,6 +30,9 @@
 
 #include "counter.h"
 
+/* Maximum number of notifications to get from the input iterator at once */
+#define NOTIF_BATCH_CAPACITY	64
+
 #define PRINTF_COUNT(_what_sing, _what_plur, _var, args...)		\
 	do {								\
 		if (counter->count._var != 0 || !counter->hide_zero) {	\
@@ -213,13 +216,58 @@ end:
 	bt_put(connection);
 }
 
+static
+void count_notification(struct counter *counter,
+		struct bt_notification *notif)
+{
+	int64_t count;
+
+	switch (bt_notification_get_type(notif)) {
+	case BT_NOTIFICATION_TYPE_EVENT:
+		counter->count.event++;
+		break;
+	case BT_NOTIFICATION_TYPE_INACTIVITY:
+		counter->count.inactivity++;
+		break;
+	case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
+		counter->count.stream_begin++;
+		break;
+	case BT_NOTIFICATION_TYPE_STREAM_END:
+		counter->count.stream_end++;
+		break;
+	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+		counter->count.packet_begin++;
+		break;
+	case BT_NOTIFICATION_TYPE_PACKET_END:
+		counter->count.packet_end++;
+		break;
+	case BT_NOTIFICATION_TYPE_DISCARDED_EVENTS:
+		counter->count.discarded_events_notifs++;
+		count = bt_notification_discarded_events_get_count(notif);
+		if (count >= 0) {
+			counter->count.discarded_events += count;
+		}
+		break;
+	case BT_NOTIFICATION_TYPE_DISCARDED_PACKETS:
+		counter->count.discarded_packets_notifs++;
+		count = bt_notification_discarded_packets_get_count(notif);
+		if (count >= 0) {
+			counter->count.discarded_packets += count;
+		}
+		break;
+	default:
+		counter->count.other++;
+	}
+}
+
 enum bt_component_status counter_consume(struct bt_private_component *component)
 {
 	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
-	struct bt_notification *notif = NULL;
+	struct bt_notification *notifs[NOTIF_BATCH_CAPACITY];
 	struct counter *counter;
 	enum bt_notification_iterator_status it_ret;
-	int64_t count;
+	uint64_t notif_count = 0;
+	uint64_t i;
 
 	counter = bt_private_component_get_user_data(component);
 	assert(counter);
@@ -235,8 +283,9 @@ enum bt_component_status counter_consume(struct bt_private_component *component)
 		goto end;
 	}
 
-	/* Consume one notification  */
-	it_ret = bt_notification_iterator_next(counter->notif_iter);
+	/* Consume a batch of notifications */
+	it_ret = bt_notification_iterator_next_batch(counter->notif_iter,
+		notifs, NOTIF_BATCH_CAPACITY, &notif_count);
 	if (it_ret < 0) {
 		ret = BT_COMPONENT_STATUS_ERROR;
 		goto end;
@@ -251,59 +300,17 @@ enum bt_component_status counter_consume(struct bt_private_component *component)
 		ret = BT_COMPONENT_STATUS_END;
 		goto end;
 	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
-	{
-		struct bt_notification *notif =
-			bt_notification_iterator_get_notification(counter->notif_iter);
-
-		assert(notif);
-		switch (bt_notification_get_type(notif)) {
-		case BT_NOTIFICATION_TYPE_EVENT:
-			counter->count.event++;
-			break;
-		case BT_NOTIFICATION_TYPE_INACTIVITY:
-			counter->count.inactivity++;
-			break;
-		case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
-			counter->count.stream_begin++;
-			break;
-		case BT_NOTIFICATION_TYPE_STREAM_END:
-			counter->count.stream_end++;
-			break;
-		case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
-			counter->count.packet_begin++;
-			break;
-		case BT_NOTIFICATION_TYPE_PACKET_END:
-			counter->count.packet_end++;
-			break;
-		case BT_NOTIFICATION_TYPE_DISCARDED_EVENTS:
-			counter->count.discarded_events_notifs++;
-			count = bt_notification_discarded_events_get_count(
-				notif);
-			if (count >= 0) {
-				counter->count.discarded_events += count;
-			}
-			break;
-		case BT_NOTIFICATION_TYPE_DISCARDED_PACKETS:
-			counter->count.discarded_packets_notifs++;
-			count = bt_notification_discarded_packets_get_count(
-				notif);
-			if (count >= 0) {
-				counter->count.discarded_packets += count;
-			}
-			break;
-		default:
-			counter->count.other++;
+		for (i = 0; i < notif_count; i++) {
+			assert(notifs[i]);
+			count_notification(counter, notifs[i]);
+			bt_put(notifs[i]);
+			try_print_count(counter);
 		}
-
-		bt_put(notif);
-	}
+		break;
 	default:
 		break;
 	}
 
-	try_print_count(counter);
-
 end:
-	bt_put(notif);
 	return ret;
 }
@@ -30,6 +30,11 @@
 #include <babeltrace/graph/component-internal.h>
 #include <babeltrace/graph/notification-iterator-internal.h>
 #include <babeltrace/graph/connection-internal.h>
+#include <babeltrace/graph/clock-class-priority-map-internal.h>
+#include <babeltrace/graph/notification-event-internal.h>
+#include <babeltrace/graph/notification-inactivity-internal.h>
+#include <babeltrace/ctf-ir/event-internal.h>
+#include <babeltrace/prio-heap-internal.h>
 #include <plugins-common.h>
 #include <glib.h>
 #include <stdbool.h>
@@ -40,6 +45,9 @@
 
 #define ASSUME_ABSOLUTE_CLOCK_CLASSES_PARAM_NAME	"assume-absolute-clock-classes"
 
+/* Maximum number of notifications to get from an upstream iterator at once */
+#define UPSTREAM_NOTIF_BATCH_CAPACITY	64
+
 struct muxer_comp {
 	/*
 	 * Array of struct
@@ -73,6 +81,39 @@ struct muxer_upstream_notif_iter {
 	 * is NULL (which means the upstream iterator is finished).
 	 */
 	bool is_valid;
+
+	/*
+	 * Notifications received from the upstream notification
+	 * iterator in one batch (owned by this). notifs[notif_index] is
+	 * the current notification when is_valid is true.
+	 */
+	struct bt_notification *notifs[UPSTREAM_NOTIF_BATCH_CAPACITY];
+	uint64_t notif_count;
+	uint64_t notif_index;
+
+	/*
+	 * Timestamp of the current notification (ns from Epoch), only
+	 * valid when is_valid is true.
+	 */
+	int64_t ts_ns;
+
+	/*
+	 * Insertion number of this wrapper in the muxer notification
+	 * iterator's heap, used to order wrappers of which the current
+	 * notifications have the same timestamp.
+	 */
+	uint64_t heap_insert_num;
+
+	/*
+	 * Clock class priority map of the last timestamped notification
+	 * of this upstream iterator, and its highest priority clock
+	 * class, which is already checked against the muxer
+	 * notification iterator's clock class expectation (NULL if the
+	 * map is empty). Consecutive notifications of an upstream
+	 * iterator usually share the same map. Both are owned by this.
+	 */
+	struct bt_clock_class_priority_map *cached_cc_prio_map;
+	struct bt_clock_class *cached_clock_class;
 };
 
 enum muxer_notif_iter_clock_class_expectation {
@@ -85,14 +126,28 @@ enum muxer_notif_iter_clock_class_expectation {
 struct muxer_notif_iter {
 	/*
 	 * Array of struct muxer_upstream_notif_iter * (owned by this).
-	 *
-	 * NOTE: This array is searched in linearly to find the youngest
-	 * current notification. Keep this until benchmarks confirm that
-	 * another data structure is faster than this for our typical
-	 * use cases.
 	 */
 	GPtrArray *muxer_upstream_notif_iters;
 
+	/*
+	 * Min-heap of the valid upstream notification iterator wrappers
+	 * (struct muxer_upstream_notif_iter *, weak), keyed by the
+	 * timestamp of their current notification: its top is the
+	 * wrapper of which the current notification is the youngest.
+	 */
+	struct ptr_heap heap;
+
+	/* Number of insertions in the heap above so far */
+	uint64_t heap_insert_count;
+
+	/*
+	 * Array of the non-ended upstream notification iterator wrappers
+	 * which are not valid (struct muxer_upstream_notif_iter *, weak),
+	 * in the order in which they need to be validated. Those
+	 * wrappers are not part of the heap above.
+	 */
+	GPtrArray *invalid_muxer_upstream_notif_iters;
+
 	/*
 	 * List of "recently" connected input ports (weak) to
 	 * handle by this muxer notification iterator.
@@ -110,6 +165,21 @@ struct muxer_notif_iter {
 	/* Last time returned in a notification */
 	int64_t last_returned_ts_ns;
 
+	/*
+	 * Status to return on the next call of the "next batch" method
+	 * (BT_NOTIFICATION_ITERATOR_STATUS_OK when there's none): a
+	 * status which muxer_notif_iter_do_next() returned after some
+	 * notifications were added to the current batch.
+	 */
+	enum bt_notification_iterator_status pending_status;
+
+	/*
+	 * True if at least one upstream notification iterator ended:
+	 * its notifications cannot be delivered again, so that this
+	 * iterator cannot seek anymore.
+	 */
+	bool upstream_ended;
+
 	/* Clock class expectation state */
 	enum muxer_notif_iter_clock_class_expectation clock_class_expectation;
 
@@ -121,6 +191,69 @@ struct muxer_notif_iter {
 	unsigned char expected_clock_class_uuid[BABELTRACE_UUID_LEN];
 };
 
+static inline
+struct bt_notification *muxer_upstream_notif_iter_borrow_notif(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	assert(muxer_upstream_notif_iter->notif_index <
+		muxer_upstream_notif_iter->notif_count);
+	return muxer_upstream_notif_iter->notifs[
+		muxer_upstream_notif_iter->notif_index];
+}
+
+static
+void muxer_upstream_notif_iter_put_notifs(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	uint64_t i;
+
+	for (i = muxer_upstream_notif_iter->notif_index;
+			i < muxer_upstream_notif_iter->notif_count; i++) {
+		BT_PUT(muxer_upstream_notif_iter->notifs[i]);
+	}
+
+	muxer_upstream_notif_iter->notif_count = 0;
+	muxer_upstream_notif_iter->notif_index = 0;
+}
+
+/*
+ * Drops the buffered notifications after a successful seek of the
+ * upstream iterator, except the stream and packet beginning/end
+ * notifications: the upstream iterator's stream states already reflect
+ * them, so they are not delivered again. The first kept notification,
+ * if any, becomes the current one.
+ */
+static
+void muxer_upstream_notif_iter_discard_obsolete_notifs(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
+{
+	uint64_t count = 0;
+	uint64_t i;
+
+	for (i = muxer_upstream_notif_iter->notif_index;
+			i < muxer_upstream_notif_iter->notif_count; i++) {
+		struct bt_notification *notif =
+			muxer_upstream_notif_iter->notifs[i];
+
+		switch (bt_notification_get_type(notif)) {
+		case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
+		case BT_NOTIFICATION_TYPE_STREAM_END:
+		case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+		case BT_NOTIFICATION_TYPE_PACKET_END:
+			muxer_upstream_notif_iter->notifs[i] = NULL;
+			muxer_upstream_notif_iter->notifs[count++] = notif;
+			break;
+		default:
+			BT_PUT(muxer_upstream_notif_iter->notifs[i]);
+			break;
+		}
+	}
+
+	muxer_upstream_notif_iter->notif_count = count;
+	muxer_upstream_notif_iter->notif_index = 0;
+	muxer_upstream_notif_iter->is_valid = count > 0;
+}
+
 static
 void destroy_muxer_upstream_notif_iter(
 		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter)
@@ -134,7 +267,10 @@ void destroy_muxer_upstream_notif_iter(
 		muxer_upstream_notif_iter,
 		muxer_upstream_notif_iter->notif_iter,
 		muxer_upstream_notif_iter->is_valid);
+	muxer_upstream_notif_iter_put_notifs(muxer_upstream_notif_iter);
 	bt_put(muxer_upstream_notif_iter->notif_iter);
+	bt_put(muxer_upstream_notif_iter->cached_cc_prio_map);
+	bt_put(muxer_upstream_notif_iter->cached_clock_class);
 	g_free(muxer_upstream_notif_iter);
 }
 
@@ -156,6 +292,8 @@ struct muxer_upstream_notif_iter *muxer_notif_iter_add_upstream_notif_iter(
 	muxer_upstream_notif_iter->is_valid = false;
 	g_ptr_array_add(muxer_notif_iter->muxer_upstream_notif_iters,
 		muxer_upstream_notif_iter);
+	g_ptr_array_add(muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+		muxer_upstream_notif_iter);
 	BT_LOGD("Added muxer's upstream notification iterator wrapper: "
 		"addr=%p, muxer-notif-iter-addr=%p, notif-iter-addr=%p",
 		muxer_upstream_notif_iter, muxer_notif_iter,
@@ -450,14 +588,37 @@ enum bt_notification_iterator_status muxer_upstream_notif_iter_next(
 {
 	enum bt_notification_iterator_status status;
 
-	BT_LOGV("Calling upstream notification iterator's \"next\" method: "
+	if (muxer_upstream_notif_iter->notif_index <
+			muxer_upstream_notif_iter->notif_count) {
+		/* Release the current (consumed) notification */
+		BT_PUT(muxer_upstream_notif_iter->notifs[
+			muxer_upstream_notif_iter->notif_index]);
+		muxer_upstream_notif_iter->notif_index++;
+	}
+
+	if (muxer_upstream_notif_iter->notif_index <
+			muxer_upstream_notif_iter->notif_count) {
+		/* Next notification of the current batch */
+		muxer_upstream_notif_iter->is_valid = true;
+		status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		goto end;
+	}
+
+	muxer_upstream_notif_iter->notif_count = 0;
+	muxer_upstream_notif_iter->notif_index = 0;
+	BT_LOGV("Calling upstream notification iterator's \"next batch\" method: "
 		"muxer-upstream-notif-iter-wrap-addr=%p, notif-iter-addr=%p",
 		muxer_upstream_notif_iter,
 		muxer_upstream_notif_iter->notif_iter);
-	status = bt_notification_iterator_next(
-		muxer_upstream_notif_iter->notif_iter);
-	BT_LOGV("Upstream notification iterator's \"next\" method returned: "
-		"status=%s", bt_notification_iterator_status_string(status));
+	status = bt_notification_iterator_next_batch(
+		muxer_upstream_notif_iter->notif_iter,
+		muxer_upstream_notif_iter->notifs,
+		UPSTREAM_NOTIF_BATCH_CAPACITY,
+		&muxer_upstream_notif_iter->notif_count);
+	BT_LOGV("Upstream notification iterator's \"next batch\" method returned: "
+		"status=%s, count=%" PRIu64,
+		bt_notification_iterator_status_string(status),
+		muxer_upstream_notif_iter->notif_count);
 
 	switch (status) {
 	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
@@ -498,6 +659,7 @@ enum bt_notification_iterator_status muxer_upstream_notif_iter_next(
 		break;
 	}
 
+end:
 	return status;
 }
 
@@ -585,16 +747,29 @@ end:
 	return ret;
 }
 
+static
+void muxer_upstream_notif_iter_set_cached_clock_class(
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter,
+		struct bt_clock_class_priority_map *cc_prio_map,
+		struct bt_clock_class *clock_class)
+{
+	BT_PUT(muxer_upstream_notif_iter->cached_cc_prio_map);
+	BT_PUT(muxer_upstream_notif_iter->cached_clock_class);
+	muxer_upstream_notif_iter->cached_cc_prio_map = bt_get(cc_prio_map);
+	muxer_upstream_notif_iter->cached_clock_class = bt_get(clock_class);
+}
+
 static
 int get_notif_ts_ns(struct muxer_comp *muxer_comp,
 		struct muxer_notif_iter *muxer_notif_iter,
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter,
 		struct bt_notification *notif, int64_t last_returned_ts_ns,
 		int64_t *ts_ns)
 {
+	/* All borrowed references */
 	struct bt_clock_class_priority_map *cc_prio_map = NULL;
 	struct bt_clock_class *clock_class = NULL;
 	struct bt_clock_value *clock_value = NULL;
-	struct bt_event *event = NULL;
 	int ret = 0;
 	const unsigned char *cc_uuid;
 	const char *cc_name;
@@ -610,13 +785,13 @@ int get_notif_ts_ns(struct muxer_comp *muxer_comp,
 	switch (bt_notification_get_type(notif)) {
 	case BT_NOTIFICATION_TYPE_EVENT:
 		cc_prio_map =
-			bt_notification_event_get_clock_class_priority_map(
+			bt_notification_event_borrow_clock_class_priority_map(
 				notif);
 		break;
 
 	case BT_NOTIFICATION_TYPE_INACTIVITY:
 		cc_prio_map =
-			bt_notification_inactivity_get_clock_class_priority_map(
+			bt_notification_inactivity_borrow_clock_class_priority_map(
 				notif);
 		break;
 	default:
@@ -632,6 +807,24 @@ int get_notif_ts_ns(struct muxer_comp *muxer_comp,
 		goto error;
 	}
 
+	if (cc_prio_map == muxer_upstream_notif_iter->cached_cc_prio_map) {
+		/*
+		 * Same clock class priority map as the previous
+		 * notification of this upstream iterator: its clock
+		 * class is already checked.
+		 */
+		clock_class = muxer_upstream_notif_iter->cached_clock_class;
+		if (!clock_class) {
+			BT_LOGV_STR("Notification's clock class priority map contains 0 clock classes: "
+				"using the last returned timestamp.");
+			*ts_ns = last_returned_ts_ns;
+			goto end;
+		}
+
+		cc_name = bt_clock_class_get_name(clock_class);
+		goto get_clock_value;
+	}
+
 	/*
 	 * If the clock class priority map is empty, then we consider
 	 * that this notification has no time. In this case it's always
@@ -640,12 +833,14 @@ int get_notif_ts_ns(struct muxer_comp *muxer_comp,
 	if (bt_clock_class_priority_map_get_clock_class_count(cc_prio_map) == 0) {
 		BT_LOGV_STR("Notification's clock class priority map contains 0 clock classes: "
 			"using the last returned timestamp.");
+		muxer_upstream_notif_iter_set_cached_clock_class(
+			muxer_upstream_notif_iter, cc_prio_map, NULL);
 		*ts_ns = last_returned_ts_ns;
 		goto end;
 	}
 
 	clock_class =
-		bt_clock_class_priority_map_get_highest_priority_clock_class(
+		bt_clock_class_priority_map_borrow_highest_priority_clock_class(
 			cc_prio_map);
 	if (!clock_class) {
 		BT_LOGE("Cannot get the clock class with the highest priority from clock class priority map: "
@@ -804,15 +999,18 @@ int get_notif_ts_ns(struct muxer_comp *muxer_comp,
 		}
 	}
 
+	muxer_upstream_notif_iter_set_cached_clock_class(
+		muxer_upstream_notif_iter, cc_prio_map, clock_class);
+
+get_clock_value:
 	switch (bt_notification_get_type(notif)) {
 	case BT_NOTIFICATION_TYPE_EVENT:
-		event = bt_notification_event_get_event(notif);
-		assert(event);
-		clock_value = bt_event_get_clock_value(event,
+		clock_value = bt_event_borrow_clock_value(
+			bt_notification_event_borrow_event(notif),
 			clock_class);
 		break;
 	case BT_NOTIFICATION_TYPE_INACTIVITY:
-		clock_value = bt_notification_inactivity_get_clock_value(
+		clock_value = bt_notification_inactivity_borrow_clock_value(
 			notif, clock_class);
 		break;
 	default:
@@ -849,13 +1047,35 @@ end:
 			*ts_ns);
 	}
 
-	bt_put(cc_prio_map);
-	bt_put(event);
-	bt_put(clock_class);
-	bt_put(clock_value);
 	return ret;
 }
 
+/*
+ * Heap comparison function: returns true if the current notification of
+ * the upstream notification iterator wrapper `a` must be returned
+ * before the one of `b`.
+ *
+ * When both notifications have the same timestamp, the wrapper which
+ * was inserted last wins: this is how a "stream begin" notification
+ * is immediately followed by its "packet begin" notification, both
+ * having no timestamp.
+ */
+static
+int muxer_upstream_notif_iter_is_younger(void *a, void *b)
+{
+	struct muxer_upstream_notif_iter *muxer_upstream_notif_iter_a = a;
+	struct muxer_upstream_notif_iter *muxer_upstream_notif_iter_b = b;
+
+	if (muxer_upstream_notif_iter_a->ts_ns !=
+			muxer_upstream_notif_iter_b->ts_ns) {
+		return muxer_upstream_notif_iter_a->ts_ns <
+			muxer_upstream_notif_iter_b->ts_ns;
+	}
+
+	return muxer_upstream_notif_iter_a->heap_insert_num >
+		muxer_upstream_notif_iter_b->heap_insert_num;
+}
+
 /*
  * This function finds the youngest available notification amongst the
  * non-ended upstream notification iterators and returns the upstream
@@ -869,6 +1089,9 @@ end:
  * * Check for newly connected ports.
  * * Check the upstream notification iterators to retry.
  *
+ * All the non-ended upstream notification iterators must be valid,
+ * that is, in the heap, when calling this function.
+ *
  * On sucess, this function sets *muxer_upstream_notif_iter to the
  * upstream notification iterator of which the current notification is
  * the youngest, and sets *ts_ns to its time.
@@ -881,58 +1104,24 @@ muxer_notif_iter_youngest_upstream_notif_iter(
 		struct muxer_upstream_notif_iter **muxer_upstream_notif_iter,
 		int64_t *ts_ns)
 {
-	size_t i;
-	int ret;
-	int64_t youngest_ts_ns = INT64_MAX;
 	enum bt_notification_iterator_status status =
 		BT_NOTIFICATION_ITERATOR_STATUS_OK;
 
 	assert(muxer_comp);
 	assert(muxer_notif_iter);
 	assert(muxer_upstream_notif_iter);
-	*muxer_upstream_notif_iter = NULL;
-
-	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
-		struct bt_notification *notif;
-		struct muxer_upstream_notif_iter *cur_muxer_upstream_notif_iter =
-			g_ptr_array_index(muxer_notif_iter->muxer_upstream_notif_iters, i);
-		int64_t notif_ts_ns;
-
-		if (!cur_muxer_upstream_notif_iter->notif_iter) {
-			/* This upstream notification iterator is ended */
-			BT_LOGV("Skipping ended upstream notification iterator: "
-				"muxer-upstream-notif-iter-wrap-addr=%p",
-				cur_muxer_upstream_notif_iter);
-			continue;
-		}
-
-		assert(cur_muxer_upstream_notif_iter->is_valid);
-		notif = bt_notification_iterator_get_notification(
-			cur_muxer_upstream_notif_iter->notif_iter);
-		assert(notif);
-		ret = get_notif_ts_ns(muxer_comp, muxer_notif_iter, notif,
-			muxer_notif_iter->last_returned_ts_ns, &notif_ts_ns);
-		bt_put(notif);
-		if (ret) {
-			/* get_notif_ts_ns() logs errors */
-			*muxer_upstream_notif_iter = NULL;
-			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
-			goto end;
-		}
-
-		if (notif_ts_ns <= youngest_ts_ns) {
-			*muxer_upstream_notif_iter =
-				cur_muxer_upstream_notif_iter;
-			youngest_ts_ns = notif_ts_ns;
-			*ts_ns = youngest_ts_ns;
-		}
-	}
+	assert(muxer_notif_iter->invalid_muxer_upstream_notif_iters->len == 0);
+	*muxer_upstream_notif_iter = bt_heap_maximum(&muxer_notif_iter->heap);
 
 	if (!*muxer_upstream_notif_iter) {
 		status = BT_NOTIFICATION_ITERATOR_STATUS_END;
 		*ts_ns = INT64_MIN;
+		goto end;
 	}
 
+	assert((*muxer_upstream_notif_iter)->is_valid);
+	*ts_ns = (*muxer_upstream_notif_iter)->ts_ns;
+
 end:
 	return status;
 }
@@ -960,22 +1149,30 @@ end:
 	return status;
 }
 
+/*
+ * Validates the invalid upstream notification iterator wrappers, in
+ * order, and inserts them into the heap with the timestamp of their
+ * new current notification. Removes the ended ones.
+ */
 static
 enum bt_notification_iterator_status validate_muxer_upstream_notif_iters(
+	struct muxer_comp *muxer_comp,
 	struct muxer_notif_iter *muxer_notif_iter)
 {
 	enum bt_notification_iterator_status status =
 		BT_NOTIFICATION_ITERATOR_STATUS_OK;
-	size_t i;
+	GPtrArray *invalid_muxer_upstream_notif_iters =
+		muxer_notif_iter->invalid_muxer_upstream_notif_iters;
 
 	BT_LOGV("Validating muxer's upstream notification iterator wrappers: "
-		"muxer-notif-iter-addr=%p", muxer_notif_iter);
+		"muxer-notif-iter-addr=%p, count=%u", muxer_notif_iter,
+		invalid_muxer_upstream_notif_iters->len);
 
-	for (i = 0; i < muxer_notif_iter->muxer_upstream_notif_iters->len; i++) {
+	while (invalid_muxer_upstream_notif_iters->len > 0) {
 		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
-			g_ptr_array_index(
-				muxer_notif_iter->muxer_upstream_notif_iters,
-				i);
+			g_ptr_array_index(invalid_muxer_upstream_notif_iters,
+				0);
+		int ret;
 
 		status = validate_muxer_upstream_notif_iter(
 			muxer_upstream_notif_iter);
@@ -1002,6 +1199,9 @@ enum bt_notification_iterator_status validate_muxer_upstream_notif_iters(
 		 * if it's ended or canceled.
 		 */
 		if (!muxer_upstream_notif_iter->notif_iter) {
+			g_ptr_array_remove_index(
+				invalid_muxer_upstream_notif_iters, 0);
+
 			/*
 			 * Use g_ptr_array_remove_fast() because the
 			 * order of those elements is not important.
@@ -1010,11 +1210,45 @@ enum bt_notification_iterator_status validate_muxer_upstream_notif_iters(
 				"muxer-notif-iter-addr=%p, "
 				"muxer-upstream-notif-iter-wrap-addr=%p",
 				muxer_notif_iter, muxer_upstream_notif_iter);
-			g_ptr_array_remove_index_fast(
+			g_ptr_array_remove_fast(
 				muxer_notif_iter->muxer_upstream_notif_iters,
-				i);
-			i--;
+				muxer_upstream_notif_iter);
+			muxer_notif_iter->upstream_ended = true;
+			continue;
+		}
+
+		assert(muxer_upstream_notif_iter->is_valid);
+
+		/*
+		 * Compute the timestamp of the new current notification
+		 * once: the heap is keyed by this value.
+		 */
+		ret = get_notif_ts_ns(muxer_comp, muxer_notif_iter,
+			muxer_upstream_notif_iter,
+			muxer_upstream_notif_iter_borrow_notif(
+				muxer_upstream_notif_iter),
+			muxer_notif_iter->last_returned_ts_ns,
+			&muxer_upstream_notif_iter->ts_ns);
+		if (ret) {
+			/* get_notif_ts_ns() logs errors */
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
 		}
+
+		muxer_upstream_notif_iter->heap_insert_num =
+			muxer_notif_iter->heap_insert_count++;
+		ret = bt_heap_insert(&muxer_notif_iter->heap,
+			muxer_upstream_notif_iter);
+		if (ret) {
+			BT_LOGE("Cannot insert muxer's upstream notification iterator wrapper into heap: "
+				"muxer-notif-iter-addr=%p, "
+				"muxer-upstream-notif-iter-wrap-addr=%p",
+				muxer_notif_iter, muxer_upstream_notif_iter);
+			status = BT_NOTIFICATION_ITERATOR_STATUS_NOMEM;
+			goto end;
+		}
+
+		g_ptr_array_remove_index(invalid_muxer_upstream_notif_iters, 0);
 	}
 
 end:
@@ -1048,7 +1282,8 @@ struct bt_notification_iterator_next_method_return muxer_notif_iter_do_next(
 		}
 
 		next_return.status =
-			validate_muxer_upstream_notif_iters(muxer_notif_iter);
+			validate_muxer_upstream_notif_iters(muxer_comp,
+				muxer_notif_iter);
 		if (next_return.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
 			/* validate_muxer_upstream_notif_iters() logs details */
 			goto end;
@@ -1114,16 +1349,21 @@ struct bt_notification_iterator_next_method_return muxer_notif_iter_do_next(
 		muxer_notif_iter, muxer_upstream_notif_iter, next_return_ts);
 	assert(next_return.status == BT_NOTIFICATION_ITERATOR_STATUS_OK);
 	assert(muxer_upstream_notif_iter);
-	next_return.notification = bt_notification_iterator_get_notification(
-		muxer_upstream_notif_iter->notif_iter);
+	next_return.notification = bt_get(
+		muxer_upstream_notif_iter_borrow_notif(
+			muxer_upstream_notif_iter));
 	assert(next_return.notification);
 
 	/*
 	 * We invalidate the upstream notification iterator so that, the
 	 * next time this function is called,
-	 * validate_muxer_upstream_notif_iters() will make it valid.
+	 * validate_muxer_upstream_notif_iters() will make it valid and
+	 * put it back into the heap.
 	 */
+	bt_heap_remove(&muxer_notif_iter->heap);
 	muxer_upstream_notif_iter->is_valid = false;
+	g_ptr_array_add(muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+		muxer_upstream_notif_iter);
 	muxer_notif_iter->last_returned_ts_ns = next_return_ts;
 
 end:
@@ -1140,6 +1380,14 @@ void destroy_muxer_notif_iter(struct muxer_notif_iter *muxer_notif_iter)
 	BT_LOGD("Destroying muxer component's notification iterator: "
 		"muxer-notif-iter-addr=%p", muxer_notif_iter);
 
+	if (muxer_notif_iter->invalid_muxer_upstream_notif_iters) {
+		g_ptr_array_free(
+			muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+			TRUE);
+	}
+
+	bt_heap_free(&muxer_notif_iter->heap);
+
 	if (muxer_notif_iter->muxer_upstream_notif_iters) {
 		BT_LOGD_STR("Destroying muxer's upstream notification iterator wrappers.");
 		g_ptr_array_free(
@@ -1268,6 +1516,19 @@ enum bt_notification_iterator_status muxer_notif_iter_init(
 		goto error;
 	}
 
+	muxer_notif_iter->invalid_muxer_upstream_notif_iters =
+		g_ptr_array_new();
+	if (!muxer_notif_iter->invalid_muxer_upstream_notif_iters) {
+		BT_LOGE_STR("Failed to allocate a GPtrArray.");
+		goto error;
+	}
+
+	if (bt_heap_init(&muxer_notif_iter->heap, 0,
+			muxer_upstream_notif_iter_is_younger)) {
+		BT_LOGE_STR("Failed to initialize a heap.");
+		goto error;
+	}
+
 	/*
 	 * Add the muxer notification iterator to the component's array
 	 * of muxer notification iterators here because
@@ -1395,6 +1656,267 @@ end:
 	return next_ret;
 }
 
+BT_HIDDEN
+enum bt_notification_iterator_status muxer_notif_iter_next_batch(
+		struct bt_private_connection_private_notification_iterator *priv_notif_iter,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	struct muxer_notif_iter *muxer_notif_iter =
+		bt_private_connection_private_notification_iterator_get_user_data(priv_notif_iter);
+	struct bt_private_component *priv_comp = NULL;
+	struct muxer_comp *muxer_comp = NULL;
+	uint64_t i = 0;
+
+	assert(muxer_notif_iter);
+	priv_comp = bt_private_connection_private_notification_iterator_get_private_component(
+		priv_notif_iter);
+	assert(priv_comp);
+	muxer_comp = bt_private_component_get_user_data(priv_comp);
+	assert(muxer_comp);
+
+	BT_LOGV("Muxer component's notification iterator's \"next batch\" method called: "
+		"comp-addr=%p, muxer-comp-addr=%p, muxer-notif-iter-addr=%p, "
+		"notif-iter-addr=%p, capacity=%" PRIu64,
+		priv_comp, muxer_comp, muxer_notif_iter, priv_notif_iter,
+		capacity);
+
+	/* Are we in an error state set elsewhere? */
+	if (unlikely(muxer_comp->error)) {
+		BT_LOGE("Muxer component is already in an error state: returning BT_NOTIFICATION_ITERATOR_STATUS_ERROR: "
+			"comp-addr=%p, muxer-comp-addr=%p, muxer-notif-iter-addr=%p, "
+			"notif-iter-addr=%p",
+			priv_comp, muxer_comp, muxer_notif_iter, priv_notif_iter);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		goto end;
+	}
+
+	if (muxer_notif_iter->pending_status !=
+			BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		status = muxer_notif_iter->pending_status;
+		muxer_notif_iter->pending_status =
+			BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		BT_LOGV("Returning pending status: status=%s",
+			bt_notification_iterator_status_string(status));
+		goto end;
+	}
+
+	while (i < capacity) {
+		struct bt_notification_iterator_next_method_return next_ret =
+			muxer_notif_iter_do_next(muxer_comp, muxer_notif_iter);
+
+		if (next_ret.status < 0) {
+			BT_LOGE("Cannot get next notification: "
+				"comp-addr=%p, muxer-comp-addr=%p, muxer-notif-iter-addr=%p, "
+				"notif-iter-addr=%p, status=%s",
+				priv_comp, muxer_comp, muxer_notif_iter,
+				priv_notif_iter,
+				bt_notification_iterator_status_string(next_ret.status));
+			status = next_ret.status;
+
+			while (i > 0) {
+				i--;
+				BT_PUT(notifications[i]);
+			}
+
+			goto end;
+		}
+
+		if (next_ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			/*
+			 * Return what we have first, if anything, and
+			 * report this status on the next call: calling
+			 * muxer_notif_iter_do_next() again would not
+			 * necessarily return it again (for example, an
+			 * upstream iterator which returned
+			 * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN can
+			 * have a notification the next time).
+			 */
+			if (i == 0) {
+				status = next_ret.status;
+			} else {
+				muxer_notif_iter->pending_status =
+					next_ret.status;
+			}
+
+			break;
+		}
+
+		notifications[i] = next_ret.notification;
+		i++;
+	}
+
+	BT_LOGV("Returning from muxer component's notification iterator's \"next batch\" method: "
+		"status=%s, count=%" PRIu64,
+		bt_notification_iterator_status_string(status), i);
+
+end:
+	*count = i;
+	bt_put(priv_comp);
+	return status;
+}
+
+/*
+ * Forwards the "seek time" request to all the upstream notification
+ * iterators. The notifications which a sought upstream iterator
+ * already delivered are discarded. An upstream iterator which does not
+ * support seeking keeps its current notifications: seeking is only a
+ * hint, so its notifications are still multiplexed by time.
+ */
+BT_HIDDEN
+enum bt_notification_iterator_status muxer_notif_iter_seek_time(
+		struct bt_private_connection_private_notification_iterator *priv_notif_iter,
+		int64_t ns_from_epoch)
+{
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED;
+	struct muxer_notif_iter *muxer_notif_iter =
+		bt_private_connection_private_notification_iterator_get_user_data(priv_notif_iter);
+	struct bt_private_component *priv_comp = NULL;
+	struct muxer_comp *muxer_comp = NULL;
+	GPtrArray *muxer_upstream_notif_iters;
+	size_t i;
+	int ret;
+
+	assert(muxer_notif_iter);
+	priv_comp = bt_private_connection_private_notification_iterator_get_private_component(
+		priv_notif_iter);
+	assert(priv_comp);
+	muxer_comp = bt_private_component_get_user_data(priv_comp);
+	assert(muxer_comp);
+	BT_LOGD("Muxer component's notification iterator's \"seek time\" method called: "
+		"comp-addr=%p, muxer-comp-addr=%p, muxer-notif-iter-addr=%p, "
+		"notif-iter-addr=%p, ns-from-epoch=%" PRId64,
+		priv_comp, muxer_comp, muxer_notif_iter, priv_notif_iter,
+		ns_from_epoch);
+
+	if (unlikely(muxer_comp->error)) {
+		BT_LOGE("Muxer component is already in an error state: returning BT_NOTIFICATION_ITERATOR_STATUS_ERROR: "
+			"comp-addr=%p, muxer-comp-addr=%p, muxer-notif-iter-addr=%p, "
+			"notif-iter-addr=%p",
+			priv_comp, muxer_comp, muxer_notif_iter, priv_notif_iter);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		goto end;
+	}
+
+	/* Seek the upstream iterators of the newly connected ports too */
+	ret = muxer_notif_iter_handle_newly_connected_ports(muxer_notif_iter);
+	if (ret) {
+		BT_LOGE("Cannot handle newly connected input ports for muxer's notification iterator: "
+			"muxer-comp-addr=%p, muxer-notif-iter-addr=%p, "
+			"ret=%d",
+			muxer_comp, muxer_notif_iter, ret);
+		status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+		goto end;
+	}
+
+	muxer_upstream_notif_iters =
+		muxer_notif_iter->muxer_upstream_notif_iters;
+
+	for (i = 0; i < muxer_upstream_notif_iters->len; i++) {
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
+			g_ptr_array_index(muxer_upstream_notif_iters, i);
+
+		if (!muxer_upstream_notif_iter->notif_iter) {
+			muxer_notif_iter->upstream_ended = true;
+		}
+	}
+
+	if (muxer_notif_iter->upstream_ended) {
+		/*
+		 * The notifications of an ended upstream iterator
+		 * which come after the requested time are already
+		 * delivered: they would be missing after this
+		 * operation.
+		 */
+		BT_LOGD("Cannot seek muxer's notification iterator: at least one upstream notification iterator is ended: "
+			"muxer-notif-iter-addr=%p", muxer_notif_iter);
+		goto end;
+	}
+
+	if (muxer_upstream_notif_iters->len == 0) {
+		/* Nothing to seek */
+		status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		goto end;
+	}
+
+	for (i = 0; i < muxer_upstream_notif_iters->len; i++) {
+		struct muxer_upstream_notif_iter *muxer_upstream_notif_iter =
+			g_ptr_array_index(muxer_upstream_notif_iters, i);
+		enum bt_notification_iterator_status seek_status;
+
+		seek_status = bt_notification_iterator_seek_time(
+			muxer_upstream_notif_iter->notif_iter, ns_from_epoch);
+		switch (seek_status) {
+		case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+			BT_LOGD("Sought upstream notification iterator: "
+				"muxer-upstream-notif-iter-wrap-addr=%p, "
+				"notif-iter-addr=%p",
+				muxer_upstream_notif_iter,
+				muxer_upstream_notif_iter->notif_iter);
+			muxer_upstream_notif_iter_discard_obsolete_notifs(
+				muxer_upstream_notif_iter);
+			status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+			break;
+		case BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED:
+			BT_LOGD("Upstream notification iterator cannot seek: "
+				"muxer-upstream-notif-iter-wrap-addr=%p, "
+				"notif-iter-addr=%p",
+				muxer_upstream_notif_iter,
+				muxer_upstream_notif_iter->notif_iter);
+			break;
+		case BT_NOTIFICATION_ITERATOR_STATUS_END:
+			/* Removed when validated */
+			BT_PUT(muxer_upstream_notif_iter->notif_iter);
+			muxer_upstream_notif_iter_put_notifs(
+				muxer_upstream_notif_iter);
+			muxer_upstream_notif_iter->is_valid = false;
+			status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+			break;
+		default:
+			BT_LOGE("Cannot seek upstream notification iterator: "
+				"muxer-upstream-notif-iter-wrap-addr=%p, "
+				"notif-iter-addr=%p, status=%s",
+				muxer_upstream_notif_iter,
+				muxer_upstream_notif_iter->notif_iter,
+				bt_notification_iterator_status_string(seek_status));
+			status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+	}
+
+	if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		/* No upstream iterator moved: keep the current state */
+		goto end;
+	}
+
+	/*
+	 * Rebuild the heap from scratch: the current notifications of
+	 * the sought upstream iterators changed, and the times of
+	 * the next ones can be less than the last returned time.
+	 */
+	while (bt_heap_remove(&muxer_notif_iter->heap)) {
+		continue;
+	}
+
+	g_ptr_array_set_size(muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+		0);
+
+	for (i = 0; i < muxer_upstream_notif_iters->len; i++) {
+		g_ptr_array_add(muxer_notif_iter->invalid_muxer_upstream_notif_iters,
+			g_ptr_array_index(muxer_upstream_notif_iters, i));
+	}
+
+	muxer_notif_iter->last_returned_ts_ns = INT64_MIN;
+	muxer_notif_iter->pending_status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+end:
+	bt_put(priv_comp);
+	return status;
+}
+
 BT_HIDDEN
 void muxer_port_connected(
 		struct bt_private_component *priv_comp,
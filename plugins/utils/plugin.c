@@ -26,6 +26,8 @@
 #include "trimmer/trimmer.h"
 #include "trimmer/iterator.h"
 #include "muxer/muxer.h"
+#include "columnar/columnar.h"
+#include "stats/stats.h"
 
 #ifndef BT_BUILT_IN_PLUGINS
 BT_PLUGIN_MODULE();
@@ -64,6 +66,10 @@ BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_INIT_METHOD(trimmer,
 	trimmer_iterator_init);
 BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD(trimmer,
 	trimmer_iterator_finalize);
+BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_SEEK_TIME_METHOD(trimmer,
+	trimmer_iterator_seek_time);
+BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD(trimmer,
+	trimmer_iterator_next_batch);
 
 /* flt.utils.muxer */
 BT_PLUGIN_FILTER_COMPONENT_CLASS(muxer, muxer_notif_iter_next);
@@ -79,3 +85,25 @@ BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_INIT_METHOD(muxer,
 	muxer_notif_iter_init);
 BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_FINALIZE_METHOD(muxer,
 	muxer_notif_iter_finalize);
+BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_SEEK_TIME_METHOD(muxer,
+	muxer_notif_iter_seek_time);
+BT_PLUGIN_FILTER_COMPONENT_CLASS_NOTIFICATION_ITERATOR_NEXT_BATCH_METHOD(muxer,
+	muxer_notif_iter_next_batch);
+
+/* sink.utils.columnar */
+BT_PLUGIN_SINK_COMPONENT_CLASS(columnar, columnar_consume);
+BT_PLUGIN_SINK_COMPONENT_CLASS_INIT_METHOD(columnar, columnar_init);
+BT_PLUGIN_SINK_COMPONENT_CLASS_FINALIZE_METHOD(columnar, columnar_finalize);
+BT_PLUGIN_SINK_COMPONENT_CLASS_PORT_CONNECTED_METHOD(columnar,
+	columnar_port_connected);
+BT_PLUGIN_SINK_COMPONENT_CLASS_DESCRIPTION(columnar,
+	"Write event fields to binary column files.");
+
+/* sink.utils.stats */
+BT_PLUGIN_SINK_COMPONENT_CLASS(stats, stats_consume);
+BT_PLUGIN_SINK_COMPONENT_CLASS_INIT_METHOD(stats, stats_init);
+BT_PLUGIN_SINK_COMPONENT_CLASS_FINALIZE_METHOD(stats, stats_finalize);
+BT_PLUGIN_SINK_COMPONENT_CLASS_PORT_CONNECTED_METHOD(stats,
+	stats_port_connected);
+BT_PLUGIN_SINK_COMPONENT_CLASS_DESCRIPTION(stats,
+	"Compute per-event-class and per-stream statistics and print them.");
@@ -0,0 +1,168 @@
+#ifndef BABELTRACE_PLUGINS_UTILS_STATS_HISTOGRAM_H
+#define BABELTRACE_PLUGINS_UTILS_STATS_HISTOGRAM_H
+
+/*
+ * Babeltrace - Statistics sink histograms
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Fixed-size histogram of 64-bit unsigned values with logarithmic
+ * buckets (HDR histogram style): each power of two range [2^N, 2^(N+1))
+ * is split into STATS_HISTOGRAM_SUB_BUCKET_COUNT buckets of equal
+ * width, so that the relative error of a bucket bound is at most
+ * 1 / STATS_HISTOGRAM_SUB_BUCKET_COUNT. The values smaller than
+ * STATS_HISTOGRAM_SUB_BUCKET_COUNT have their own, exact, bucket.
+ *
+ * Recording a value is a few arithmetic operations and does not
+ * allocate.
+ */
+
+#include <stdint.h>
+
+#define STATS_HISTOGRAM_SUB_BUCKET_BITS		2
+#define STATS_HISTOGRAM_SUB_BUCKET_COUNT	(1 << STATS_HISTOGRAM_SUB_BUCKET_BITS)
+#define STATS_HISTOGRAM_BUCKET_COUNT		\
+	((64 - STATS_HISTOGRAM_SUB_BUCKET_BITS + 1) * STATS_HISTOGRAM_SUB_BUCKET_COUNT)
+
+struct stats_histogram {
+	uint64_t count;
+	uint64_t min;
+	uint64_t max;
+
+	/* Sum of the values, saturated at UINT64_MAX */
+	uint64_t sum;
+
+	uint64_t buckets[STATS_HISTOGRAM_BUCKET_COUNT];
+};
+
+/* Returns the index of the bucket of the value `v` */
+static inline
+unsigned int stats_histogram_bucket_index(uint64_t v)
+{
+	unsigned int msb;
+
+	if (v < STATS_HISTOGRAM_SUB_BUCKET_COUNT) {
+		return (unsigned int) v;
+	}
+
+	msb = 63 - __builtin_clzll(v);
+	return (msb - STATS_HISTOGRAM_SUB_BUCKET_BITS + 1) *
+		STATS_HISTOGRAM_SUB_BUCKET_COUNT +
+		(unsigned int) ((v >> (msb - STATS_HISTOGRAM_SUB_BUCKET_BITS)) &
+			(STATS_HISTOGRAM_SUB_BUCKET_COUNT - 1));
+}
+
+/* Returns the smallest value of the bucket at index `index` */
+static inline
+uint64_t stats_histogram_bucket_lower(unsigned int index)
+{
+	unsigned int msb;
+	uint64_t sub;
+
+	if (index < STATS_HISTOGRAM_SUB_BUCKET_COUNT) {
+		return index;
+	}
+
+	msb = index / STATS_HISTOGRAM_SUB_BUCKET_COUNT +
+		STATS_HISTOGRAM_SUB_BUCKET_BITS - 1;
+	sub = index % STATS_HISTOGRAM_SUB_BUCKET_COUNT;
+	return (STATS_HISTOGRAM_SUB_BUCKET_COUNT + sub) <<
+		(msb - STATS_HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+/* Returns the largest value of the bucket at index `index` */
+static inline
+uint64_t stats_histogram_bucket_upper(unsigned int index)
+{
+	unsigned int msb;
+
+	if (index < STATS_HISTOGRAM_SUB_BUCKET_COUNT) {
+		return index;
+	}
+
+	msb = index / STATS_HISTOGRAM_SUB_BUCKET_COUNT +
+		STATS_HISTOGRAM_SUB_BUCKET_BITS - 1;
+	return stats_histogram_bucket_lower(index) +
+		((UINT64_C(1) << (msb - STATS_HISTOGRAM_SUB_BUCKET_BITS)) - 1);
+}
+
+static inline
+void stats_histogram_record(struct stats_histogram *hist, uint64_t v)
+{
+	if (hist->count == 0 || v < hist->min) {
+		hist->min = v;
+	}
+
+	if (hist->count == 0 || v > hist->max) {
+		hist->max = v;
+	}
+
+	hist->sum = hist->sum + v < hist->sum ? UINT64_MAX : hist->sum + v;
+	hist->count++;
+	hist->buckets[stats_histogram_bucket_index(v)]++;
+}
+
+/*
+ * Returns an estimate of the value below or at which are `percent`
+ * percent of the recorded values: the upper bound of the bucket of this
+ * value, clamped to the recorded minimum and maximum. Returns 0 if the
+ * histogram is empty.
+ */
+static inline
+uint64_t stats_histogram_percentile(const struct stats_histogram *hist,
+		double percent)
+{
+	uint64_t rank;
+	uint64_t seen = 0;
+	unsigned int i;
+
+	if (hist->count == 0) {
+		return 0;
+	}
+
+	/* Rank of the value, from 1 */
+	rank = (uint64_t) (percent / 100. * (double) hist->count + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	} else if (rank > hist->count) {
+		rank = hist->count;
+	}
+
+	for (i = 0; i < STATS_HISTOGRAM_BUCKET_COUNT; i++) {
+		seen += hist->buckets[i];
+
+		if (seen >= rank) {
+			uint64_t upper = stats_histogram_bucket_upper(i);
+
+			if (upper > hist->max) {
+				upper = hist->max;
+			}
+
+			return upper < hist->min ? hist->min : upper;
+		}
+	}
+
+	return hist->max;
+}
+
+#endif /* BABELTRACE_PLUGINS_UTILS_STATS_HISTOGRAM_H */
@@ -0,0 +1,1342 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define BT_LOG_TAG "PLUGIN-UTILS-STATS-SINK"
+#include "logging.h"
+
+#include <babeltrace/babeltrace.h>
+#include <babeltrace/babeltrace-internal.h>
+#include <babeltrace/graph/connection-internal.h>
+#include <babeltrace/graph/notification-iterator-internal.h>
+#include <plugins-common.h>
+#include <glib.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stats.h"
+
+/* Maximum number of notifications to get from the input iterator at once */
+#define NOTIF_BATCH_CAPACITY	64
+
+static
+void destroy_event_class(struct stats_event_class *sec)
+{
+	if (!sec) {
+		return;
+	}
+
+	bt_put(sec->event_class);
+	g_free(sec);
+}
+
+static
+void destroy_stream_class(struct stats_stream_class *ssc)
+{
+	if (!ssc) {
+		return;
+	}
+
+	if (ssc->event_classes) {
+		g_ptr_array_free(ssc->event_classes, TRUE);
+	}
+
+	if (ssc->sparse_event_classes) {
+		g_hash_table_destroy(ssc->sparse_event_classes);
+	}
+
+	bt_put(ssc->stream_class);
+	g_free(ssc);
+}
+
+static
+void destroy_stream(struct stats_stream *ss)
+{
+	if (!ss) {
+		return;
+	}
+
+	bt_put(ss->stream);
+	g_free(ss);
+}
+
+/*
+ * Returns the size (bits) of the fields of type `ft` if they all have
+ * the same size, without alignment padding, or -1.
+ */
+static
+int64_t get_fixed_size(struct bt_field_type *ft)
+{
+	struct bt_field_type *sub_ft = NULL;
+	int64_t size = -1;
+	int64_t count;
+	int64_t i;
+
+	switch (bt_field_type_get_type_id(ft)) {
+	case BT_FIELD_TYPE_ID_INTEGER:
+		size = bt_field_type_integer_get_size(ft);
+		break;
+	case BT_FIELD_TYPE_ID_ENUM:
+		sub_ft = bt_field_type_enumeration_get_container_type(ft);
+		assert(sub_ft);
+		size = get_fixed_size(sub_ft);
+		break;
+	case BT_FIELD_TYPE_ID_FLOAT:
+		size = bt_field_type_floating_point_get_exponent_digits(ft) +
+			bt_field_type_floating_point_get_mantissa_digits(ft);
+		break;
+	case BT_FIELD_TYPE_ID_STRUCT:
+		count = bt_field_type_structure_get_field_count(ft);
+		assert(count >= 0);
+		size = 0;
+
+		for (i = 0; i < count; i++) {
+			int64_t member_size;
+			int ret;
+
+			ret = bt_field_type_structure_get_field_by_index(ft,
+				NULL, &sub_ft, i);
+			assert(ret == 0);
+			member_size = get_fixed_size(sub_ft);
+			BT_PUT(sub_ft);
+
+			if (member_size < 0) {
+				size = -1;
+				break;
+			}
+
+			size += member_size;
+		}
+		break;
+	case BT_FIELD_TYPE_ID_ARRAY:
+		sub_ft = bt_field_type_array_get_element_type(ft);
+		assert(sub_ft);
+		size = get_fixed_size(sub_ft);
+		count = bt_field_type_array_get_length(ft);
+
+		if (size >= 0 && count >= 0) {
+			size *= count;
+		} else {
+			size = -1;
+		}
+		break;
+	default:
+		/* Strings, sequences, and variants */
+		break;
+	}
+
+	bt_put(sub_ft);
+	return size;
+}
+
+/*
+ * Returns the size (bits) of the elements 0 to `length` - 1 of the
+ * array or sequence field `field` of which the element field type is
+ * `elem_ft`.
+ */
+static
+uint64_t get_field_size(struct bt_field *field);
+
+static
+uint64_t get_elements_size(struct bt_field *field,
+		struct bt_field_type *elem_ft, uint64_t length, bool is_seq)
+{
+	int64_t elem_size = get_fixed_size(elem_ft);
+	uint64_t size = 0;
+	uint64_t i;
+
+	if (elem_size >= 0) {
+		return length * (uint64_t) elem_size;
+	}
+
+	for (i = 0; i < length; i++) {
+		struct bt_field *elem = is_seq ?
+			bt_field_sequence_get_field(field, i) :
+			bt_field_array_get_field(field, i);
+
+		if (elem) {
+			size += get_field_size(elem);
+			bt_put(elem);
+		}
+	}
+
+	return size;
+}
+
+/* Returns the size (bits) of `field`, without alignment padding */
+static
+uint64_t get_field_size(struct bt_field *field)
+{
+	struct bt_field_type *ft = bt_field_get_type(field);
+	struct bt_field_type *elem_ft = NULL;
+	struct bt_field *sub_field = NULL;
+	int64_t fixed_size;
+	uint64_t size = 0;
+	int64_t count;
+	int64_t i;
+
+	assert(ft);
+	fixed_size = get_fixed_size(ft);
+	if (fixed_size >= 0) {
+		size = (uint64_t) fixed_size;
+		goto end;
+	}
+
+	switch (bt_field_type_get_type_id(ft)) {
+	case BT_FIELD_TYPE_ID_STRING:
+	{
+		const char *str = bt_field_string_get_value(field);
+
+		size = ((str ? strlen(str) : 0) + 1) * CHAR_BIT;
+		break;
+	}
+	case BT_FIELD_TYPE_ID_STRUCT:
+		count = bt_field_type_structure_get_field_count(ft);
+		assert(count >= 0);
+
+		for (i = 0; i < count; i++) {
+			sub_field = bt_field_structure_get_field_by_index(field,
+				i);
+			if (sub_field) {
+				size += get_field_size(sub_field);
+				BT_PUT(sub_field);
+			}
+		}
+		break;
+	case BT_FIELD_TYPE_ID_ARRAY:
+		elem_ft = bt_field_type_array_get_element_type(ft);
+		assert(elem_ft);
+		count = bt_field_type_array_get_length(ft);
+		size = get_elements_size(field, elem_ft,
+			count > 0 ? (uint64_t) count : 0, false);
+		break;
+	case BT_FIELD_TYPE_ID_SEQUENCE:
+	{
+		uint64_t length = 0;
+
+		elem_ft = bt_field_type_sequence_get_element_type(ft);
+		assert(elem_ft);
+		sub_field = bt_field_sequence_get_length(field);
+		if (!sub_field || bt_field_unsigned_integer_get_value(
+				sub_field, &length)) {
+			length = 0;
+		}
+
+		size = get_elements_size(field, elem_ft, length, true);
+		break;
+	}
+	case BT_FIELD_TYPE_ID_VARIANT:
+		sub_field = bt_field_variant_get_current_field(field);
+		if (sub_field) {
+			size = get_field_size(sub_field);
+		}
+		break;
+	default:
+		break;
+	}
+
+end:
+	bt_put(sub_field);
+	bt_put(elem_ft);
+	bt_put(ft);
+	return size;
+}
+
+static
+struct stats_event_class *create_event_class(
+		struct bt_event_class *event_class)
+{
+	struct stats_event_class *sec = g_new0(struct stats_event_class, 1);
+	struct bt_field_type *payload_ft;
+
+	if (!sec) {
+		goto end;
+	}
+
+	sec->event_class = bt_get(event_class);
+	payload_ft = bt_event_class_get_payload_type(event_class);
+	sec->fixed_payload_size = payload_ft ? get_fixed_size(payload_ft) : 0;
+	bt_put(payload_ft);
+
+end:
+	return sec;
+}
+
+static
+struct stats_stream_class *get_stream_class(struct stats *stats,
+		struct bt_stream_class *stream_class)
+{
+	struct stats_stream_class *ssc = stats->last_stream_class;
+
+	if (likely(ssc && ssc->stream_class == stream_class)) {
+		goto end;
+	}
+
+	ssc = g_hash_table_lookup(stats->stream_class_index, stream_class);
+	if (ssc) {
+		goto set_last;
+	}
+
+	ssc = g_new0(struct stats_stream_class, 1);
+	if (!ssc) {
+		goto end;
+	}
+
+	ssc->stream_class = bt_get(stream_class);
+	ssc->event_classes = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) destroy_event_class);
+	ssc->sparse_event_classes = g_hash_table_new_full(g_direct_hash,
+		g_direct_equal, NULL, (GDestroyNotify) destroy_event_class);
+	if (!ssc->event_classes || !ssc->sparse_event_classes) {
+		destroy_stream_class(ssc);
+		ssc = NULL;
+		goto end;
+	}
+
+	g_ptr_array_add(stats->stream_classes, ssc);
+	g_hash_table_insert(stats->stream_class_index, stream_class, ssc);
+
+set_last:
+	stats->last_stream_class = ssc;
+
+end:
+	return ssc;
+}
+
+/*
+ * Returns the statistics of `event_class`: an array access by event
+ * class ID once its stream class is known, which it mostly is (previous
+ * event).
+ */
+static
+struct stats_event_class *get_event_class(struct stats *stats,
+		struct bt_event_class *event_class)
+{
+	struct bt_stream_class *stream_class =
+		bt_event_class_get_stream_class(event_class);
+	struct stats_stream_class *ssc;
+	struct stats_event_class *sec = NULL;
+	int64_t id;
+
+	assert(stream_class);
+	ssc = get_stream_class(stats, stream_class);
+	if (!ssc) {
+		goto end;
+	}
+
+	id = bt_event_class_get_id(event_class);
+	if (likely(id >= 0 && id < STATS_MAX_DENSE_EVENT_CLASS_ID)) {
+		if (id >= ssc->event_classes->len) {
+			g_ptr_array_set_size(ssc->event_classes, id + 1);
+		}
+
+		sec = g_ptr_array_index(ssc->event_classes, id);
+		if (likely(sec)) {
+			goto end;
+		}
+
+		sec = create_event_class(event_class);
+		g_ptr_array_index(ssc->event_classes, id) = sec;
+	} else {
+		sec = g_hash_table_lookup(ssc->sparse_event_classes,
+			event_class);
+		if (sec) {
+			goto end;
+		}
+
+		sec = create_event_class(event_class);
+		if (sec) {
+			g_hash_table_insert(ssc->sparse_event_classes,
+				event_class, sec);
+		}
+	}
+
+end:
+	bt_put(stream_class);
+	return sec;
+}
+
+static
+struct stats_stream *get_stream(struct stats *stats, struct bt_stream *stream)
+{
+	struct stats_stream *ss = stats->last_stream;
+
+	if (likely(ss && ss->stream == stream)) {
+		goto end;
+	}
+
+	ss = g_hash_table_lookup(stats->stream_index, stream);
+	if (ss) {
+		goto set_last;
+	}
+
+	ss = g_new0(struct stats_stream, 1);
+	if (!ss) {
+		goto end;
+	}
+
+	ss->stream = bt_get(stream);
+	g_ptr_array_add(stats->streams, ss);
+	g_hash_table_insert(stats->stream_index, stream, ss);
+
+set_last:
+	stats->last_stream = ss;
+
+end:
+	return ss;
+}
+
+/*
+ * Sets `*ts` to the timestamp (ns from Epoch) of `event`, the event of
+ * `notif`, and returns true, or returns false if it has none.
+ */
+static
+bool get_event_timestamp(struct bt_notification *notif,
+		struct bt_event *event, int64_t *ts)
+{
+	struct bt_clock_class_priority_map *cc_prio_map;
+	struct bt_clock_class *clock_class = NULL;
+	struct bt_clock_value *clock_value = NULL;
+	bool found = false;
+
+	cc_prio_map = bt_notification_event_get_clock_class_priority_map(notif);
+	if (!cc_prio_map ||
+			bt_clock_class_priority_map_get_clock_class_count(
+				cc_prio_map) == 0) {
+		goto end;
+	}
+
+	clock_class = bt_clock_class_priority_map_get_highest_priority_clock_class(
+		cc_prio_map);
+	if (!clock_class) {
+		goto end;
+	}
+
+	clock_value = bt_event_get_clock_value(event, clock_class);
+	if (clock_value &&
+			bt_clock_value_get_value_ns_from_epoch(clock_value,
+				ts) == 0) {
+		found = true;
+	}
+
+end:
+	bt_put(clock_value);
+	bt_put(clock_class);
+	bt_put(cc_prio_map);
+	return found;
+}
+
+static
+int handle_event(struct stats *stats, struct bt_notification *notif)
+{
+	struct bt_event *event = bt_notification_event_get_event(notif);
+	struct bt_event_class *event_class = NULL;
+	struct bt_stream *stream = NULL;
+	struct stats_event_class *sec;
+	struct stats_stream *ss;
+	uint64_t payload_size;
+	int64_t ts;
+	int ret = 0;
+
+	assert(event);
+	event_class = bt_event_get_class(event);
+	assert(event_class);
+	stream = bt_event_get_stream(event);
+	assert(stream);
+	sec = get_event_class(stats, event_class);
+	ss = get_stream(stats, stream);
+	if (!sec || !ss) {
+		ret = -1;
+		goto end;
+	}
+
+	if (sec->fixed_payload_size >= 0) {
+		payload_size = (uint64_t) sec->fixed_payload_size;
+	} else {
+		struct bt_field *payload = bt_event_get_event_payload(event);
+
+		payload_size = payload ? get_field_size(payload) : 0;
+		bt_put(payload);
+	}
+
+	stats_histogram_record(&sec->payload_size, (payload_size + 7) / 8);
+
+	if (get_event_timestamp(notif, event, &ts)) {
+		/* Ignore the time going backward (not muxed) */
+		if (sec->has_last_ts && ts >= sec->last_ts) {
+			stats_histogram_record(&sec->inter_arrival,
+				(uint64_t) (ts - sec->last_ts));
+		}
+
+		sec->has_last_ts = true;
+		sec->last_ts = ts;
+
+		if (!ss->has_ts) {
+			ss->first_ts = ts;
+			ss->has_ts = true;
+		}
+
+		ss->last_ts = ts;
+	}
+
+	sec->event_count++;
+	ss->event_count++;
+	stats->event_count++;
+
+end:
+	bt_put(stream);
+	bt_put(event_class);
+	bt_put(event);
+	return ret;
+}
+
+static
+int handle_packet_begin(struct stats *stats, struct bt_notification *notif)
+{
+	struct bt_packet *packet = bt_notification_packet_begin_get_packet(notif);
+	struct bt_stream *stream;
+	struct stats_stream *ss;
+	int ret = 0;
+
+	assert(packet);
+	stream = bt_packet_get_stream(packet);
+	assert(stream);
+	ss = get_stream(stats, stream);
+	if (!ss) {
+		ret = -1;
+		goto end;
+	}
+
+	ss->packet_count++;
+
+end:
+	bt_put(stream);
+	bt_put(packet);
+	return ret;
+}
+
+/*
+ * A discarded events notification reports the events discarded between
+ * two packets of the same stream.
+ */
+static
+int handle_discarded_events(struct stats *stats,
+		struct bt_notification *notif)
+{
+	struct bt_stream *stream =
+		bt_notification_discarded_events_get_stream(notif);
+	int64_t count = bt_notification_discarded_events_get_count(notif);
+	struct stats_stream *ss;
+	int ret = 0;
+
+	if (!stream || count <= 0) {
+		goto end;
+	}
+
+	ss = get_stream(stats, stream);
+	if (!ss) {
+		ret = -1;
+		goto end;
+	}
+
+	ss->discarded_events += (uint64_t) count;
+	ss->packets_with_discarded_events++;
+
+	if ((uint64_t) count > ss->max_discarded_events_per_packet) {
+		ss->max_discarded_events_per_packet = (uint64_t) count;
+	}
+
+end:
+	bt_put(stream);
+	return ret;
+}
+
+static
+int insert_uint(struct bt_value *map, const char *key, uint64_t v)
+{
+	return bt_value_map_insert_integer(map, key, (int64_t) v) ==
+		BT_VALUE_STATUS_OK ? 0 : -1;
+}
+
+static
+int insert_string(struct bt_value *map, const char *key, const char *str)
+{
+	return bt_value_map_insert_string(map, key, str ? str : "") ==
+		BT_VALUE_STATUS_OK ? 0 : -1;
+}
+
+/* Inserts `value` (may be NULL: error) into `map` and puts it */
+static
+int insert_value(struct bt_value *map, const char *key,
+		struct bt_value *value)
+{
+	int ret = -1;
+
+	if (value && bt_value_map_insert(map, key, value) ==
+			BT_VALUE_STATUS_OK) {
+		ret = 0;
+	}
+
+	bt_put(value);
+	return ret;
+}
+
+static
+struct bt_value *histogram_to_value(const struct stats_histogram *hist,
+		bool with_buckets)
+{
+	struct bt_value *map = bt_value_map_create();
+	struct bt_value *buckets = NULL;
+	unsigned int i;
+
+	if (!map) {
+		goto error;
+	}
+
+	if (insert_uint(map, "count", hist->count)) {
+		goto error;
+	}
+
+	if (hist->count == 0) {
+		goto end;
+	}
+
+	if (insert_uint(map, "min", hist->min) ||
+			insert_uint(map, "max", hist->max) ||
+			bt_value_map_insert_float(map, "mean",
+				(double) hist->sum / (double) hist->count) ||
+			insert_uint(map, "p50",
+				stats_histogram_percentile(hist, 50.)) ||
+			insert_uint(map, "p90",
+				stats_histogram_percentile(hist, 90.)) ||
+			insert_uint(map, "p99",
+				stats_histogram_percentile(hist, 99.))) {
+		goto error;
+	}
+
+	if (!with_buckets) {
+		goto end;
+	}
+
+	/* Non-empty buckets only: [lower, upper, count] */
+	buckets = bt_value_array_create();
+	if (!buckets) {
+		goto error;
+	}
+
+	for (i = 0; i < STATS_HISTOGRAM_BUCKET_COUNT; i++) {
+		struct bt_value *bucket;
+
+		if (hist->buckets[i] == 0) {
+			continue;
+		}
+
+		bucket = bt_value_array_create();
+		if (!bucket ||
+				bt_value_array_append_integer(bucket,
+					(int64_t) stats_histogram_bucket_lower(i)) ||
+				bt_value_array_append_integer(bucket,
+					(int64_t) stats_histogram_bucket_upper(i)) ||
+				bt_value_array_append_integer(bucket,
+					(int64_t) hist->buckets[i]) ||
+				bt_value_array_append(buckets, bucket)) {
+			bt_put(bucket);
+			goto error;
+		}
+
+		bt_put(bucket);
+	}
+
+	if (insert_value(map, "buckets", buckets)) {
+		buckets = NULL;
+		goto error;
+	}
+
+	buckets = NULL;
+	goto end;
+
+error:
+	BT_PUT(map);
+
+end:
+	bt_put(buckets);
+	return map;
+}
+
+static
+int append_event_class_value(struct stats *stats, struct bt_value *array,
+		struct stats_stream_class *ssc, struct stats_event_class *sec)
+{
+	struct bt_value *map = bt_value_map_create();
+	int ret = -1;
+
+	if (!map) {
+		goto end;
+	}
+
+	if (insert_uint(map, "stream-class-id",
+				bt_stream_class_get_id(ssc->stream_class)) ||
+			insert_uint(map, "id",
+				bt_event_class_get_id(sec->event_class)) ||
+			insert_string(map, "name",
+				bt_event_class_get_name(sec->event_class)) ||
+			insert_uint(map, "events", sec->event_count) ||
+			insert_value(map, "payload-size",
+				histogram_to_value(&sec->payload_size,
+					stats->buckets)) ||
+			insert_value(map, "inter-arrival-time",
+				histogram_to_value(&sec->inter_arrival,
+					stats->buckets))) {
+		goto end;
+	}
+
+	if (bt_value_array_append(array, map)) {
+		goto end;
+	}
+
+	ret = 0;
+
+end:
+	bt_put(map);
+	return ret;
+}
+
+static
+struct bt_value *event_classes_to_value(struct stats *stats)
+{
+	struct bt_value *array = bt_value_array_create();
+	guint i, j;
+
+	if (!array) {
+		goto error;
+	}
+
+	for (i = 0; i < stats->stream_classes->len; i++) {
+		struct stats_stream_class *ssc =
+			g_ptr_array_index(stats->stream_classes, i);
+		GHashTableIter iter;
+		gpointer value;
+
+		for (j = 0; j < ssc->event_classes->len; j++) {
+			struct stats_event_class *sec =
+				g_ptr_array_index(ssc->event_classes, j);
+
+			if (sec && append_event_class_value(stats, array, ssc,
+					sec)) {
+				goto error;
+			}
+		}
+
+		g_hash_table_iter_init(&iter, ssc->sparse_event_classes);
+
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			if (append_event_class_value(stats, array, ssc,
+					value)) {
+				goto error;
+			}
+		}
+	}
+
+	goto end;
+
+error:
+	BT_PUT(array);
+
+end:
+	return array;
+}
+
+static
+struct bt_value *stream_to_value(struct stats_stream *ss)
+{
+	struct bt_value *map = bt_value_map_create();
+	struct bt_stream_class *stream_class = bt_stream_get_class(ss->stream);
+
+	if (!map || !stream_class) {
+		goto error;
+	}
+
+	if (insert_uint(map, "stream-class-id",
+				bt_stream_class_get_id(stream_class)) ||
+			insert_uint(map, "id", bt_stream_get_id(ss->stream)) ||
+			insert_string(map, "name",
+				bt_stream_get_name(ss->stream)) ||
+			insert_uint(map, "events", ss->event_count) ||
+			insert_uint(map, "packets", ss->packet_count) ||
+			insert_uint(map, "discarded-events",
+				ss->discarded_events) ||
+			insert_uint(map, "packets-with-discarded-events",
+				ss->packets_with_discarded_events) ||
+			insert_uint(map, "max-discarded-events-per-packet",
+				ss->max_discarded_events_per_packet)) {
+		goto error;
+	}
+
+	if (ss->has_ts && ss->last_ts > ss->first_ts) {
+		const double duration =
+			(double) (ss->last_ts - ss->first_ts) / 1e9;
+
+		if (bt_value_map_insert_float(map, "duration", duration) ||
+				bt_value_map_insert_float(map, "event-rate",
+					(double) ss->event_count / duration)) {
+			goto error;
+		}
+	}
+
+	goto end;
+
+error:
+	BT_PUT(map);
+
+end:
+	bt_put(stream_class);
+	return map;
+}
+
+/*
+ * Returns the current statistics as a map value:
+ *
+ * * `events`: total number of events.
+ * * `event-classes`: one map per event class.
+ * * `streams`: one map per stream.
+ */
+static
+struct bt_value *stats_to_value(struct stats *stats)
+{
+	struct bt_value *map = bt_value_map_create();
+	struct bt_value *streams = NULL;
+	guint i;
+
+	if (!map) {
+		goto error;
+	}
+
+	streams = bt_value_array_create();
+	if (!streams) {
+		goto error;
+	}
+
+	for (i = 0; i < stats->streams->len; i++) {
+		struct bt_value *stream = stream_to_value(
+			g_ptr_array_index(stats->streams, i));
+
+		if (!stream || bt_value_array_append(streams, stream)) {
+			bt_put(stream);
+			goto error;
+		}
+
+		bt_put(stream);
+	}
+
+	if (insert_uint(map, "events", stats->event_count) ||
+			insert_value(map, "event-classes",
+				event_classes_to_value(stats))) {
+		goto error;
+	}
+
+	if (insert_value(map, "streams", streams)) {
+		streams = NULL;
+		goto error;
+	}
+
+	streams = NULL;
+	goto end;
+
+error:
+	BT_PUT(map);
+
+end:
+	bt_put(streams);
+	return map;
+}
+
+static
+void print_indent(FILE *fp, size_t indent)
+{
+	size_t i;
+
+	for (i = 0; i < indent; i++) {
+		fputc(' ', fp);
+	}
+}
+
+static
+bool is_scalar(struct bt_value *value)
+{
+	return !bt_value_is_array(value) && !bt_value_is_map(value);
+}
+
+/* Returns whether or not the array `value` only contains scalars */
+static
+bool is_scalar_array(struct bt_value *value)
+{
+	int64_t size = bt_value_array_size(value);
+	int64_t i;
+
+	for (i = 0; i < size; i++) {
+		struct bt_value *element = bt_value_array_get(value, i);
+		bool scalar = is_scalar(element);
+
+		bt_put(element);
+
+		if (!scalar) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static
+void print_scalar(FILE *fp, struct bt_value *value)
+{
+	int64_t int_val;
+	double dbl_val;
+	const char *str_val;
+
+	switch (bt_value_get_type(value)) {
+	case BT_VALUE_TYPE_INTEGER:
+		(void) bt_value_integer_get(value, &int_val);
+		fprintf(fp, "%" PRId64, int_val);
+		break;
+	case BT_VALUE_TYPE_FLOAT:
+		(void) bt_value_float_get(value, &dbl_val);
+		fprintf(fp, "%.3f", dbl_val);
+		break;
+	case BT_VALUE_TYPE_STRING:
+		(void) bt_value_string_get(value, &str_val);
+		fprintf(fp, "%s", str_val);
+		break;
+	default:
+		break;
+	}
+}
+
+static
+void print_scalar_array(FILE *fp, struct bt_value *value)
+{
+	int64_t size = bt_value_array_size(value);
+	int64_t i;
+
+	fputc('[', fp);
+
+	for (i = 0; i < size; i++) {
+		struct bt_value *element = bt_value_array_get(value, i);
+
+		if (i > 0) {
+			fputs(", ", fp);
+		}
+
+		print_scalar(fp, element);
+		bt_put(element);
+	}
+
+	fputc(']', fp);
+}
+
+static
+void print_map(FILE *fp, struct bt_value *map, size_t indent,
+		bool first_on_line);
+
+static
+void print_array(FILE *fp, struct bt_value *array, size_t indent)
+{
+	int64_t size = bt_value_array_size(array);
+	int64_t i;
+
+	for (i = 0; i < size; i++) {
+		struct bt_value *element = bt_value_array_get(array, i);
+
+		print_indent(fp, indent);
+		fputs("- ", fp);
+
+		if (is_scalar(element)) {
+			print_scalar(fp, element);
+			fputc('\n', fp);
+		} else if (bt_value_is_map(element)) {
+			print_map(fp, element, indent + 2, true);
+		} else if (is_scalar_array(element)) {
+			print_scalar_array(fp, element);
+			fputc('\n', fp);
+		} else {
+			fputc('\n', fp);
+			print_array(fp, element, indent + 2);
+		}
+
+		bt_put(element);
+	}
+}
+
+static
+bt_bool append_key(const char *key, struct bt_value *value, void *data)
+{
+	g_ptr_array_add(data, (gpointer) key);
+	return BT_TRUE;
+}
+
+static
+gint compare_keys(gconstpointer a, gconstpointer b)
+{
+	return strcmp(*(const char * const *) a, *(const char * const *) b);
+}
+
+/*
+ * Prints `map` in a YAML-like format, its keys sorted, starting at the
+ * current position of the current line if `first_on_line` is true.
+ */
+static
+void print_map(FILE *fp, struct bt_value *map, size_t indent,
+		bool first_on_line)
+{
+	GPtrArray *keys = g_ptr_array_new();
+	guint i;
+
+	if (!keys) {
+		return;
+	}
+
+	(void) bt_value_map_foreach(map, append_key, keys);
+	g_ptr_array_sort(keys, compare_keys);
+
+	if (keys->len == 0 && first_on_line) {
+		fputs("{ }\n", fp);
+	}
+
+	for (i = 0; i < keys->len; i++) {
+		const char *key = g_ptr_array_index(keys, i);
+		struct bt_value *value = bt_value_map_get(map, key);
+
+		if (i > 0 || !first_on_line) {
+			print_indent(fp, indent);
+		}
+
+		fprintf(fp, "%s:", key);
+
+		if (is_scalar(value)) {
+			fputc(' ', fp);
+			print_scalar(fp, value);
+			fputc('\n', fp);
+		} else if (bt_value_is_map(value)) {
+			if (bt_value_map_is_empty(value)) {
+				fputs(" { }\n", fp);
+			} else {
+				fputc('\n', fp);
+				print_map(fp, value, indent + 2, false);
+			}
+		} else if (is_scalar_array(value)) {
+			fputc(' ', fp);
+			print_scalar_array(fp, value);
+			fputc('\n', fp);
+		} else {
+			fputc('\n', fp);
+			print_array(fp, value, indent + 2);
+		}
+
+		bt_put(value);
+	}
+
+	g_ptr_array_free(keys, TRUE);
+}
+
+static
+void print_stats(struct stats *stats)
+{
+	struct bt_value *value = stats_to_value(stats);
+
+	if (!value) {
+		BT_LOGE_STR("Cannot create statistics value.");
+		return;
+	}
+
+	print_map(stdout, value, 0, false);
+	bt_put(value);
+	stats->last_printed_event_count = stats->event_count;
+}
+
+static
+void try_print_stats(struct stats *stats)
+{
+	if (stats->step == 0 || stats->event_count % stats->step != 0) {
+		return;
+	}
+
+	print_stats(stats);
+	putchar('\n');
+}
+
+static
+void try_print_last(struct stats *stats)
+{
+	if (stats->event_count != stats->last_printed_event_count) {
+		print_stats(stats);
+	}
+}
+
+static
+void destroy_stats_data(struct stats *stats)
+{
+	if (!stats) {
+		return;
+	}
+
+	bt_put(stats->notif_iter);
+
+	if (stats->stream_class_index) {
+		g_hash_table_destroy(stats->stream_class_index);
+	}
+
+	if (stats->stream_index) {
+		g_hash_table_destroy(stats->stream_index);
+	}
+
+	if (stats->stream_classes) {
+		g_ptr_array_free(stats->stream_classes, TRUE);
+	}
+
+	if (stats->streams) {
+		g_ptr_array_free(stats->streams, TRUE);
+	}
+
+	g_free(stats);
+}
+
+void stats_finalize(struct bt_private_component *component)
+{
+	struct stats *stats;
+
+	assert(component);
+	stats = bt_private_component_get_user_data(component);
+	assert(stats);
+	try_print_last(stats);
+	destroy_stats_data(stats);
+}
+
+enum bt_component_status stats_init(struct bt_private_component *component,
+		struct bt_value *params, UNUSED_VAR void *init_method_data)
+{
+	enum bt_component_status ret;
+	struct stats *stats = g_new0(struct stats, 1);
+	struct bt_value *step = NULL;
+	struct bt_value *buckets = NULL;
+
+	if (!stats) {
+		ret = BT_COMPONENT_STATUS_NOMEM;
+		goto end;
+	}
+
+	stats->stream_classes = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) destroy_stream_class);
+	stats->streams = g_ptr_array_new_with_free_func(
+		(GDestroyNotify) destroy_stream);
+	stats->stream_class_index = g_hash_table_new(g_direct_hash,
+		g_direct_equal);
+	stats->stream_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+	if (!stats->stream_classes || !stats->streams ||
+			!stats->stream_class_index || !stats->stream_index) {
+		ret = BT_COMPONENT_STATUS_NOMEM;
+		goto error;
+	}
+
+	ret = bt_private_component_sink_add_input_private_port(component,
+		"in", NULL, NULL);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto error;
+	}
+
+	/* Print the last statistics even without any event */
+	stats->last_printed_event_count = -1ULL;
+	step = bt_value_map_get(params, "step");
+	if (step) {
+		int64_t val;
+
+		if (!bt_value_is_integer(step)) {
+			BT_LOGE_STR("Invalid `step` parameter: expecting an integer.");
+			ret = BT_COMPONENT_STATUS_INVALID;
+			goto error;
+		}
+
+		(void) bt_value_integer_get(step, &val);
+		if (val < 0) {
+			BT_LOGE("Invalid `step` parameter: expecting a positive integer or 0: "
+				"value=%" PRId64, val);
+			ret = BT_COMPONENT_STATUS_INVALID;
+			goto error;
+		}
+
+		stats->step = (uint64_t) val;
+	}
+
+	buckets = bt_value_map_get(params, "buckets");
+	if (buckets) {
+		bt_bool val;
+
+		if (!bt_value_is_bool(buckets)) {
+			BT_LOGE_STR("Invalid `buckets` parameter: expecting a boolean.");
+			ret = BT_COMPONENT_STATUS_INVALID;
+			goto error;
+		}
+
+		(void) bt_value_bool_get(buckets, &val);
+		stats->buckets = (bool) val;
+	}
+
+	ret = bt_private_component_set_user_data(component, stats);
+	if (ret != BT_COMPONENT_STATUS_OK) {
+		goto error;
+	}
+
+	goto end;
+
+error:
+	destroy_stats_data(stats);
+
+end:
+	bt_put(step);
+	bt_put(buckets);
+	return ret;
+}
+
+void stats_port_connected(
+		struct bt_private_component *component,
+		struct bt_private_port *self_port,
+		struct bt_port *other_port)
+{
+	struct stats *stats;
+	struct bt_notification_iterator *iterator;
+	struct bt_private_connection *connection;
+	enum bt_connection_status conn_status;
+	static const enum bt_notification_type notif_types[] = {
+		BT_NOTIFICATION_TYPE_EVENT,
+		BT_NOTIFICATION_TYPE_PACKET_BEGIN,
+		BT_NOTIFICATION_TYPE_DISCARDED_EVENTS,
+		BT_NOTIFICATION_TYPE_SENTINEL,
+	};
+
+	stats = bt_private_component_get_user_data(component);
+	assert(stats);
+	connection = bt_private_port_get_private_connection(self_port);
+	assert(connection);
+	conn_status = bt_private_connection_create_notification_iterator(
+		connection, notif_types, &iterator);
+	if (conn_status != BT_CONNECTION_STATUS_OK) {
+		BT_LOGE("Cannot create notification iterator: status=%s",
+			bt_connection_status_string(conn_status));
+		stats->error = true;
+		goto end;
+	}
+
+	BT_MOVE(stats->notif_iter, iterator);
+
+end:
+	bt_put(connection);
+}
+
+static
+int handle_notification(struct stats *stats, struct bt_notification *notif)
+{
+	int ret = 0;
+
+	switch (bt_notification_get_type(notif)) {
+	case BT_NOTIFICATION_TYPE_EVENT:
+		ret = handle_event(stats, notif);
+		if (ret == 0) {
+			try_print_stats(stats);
+		}
+		break;
+	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+		ret = handle_packet_begin(stats, notif);
+		break;
+	case BT_NOTIFICATION_TYPE_DISCARDED_EVENTS:
+		ret = handle_discarded_events(stats, notif);
+		break;
+	default:
+		break;
+	}
+
+	return ret;
+}
+
+enum bt_component_status stats_consume(struct bt_private_component *component)
+{
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_notification *notifs[NOTIF_BATCH_CAPACITY];
+	struct stats *stats;
+	enum bt_notification_iterator_status it_ret;
+	uint64_t notif_count = 0;
+	uint64_t i;
+
+	stats = bt_private_component_get_user_data(component);
+	assert(stats);
+
+	if (unlikely(stats->error)) {
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+	if (unlikely(!stats->notif_iter)) {
+		try_print_last(stats);
+		ret = BT_COMPONENT_STATUS_END;
+		goto end;
+	}
+
+	it_ret = bt_notification_iterator_next_batch(stats->notif_iter,
+		notifs, NOTIF_BATCH_CAPACITY, &notif_count);
+	if (it_ret < 0) {
+		BT_LOGE("Cannot get next notifications: status=%s",
+			bt_notification_iterator_status_string(it_ret));
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+	switch (it_ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		ret = BT_COMPONENT_STATUS_AGAIN;
+		goto end;
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+		try_print_last(stats);
+		ret = BT_COMPONENT_STATUS_END;
+		goto end;
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		for (i = 0; i < notif_count; i++) {
+			assert(notifs[i]);
+
+			if (ret == BT_COMPONENT_STATUS_OK &&
+					handle_notification(stats, notifs[i])) {
+				BT_LOGE("Cannot handle notification: notif-addr=%p",
+					notifs[i]);
+				ret = BT_COMPONENT_STATUS_ERROR;
+			}
+
+			bt_put(notifs[i]);
+		}
+		break;
+	default:
+		break;
+	}
+
+end:
+	return ret;
+}
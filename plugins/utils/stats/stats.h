@@ -0,0 +1,134 @@
+#ifndef BABELTRACE_PLUGINS_UTILS_STATS_H
+#define BABELTRACE_PLUGINS_UTILS_STATS_H
+
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <glib.h>
+#include <babeltrace/babeltrace.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "histogram.h"
+
+/*
+ * Event classes with an ID greater than or equal to this are kept in a
+ * hash table instead of the array indexed by ID of their stream class.
+ */
+#define STATS_MAX_DENSE_EVENT_CLASS_ID	4096
+
+struct stats_event_class {
+	/* Owned by this */
+	struct bt_event_class *event_class;
+
+	uint64_t event_count;
+
+	/*
+	 * Payload size (bits) if all the payloads of this event class have
+	 * the same size, or -1.
+	 */
+	int64_t fixed_payload_size;
+
+	/* Timestamp (ns from Epoch) of the previous event, if any */
+	bool has_last_ts;
+	int64_t last_ts;
+
+	/* Payload sizes (bytes) */
+	struct stats_histogram payload_size;
+
+	/* Times (ns) between two consecutive events of this class */
+	struct stats_histogram inter_arrival;
+};
+
+struct stats_stream_class {
+	/* Owned by this */
+	struct bt_stream_class *stream_class;
+
+	/*
+	 * Array of struct stats_event_class * (owned by this, NULL if not
+	 * seen yet), indexed by event class ID.
+	 */
+	GPtrArray *event_classes;
+
+	/*
+	 * struct bt_event_class * (weak) -> struct stats_event_class *
+	 * (owned by this), for the event classes of which the ID is too
+	 * large for `event_classes`.
+	 */
+	GHashTable *sparse_event_classes;
+};
+
+struct stats_stream {
+	/* Owned by this */
+	struct bt_stream *stream;
+
+	uint64_t event_count;
+	uint64_t packet_count;
+
+	/* Timestamps (ns from Epoch) of the first and last events */
+	bool has_ts;
+	int64_t first_ts;
+	int64_t last_ts;
+
+	/* Discarded events, as reported between packets */
+	uint64_t discarded_events;
+	uint64_t packets_with_discarded_events;
+	uint64_t max_discarded_events_per_packet;
+};
+
+struct stats {
+	struct bt_notification_iterator *notif_iter;
+
+	/* Array of struct stats_stream_class *, in order of appearance */
+	GPtrArray *stream_classes;
+
+	/* Array of struct stats_stream *, in order of appearance */
+	GPtrArray *streams;
+
+	/* Weak indexes of `stream_classes` and `streams` by IR object */
+	GHashTable *stream_class_index;
+	GHashTable *stream_index;
+
+	/* Stream class and stream of the previous event */
+	struct stats_stream_class *last_stream_class;
+	struct stats_stream *last_stream;
+
+	uint64_t event_count;
+	uint64_t last_printed_event_count;
+
+	/* Print every `step` events, only at the end if 0 */
+	uint64_t step;
+
+	/* Include the histogram buckets in the statistics */
+	bool buckets;
+	bool error;
+};
+
+enum bt_component_status stats_init(struct bt_private_component *component,
+		struct bt_value *params, void *init_method_data);
+void stats_finalize(struct bt_private_component *component);
+void stats_port_connected(struct bt_private_component *component,
+		struct bt_private_port *self_port,
+		struct bt_port *other_port);
+enum bt_component_status stats_consume(struct bt_private_component *component);
+
+#endif /* BABELTRACE_PLUGINS_UTILS_STATS_H */
@@ -33,6 +33,7 @@
 #include <babeltrace/compat/utc-internal.h>
 #include <babeltrace/babeltrace.h>
 #include <assert.h>
+#include <inttypes.h>
 #include <plugins-common.h>
 
 #include "trimmer.h"
@@ -48,6 +49,53 @@ gboolean close_packets(gpointer key, gpointer value, gpointer user_data)
 	return TRUE;
 }
 
+static
+void put_input_notifs(struct trimmer_iterator *trim_it)
+{
+	uint64_t i;
+
+	for (i = trim_it->input_index; i < trim_it->input_count; i++) {
+		BT_PUT(trim_it->input_notifs[i]);
+	}
+
+	trim_it->input_count = 0;
+	trim_it->input_index = 0;
+}
+
+/*
+ * Drops the buffered input notifications after a successful seek of
+ * the input iterator, except the stream and packet beginning/end
+ * notifications: like the library does for its own queue, the input
+ * iterator's stream states already reflect them, so they are not
+ * delivered again.
+ */
+static
+void discard_obsolete_input_notifs(struct trimmer_iterator *trim_it)
+{
+	uint64_t count = 0;
+	uint64_t i;
+
+	for (i = trim_it->input_index; i < trim_it->input_count; i++) {
+		struct bt_notification *notif = trim_it->input_notifs[i];
+
+		switch (bt_notification_get_type(notif)) {
+		case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
+		case BT_NOTIFICATION_TYPE_STREAM_END:
+		case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+		case BT_NOTIFICATION_TYPE_PACKET_END:
+			trim_it->input_notifs[i] = NULL;
+			trim_it->input_notifs[count++] = notif;
+			break;
+		default:
+			BT_PUT(trim_it->input_notifs[i]);
+			break;
+		}
+	}
+
+	trim_it->input_count = count;
+	trim_it->input_index = 0;
+}
+
 BT_HIDDEN
 void trimmer_iterator_finalize(struct bt_private_connection_private_notification_iterator *it)
 {
@@ -56,6 +104,7 @@ void trimmer_iterator_finalize(struct bt_private_connection_private_notification
 	trim_it = bt_private_connection_private_notification_iterator_get_user_data(it);
 	assert(trim_it);
 
+	put_input_notifs(trim_it);
 	bt_put(trim_it->input_iterator);
 	g_hash_table_foreach_remove(trim_it->packet_map,
 			close_packets, NULL);
@@ -464,6 +513,13 @@ struct bt_notification *evaluate_packet_notification(
 	 */
 	in_range = (pkt_end_ns >= begin_ns) && (pkt_begin_ns <= end_ns);
 	if (!in_range) {
+		/*
+		 * Do not end the iteration here, even if this packet
+		 * begins after the selected region: the other streams
+		 * can still have events within the region. Events are
+		 * delivered in time order, so the first event after
+		 * the region ends the iteration.
+		 */
 		goto end_no_notif;
 	}
 	if (pkt_begin_ns > end_ns) {
@@ -563,6 +619,308 @@ enum bt_notification_iterator_status evaluate_notification(
 	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
 }
 
+/*
+ * Gets the time (ns from Epoch) of an event notification (its clock
+ * value) or of a packet beginning/end notification (the beginning time
+ * of its packet). Returns -1 if the notification has no time.
+ */
+static
+int get_notification_ns(struct bt_notification *notification, int64_t *ns)
+{
+	int ret = -1;
+	struct bt_event *event = NULL;
+	struct bt_stream *stream = NULL;
+	struct bt_stream_class *stream_class = NULL;
+	struct bt_trace *trace = NULL;
+	struct bt_clock_class *clock_class = NULL;
+	struct bt_clock_value *clock_value = NULL;
+	struct bt_packet *packet = NULL;
+	struct bt_field *packet_context = NULL;
+	struct bt_field *timestamp_begin = NULL;
+
+	switch (bt_notification_get_type(notification)) {
+	case BT_NOTIFICATION_TYPE_EVENT:
+		event = bt_notification_event_get_event(notification);
+		assert(event);
+		stream = bt_event_get_stream(event);
+		assert(stream);
+		stream_class = bt_stream_get_class(stream);
+		assert(stream_class);
+		trace = bt_stream_class_get_trace(stream_class);
+		assert(trace);
+
+		/* FIXME multi-clock? */
+		clock_class = bt_trace_get_clock_class_by_index(trace, 0);
+		if (!clock_class) {
+			goto end;
+		}
+
+		clock_value = bt_event_get_clock_value(event, clock_class);
+		if (!clock_value) {
+			goto end;
+		}
+
+		ret = bt_clock_value_get_value_ns_from_epoch(clock_value, ns);
+		break;
+	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
+	case BT_NOTIFICATION_TYPE_PACKET_END:
+		packet = bt_notification_get_type(notification) ==
+			BT_NOTIFICATION_TYPE_PACKET_BEGIN ?
+			bt_notification_packet_begin_get_packet(notification) :
+			bt_notification_packet_end_get_packet(notification);
+		assert(packet);
+		packet_context = bt_packet_get_context(packet);
+		if (!packet_context || !bt_field_is_structure(packet_context)) {
+			goto end;
+		}
+
+		timestamp_begin = bt_field_structure_get_field_by_name(
+			packet_context, "timestamp_begin");
+		if (!timestamp_begin || !bt_field_is_integer(timestamp_begin)) {
+			goto end;
+		}
+
+		ret = ns_from_integer_field(timestamp_begin, ns);
+		break;
+	default:
+		break;
+	}
+
+end:
+	bt_put(event);
+	bt_put(stream);
+	bt_put(stream_class);
+	bt_put(trace);
+	bt_put(clock_class);
+	bt_put(clock_value);
+	bt_put(packet);
+	bt_put(packet_context);
+	bt_put(timestamp_begin);
+	return ret;
+}
+
+/*
+ * Gets a new batch of notifications from the input iterator if all
+ * the notifications of the current one are evaluated.
+ */
+static
+enum bt_notification_iterator_status fill_input_notifs(
+		struct trimmer_iterator *trim_it)
+{
+	if (trim_it->input_index < trim_it->input_count) {
+		return BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	}
+
+	trim_it->input_count = 0;
+	trim_it->input_index = 0;
+	return bt_notification_iterator_next_batch(trim_it->input_iterator,
+		trim_it->input_notifs, TRIMMER_INPUT_BATCH_CAPACITY,
+		&trim_it->input_count);
+}
+
+/*
+ * Resolves a lazy beginning bound with the time of the next input
+ * notification, without evaluating it, so that the input iterator can
+ * seek to this bound before anything is forwarded.
+ */
+static
+enum bt_notification_iterator_status resolve_lazy_begin_bound(
+		struct trimmer_iterator *trim_it, struct trimmer_bound *begin)
+{
+	enum bt_notification_iterator_status ret;
+	bool lazy_update;
+	int64_t ns;
+
+	ret = fill_input_notifs(trim_it);
+	if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		goto end;
+	}
+
+	if (get_notification_ns(trim_it->input_notifs[trim_it->input_index],
+			&ns)) {
+		/*
+		 * The bound is resolved when evaluating a later
+		 * notification, after this one is forwarded: filter
+		 * without seeking.
+		 */
+		BT_LOGD_STR("Cannot resolve lazy beginning bound with the first input notification: not seeking.");
+		goto end;
+	}
+
+	if (update_lazy_bound(begin, "begin", ns, &lazy_update)) {
+		ret = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Asks the input iterator to skip what comes before the beginning
+ * bound, once this bound is known. Upstream components which do not
+ * support this still deliver all their notifications, which are
+ * filtered as usual.
+ *
+ * This is only done before any event is forwarded: a lazy beginning
+ * bound is resolved with the first input notification, before this
+ * one is evaluated.
+ */
+static
+enum bt_notification_iterator_status push_begin_bound(
+		struct trimmer_iterator *trim_it, struct trimmer_bound *begin)
+{
+	enum bt_notification_iterator_status ret =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	if (trim_it->begin_pushed || (!begin->set && !begin->lazy)) {
+		goto end;
+	}
+
+	if (begin->lazy) {
+		ret = resolve_lazy_begin_bound(trim_it, begin);
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			goto end;
+		}
+	}
+
+	trim_it->begin_pushed = true;
+
+	if (!begin->set) {
+		goto end;
+	}
+
+	ret = bt_notification_iterator_seek_time(trim_it->input_iterator,
+		begin->value);
+	switch (ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		BT_LOGD("Sought input iterator to beginning bound: "
+			"ns-from-epoch=%" PRId64, begin->value);
+
+		/* Those are before the new position */
+		discard_obsolete_input_notifs(trim_it);
+		break;
+	case BT_NOTIFICATION_ITERATOR_STATUS_UNSUPPORTED:
+		BT_LOGD_STR("Input iterator cannot seek: filtering all its notifications.");
+		ret = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		break;
+	default:
+		BT_LOGE("Cannot seek input iterator to beginning bound: "
+			"ns-from-epoch=%" PRId64 ", status=%d",
+			begin->value, ret);
+		break;
+	}
+
+end:
+	return ret;
+}
+
+BT_HIDDEN
+enum bt_notification_iterator_status trimmer_iterator_seek_time(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		int64_t ns_from_epoch)
+{
+	struct trimmer_iterator *trim_it;
+	struct bt_private_component *component;
+	struct trimmer *trimmer;
+	enum bt_notification_iterator_status ret;
+
+	trim_it = bt_private_connection_private_notification_iterator_get_user_data(iterator);
+	assert(trim_it);
+	component = bt_private_connection_private_notification_iterator_get_private_component(
+		iterator);
+	assert(component);
+	trimmer = bt_private_component_get_user_data(component);
+	assert(trimmer);
+	bt_put(component);
+
+	/* Nothing before the beginning bound is delivered anyway */
+	if (trimmer->begin.set && ns_from_epoch < trimmer->begin.value) {
+		ns_from_epoch = trimmer->begin.value;
+	}
+
+	ret = bt_notification_iterator_seek_time(trim_it->input_iterator,
+		ns_from_epoch);
+	if (ret == BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		/* Drop what was received before the new position */
+		discard_obsolete_input_notifs(trim_it);
+		trim_it->begin_pushed = true;
+		trim_it->pending_status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	}
+
+	return ret;
+}
+
+/*
+ * Gets the next notification of the input iterator, from the current
+ * batch if possible.
+ */
+static
+enum bt_notification_iterator_status next_input_notification(
+		struct trimmer_iterator *trim_it,
+		struct bt_notification **notification)
+{
+	enum bt_notification_iterator_status ret;
+
+	ret = fill_input_notifs(trim_it);
+	if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		goto end;
+	}
+
+	*notification = trim_it->input_notifs[trim_it->input_index];
+	trim_it->input_notifs[trim_it->input_index] = NULL;
+	trim_it->input_index++;
+
+end:
+	return ret;
+}
+
+/*
+ * Gets the next notification to forward. On success, the returned
+ * notification's reference is owned by the caller.
+ */
+static
+enum bt_notification_iterator_status next_in_range_notification(
+		struct trimmer_iterator *trim_it, struct trimmer *trimmer,
+		struct bt_notification **notification)
+{
+	enum bt_notification_iterator_status ret =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+	bool notification_in_range = false;
+
+	*notification = NULL;
+
+	while (!notification_in_range) {
+		ret = push_begin_bound(trim_it, &trimmer->begin);
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			goto end;
+		}
+
+		ret = next_input_notification(trim_it, notification);
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			goto end;
+		}
+
+		if (!*notification) {
+			ret = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
+			goto end;
+		}
+
+		ret = evaluate_notification(notification, trim_it,
+				&trimmer->begin, &trimmer->end,
+				&notification_in_range);
+		if (!notification_in_range) {
+			BT_PUT(*notification);
+		}
+
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+	}
+
+end:
+	return ret;
+}
+
 BT_HIDDEN
 struct bt_notification_iterator_next_method_return trimmer_iterator_next(
 		struct bt_private_connection_private_notification_iterator *iterator)
@@ -570,12 +928,10 @@ struct bt_notification_iterator_next_method_return trimmer_iterator_next(
 	struct trimmer_iterator *trim_it = NULL;
 	struct bt_private_component *component = NULL;
 	struct trimmer *trimmer = NULL;
-	struct bt_notification_iterator *source_it = NULL;
 	struct bt_notification_iterator_next_method_return ret = {
 		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
 		.notification = NULL,
 	};
-	bool notification_in_range = false;
 
 	trim_it = bt_private_connection_private_notification_iterator_get_user_data(iterator);
 	assert(trim_it);
@@ -585,35 +941,66 @@ struct bt_notification_iterator_next_method_return trimmer_iterator_next(
 	assert(component);
 	trimmer = bt_private_component_get_user_data(component);
 	assert(trimmer);
+	assert(trim_it->input_iterator);
 
-	source_it = trim_it->input_iterator;
-	assert(source_it);
+	ret.status = next_in_range_notification(trim_it, trimmer,
+		&ret.notification);
+	bt_put(component);
+	return ret;
+}
 
-	while (!notification_in_range) {
-		ret.status = bt_notification_iterator_next(source_it);
-		if (ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
-			goto end;
-		}
+BT_HIDDEN
+enum bt_notification_iterator_status trimmer_iterator_next_batch(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct trimmer_iterator *trim_it = NULL;
+	struct bt_private_component *component = NULL;
+	struct trimmer *trimmer = NULL;
+	enum bt_notification_iterator_status ret;
+	uint64_t i = 0;
 
-		ret.notification = bt_notification_iterator_get_notification(
-			        source_it);
-		if (!ret.notification) {
-			ret.status = BT_NOTIFICATION_ITERATOR_STATUS_ERROR;
-			goto end;
-		}
+	trim_it = bt_private_connection_private_notification_iterator_get_user_data(iterator);
+	assert(trim_it);
 
-	        ret.status = evaluate_notification(&ret.notification, trim_it,
-				&trimmer->begin, &trimmer->end,
-				&notification_in_range);
-		if (!notification_in_range) {
-			BT_PUT(ret.notification);
-		}
+	component = bt_private_connection_private_notification_iterator_get_private_component(
+		iterator);
+	assert(component);
+	trimmer = bt_private_component_get_user_data(component);
+	assert(trimmer);
+	assert(trim_it->input_iterator);
+
+	ret = trim_it->pending_status;
+	if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+		/* Status deferred by the previous call */
+		trim_it->pending_status = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+		goto end;
+	}
+
+	while (i < capacity) {
+		struct bt_notification *notification;
+
+		ret = next_in_range_notification(trim_it, trimmer,
+			&notification);
+		if (ret != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			bt_put(notification);
+
+			if (i > 0) {
+				/* Deliver the notifications we have first */
+				trim_it->pending_status = ret;
+				ret = BT_NOTIFICATION_ITERATOR_STATUS_OK;
+			}
 
-		if (ret.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
 			break;
 		}
+
+		notifications[i] = notification;
+		i++;
 	}
+
 end:
+	*count = i;
 	bt_put(component);
 	return ret;
 }
@@ -30,6 +30,9 @@
 #include "trimmer.h"
 #include <babeltrace/babeltrace.h>
 
+/* Maximum number of notifications to get from the input iterator at once */
+#define TRIMMER_INPUT_BATCH_CAPACITY	64
+
 struct trimmer_iterator {
 	/* Input iterator associated with this output iterator. */
 	struct bt_notification_iterator *input_iterator;
@@ -37,6 +40,26 @@ struct trimmer_iterator {
 	FILE *err;
 	/* Map between reader and writer packets. */
 	GHashTable *packet_map;
+	/*
+	 * True once the input iterator was asked to seek to the
+	 * beginning bound (or to another time).
+	 */
+	bool begin_pushed;
+	/*
+	 * Notifications received from the input iterator in one batch
+	 * which are not evaluated yet (owned by this), from
+	 * input_notifs[input_index] to input_notifs[input_count - 1].
+	 */
+	struct bt_notification *input_notifs[TRIMMER_INPUT_BATCH_CAPACITY];
+	uint64_t input_count;
+	uint64_t input_index;
+	/*
+	 * Status to return on the next call to
+	 * trimmer_iterator_next_batch() when the previous call got
+	 * notifications before this status
+	 * (BT_NOTIFICATION_ITERATOR_STATUS_OK if none).
+	 */
+	enum bt_notification_iterator_status pending_status;
 };
 
 BT_HIDDEN
@@ -51,4 +74,15 @@ BT_HIDDEN
 struct bt_notification_iterator_next_method_return trimmer_iterator_next(
 		struct bt_private_connection_private_notification_iterator *iterator);
 
+BT_HIDDEN
+enum bt_notification_iterator_status trimmer_iterator_next_batch(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count);
+
+BT_HIDDEN
+enum bt_notification_iterator_status trimmer_iterator_seek_time(
+		struct bt_private_connection_private_notification_iterator *iterator,
+		int64_t ns_from_epoch);
+
 #endif /* BABELTRACE_PLUGIN_TRIMMER_ITERATOR_H */
@@ -0,0 +1,400 @@
+/*
+ * bench-btr.c
+ *
+ * Babeltrace - CTF binary type reader micro-benchmark
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * This program decodes the same buffer over and over with the CTF
+ * binary type reader, once with a structure field type of which all
+ * the integer and floating point number fields start on a byte
+ * boundary, and once with the same fields shifted by one bit (true
+ * bitfields, like in the patterns of tests/lib/test_bitfield.c), and
+ * once with an array of small structures, which measures the cost of
+ * entering and leaving compound fields. It prints the average decoding
+ * time of a basic field for the three layouts and both byte orders.
+ *
+ * Usage: bench-btr [ITERATIONS]
+ */
+
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/fields.h>
+#include <babeltrace/ref.h>
+#include <ctf/common/btr/btr.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS	1000000
+#define GROUP_COUNT		8
+#define BUF_SIZE		4096
+
+/* Sizes of the integer fields of one group */
+static const unsigned int int_sizes[] = { 8, 16, 32, 64, 8, 16, 32, 64 };
+
+#define INT_COUNT	(sizeof(int_sizes) / sizeof(*int_sizes))
+
+/* Integer fields and one double precision field per group */
+#define FIELD_COUNT	(GROUP_COUNT * (INT_COUNT + 1))
+
+/* Sizes of the integer fields of one element of the nested layout */
+static const unsigned int nested_int_sizes[] = { 8, 16, 32, 64 };
+
+#define NESTED_INT_COUNT	\
+	(sizeof(nested_int_sizes) / sizeof(*nested_int_sizes))
+#define NESTED_ELEM_COUNT	16
+#define NESTED_FIELD_COUNT	(NESTED_ELEM_COUNT * NESTED_INT_COUNT)
+
+struct bench_data {
+	uint64_t sum;
+	double fsum;
+};
+
+static
+enum bt_btr_status signed_int_cb(int64_t value,
+		struct bt_field_type *type, void *data)
+{
+	struct bench_data *bench_data = data;
+
+	bench_data->sum += (uint64_t) value;
+	return BT_BTR_STATUS_OK;
+}
+
+static
+enum bt_btr_status unsigned_int_cb(uint64_t value,
+		struct bt_field_type *type, void *data)
+{
+	struct bench_data *bench_data = data;
+
+	bench_data->sum += value;
+	return BT_BTR_STATUS_OK;
+}
+
+static
+enum bt_btr_status floating_point_cb(double value,
+		struct bt_field_type *type, void *data)
+{
+	struct bench_data *bench_data = data;
+
+	bench_data->fsum += value;
+	return BT_BTR_STATUS_OK;
+}
+
+static
+int add_field(struct bt_field_type *struct_ft, struct bt_field_type *ft,
+		const char *name, enum bt_byte_order bo, unsigned int alignment)
+{
+	int ret;
+
+	ret = bt_field_type_set_byte_order(ft, bo);
+	if (ret) {
+		goto end;
+	}
+
+	ret = bt_field_type_set_alignment(ft, alignment);
+	if (ret) {
+		goto end;
+	}
+
+	ret = bt_field_type_structure_add_field(struct_ft, ft, name);
+
+end:
+	bt_put(ft);
+	return ret;
+}
+
+/*
+ * Creates a structure field type of GROUP_COUNT groups of integer and
+ * floating point number fields.
+ *
+ * If `bitfield` is true, a 1-bit field is placed before the groups and
+ * all the fields are 1-bit aligned, so that none of them starts on a
+ * byte boundary. Otherwise, an 8-bit field is placed before the groups
+ * and all the fields are 8-bit aligned.
+ */
+static
+struct bt_field_type *create_struct_ft(enum bt_byte_order bo, bool bitfield)
+{
+	struct bt_field_type *struct_ft;
+	struct bt_field_type *ft;
+	unsigned int alignment = bitfield ? 1 : 8;
+	unsigned int i, j;
+	char name[32];
+
+	struct_ft = bt_field_type_structure_create();
+	if (!struct_ft) {
+		goto error;
+	}
+
+	ft = bt_field_type_integer_create(bitfield ? 1 : 8);
+	if (!ft || add_field(struct_ft, ft, "lead", bo, alignment)) {
+		goto error;
+	}
+
+	for (i = 0; i < GROUP_COUNT; i++) {
+		for (j = 0; j < INT_COUNT; j++) {
+			ft = bt_field_type_integer_create(int_sizes[j]);
+			if (!ft) {
+				goto error;
+			}
+
+			/* Second half of each group is signed */
+			if (bt_field_type_integer_set_is_signed(ft,
+					j >= INT_COUNT / 2)) {
+				bt_put(ft);
+				goto error;
+			}
+
+			snprintf(name, sizeof(name), "int_%u_%u", i, j);
+			if (add_field(struct_ft, ft, name, bo, alignment)) {
+				goto error;
+			}
+		}
+
+		ft = bt_field_type_floating_point_create();
+		if (!ft) {
+			goto error;
+		}
+
+		if (bt_field_type_floating_point_set_exponent_digits(ft, 11) ||
+				bt_field_type_floating_point_set_mantissa_digits(
+					ft, 53)) {
+			bt_put(ft);
+			goto error;
+		}
+
+		snprintf(name, sizeof(name), "dbl_%u", i);
+		if (add_field(struct_ft, ft, name, bo, alignment)) {
+			goto error;
+		}
+	}
+
+	return struct_ft;
+
+error:
+	bt_put(struct_ft);
+	return NULL;
+}
+
+/*
+ * Creates a structure field type containing an array of
+ * NESTED_ELEM_COUNT structures of byte-aligned integer fields.
+ */
+static
+struct bt_field_type *create_nested_ft(enum bt_byte_order bo)
+{
+	struct bt_field_type *struct_ft;
+	struct bt_field_type *elem_ft = NULL;
+	struct bt_field_type *array_ft = NULL;
+	struct bt_field_type *ft;
+	unsigned int i;
+	char name[32];
+
+	struct_ft = bt_field_type_structure_create();
+	elem_ft = bt_field_type_structure_create();
+	if (!struct_ft || !elem_ft) {
+		goto error;
+	}
+
+	for (i = 0; i < NESTED_INT_COUNT; i++) {
+		ft = bt_field_type_integer_create(nested_int_sizes[i]);
+		if (!ft) {
+			goto error;
+		}
+
+		snprintf(name, sizeof(name), "int_%u", i);
+		if (add_field(elem_ft, ft, name, bo, 8)) {
+			goto error;
+		}
+	}
+
+	array_ft = bt_field_type_array_create(elem_ft, NESTED_ELEM_COUNT);
+	if (!array_ft ||
+			bt_field_type_structure_add_field(struct_ft, array_ft,
+				"elems")) {
+		goto error;
+	}
+
+	goto end;
+
+error:
+	BT_PUT(struct_ft);
+
+end:
+	bt_put(array_ft);
+	bt_put(elem_ft);
+	return struct_ft;
+}
+
+static
+uint64_t get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * UINT64_C(1000000000) +
+		(uint64_t) ts.tv_nsec;
+}
+
+/*
+ * Decodes `buf` `iterations` times with `ft`, which contains
+ * `field_count` basic fields, and returns the average decoding time of
+ * one basic field (ns), or a negative value on error.
+ */
+static
+double run(struct bt_btr *btr, struct bt_field_type *ft,
+		const uint8_t *buf, unsigned long iterations,
+		unsigned int field_count)
+{
+	enum bt_btr_status status;
+	struct bt_field *field;
+	unsigned long i;
+	uint64_t begin, end;
+
+	/*
+	 * Creating a field freezes the field type, so that the BTR
+	 * compiles its decode program once.
+	 */
+	field = bt_field_create(ft);
+	if (!field) {
+		return -1.;
+	}
+
+	bt_put(field);
+	begin = get_time_ns();
+
+	for (i = 0; i < iterations; i++) {
+		bt_btr_start(btr, ft, buf, 0, 0, BUF_SIZE, &status);
+		if (status != BT_BTR_STATUS_OK) {
+			return -1.;
+		}
+	}
+
+	end = get_time_ns();
+	return (double) (end - begin) / ((double) iterations * field_count);
+}
+
+int main(int argc, char **argv)
+{
+	static const struct {
+		enum bt_byte_order bo;
+		const char *name;
+	} byte_orders[] = {
+		{ BT_BYTE_ORDER_LITTLE_ENDIAN, "little-endian" },
+		{ BT_BYTE_ORDER_BIG_ENDIAN, "big-endian" },
+	};
+	struct bench_data bench_data = { 0 };
+	struct bt_btr_cbs cbs = {
+		.types = {
+			.signed_int = signed_int_cb,
+			.unsigned_int = unsigned_int_cb,
+			.floating_point = floating_point_cb,
+		},
+	};
+	unsigned long iterations = DEFAULT_ITERATIONS;
+	struct bt_btr *btr = NULL;
+	uint8_t *buf = NULL;
+	int ret = 1;
+	size_t i;
+
+	if (argc > 1) {
+		iterations = strtoul(argv[1], NULL, 10);
+		if (iterations == 0) {
+			fprintf(stderr, "Invalid iteration count: `%s`\n",
+				argv[1]);
+			goto end;
+		}
+	}
+
+	buf = malloc(BUF_SIZE);
+	if (!buf) {
+		goto end;
+	}
+
+	srand(time(NULL));
+
+	for (i = 0; i < BUF_SIZE; i++) {
+		buf[i] = (uint8_t) rand();
+	}
+
+	btr = bt_btr_create(cbs, &bench_data);
+	if (!btr) {
+		goto end;
+	}
+
+	printf("%lu iterations, %zu (%zu nested) fields per iteration\n",
+		iterations, (size_t) FIELD_COUNT,
+		(size_t) NESTED_FIELD_COUNT);
+
+	for (i = 0; i < sizeof(byte_orders) / sizeof(*byte_orders); i++) {
+		struct bt_field_type *aligned_ft;
+		struct bt_field_type *bitfield_ft;
+		struct bt_field_type *nested_ft;
+		double aligned_ns, bitfield_ns, nested_ns;
+
+		aligned_ft = create_struct_ft(byte_orders[i].bo, false);
+		bitfield_ft = create_struct_ft(byte_orders[i].bo, true);
+		nested_ft = create_nested_ft(byte_orders[i].bo);
+		if (!aligned_ft || !bitfield_ft || !nested_ft) {
+			fprintf(stderr, "Cannot create field types\n");
+			bt_put(aligned_ft);
+			bt_put(bitfield_ft);
+			bt_put(nested_ft);
+			goto end;
+		}
+
+		aligned_ns = run(btr, aligned_ft, buf, iterations,
+			FIELD_COUNT);
+		bitfield_ns = run(btr, bitfield_ft, buf, iterations,
+			FIELD_COUNT);
+		nested_ns = run(btr, nested_ft, buf, iterations,
+			NESTED_FIELD_COUNT);
+		bt_put(aligned_ft);
+		bt_put(bitfield_ft);
+		bt_put(nested_ft);
+
+		if (aligned_ns < 0 || bitfield_ns < 0 || nested_ns < 0) {
+			fprintf(stderr, "Cannot decode buffer\n");
+			goto end;
+		}
+
+		printf("%s:\n", byte_orders[i].name);
+		printf("  byte-aligned fields: %8.3f ns/field\n", aligned_ns);
+		printf("  bitfields:           %8.3f ns/field\n", bitfield_ns);
+		printf("  speedup:             %8.3fx\n",
+			bitfield_ns / aligned_ns);
+		printf("  nested structures:   %8.3f ns/field\n", nested_ns);
+	}
+
+	/* Make sure the decoded values are used */
+	printf("(checksum: %" PRIx64 ", %g)\n", bench_data.sum,
+		bench_data.fsum);
+	ret = 0;
+
+end:
+	if (btr) {
+		bt_btr_destroy(btr);
+	}
+
+	free(buf);
+	return ret;
+}
@@ -0,0 +1,301 @@
+/*
+ * bench-pretty.c
+ *
+ * Babeltrace - text.pretty sink component benchmark
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * This program converts each given CTF trace to text with a
+ * ctf.fs -> utils.muxer -> text.pretty graph, writing to a temporary
+ * file, once without and once with the "writer-thread" parameter of
+ * the sink. It prints the best number of lines per second of
+ * ITERATIONS runs for both modes. Compare its results before and after
+ * a change of the text.pretty sink on the same traces, for example on
+ * the traces of tests/ctf-traces/succeed, from the build directory:
+ *
+ *     BABELTRACE_PLUGIN_PATH=plugins/ctf:plugins/utils:plugins/text \
+ *         tests/benchmark/bench-pretty tests/ctf-traces/succeed/<TRACE>...
+ *
+ * Usage: bench-pretty [-n ITERATIONS] TRACE...
+ */
+
+#include <babeltrace/babeltrace.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_ITERATIONS	3
+
+static
+uint64_t get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * UINT64_C(1000000000) +
+		(uint64_t) ts.tv_nsec;
+}
+
+/* Returns the number of lines of the file `path`, or -1 on error */
+static
+int64_t count_lines(const char *path)
+{
+	char buf[65536];
+	int64_t lines = 0;
+	FILE *fp;
+	size_t len;
+
+	fp = fopen(path, "r");
+	if (!fp) {
+		return -1;
+	}
+
+	while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) {
+		const char *p = buf;
+		const char *end = buf + len;
+
+		while ((p = memchr(p, '\n', end - p))) {
+			lines++;
+			p++;
+		}
+	}
+
+	fclose(fp);
+	return lines;
+}
+
+static
+struct bt_component *add_component(struct bt_graph *graph,
+		const char *plugin_name, const char *cc_name,
+		enum bt_component_class_type type, const char *name,
+		struct bt_value *params)
+{
+	struct bt_component_class *cc;
+	struct bt_component *comp = NULL;
+
+	cc = bt_plugin_find_component_class(plugin_name, cc_name, type);
+	if (!cc) {
+		fprintf(stderr, "Cannot find component class `%s.%s`: is BABELTRACE_PLUGIN_PATH set?\n",
+			plugin_name, cc_name);
+		goto end;
+	}
+
+	if (bt_graph_add_component(graph, cc, name, params, &comp)) {
+		fprintf(stderr, "Cannot create component `%s`\n", name);
+		comp = NULL;
+	}
+
+end:
+	bt_put(cc);
+	return comp;
+}
+
+static
+int connect_graph(struct bt_graph *graph, struct bt_component *src,
+		struct bt_component *muxer, struct bt_component *sink)
+{
+	struct bt_port *upstream = NULL;
+	struct bt_port *downstream = NULL;
+	int64_t count;
+	int64_t i;
+	int ret = -1;
+
+	count = bt_component_source_get_output_port_count(src);
+	if (count < 0) {
+		goto end;
+	}
+
+	for (i = 0; i < count; i++) {
+		upstream = bt_component_source_get_output_port_by_index(src, i);
+		downstream = bt_component_filter_get_input_port_by_index(muxer,
+			i);
+		if (!upstream || !downstream || bt_graph_connect_ports(graph,
+				upstream, downstream, NULL)) {
+			goto end;
+		}
+
+		BT_PUT(upstream);
+		BT_PUT(downstream);
+	}
+
+	upstream = bt_component_filter_get_output_port_by_name(muxer, "out");
+	downstream = bt_component_sink_get_input_port_by_name(sink, "in");
+	if (!upstream || !downstream || bt_graph_connect_ports(graph,
+			upstream, downstream, NULL)) {
+		goto end;
+	}
+
+	ret = 0;
+
+end:
+	bt_put(upstream);
+	bt_put(downstream);
+	return ret;
+}
+
+/*
+ * Converts the trace `trace_path` to text into the file `out_path` and
+ * returns the conversion time (ns), or 0 on error.
+ */
+static
+uint64_t run(const char *trace_path, const char *out_path,
+		bool writer_thread)
+{
+	struct bt_graph *graph = NULL;
+	struct bt_value *src_params = NULL;
+	struct bt_value *sink_params = NULL;
+	struct bt_component *src = NULL;
+	struct bt_component *muxer = NULL;
+	struct bt_component *sink = NULL;
+	enum bt_graph_status status = BT_GRAPH_STATUS_OK;
+	uint64_t begin, end;
+	uint64_t duration = 0;
+
+	graph = bt_graph_create();
+	src_params = bt_value_map_create();
+	sink_params = bt_value_map_create();
+	if (!graph || !src_params || !sink_params) {
+		goto end;
+	}
+
+	if (bt_value_map_insert_string(src_params, "path", trace_path) ||
+			bt_value_map_insert_string(sink_params, "path",
+				out_path) ||
+			bt_value_map_insert_bool(sink_params, "writer-thread",
+				writer_thread)) {
+		goto end;
+	}
+
+	/* Opening the trace is not part of the measurement */
+	src = add_component(graph, "ctf", "fs", BT_COMPONENT_CLASS_TYPE_SOURCE,
+		"src", src_params);
+	muxer = add_component(graph, "utils", "muxer",
+		BT_COMPONENT_CLASS_TYPE_FILTER, "muxer", NULL);
+	sink = add_component(graph, "text", "pretty",
+		BT_COMPONENT_CLASS_TYPE_SINK, "sink", sink_params);
+	if (!src || !muxer || !sink) {
+		goto end;
+	}
+
+	if (connect_graph(graph, src, muxer, sink)) {
+		fprintf(stderr, "Cannot connect the components\n");
+		goto end;
+	}
+
+	begin = get_time_ns();
+
+	while (status == BT_GRAPH_STATUS_OK ||
+			status == BT_GRAPH_STATUS_AGAIN) {
+		status = bt_graph_run(graph);
+	}
+
+	end = get_time_ns();
+
+	if (status != BT_GRAPH_STATUS_END) {
+		fprintf(stderr, "Graph failed: status=%d\n", (int) status);
+		goto end;
+	}
+
+	duration = end - begin;
+
+end:
+	bt_put(sink);
+	bt_put(muxer);
+	bt_put(src);
+	bt_put(sink_params);
+	bt_put(src_params);
+	bt_put(graph);
+	return duration;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long iterations = DEFAULT_ITERATIONS;
+	char out_path[] = "/tmp/bench-pretty-XXXXXX";
+	int first_trace = 1;
+	int ret = 1;
+	int fd;
+	int i;
+
+	if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+		iterations = strtoul(argv[2], NULL, 10);
+		first_trace = 3;
+	}
+
+	if (iterations == 0 || first_trace >= argc) {
+		fprintf(stderr, "Usage: %s [-n ITERATIONS] TRACE...\n",
+			argv[0]);
+		goto end;
+	}
+
+	fd = mkstemp(out_path);
+	if (fd < 0) {
+		perror("mkstemp");
+		goto end;
+	}
+
+	close(fd);
+
+	for (i = first_trace; i < argc; i++) {
+		int writer_thread;
+
+		for (writer_thread = 0; writer_thread < 2; writer_thread++) {
+			uint64_t best = UINT64_MAX;
+			unsigned long it;
+			int64_t lines;
+
+			for (it = 0; it < iterations; it++) {
+				uint64_t duration = run(argv[i], out_path,
+					writer_thread);
+
+				if (duration == 0) {
+					fprintf(stderr, "Cannot convert trace `%s`\n",
+						argv[i]);
+					goto end_unlink;
+				}
+
+				if (duration < best) {
+					best = duration;
+				}
+			}
+
+			lines = count_lines(out_path);
+			if (lines < 0) {
+				perror("count lines");
+				goto end_unlink;
+			}
+
+			printf("%s (writer thread: %s): %" PRId64 " lines, %.0f lines/s\n",
+				argv[i], writer_thread ? "yes" : "no", lines,
+				(double) lines * 1e9 / (double) best);
+		}
+	}
+
+	ret = 0;
+
+end_unlink:
+	unlink(out_path);
+
+end:
+	return ret;
+}
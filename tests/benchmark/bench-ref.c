@@ -0,0 +1,153 @@
+/*
+ * bench-ref.c
+ *
+ * Babeltrace - Reference counting micro-benchmark
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * This program measures the single-threaded cost of a bt_get()/bt_put()
+ * pair, first with the default (plain) reference counting, then with
+ * the atomic reference counting which a threaded graph enables (see
+ * bt_graph_set_threaded()). It measures two cases:
+ *
+ * * An object without a parent (a value object) of which the caller
+ *   owns a reference.
+ *
+ * * An object with a parent (an event class within a stream class) of
+ *   which the reference count goes from 0 to 1 and back to 0 at each
+ *   iteration, so that its parent's reference count changes too.
+ *
+ * Usage: bench-ref [ITERATIONS]
+ */
+
+#include <babeltrace/ctf-ir/event-class.h>
+#include <babeltrace/ctf-ir/stream-class.h>
+#include <babeltrace/graph/graph.h>
+#include <babeltrace/values.h>
+#include <babeltrace/ref.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS	100000000
+
+static
+uint64_t get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * UINT64_C(1000000000) +
+		(uint64_t) ts.tv_nsec;
+}
+
+/*
+ * Gets and puts `obj` `iterations` times and returns the average time
+ * of a bt_get()/bt_put() pair (ns).
+ */
+static
+double run(void *obj, unsigned long iterations)
+{
+	unsigned long i;
+	uint64_t begin, end;
+
+	begin = get_time_ns();
+
+	for (i = 0; i < iterations; i++) {
+		bt_get(obj);
+		bt_put(obj);
+	}
+
+	end = get_time_ns();
+	return (double) (end - begin) / (double) iterations;
+}
+
+static
+void run_and_print(const char *mode, struct bt_value *value,
+		struct bt_event_class *event_class, unsigned long iterations,
+		double *results)
+{
+	results[0] = run(value, iterations);
+	results[1] = run(event_class, iterations);
+	printf("%s reference counting:\n", mode);
+	printf("  object without parent:    %8.3f ns/pair\n", results[0]);
+	printf("  object with parent (0-1): %8.3f ns/pair\n", results[1]);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long iterations = DEFAULT_ITERATIONS;
+	struct bt_value *value = NULL;
+	struct bt_stream_class *stream_class = NULL;
+	struct bt_event_class *event_class = NULL;
+	struct bt_graph *graph = NULL;
+	double plain_results[2];
+	double atomic_results[2];
+	int ret = 1;
+
+	if (argc > 1) {
+		iterations = strtoul(argv[1], NULL, 10);
+		if (iterations == 0) {
+			fprintf(stderr, "Invalid iteration count: `%s`\n",
+				argv[1]);
+			goto end;
+		}
+	}
+
+	value = bt_value_integer_create();
+	stream_class = bt_stream_class_create("sc");
+	event_class = bt_event_class_create("ec");
+	if (!value || !stream_class || !event_class) {
+		fprintf(stderr, "Cannot create objects\n");
+		goto end;
+	}
+
+	if (bt_stream_class_add_event_class(stream_class, event_class)) {
+		fprintf(stderr, "Cannot add event class to stream class\n");
+		goto end;
+	}
+
+	/*
+	 * Only the stream class keeps the event class alive from now
+	 * on: `event_class` is a borrowed reference.
+	 */
+	bt_put(event_class);
+	printf("%lu iterations\n", iterations);
+	run_and_print("Plain", value, event_class, iterations, plain_results);
+
+	/* Making a graph threaded enables atomic reference counting */
+	graph = bt_graph_create();
+	if (!graph || bt_graph_set_threaded(graph, BT_TRUE)) {
+		fprintf(stderr, "Cannot create threaded graph\n");
+		goto end;
+	}
+
+	run_and_print("Atomic", value, event_class, iterations,
+		atomic_results);
+	printf("Slowdown: %.3fx (without parent), %.3fx (with parent)\n",
+		atomic_results[0] / plain_results[0],
+		atomic_results[1] / plain_results[1]);
+	ret = 0;
+
+end:
+	bt_put(graph);
+	bt_put(stream_class);
+	bt_put(value);
+	return ret;
+}
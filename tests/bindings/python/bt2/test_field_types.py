@@ -415,6 +415,21 @@ class EnumerationFieldTypeTestCase(_TestIntegerFieldTypeProps, _TestInvalidEq,
     def test_find_by_value_unsigned(self):
         self._test_find_by_value(bt2.EnumerationFieldType(size=8))
 
+    def _test_labels_by_value(self, ft):
+        ft.append_mapping('a', 0)
+        ft.append_mapping('b', 1, 3)
+        ft.append_mapping('c', 5, 19)
+        ft.append_mapping('d', 8, 15)
+        ft.append_mapping('e', 10, 21)
+        self.assertEqual(ft.labels_by_value(14), ['c', 'd', 'e'])
+        self.assertEqual(ft.labels_by_value(4), [])
+
+    def test_labels_by_value_signed(self):
+        self._test_labels_by_value(bt2.EnumerationFieldType(size=8, is_signed=True))
+
+    def test_labels_by_value_unsigned(self):
+        self._test_labels_by_value(bt2.EnumerationFieldType(size=8))
+
     def test_create_field(self):
         self._ft.append_mapping('c', 4, 5)
         field = self._ft()
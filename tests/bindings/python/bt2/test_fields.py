@@ -825,6 +825,9 @@ class EnumerationFieldTestCase(_TestIntegerFieldCommon, unittest.TestCase):
         self.assertEqual(total, 3)
         self.assertTrue(0 in index_set and 1 in index_set and 2 in index_set)
 
+    def test_labels(self):
+        self.assertEqual(self._def.labels, ['whole range', 'something', 'zip'])
+
     def test_str_op(self):
         expected_string_found = False
         s = str(self._def)
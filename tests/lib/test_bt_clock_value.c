@@ -0,0 +1,187 @@
+/*
+ * test_bt_clock_value.c
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <babeltrace/ref.h>
+#include <babeltrace/ctf-ir/clock-class.h>
+#include <babeltrace/ctf-ir/event-class.h>
+#include <babeltrace/ctf-ir/event.h>
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/stream-class.h>
+#include <babeltrace/ctf-ir/trace.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <assert.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS	17
+
+/*
+ * Creates a clock value of `value` cycles with a new clock class and
+ * returns its value in nanoseconds from Epoch in `*ns`. Returns the
+ * return value of bt_clock_value_get_value_ns_from_epoch().
+ */
+static
+int get_ns(uint64_t freq, int64_t offset_s, int64_t offset_cycles,
+		uint64_t value, int64_t *ns)
+{
+	struct bt_clock_class *cc;
+	struct bt_clock_value *cv;
+	int ret;
+
+	cc = bt_clock_class_create("cc", freq);
+	assert(cc);
+	ret = bt_clock_class_set_offset_s(cc, offset_s);
+	assert(ret == 0);
+	ret = bt_clock_class_set_offset_cycles(cc, offset_cycles);
+	assert(ret == 0);
+	cv = bt_clock_value_create(cc, value);
+	assert(cv);
+	ret = bt_clock_value_get_value_ns_from_epoch(cv, ns);
+	bt_put(cv);
+	bt_put(cc);
+	return ret;
+}
+
+static
+void test_ns_from_epoch(void)
+{
+	int64_t ns;
+	int ret;
+
+	ret = get_ns(1000000000, 0, 0, 0, &ns);
+	ok(ret == 0 && ns == 0, "1 GHz: value 0");
+	ret = get_ns(1000000000, 10, 5, 7, &ns);
+	ok(ret == 0 && ns == INT64_C(10000000012),
+		"1 GHz: offset (s), offset (cycles), and value");
+	ret = get_ns(1000, 45, 354, 123, &ns);
+	ok(ret == 0 && ns == INT64_C(45477000000),
+		"1 kHz: offset (s), offset (cycles), and value");
+	ret = get_ns(1000000000, -1, 0, 50, &ns);
+	ok(ret == 0 && ns == INT64_C(-999999950), "1 GHz: negative offset (s)");
+	ret = get_ns(3, 0, 0, 10, &ns);
+	ok(ret == 0 && ns == INT64_C(3333333333),
+		"3 Hz: result is rounded down");
+	ret = get_ns(2400000000ULL, 0, 0, UINT64_C(1) << 62, &ns);
+	ok(ret == 0 && ns == INT64_C(1921535841011411626),
+		"2.4 GHz: large value is exact");
+	ret = get_ns(1000000000, 0, 0, INT64_MAX, &ns);
+	ok(ret == 0 && ns == INT64_MAX, "1 GHz: largest value");
+	ret = get_ns(1000000000, 0, 0, (uint64_t) INT64_MAX + 1, &ns);
+	ok(ret < 0, "1 GHz: value overflows");
+	ret = get_ns(1000000000, 1, 0, INT64_MAX, &ns);
+	ok(ret < 0, "1 GHz: value and offset overflow");
+	ret = get_ns(1, 0, 0, UINT64_MAX, &ns);
+	ok(ret < 0, "1 Hz: value overflows");
+	ret = get_ns(UINT64_MAX - 1, 0, 0, UINT64_MAX - 1, &ns);
+	ok(ret == 0 && ns == INT64_C(1000000000),
+		"highest frequency: one second");
+}
+
+static
+void test_event_clock_value(void)
+{
+	struct bt_trace *trace;
+	struct bt_stream_class *sc;
+	struct bt_event_class *ec;
+	struct bt_event *event;
+	struct bt_clock_class *cc;
+	struct bt_clock_class *other_cc;
+	struct bt_clock_class *ret_cc;
+	struct bt_clock_value *cv;
+	struct bt_clock_value *ret_cv;
+	struct bt_field_type *empty_struct_ft;
+	uint64_t value;
+	int64_t ns;
+	int ret;
+
+	empty_struct_ft = bt_field_type_structure_create();
+	assert(empty_struct_ft);
+	trace = bt_trace_create();
+	assert(trace);
+	ret = bt_trace_set_packet_header_type(trace, empty_struct_ft);
+	assert(ret == 0);
+	cc = bt_clock_class_create("cc", 1000);
+	assert(cc);
+	ret = bt_clock_class_set_offset_s(cc, 2);
+	assert(ret == 0);
+	ret = bt_trace_add_clock_class(trace, cc);
+	assert(ret == 0);
+	other_cc = bt_clock_class_create("other_cc", 1000);
+	assert(other_cc);
+	sc = bt_stream_class_create("sc");
+	assert(sc);
+	ret = bt_stream_class_set_packet_context_type(sc, empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_header_type(sc, empty_struct_ft);
+	assert(ret == 0);
+	ec = bt_event_class_create("ec");
+	assert(ec);
+	ret = bt_stream_class_add_event_class(sc, ec);
+	assert(ret == 0);
+	ret = bt_trace_add_stream_class(trace, sc);
+	assert(ret == 0);
+	event = bt_event_create(ec);
+	assert(event);
+
+	ok(!bt_event_get_clock_value(event, cc),
+		"bt_event_get_clock_value() returns NULL when no value is set");
+	cv = bt_clock_value_create(cc, 1500);
+	assert(cv);
+	ret = bt_event_set_clock_value(event, cv);
+	ok(ret == 0, "bt_event_set_clock_value() succeeds");
+	bt_put(cv);
+	cv = bt_clock_value_create(other_cc, 1500);
+	assert(cv);
+	ret = bt_event_set_clock_value(event, cv);
+	ok(ret < 0,
+		"bt_event_set_clock_value() fails with a clock class which is not in the trace");
+	bt_put(cv);
+	ret_cv = bt_event_get_clock_value(event, cc);
+	ret_cc = bt_clock_value_get_class(ret_cv);
+	ok(ret_cc == cc, "bt_event_get_clock_value() returns a value of the right clock class");
+	ret = bt_clock_value_get_value(ret_cv, &value);
+	assert(ret == 0);
+	ret = bt_clock_value_get_value_ns_from_epoch(ret_cv, &ns);
+	ok(ret == 0 && value == 1500 && ns == INT64_C(3500000000),
+		"bt_event_get_clock_value() returns the value which was set");
+
+	/* The clock value keeps the event alive */
+	bt_put(event);
+	ret = bt_clock_value_get_value(ret_cv, &value);
+	ok(ret == 0 && value == 1500,
+		"clock value remains valid after putting its event");
+
+	bt_put(ret_cc);
+	bt_put(ret_cv);
+	bt_put(ec);
+	bt_put(sc);
+	bt_put(other_cc);
+	bt_put(cc);
+	bt_put(trace);
+	bt_put(empty_struct_ft);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	test_ns_from_epoch();
+	test_event_clock_value();
+	return exit_status();
+}
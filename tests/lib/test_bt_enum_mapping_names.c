@@ -0,0 +1,164 @@
+/*
+ * test_bt_enum_mapping_names.c
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <babeltrace/ref.h>
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/fields.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS	15
+
+/* Freezes `ft` by creating a field from it */
+static
+void freeze(struct bt_field_type *ft)
+{
+	struct bt_field *field = bt_field_create(ft);
+
+	assert(field);
+	bt_put(field);
+}
+
+/*
+ * Checks the overlapping mappings of the unsigned enumeration field type
+ * `ft`, which is frozen or not.
+ */
+static
+void test_unsigned(struct bt_field_type *ft, const char *what)
+{
+	const char *names[2];
+	int64_t count;
+
+	count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		ft, 14, names, 2);
+	ok(count == 3 && strcmp(names[0], "c") == 0 &&
+		strcmp(names[1], "d") == 0,
+		"%s: overlapping mappings are returned in order, count is the total", what);
+	count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		ft, 21, names, 2);
+	ok(count == 1 && strcmp(names[0], "e") == 0,
+		"%s: last value of a range", what);
+	count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		ft, 4, names, 2);
+	ok(count == 0, "%s: value between ranges", what);
+	count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		ft, UINT64_MAX, NULL, 0);
+	ok(count == 1, "%s: largest value, no names", what);
+	count = bt_field_type_enumeration_get_mapping_names_by_unsigned_value(
+		ft, 1000000, names, 2);
+	ok(count == 0, "%s: value after the last range", what);
+}
+
+static
+void test_unsigned_enum(void)
+{
+	struct bt_field_type *int_ft;
+	struct bt_field_type *ft;
+	const char *names[1];
+	int ret;
+
+	int_ft = bt_field_type_integer_create(64);
+	assert(int_ft);
+	ft = bt_field_type_enumeration_create(int_ft);
+	assert(ft);
+	ret = bt_field_type_enumeration_add_mapping_unsigned(ft, "a", 0, 0);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_add_mapping_unsigned(ft, "c", 5, 19);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_add_mapping_unsigned(ft, "d", 8, 15);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_add_mapping_unsigned(ft, "e", 10, 21);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_add_mapping_unsigned(ft, "max",
+		UINT64_MAX - 1, UINT64_MAX);
+	assert(ret == 0);
+
+	ok(bt_field_type_enumeration_get_mapping_names_by_signed_value(
+		ft, 14, names, 1) < 0,
+		"signed lookup fails with an unsigned enumeration field type");
+	test_unsigned(ft, "not frozen");
+	freeze(ft);
+	test_unsigned(ft, "frozen, sparse");
+	bt_put(ft);
+	bt_put(int_ft);
+}
+
+static
+void test_signed_enum(void)
+{
+	struct bt_field_type *int_ft;
+	struct bt_field_type *ft;
+	struct bt_field_type_enumeration_mapping_iterator *iter;
+	const char *names[2];
+	const char *name;
+	int64_t count;
+	int ret;
+
+	int_ft = bt_field_type_integer_create(32);
+	assert(int_ft);
+	ret = bt_field_type_integer_set_is_signed(int_ft, BT_TRUE);
+	assert(ret == 0);
+	ft = bt_field_type_enumeration_create(int_ft);
+	assert(ft);
+	ret = bt_field_type_enumeration_add_mapping_signed(ft, "neg", -10, -1);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_add_mapping_signed(ft, "around", -2, 2);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_add_mapping_signed(ft, "big", 300, 400);
+	assert(ret == 0);
+	freeze(ft);
+
+	count = bt_field_type_enumeration_get_mapping_names_by_signed_value(
+		ft, -1, names, 2);
+	ok(count == 2 && strcmp(names[0], "neg") == 0 &&
+		strcmp(names[1], "around") == 0,
+		"frozen, dense: negative value in overlapping ranges");
+	count = bt_field_type_enumeration_get_mapping_names_by_signed_value(
+		ft, -11, names, 2);
+	ok(count == 0, "frozen, dense: value before the first range");
+	count = bt_field_type_enumeration_get_mapping_names_by_signed_value(
+		ft, 400, names, 2);
+	ok(count == 1 && strcmp(names[0], "big") == 0,
+		"frozen, dense: last value of the last range");
+
+	iter = bt_field_type_enumeration_find_mappings_by_signed_value(ft, 0);
+	assert(iter);
+	ret = bt_field_type_enumeration_mapping_iterator_next(iter);
+	assert(ret == 0);
+	ret = bt_field_type_enumeration_mapping_iterator_get_signed(iter,
+		&name, NULL, NULL);
+	assert(ret == 0);
+	ok(strcmp(name, "around") == 0 &&
+		bt_field_type_enumeration_mapping_iterator_next(iter) < 0,
+		"mapping iterator of a frozen enumeration field type");
+	bt_put(iter);
+	bt_put(ft);
+	bt_put(int_ft);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	test_unsigned_enum();
+	test_signed_enum();
+	return exit_status();
+}
@@ -0,0 +1,205 @@
+/*
+ * test_bt_field_arena.c
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <babeltrace/ref.h>
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/fields.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS	11
+
+/*
+ * Creates the type of:
+ *
+ *     struct {
+ *         uint32_t a;
+ *         string s;
+ *         struct {
+ *             uint8_t x[4];
+ *         } inner;
+ *         uint8_t big[1000000];
+ *     }
+ *
+ * `big` is too large for its elements to be part of its field tree's
+ * arena.
+ */
+static
+struct bt_field_type *create_root_ft(void)
+{
+	struct bt_field_type *root_ft;
+	struct bt_field_type *inner_ft;
+	struct bt_field_type *u8_ft;
+	struct bt_field_type *u32_ft;
+	struct bt_field_type *string_ft;
+	struct bt_field_type *array_ft;
+	int ret;
+
+	u8_ft = bt_field_type_integer_create(8);
+	assert(u8_ft);
+	u32_ft = bt_field_type_integer_create(32);
+	assert(u32_ft);
+	string_ft = bt_field_type_string_create();
+	assert(string_ft);
+	inner_ft = bt_field_type_structure_create();
+	assert(inner_ft);
+	array_ft = bt_field_type_array_create(u8_ft, 4);
+	assert(array_ft);
+	ret = bt_field_type_structure_add_field(inner_ft, array_ft, "x");
+	assert(ret == 0);
+	BT_PUT(array_ft);
+	root_ft = bt_field_type_structure_create();
+	assert(root_ft);
+	ret = bt_field_type_structure_add_field(root_ft, u32_ft, "a");
+	assert(ret == 0);
+	ret = bt_field_type_structure_add_field(root_ft, string_ft, "s");
+	assert(ret == 0);
+	ret = bt_field_type_structure_add_field(root_ft, inner_ft, "inner");
+	assert(ret == 0);
+	array_ft = bt_field_type_array_create(u8_ft, 1000000);
+	assert(array_ft);
+	ret = bt_field_type_structure_add_field(root_ft, array_ft, "big");
+	assert(ret == 0);
+	bt_put(array_ft);
+	bt_put(inner_ft);
+	bt_put(string_ft);
+	bt_put(u32_ft);
+	bt_put(u8_ft);
+	return root_ft;
+}
+
+/* Returns the element `index` of the `x` array of the `inner` field. */
+static
+struct bt_field *get_inner_x_elem(struct bt_field *root, uint64_t index)
+{
+	struct bt_field *inner;
+	struct bt_field *x;
+	struct bt_field *elem;
+
+	inner = bt_field_structure_get_field_by_name(root, "inner");
+	assert(inner);
+	x = bt_field_structure_get_field_by_name(inner, "x");
+	assert(x);
+	elem = bt_field_array_get_field(x, index);
+	bt_put(x);
+	bt_put(inner);
+	return elem;
+}
+
+static
+void test_field_arena(void)
+{
+	struct bt_field_type *root_ft;
+	struct bt_field *root;
+	struct bt_field *root_copy;
+	struct bt_field *a;
+	struct bt_field *s;
+	struct bt_field *elem;
+	struct bt_field *big_elem;
+	struct bt_field *big;
+	struct bt_field *new_a;
+	struct bt_field_type *u32_ft;
+	uint64_t uval;
+	int ret;
+
+	root_ft = create_root_ft();
+	root = bt_field_create(root_ft);
+	ok(root, "bt_field_create() succeeds with a compound type");
+	a = bt_field_structure_get_field_by_name(root, "a");
+	s = bt_field_structure_get_field_by_name(root, "s");
+	elem = get_inner_x_elem(root, 3);
+	ok(a && s && elem, "contained fields exist after creation");
+	ret = bt_field_unsigned_integer_set_value(a, 23);
+	assert(ret == 0);
+	ret = bt_field_string_set_value(s, "hello");
+	assert(ret == 0);
+	ret = bt_field_unsigned_integer_set_value(elem, 42);
+	assert(ret == 0);
+	big = bt_field_structure_get_field_by_name(root, "big");
+	assert(big);
+	big_elem = bt_field_array_get_field(big, 999999);
+	ok(big_elem, "elements of a large array are created on demand");
+	ret = bt_field_unsigned_integer_set_value(big_elem, 7);
+	assert(ret == 0);
+	BT_PUT(big_elem);
+	BT_PUT(big);
+
+	/* Copy */
+	root_copy = bt_field_copy(root);
+	ok(root_copy, "bt_field_copy() succeeds");
+	BT_PUT(elem);
+	elem = get_inner_x_elem(root_copy, 3);
+	ret = bt_field_unsigned_integer_get_value(elem, &uval);
+	ok(ret == 0 && uval == 42, "copy contains the values of the original");
+	BT_PUT(elem);
+	big = bt_field_structure_get_field_by_name(root_copy, "big");
+	assert(big);
+	big_elem = bt_field_array_get_field(big, 999999);
+	assert(big_elem);
+	ret = bt_field_unsigned_integer_get_value(big_elem, &uval);
+	ok(ret == 0 && uval == 7,
+		"copy contains the values of the original's large array");
+	BT_PUT(big_elem);
+	BT_PUT(big);
+	BT_PUT(root_copy);
+
+	/* Replace a contained field */
+	u32_ft = bt_field_get_type(a);
+	assert(u32_ft);
+	new_a = bt_field_create(u32_ft);
+	assert(new_a);
+	ret = bt_field_unsigned_integer_set_value(new_a, 1984);
+	assert(ret == 0);
+	ret = bt_field_structure_set_field_by_name(root, "a", new_a);
+	ok(ret == 0, "contained field can be replaced");
+	BT_PUT(new_a);
+	new_a = bt_field_structure_get_field_by_name(root, "a");
+	ret = bt_field_unsigned_integer_get_value(new_a, &uval);
+	ok(ret == 0 && uval == 1984, "replacing field is contained");
+
+	/* Contained fields outlive their root */
+	elem = get_inner_x_elem(root, 3);
+	assert(elem);
+	BT_PUT(root);
+	ret = bt_field_unsigned_integer_get_value(a, &uval);
+	ok(ret == 0 && uval == 23,
+		"replaced field remains valid after putting its former root");
+	ok(strcmp(bt_field_string_get_value(s), "hello") == 0,
+		"contained string field remains valid after putting its root");
+	ret = bt_field_unsigned_integer_get_value(elem, &uval);
+	ok(ret == 0 && uval == 42,
+		"nested array element remains valid after putting its root");
+
+	bt_put(elem);
+	bt_put(new_a);
+	bt_put(u32_ft);
+	bt_put(s);
+	bt_put(a);
+	bt_put(root_ft);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	test_field_arena();
+	return exit_status();
+}
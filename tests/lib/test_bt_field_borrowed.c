@@ -0,0 +1,218 @@
+/*
+ * test_bt_field_borrowed.c
+ *
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <babeltrace/ref.h>
+#include <babeltrace/values.h>
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/fields.h>
+#include <babeltrace/object-internal.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS	23
+
+static
+void test_string(struct bt_value *owner)
+{
+	static const char bytes[] = "hello\0garbage";
+	struct bt_field_type *ft;
+	struct bt_field *field;
+	struct bt_field *copy;
+	int ret;
+
+	ft = bt_field_type_string_create();
+	assert(ft);
+	field = bt_field_create(ft);
+	assert(field);
+
+	ret = bt_field_string_set_borrowed_value(field, bytes, 3, owner);
+	ok(ret < 0 && bt_object_get_ref_count(owner) == 1,
+		"bt_field_string_set_borrowed_value() fails with a value which is not null-terminated");
+	ret = bt_field_string_set_borrowed_value(field, bytes, 5, owner);
+	ok(ret == 0, "bt_field_string_set_borrowed_value() succeeds");
+	ok(bt_field_string_get_value(field) == bytes,
+		"bt_field_string_get_value() returns the borrowed value");
+	ok(bt_object_get_ref_count(owner) == 2,
+		"string field holds a reference on the owner");
+
+	copy = bt_field_copy(field);
+	assert(copy);
+	ok(bt_field_string_get_value(copy) != bytes &&
+		strcmp(bt_field_string_get_value(copy), "hello") == 0,
+		"string field copy owns a copy of the borrowed value");
+	ok(bt_object_get_ref_count(owner) == 2,
+		"string field copy does not hold a reference on the owner");
+	BT_PUT(copy);
+
+	ret = bt_field_string_append(field, " world");
+	assert(ret == 0);
+	ok(strcmp(bt_field_string_get_value(field), "hello world") == 0,
+		"appending to a borrowed value copies it first");
+	ok(bt_object_get_ref_count(owner) == 1,
+		"string field releases the owner when it copies the value");
+
+	ret = bt_field_string_set_borrowed_value(field, bytes, 5, owner);
+	assert(ret == 0);
+	ret = bt_field_string_set_value(field, "other");
+	assert(ret == 0);
+	ok(strcmp(bt_field_string_get_value(field), "other") == 0 &&
+		bt_object_get_ref_count(owner) == 1,
+		"setting a value releases the owner");
+
+	ret = bt_field_string_set_borrowed_value(field, bytes, 5, owner);
+	assert(ret == 0);
+	BT_PUT(field);
+	ok(bt_object_get_ref_count(owner) == 1,
+		"destroying a string field releases the owner");
+	bt_put(ft);
+}
+
+static
+void test_array(struct bt_value *owner)
+{
+	static const uint8_t bytes[] = { 23, 0xff, 42, 0 };
+	struct bt_field_type *s8_ft;
+	struct bt_field_type *s32_ft;
+	struct bt_field_type *array_ft;
+	struct bt_field_type *bad_array_ft;
+	struct bt_field *field;
+	struct bt_field *bad_field;
+	struct bt_field *elem;
+	int64_t value;
+	int ret;
+
+	s8_ft = bt_field_type_integer_create(8);
+	assert(s8_ft);
+	ret = bt_field_type_integer_set_is_signed(s8_ft, BT_TRUE);
+	assert(ret == 0);
+	s32_ft = bt_field_type_integer_create(32);
+	assert(s32_ft);
+	array_ft = bt_field_type_array_create(s8_ft, 4);
+	assert(array_ft);
+	bad_array_ft = bt_field_type_array_create(s32_ft, 4);
+	assert(bad_array_ft);
+	field = bt_field_create(array_ft);
+	assert(field);
+	bad_field = bt_field_create(bad_array_ft);
+	assert(bad_field);
+
+	ret = bt_field_array_set_borrowed_bytes(bad_field, bytes, owner);
+	ok(ret < 0,
+		"bt_field_array_set_borrowed_bytes() fails with 32-bit elements");
+	ret = bt_field_array_set_borrowed_bytes(field, bytes, owner);
+	ok(ret == 0, "bt_field_array_set_borrowed_bytes() succeeds");
+	ok(bt_field_array_get_borrowed_bytes(field) == bytes,
+		"bt_field_array_get_borrowed_bytes() returns the borrowed bytes");
+	ok(bt_field_is_set(field), "array field referring to bytes is set");
+
+	elem = bt_field_array_get_field(field, 1);
+	assert(elem);
+	ret = bt_field_signed_integer_get_value(elem, &value);
+	ok(ret == 0 && value == -1,
+		"element field is created from the borrowed bytes");
+	bt_put(elem);
+	ok(!bt_field_array_get_borrowed_bytes(field) &&
+		bt_object_get_ref_count(owner) == 1,
+		"getting an element field releases the borrowed bytes");
+
+	bt_put(bad_field);
+	bt_put(field);
+	bt_put(bad_array_ft);
+	bt_put(array_ft);
+	bt_put(s32_ft);
+	bt_put(s8_ft);
+}
+
+static
+void test_sequence(struct bt_value *owner)
+{
+	static const uint8_t bytes[] = { 23, 0xff, 42 };
+	struct bt_field_type *u8_ft;
+	struct bt_field_type *seq_ft;
+	struct bt_field *field;
+	struct bt_field *length;
+	struct bt_field *copy;
+	struct bt_field *elem;
+	uint64_t value;
+	int ret;
+
+	u8_ft = bt_field_type_integer_create(8);
+	assert(u8_ft);
+	seq_ft = bt_field_type_sequence_create(u8_ft, "len");
+	assert(seq_ft);
+	field = bt_field_create(seq_ft);
+	assert(field);
+	length = bt_field_create(u8_ft);
+	assert(length);
+	ret = bt_field_unsigned_integer_set_value(length, 3);
+	assert(ret == 0);
+
+	ret = bt_field_sequence_set_borrowed_bytes(field, bytes, owner);
+	ok(ret < 0,
+		"bt_field_sequence_set_borrowed_bytes() fails without a length");
+	ret = bt_field_sequence_set_length(field, length);
+	assert(ret == 0);
+	ret = bt_field_sequence_set_borrowed_bytes(field, bytes, owner);
+	ok(ret == 0, "bt_field_sequence_set_borrowed_bytes() succeeds");
+	ok(bt_field_sequence_get_borrowed_bytes(field) == bytes,
+		"bt_field_sequence_get_borrowed_bytes() returns the borrowed bytes");
+
+	copy = bt_field_copy(field);
+	assert(copy);
+	ok(!bt_field_sequence_get_borrowed_bytes(copy) &&
+		bt_object_get_ref_count(owner) == 2,
+		"sequence field copy does not refer to the borrowed bytes");
+	elem = bt_field_sequence_get_field(copy, 1);
+	assert(elem);
+	ret = bt_field_unsigned_integer_get_value(elem, &value);
+	ok(ret == 0 && value == 0xff,
+		"sequence field copy's element field has the borrowed byte's value");
+	bt_put(elem);
+	bt_put(copy);
+	ok(bt_field_sequence_get_borrowed_bytes(field) == bytes,
+		"copying a sequence field keeps its borrowed bytes");
+
+	ret = bt_field_sequence_set_length(field, length);
+	assert(ret == 0);
+	ok(!bt_field_sequence_get_borrowed_bytes(field) &&
+		bt_object_get_ref_count(owner) == 1,
+		"setting the length releases the borrowed bytes");
+
+	bt_put(length);
+	bt_put(field);
+	bt_put(seq_ft);
+	bt_put(u8_ft);
+}
+
+int main(int argc, char **argv)
+{
+	struct bt_value *owner;
+
+	plan_tests(NR_TESTS);
+	owner = bt_value_integer_create();
+	assert(owner);
+	test_string(owner);
+	test_array(owner);
+	test_sequence(owner);
+	bt_put(owner);
+	return exit_status();
+}
@@ -59,7 +59,7 @@
 
 #include "tap/tap.h"
 
-#define NR_TESTS	31
+#define NR_TESTS	43
 
 enum test {
 	TEST_NO_AUTO_NOTIFS,
@@ -75,6 +75,8 @@ enum test {
 	TEST_MULTIPLE_AUTO_STREAM_END_FROM_END,
 	TEST_MULTIPLE_AUTO_PACKET_END_STREAM_END_FROM_END,
 	TEST_OUTPUT_PORT_NOTIFICATION_ITERATOR,
+	TEST_MANY_EVENTS,
+	TEST_NEXT_BATCH,
 };
 
 enum test_event_type {
@@ -96,6 +98,8 @@ struct test_event {
 };
 
 static bool debug = false;
+static bool threaded_graph = false;
+static bool trusted_source = false;
 static enum test current_test;
 static GArray *test_events;
 static struct bt_clock_class_priority_map *src_empty_cc_prio_map;
@@ -127,6 +131,7 @@ enum {
 	SEQ_EVENT_STREAM2_PACKET1 = -16,
 	SEQ_EVENT_STREAM2_PACKET2 = -17,
 	SEQ_INACTIVITY = -18,
+	SEQ_AGAIN = -19,
 };
 
 struct src_iter_user_data {
@@ -138,6 +143,28 @@ struct sink_user_data {
 	struct bt_notification_iterator *notif_iter;
 };
 
+/* Status and notification count of a "next batch" call of the sink */
+struct batch_result {
+	enum bt_notification_iterator_status status;
+	uint64_t count;
+};
+
+#define SINK_MAX_BATCH_CAPACITY	8
+
+/*
+ * Capacity of the sink's notification array (at most
+ * SINK_MAX_BATCH_CAPACITY) when it gets its notifications with
+ * bt_notification_iterator_next_batch(), or 0 if it uses
+ * bt_notification_iterator_next().
+ */
+static uint64_t sink_batch_capacity;
+
+/* Notification types to which the sink subscribes (NULL: all) */
+static const enum bt_notification_type *sink_notification_types;
+
+/* Results of the sink's "next batch" calls */
+static GArray *batch_results;
+
 /*
  * No automatic notifications generated in this block.
  * Stream 2 notifications are more indented.
@@ -267,6 +294,37 @@ static int64_t seq_multiple_auto_packet_end_stream_end_from_end[] = {
 	SEQ_END,
 };
 
+/*
+ * Many events in a single packet, so that the worker thread of a
+ * threaded graph and the consumer thread get and put the references of
+ * the same objects (packet, stream, classes) at the same time. Filled
+ * by init_static_data().
+ */
+#define MANY_EVENTS_COUNT	10000
+
+static int64_t seq_many_events[MANY_EVENTS_COUNT + 5];
+
+/*
+ * Delivered by the source's "next batch" method: each batch ends at
+ * SEQ_AGAIN, where this method returns
+ * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN, or at SEQ_END.
+ */
+static int64_t seq_next_batch[] = {
+	SEQ_STREAM1_BEGIN,
+	SEQ_STREAM1_PACKET1_BEGIN,
+	SEQ_EVENT_STREAM1_PACKET1,
+	SEQ_EVENT_STREAM1_PACKET1,
+	SEQ_AGAIN,
+	SEQ_EVENT_STREAM1_PACKET1,
+	/* Automatic "packet end" here */
+	/* Automatic "packet begin" here */
+	SEQ_EVENT_STREAM1_PACKET2,
+	SEQ_EVENT_STREAM1_PACKET2,
+	SEQ_STREAM1_PACKET2_END,
+	SEQ_STREAM1_END,
+	SEQ_END,
+};
+
 static
 void clear_test_events(void)
 {
@@ -395,12 +453,27 @@ static
 void init_static_data(void)
 {
 	int ret;
+	size_t i;
 	struct bt_trace *trace;
 	struct bt_field_type *empty_struct_ft;
 
+	/* Many events sequence */
+	seq_many_events[0] = SEQ_STREAM1_BEGIN;
+	seq_many_events[1] = SEQ_STREAM1_PACKET1_BEGIN;
+
+	for (i = 0; i < MANY_EVENTS_COUNT; i++) {
+		seq_many_events[i + 2] = SEQ_EVENT_STREAM1_PACKET1;
+	}
+
+	seq_many_events[MANY_EVENTS_COUNT + 2] = SEQ_STREAM1_PACKET1_END;
+	seq_many_events[MANY_EVENTS_COUNT + 3] = SEQ_STREAM1_END;
+	seq_many_events[MANY_EVENTS_COUNT + 4] = SEQ_END;
+
 	/* Test events */
 	test_events = g_array_new(FALSE, TRUE, sizeof(struct test_event));
 	assert(test_events);
+	batch_results = g_array_new(FALSE, TRUE, sizeof(struct batch_result));
+	assert(batch_results);
 
 	/* Metadata */
 	empty_struct_ft = bt_field_type_structure_create();
@@ -465,6 +538,7 @@ void fini_static_data(void)
 {
 	/* Test events */
 	g_array_free(test_events, TRUE);
+	g_array_free(batch_results, TRUE);
 
 	/* Metadata */
 	bt_put(src_empty_cc_prio_map);
@@ -543,6 +617,12 @@ enum bt_notification_iterator_status src_iter_init(
 	case TEST_MULTIPLE_AUTO_PACKET_END_STREAM_END_FROM_END:
 		user_data->seq = seq_multiple_auto_packet_end_stream_end_from_end;
 		break;
+	case TEST_MANY_EVENTS:
+		user_data->seq = seq_many_events;
+		break;
+	case TEST_NEXT_BATCH:
+		user_data->seq = seq_next_batch;
+		break;
 	default:
 		abort();
 	}
@@ -694,6 +774,49 @@ struct bt_notification_iterator_next_method_return src_iter_next(
 	return next_return;
 }
 
+static
+enum bt_notification_iterator_status src_iter_next_batch(
+		struct bt_private_connection_private_notification_iterator *priv_iterator,
+		struct bt_notification **notifications, uint64_t capacity,
+		uint64_t *count)
+{
+	struct src_iter_user_data *user_data =
+		bt_private_connection_private_notification_iterator_get_user_data(priv_iterator);
+	enum bt_notification_iterator_status status =
+		BT_NOTIFICATION_ITERATOR_STATUS_OK;
+
+	assert(user_data);
+	*count = 0;
+
+	while (*count < capacity) {
+		struct bt_notification_iterator_next_method_return next_return;
+
+		if (user_data->seq[user_data->at] == SEQ_AGAIN) {
+			if (*count == 0) {
+				user_data->at++;
+				status = BT_NOTIFICATION_ITERATOR_STATUS_AGAIN;
+			}
+
+			break;
+		}
+
+		if (user_data->seq[user_data->at] == SEQ_END && *count > 0) {
+			break;
+		}
+
+		next_return = src_iter_next_seq(user_data);
+		if (next_return.status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			status = next_return.status;
+			break;
+		}
+
+		notifications[*count] = next_return.notification;
+		(*count)++;
+	}
+
+	return status;
+}
+
 static
 enum bt_component_status src_init(
 		struct bt_private_component *private_component,
@@ -713,91 +836,97 @@ void src_finalize(struct bt_private_component *private_component)
 }
 
 static
-enum bt_notification_iterator_status common_consume(
-		struct bt_notification_iterator *notif_iter)
+void init_test_event_from_notification(struct test_event *test_event,
+		struct bt_notification *notification)
 {
-	enum bt_notification_iterator_status ret;
-	struct bt_notification *notification = NULL;
-	struct test_event test_event = { 0 };
-	bool do_append_test_event = true;
-	assert(notif_iter);
-
-	ret = bt_notification_iterator_next(notif_iter);
-	if (ret < 0) {
-		do_append_test_event = false;
-		goto end;
-	}
-
-	switch (ret) {
-	case BT_NOTIFICATION_ITERATOR_STATUS_END:
-		test_event.type = TEST_EV_TYPE_END;
-		goto end;
-	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
-		abort();
-	default:
-		break;
-	}
-
-	notification = bt_notification_iterator_get_notification(
-		notif_iter);
-	assert(notification);
-
 	switch (bt_notification_get_type(notification)) {
 	case BT_NOTIFICATION_TYPE_EVENT:
 	{
 		struct bt_event *event;
 
-		test_event.type = TEST_EV_TYPE_NOTIF_EVENT;
+		test_event->type = TEST_EV_TYPE_NOTIF_EVENT;
 		event = bt_notification_event_get_event(notification);
 		assert(event);
-		test_event.packet = bt_event_get_packet(event);
+		test_event->packet = bt_event_get_packet(event);
 		bt_put(event);
-		assert(test_event.packet);
-		bt_put(test_event.packet);
+		assert(test_event->packet);
+		bt_put(test_event->packet);
 		break;
 	}
 	case BT_NOTIFICATION_TYPE_INACTIVITY:
-		test_event.type = TEST_EV_TYPE_NOTIF_INACTIVITY;
+		test_event->type = TEST_EV_TYPE_NOTIF_INACTIVITY;
 		break;
 	case BT_NOTIFICATION_TYPE_STREAM_BEGIN:
-		test_event.type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN;
-		test_event.stream =
+		test_event->type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN;
+		test_event->stream =
 			bt_notification_stream_begin_get_stream(notification);
-		assert(test_event.stream);
-		bt_put(test_event.stream);
+		assert(test_event->stream);
+		bt_put(test_event->stream);
 		break;
 	case BT_NOTIFICATION_TYPE_STREAM_END:
-		test_event.type = TEST_EV_TYPE_NOTIF_STREAM_END;
-		test_event.stream =
+		test_event->type = TEST_EV_TYPE_NOTIF_STREAM_END;
+		test_event->stream =
 			bt_notification_stream_end_get_stream(notification);
-		assert(test_event.stream);
-		bt_put(test_event.stream);
+		assert(test_event->stream);
+		bt_put(test_event->stream);
 		break;
 	case BT_NOTIFICATION_TYPE_PACKET_BEGIN:
-		test_event.type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN;
-		test_event.packet =
+		test_event->type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN;
+		test_event->packet =
 			bt_notification_packet_begin_get_packet(notification);
-		assert(test_event.packet);
-		bt_put(test_event.packet);
+		assert(test_event->packet);
+		bt_put(test_event->packet);
 		break;
 	case BT_NOTIFICATION_TYPE_PACKET_END:
-		test_event.type = TEST_EV_TYPE_NOTIF_PACKET_END;
-		test_event.packet =
+		test_event->type = TEST_EV_TYPE_NOTIF_PACKET_END;
+		test_event->packet =
 			bt_notification_packet_end_get_packet(notification);
-		assert(test_event.packet);
-		bt_put(test_event.packet);
+		assert(test_event->packet);
+		bt_put(test_event->packet);
 		break;
 	default:
-		test_event.type = TEST_EV_TYPE_NOTIF_UNEXPECTED;
+		test_event->type = TEST_EV_TYPE_NOTIF_UNEXPECTED;
 		break;
 	}
 
-	if (test_event.packet) {
-		test_event.stream = bt_packet_get_stream(test_event.packet);
-		assert(test_event.stream);
-		bt_put(test_event.stream);
+	if (test_event->packet) {
+		test_event->stream = bt_packet_get_stream(test_event->packet);
+		assert(test_event->stream);
+		bt_put(test_event->stream);
+	}
+}
+
+static
+enum bt_notification_iterator_status common_consume(
+		struct bt_notification_iterator *notif_iter)
+{
+	enum bt_notification_iterator_status ret;
+	struct bt_notification *notification = NULL;
+	struct test_event test_event = { 0 };
+	bool do_append_test_event = true;
+	assert(notif_iter);
+
+	ret = bt_notification_iterator_next(notif_iter);
+	if (ret < 0) {
+		do_append_test_event = false;
+		goto end;
+	}
+
+	switch (ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+		test_event.type = TEST_EV_TYPE_END;
+		goto end;
+	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		abort();
+	default:
+		break;
 	}
 
+	notification = bt_notification_iterator_get_notification(
+		notif_iter);
+	assert(notification);
+	init_test_event_from_notification(&test_event, notification);
+
 end:
 	if (do_append_test_event) {
 		append_test_event(&test_event);
@@ -807,6 +936,38 @@ end:
 	return ret;
 }
 
+static
+enum bt_notification_iterator_status batch_consume(
+		struct bt_notification_iterator *notif_iter)
+{
+	struct bt_notification *notifications[SINK_MAX_BATCH_CAPACITY];
+	struct batch_result result;
+	uint64_t i;
+
+	assert(notif_iter);
+	assert(sink_batch_capacity <= SINK_MAX_BATCH_CAPACITY);
+	result.status = bt_notification_iterator_next_batch(notif_iter,
+		notifications, sink_batch_capacity, &result.count);
+	g_array_append_val(batch_results, result);
+
+	for (i = 0; i < result.count; i++) {
+		struct test_event test_event = { 0 };
+
+		init_test_event_from_notification(&test_event,
+			notifications[i]);
+		append_test_event(&test_event);
+		bt_put(notifications[i]);
+	}
+
+	if (result.status == BT_NOTIFICATION_ITERATOR_STATUS_END) {
+		struct test_event test_event = { .type = TEST_EV_TYPE_END };
+
+		append_test_event(&test_event);
+	}
+
+	return result.status;
+}
+
 static
 enum bt_component_status sink_consume(
 		struct bt_private_component *priv_component)
@@ -817,7 +978,12 @@ enum bt_component_status sink_consume(
 	enum bt_notification_iterator_status it_ret;
 
 	assert(user_data && user_data->notif_iter);
-	it_ret = common_consume(user_data->notif_iter);
+
+	if (sink_batch_capacity > 0) {
+		it_ret = batch_consume(user_data->notif_iter);
+	} else {
+		it_ret = common_consume(user_data->notif_iter);
+	}
 
 	if (it_ret < 0) {
 		ret = BT_COMPONENT_STATUS_ERROR;
@@ -830,7 +996,10 @@ enum bt_component_status sink_consume(
 		BT_PUT(user_data->notif_iter);
 		goto end;
 	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
-		abort();
+		/* Only the source's "next batch" method returns this */
+		assert(sink_batch_capacity > 0);
+		ret = BT_COMPONENT_STATUS_AGAIN;
+		goto end;
 	default:
 		break;
 	}
@@ -853,7 +1022,7 @@ void sink_port_connected(struct bt_private_component *private_component,
 	assert(user_data);
 	assert(priv_conn);
 	conn_status = bt_private_connection_create_notification_iterator(
-		priv_conn, NULL, &user_data->notif_iter);
+		priv_conn, sink_notification_types, &user_data->notif_iter);
 	assert(conn_status == 0);
 	bt_put(priv_conn);
 }
@@ -913,6 +1082,16 @@ void create_source_sink(struct bt_graph *graph, struct bt_component **source,
 		ret = bt_component_class_source_set_notification_iterator_finalize_method(
 			src_comp_class, src_iter_finalize);
 		assert(ret == 0);
+
+		if (current_test == TEST_NEXT_BATCH) {
+			ret = bt_component_class_source_set_notification_iterator_next_batch_method(
+				src_comp_class, src_iter_next_batch);
+			assert(ret == 0);
+		}
+
+		ret = bt_component_class_set_trusted(src_comp_class,
+			trusted_source);
+		assert(ret == 0);
 		ret = bt_graph_add_component(graph, src_comp_class, "source",
 			NULL, source);
 		assert(ret == 0);
@@ -955,6 +1134,12 @@ void do_std_test(enum test test, const char *name,
 	diag("test: %s", name);
 	graph = bt_graph_create();
 	assert(graph);
+
+	if (threaded_graph) {
+		graph_status = bt_graph_set_threaded(graph, BT_TRUE);
+		assert(graph_status == BT_GRAPH_STATUS_OK);
+	}
+
 	create_source_sink(graph, &src_comp, &sink_comp);
 
 	/* Connect source to sink */
@@ -1014,6 +1199,52 @@ void test_no_auto_notifs(void)
 		expected_test_events);
 }
 
+static
+void test_no_auto_notifs_trusted(void)
+{
+	diag("running the next test with a trusted source component class");
+	trusted_source = true;
+	test_no_auto_notifs();
+	trusted_source = false;
+}
+
+/*
+ * Threaded graphs enable atomic reference counting for the rest of the
+ * process's lifetime: the threaded tests must be the last ones.
+ */
+static
+void test_no_auto_notifs_threaded(void)
+{
+	diag("running the next test with a threaded graph");
+	threaded_graph = true;
+	test_no_auto_notifs();
+	threaded_graph = false;
+}
+
+static
+void test_many_events_threaded(void)
+{
+	uint64_t event_count = 0;
+	size_t i;
+
+	threaded_graph = true;
+	do_std_test(TEST_MANY_EVENTS, "many events with a threaded graph",
+		NULL);
+	threaded_graph = false;
+
+	for (i = 0; i < test_events->len; i++) {
+		const struct test_event *test_event =
+			&g_array_index(test_events, struct test_event, i);
+
+		if (test_event->type == TEST_EV_TYPE_NOTIF_EVENT) {
+			event_count++;
+		}
+	}
+
+	ok(event_count == MANY_EVENTS_COUNT,
+		"the sink receives all the events of the worker thread");
+}
+
 static
 void test_auto_stream_begin_from_packet_begin(void)
 {
@@ -1485,6 +1716,123 @@ void test_output_port_notification_iterator_cannot_consume(void)
 	bt_put(notif_iter);
 }
 
+/*
+ * Runs the graph with a sink which gets its notifications with
+ * bt_notification_iterator_next_batch() (array of `capacity`
+ * notifications, subscribed to `notification_types`) and checks the
+ * results of its calls, the last one being
+ * BT_NOTIFICATION_ITERATOR_STATUS_END.
+ */
+static
+void do_next_batch_test(const char *name, uint64_t capacity,
+		const enum bt_notification_type *notification_types,
+		const struct test_event *expected_test_events,
+		const struct batch_result *expected_results)
+{
+	bool expected = true;
+	size_t i = 0;
+
+	g_array_set_size(batch_results, 0);
+	sink_batch_capacity = capacity;
+	sink_notification_types = notification_types;
+	do_std_test(TEST_NEXT_BATCH, name, expected_test_events);
+	sink_batch_capacity = 0;
+	sink_notification_types = NULL;
+
+	while (true) {
+		const struct batch_result *result;
+
+		if (i >= batch_results->len) {
+			expected = false;
+			break;
+		}
+
+		result = &g_array_index(batch_results, struct batch_result, i);
+		if (debug) {
+			fprintf(stderr, ":: Batch result: status=%d, count=%" PRIu64 "\n",
+				result->status, result->count);
+		}
+
+		if (result->status != expected_results[i].status ||
+				result->count != expected_results[i].count) {
+			expected = false;
+			break;
+		}
+
+		if (result->status == BT_NOTIFICATION_ITERATOR_STATUS_END) {
+			expected = i == batch_results->len - 1;
+			break;
+		}
+
+		i++;
+	}
+
+	ok(expected,
+		"bt_notification_iterator_next_batch() returns the expected batches");
+}
+
+static
+void test_next_batch(void)
+{
+	const struct test_event expected_test_events[] = {
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_BEGIN, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_BEGIN, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_PACKET_END, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_STREAM_END, .stream = src_stream1, .packet = NULL, },
+		{ .type = TEST_EV_TYPE_END, },
+		{ .type = TEST_EV_TYPE_SENTINEL, },
+	};
+	const struct batch_result expected_results[] = {
+		/* First batch of the source: 4 notifications */
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 3 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 1 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_AGAIN, 0 },
+		/* Second batch: 5 notifications + 2 automatic ones */
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 3 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 3 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 1 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_END, 0 },
+	};
+
+	do_next_batch_test("\"next batch\" with partial batches and automatic notifs.",
+		3, NULL, expected_test_events, expected_results);
+}
+
+static
+void test_next_batch_subscribe_events(void)
+{
+	const struct test_event expected_test_events[] = {
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet1, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_NOTIF_EVENT, .stream = src_stream1, .packet = src_stream1_packet2, },
+		{ .type = TEST_EV_TYPE_END, },
+		{ .type = TEST_EV_TYPE_SENTINEL, },
+	};
+	const enum bt_notification_type notification_types[] = {
+		BT_NOTIFICATION_TYPE_EVENT,
+		BT_NOTIFICATION_TYPE_SENTINEL,
+	};
+	const struct batch_result expected_results[] = {
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 2 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_AGAIN, 0 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_OK, 3 },
+		{ BT_NOTIFICATION_ITERATOR_STATUS_END, 0 },
+	};
+
+	do_next_batch_test("\"next batch\" with event subscription",
+		SINK_MAX_BATCH_CAPACITY, notification_types,
+		expected_test_events, expected_results);
+}
+
 #define DEBUG_ENV_VAR	"TEST_BT_NOTIFICATION_ITERATOR_DEBUG"
 
 int main(int argc, char **argv)
@@ -1510,6 +1858,11 @@ int main(int argc, char **argv)
 	test_output_port_notification_iterator();
 	test_output_port_notification_iterator_subscribe_events();
 	test_output_port_notification_iterator_cannot_consume();
+	test_next_batch();
+	test_next_batch_subscribe_events();
+	test_no_auto_notifs_trusted();
+	test_no_auto_notifs_threaded();
+	test_many_events_threaded();
 	fini_static_data();
 	return exit_status();
 }
@@ -34,7 +34,7 @@
 #include <assert.h>
 #include "common.h"
 
-#define NR_TESTS 41
+#define NR_TESTS 45
 
 struct user {
 	struct bt_ctf_writer *writer;
@@ -689,6 +689,63 @@ static void test_put_order(void)
 	test_put_order_permute(array, USER_NR_ELEMENTS, USER_NR_ELEMENTS);
 }
 
+static void test_event_recycling(void)
+{
+	int ret;
+	uint64_t value;
+	struct bt_stream_class *sc;
+	struct bt_event_class *ec;
+	struct bt_event *event;
+	struct bt_event *weak_event;
+	struct bt_field *payload;
+	struct bt_field *weak_payload;
+	struct bt_field *field;
+
+	sc = bt_stream_class_create_empty("sc");
+	assert(sc);
+	ec = create_simple_event("ec");
+	assert(ec);
+	ret = bt_stream_class_add_event_class(sc, ec);
+	assert(!ret);
+	event = bt_event_create(ec);
+	assert(event);
+	field = bt_event_get_payload(event, "payload_8");
+	assert(field);
+	ret = bt_field_unsigned_integer_set_value(field, 23);
+	assert(!ret);
+	BT_PUT(field);
+	weak_event = event;
+	weak_payload = bt_event_get_event_payload(event);
+	assert(weak_payload);
+	bt_put(weak_payload);
+	BT_PUT(event);
+
+	event = bt_event_create(ec);
+	ok(event == weak_event,
+		"Released event is recycled by its event class");
+	payload = bt_event_get_event_payload(event);
+	ok(payload == weak_payload,
+		"Recycled event reuses its exclusive payload field");
+	field = bt_event_get_payload(event, "payload_8");
+	assert(field);
+	ok(bt_field_unsigned_integer_get_value(field, &value),
+		"Recycled event's payload field is reset");
+	BT_PUT(field);
+
+	/* Keep the payload field while the event is recycled */
+	BT_PUT(event);
+	event = bt_event_create(ec);
+	assert(event);
+	field = bt_event_get_event_payload(event);
+	ok(field && field != payload,
+		"Recycled event does not reuse a shared payload field");
+	BT_PUT(field);
+	BT_PUT(payload);
+	BT_PUT(event);
+	BT_PUT(ec);
+	BT_PUT(sc);
+}
+
 /**
  * The objective of this test is to implement and expand upon the scenario
  * described in the reference counting documentation and ensure that any node of
@@ -705,6 +762,7 @@ int main(int argc, char **argv)
 
 	test_example_scenario();
 	test_put_order();
+	test_event_recycling();
 
 	return exit_status();
 }
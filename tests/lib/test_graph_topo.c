@@ -36,11 +36,12 @@
 #include <string.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <unistd.h>
 #include <glib.h>
 
 #include "tap/tap.h"
 
-#define NR_TESTS	77
+#define NR_TESTS	81
 
 enum event_type {
 	COMP_ACCEPT_PORT_CONNECTION,
@@ -58,6 +59,7 @@ enum test {
 	TEST_SRC_ADDS_PORT_IN_PORT_CONNECTED,
 	TEST_SINK_REMOVES_PORT_IN_CONSUME,
 	TEST_SINK_REMOVES_PORT_IN_CONSUME_THEN_SRC_REMOVES_DISCONNECTED_PORT,
+	TEST_WAIT_READY,
 };
 
 struct event {
@@ -112,6 +114,7 @@ static GArray *events;
 static struct bt_component_class *src_comp_class;
 static struct bt_component_class *sink_comp_class;
 static enum test current_test;
+static int src_ready_fd = -1;
 
 static
 void clear_events(void)
@@ -382,6 +385,13 @@ enum bt_component_status src_init(struct bt_private_component *priv_comp,
 	ret = bt_private_component_source_add_output_private_port(
 		priv_comp, "out", NULL, NULL);
 	assert(ret == 0);
+
+	if (current_test == TEST_WAIT_READY) {
+		ret = bt_private_component_set_ready_fd(priv_comp,
+			src_ready_fd);
+		assert(ret == 0);
+	}
+
 	return BT_COMPONENT_STATUS_OK;
 }
 
@@ -1220,6 +1230,44 @@ void test_empty_graph(void)
 	bt_put(graph);
 }
 
+static
+void test_wait_ready(void)
+{
+	struct bt_component *src;
+	struct bt_graph *graph;
+	enum bt_graph_status status;
+	int pipe_fds[2];
+	char byte = 0;
+	int ret;
+
+	prepare_test(TEST_WAIT_READY, "wait for a ready component");
+	ret = pipe(pipe_fds);
+	assert(ret == 0);
+	src_ready_fd = pipe_fds[0];
+	graph = create_graph();
+	src = create_src(graph);
+	ok(bt_component_get_ready_fd(src) == pipe_fds[0],
+		"bt_component_get_ready_fd() returns the readiness file descriptor");
+	status = bt_graph_wait_ready(graph, 0);
+	ok(status == BT_GRAPH_STATUS_AGAIN,
+		"bt_graph_wait_ready() times out when no component is ready");
+	ret = write(pipe_fds[1], &byte, 1);
+	assert(ret == 1);
+	status = bt_graph_wait_ready(graph, -1);
+	ok(status == BT_GRAPH_STATUS_OK,
+		"bt_graph_wait_ready() returns when a component is ready");
+	status = bt_graph_cancel(graph);
+	assert(status == BT_GRAPH_STATUS_OK);
+	status = bt_graph_wait_ready(graph, -1);
+	ok(status == BT_GRAPH_STATUS_CANCELED,
+		"bt_graph_wait_ready() does not wait when the graph is canceled");
+	bt_put(graph);
+	bt_put(src);
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+	src_ready_fd = -1;
+}
+
 int main(int argc, char **argv)
 {
 	plan_tests(NR_TESTS);
@@ -1229,6 +1277,7 @@ int main(int argc, char **argv)
 	test_src_adds_port_in_port_connected();
 	test_sink_removes_port_in_port_connected();
 	test_sink_removes_port_in_port_connected_then_src_removes_disconnected_port();
+	test_wait_ready();
 	fini_test();
 	return exit_status();
 }
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <babeltrace/babeltrace.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "common.h"
+
+struct src_iter_user_data {
+	const struct test_src_config *config;
+	uint64_t stream_index;
+
+	/*
+	 * 0: packet beginning, 1 to event count: events, event count + 1:
+	 * packet end
+	 */
+	uint64_t at;
+
+	/* Time of the last seek operation, or INT64_MIN */
+	int64_t seek_ns;
+
+	bool again;
+};
+
+static
+void src_iter_finalize(
+		struct bt_private_connection_private_notification_iterator *private_notification_iterator)
+{
+	struct src_iter_user_data *user_data =
+		bt_private_connection_private_notification_iterator_get_user_data(
+			private_notification_iterator);
+
+	g_free(user_data);
+}
+
+static
+enum bt_notification_iterator_status src_iter_init(
+		struct bt_private_connection_private_notification_iterator *priv_notif_iter,
+		struct bt_private_port *private_port)
+{
+	struct src_iter_user_data *user_data =
+		g_new0(struct src_iter_user_data, 1);
+	struct bt_private_component *priv_comp =
+		bt_private_connection_private_notification_iterator_get_private_component(
+			priv_notif_iter);
+	int ret;
+
+	assert(user_data);
+	assert(priv_comp);
+	user_data->config = bt_private_component_get_user_data(priv_comp);
+	assert(user_data->config);
+
+	/* The port's user data is the index of its stream */
+	user_data->stream_index = GPOINTER_TO_UINT(
+		bt_private_port_get_user_data(private_port));
+	user_data->seek_ns = INT64_MIN;
+	user_data->again = user_data->config->again_after_events > 0;
+	ret = bt_private_connection_private_notification_iterator_set_user_data(
+		priv_notif_iter, user_data);
+	assert(ret == 0);
+	bt_put(priv_comp);
+	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
+}
+
+static
+struct bt_notification_iterator_next_method_return src_iter_next(
+		struct bt_private_connection_private_notification_iterator *priv_iterator)
+{
+	struct bt_notification_iterator_next_method_return next_return = {
+		.notification = NULL,
+		.status = BT_NOTIFICATION_ITERATOR_STATUS_OK,
+	};
+	struct src_iter_user_data *user_data =
+		bt_private_connection_private_notification_iterator_get_user_data(
+			priv_iterator);
+	const struct test_src_config *config;
+	const struct test_src_stream *stream;
+
+	assert(user_data);
+	config = user_data->config;
+	stream = &config->streams[user_data->stream_index];
+
+	if (user_data->at == 0) {
+		next_return.notification =
+			bt_notification_packet_begin_create(stream->packet);
+		assert(next_return.notification);
+		user_data->at++;
+		goto end;
+	}
+
+	if (user_data->again &&
+			user_data->at == config->again_after_events + 1) {
+		user_data->again = false;
+		next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_AGAIN;
+		goto end;
+	}
+
+	/* Skip the events before the sought time */
+	while (user_data->at <= stream->event_count &&
+			user_data->seek_ns != INT64_MIN &&
+			config->get_event_ns(user_data->stream_index,
+				user_data->at - 1) < user_data->seek_ns) {
+		user_data->at++;
+	}
+
+	if (user_data->at <= stream->event_count) {
+		struct bt_event *event = config->create_event(
+			user_data->stream_index, user_data->at - 1);
+
+		assert(event);
+		next_return.notification = bt_notification_event_create(event,
+			config->cc_prio_map);
+		assert(next_return.notification);
+		bt_put(event);
+	} else if (user_data->at == stream->event_count + 1) {
+		next_return.notification =
+			bt_notification_packet_end_create(stream->packet);
+		assert(next_return.notification);
+	} else {
+		next_return.status = BT_NOTIFICATION_ITERATOR_STATUS_END;
+	}
+
+	user_data->at++;
+
+end:
+	return next_return;
+}
+
+static
+enum bt_notification_iterator_status src_iter_seek_time(
+		struct bt_private_connection_private_notification_iterator *priv_iterator,
+		int64_t ns_from_epoch)
+{
+	struct src_iter_user_data *user_data =
+		bt_private_connection_private_notification_iterator_get_user_data(
+			priv_iterator);
+
+	assert(user_data);
+
+	if (user_data->config->sought) {
+		user_data->config->sought(user_data->stream_index,
+			ns_from_epoch);
+	}
+
+	/*
+	 * Start again from the beginning of the packet, without a new
+	 * packet beginning notification if it is already delivered:
+	 * the stream states are kept.
+	 */
+	if (user_data->at > 0) {
+		user_data->at = 1;
+	}
+
+	user_data->seek_ns = ns_from_epoch;
+	return BT_NOTIFICATION_ITERATOR_STATUS_OK;
+}
+
+static
+enum bt_component_status src_init(
+		struct bt_private_component *private_component,
+		struct bt_value *params, void *init_method_data)
+{
+	const struct test_src_config *config = init_method_data;
+	uint64_t i;
+	int ret;
+
+	assert(config);
+	ret = bt_private_component_set_user_data(private_component,
+		(void *) config);
+	assert(ret == 0);
+
+	for (i = 0; i < config->stream_count; i++) {
+		char name[32];
+
+		snprintf(name, sizeof(name), "out%" PRIu64, i);
+		ret = bt_private_component_source_add_output_private_port(
+			private_component, name, GUINT_TO_POINTER((guint) i),
+			NULL);
+		assert(ret == 0);
+	}
+
+	return BT_COMPONENT_STATUS_OK;
+}
+
+struct bt_component *test_src_add(struct bt_graph *graph,
+		const struct test_src_config *config)
+{
+	struct bt_component_class *comp_class;
+	struct bt_component *comp;
+	int ret;
+
+	assert(config->create_event);
+	comp_class = bt_component_class_source_create("src", src_iter_next);
+	assert(comp_class);
+	ret = bt_component_class_set_init_method(comp_class, src_init);
+	assert(ret == 0);
+	ret = bt_component_class_source_set_notification_iterator_init_method(
+		comp_class, src_iter_init);
+	assert(ret == 0);
+	ret = bt_component_class_source_set_notification_iterator_finalize_method(
+		comp_class, src_iter_finalize);
+	assert(ret == 0);
+
+	if (config->get_event_ns) {
+		ret = bt_component_class_source_set_notification_iterator_seek_time_method(
+			comp_class, src_iter_seek_time);
+		assert(ret == 0);
+	}
+
+	ret = bt_graph_add_component_with_init_method_data(graph, comp_class,
+		"source", NULL, (void *) config, &comp);
+	assert(ret == 0);
+	bt_put(comp_class);
+	return comp;
+}
+
+struct bt_component *test_add_plugin_component(struct bt_graph *graph,
+		const char *plugin_name, const char *class_name,
+		enum bt_component_class_type type, const char *name,
+		struct bt_value *params)
+{
+	struct bt_component_class *comp_class;
+	struct bt_component *comp = NULL;
+
+	comp_class = bt_plugin_find_component_class(plugin_name, class_name,
+		type);
+	assert(comp_class);
+
+	if (bt_graph_add_component(graph, comp_class, name, params, &comp)) {
+		comp = NULL;
+	}
+
+	bt_put(comp_class);
+	return comp;
+}
+
+void test_connect_ports(struct bt_graph *graph,
+		struct bt_port *upstream_port, struct bt_port *downstream_port)
+{
+	enum bt_graph_status graph_status;
+
+	assert(upstream_port);
+	assert(downstream_port);
+	graph_status = bt_graph_connect_ports(graph, upstream_port,
+		downstream_port, NULL);
+	assert(graph_status == 0);
+	bt_put(upstream_port);
+	bt_put(downstream_port);
+}
+
+enum bt_graph_status test_run_graph(struct bt_graph *graph)
+{
+	enum bt_graph_status graph_status = BT_GRAPH_STATUS_OK;
+
+	while (graph_status == BT_GRAPH_STATUS_OK ||
+			graph_status == BT_GRAPH_STATUS_AGAIN) {
+		graph_status = bt_graph_run(graph);
+	}
+
+	return graph_status;
+}
+
+void test_remove_dir(const char *path)
+{
+	GDir *dir = g_dir_open(path, 0, NULL);
+	const char *name;
+
+	if (!dir) {
+		return;
+	}
+
+	while ((name = g_dir_read_name(dir))) {
+		char *child = g_build_filename(path, name, NULL);
+
+		if (g_file_test(child, G_FILE_TEST_IS_DIR)) {
+			test_remove_dir(child);
+		} else {
+			(void) g_unlink(child);
+		}
+
+		g_free(child);
+	}
+
+	g_dir_close(dir);
+	(void) g_rmdir(path);
+}
@@ -0,0 +1,99 @@
+#ifndef BABELTRACE_TESTS_PLUGINS_COMMON_H
+#define BABELTRACE_TESTS_PLUGINS_COMMON_H
+
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+#include <babeltrace/babeltrace.h>
+
+/* Stream of the test source */
+struct test_src_stream {
+	/* Packet of all the stream's events */
+	struct bt_packet *packet;
+
+	uint64_t event_count;
+};
+
+/*
+ * Test source configuration. The test source has one output port per
+ * stream, named `out0`, `out1`, and so on. The notification iterator
+ * of a port delivers the packet beginning of its stream, its events,
+ * and its packet end.
+ */
+struct test_src_config {
+	const struct test_src_stream *streams;
+	uint64_t stream_count;
+
+	/* Clock class priority map of the event notifications */
+	struct bt_clock_class_priority_map *cc_prio_map;
+
+	/*
+	 * Creates the event `index` (from 0) of the stream
+	 * `stream_index`, with the stream's packet.
+	 */
+	struct bt_event *(*create_event)(uint64_t stream_index,
+		uint64_t index);
+
+	/*
+	 * If set, returns the time (ns from Epoch) of the event `index`
+	 * of the stream `stream_index`, and the source supports the
+	 * "seek time" operation: a sought iterator starts again with the
+	 * first event of its stream which is not before the sought
+	 * time, without a new packet beginning notification if it was
+	 * already delivered.
+	 */
+	int64_t (*get_event_ns)(uint64_t stream_index, uint64_t index);
+
+	/* If set, called when an iterator of the stream is sought */
+	void (*sought)(uint64_t stream_index, int64_t ns_from_epoch);
+
+	/*
+	 * If not 0, each iterator returns
+	 * BT_NOTIFICATION_ITERATOR_STATUS_AGAIN once, after this number
+	 * of events.
+	 */
+	uint64_t again_after_events;
+};
+
+/*
+ * Adds a test source component named `source` to `graph`. `config`
+ * must exist as long as the component.
+ */
+struct bt_component *test_src_add(struct bt_graph *graph,
+		const struct test_src_config *config);
+
+/*
+ * Adds a component of the component class `plugin_name`.`class_name`
+ * to `graph`. Returns NULL if the component cannot be created.
+ */
+struct bt_component *test_add_plugin_component(struct bt_graph *graph,
+		const char *plugin_name, const char *class_name,
+		enum bt_component_class_type type, const char *name,
+		struct bt_value *params);
+
+/* Connects two ports of `graph` and puts them */
+void test_connect_ports(struct bt_graph *graph,
+		struct bt_port *upstream_port, struct bt_port *downstream_port);
+
+/* Runs `graph` until it ends or fails, and returns its last status */
+enum bt_graph_status test_run_graph(struct bt_graph *graph);
+
+/* Removes the directory `path` and its content, recursively */
+void test_remove_dir(const char *path);
+
+#endif /* BABELTRACE_TESTS_PLUGINS_COMMON_H */
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <babeltrace/ctf-ir/field-types.h>
+#include <babeltrace/ctf-ir/fields.h>
+#include <babeltrace/ref.h>
+#include <ctf/common/btr/btr.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <assert.h>
+
+#include "tap/tap.h"
+
+#define NR_TESTS	9
+
+#define MAX_VALUES	16
+#define ELEM_COUNT	4
+
+/* Values and byte arrays which the type reader passes */
+struct test_data {
+	uint64_t values[MAX_VALUES];
+	unsigned int value_count;
+	const uint8_t *bytes;
+	size_t bytes_len;
+	unsigned int byte_array_count;
+};
+
+static
+enum bt_btr_status unsigned_int_cb(uint64_t value,
+		struct bt_field_type *type, void *data)
+{
+	struct test_data *test_data = data;
+
+	if (test_data->value_count == MAX_VALUES) {
+		return BT_BTR_STATUS_ERROR;
+	}
+
+	test_data->values[test_data->value_count++] = value;
+	return BT_BTR_STATUS_OK;
+}
+
+static
+enum bt_btr_status byte_array_cb(const uint8_t *bytes, size_t len,
+		struct bt_field_type *type, void *data)
+{
+	struct test_data *test_data = data;
+
+	test_data->bytes = bytes;
+	test_data->bytes_len = len;
+	test_data->byte_array_count++;
+	return BT_BTR_STATUS_OK;
+}
+
+static
+int64_t get_sequence_length_cb(struct bt_field_type *type, void *data)
+{
+	return ELEM_COUNT;
+}
+
+/*
+ * Creates a structure field type containing an 8-bit integer field
+ * (`lead`) followed by an array (or a sequence of ELEM_COUNT elements,
+ * if `sequence` is true) of ELEM_COUNT 8-bit integer elements aligned
+ * on `alignment` bits.
+ */
+static
+struct bt_field_type *create_struct_ft(unsigned int alignment, bool sequence)
+{
+	struct bt_field_type *struct_ft;
+	struct bt_field_type *lead_ft;
+	struct bt_field_type *elem_ft;
+	struct bt_field_type *array_ft;
+	int ret;
+
+	struct_ft = bt_field_type_structure_create();
+	assert(struct_ft);
+	lead_ft = bt_field_type_integer_create(8);
+	assert(lead_ft);
+	ret = bt_field_type_structure_add_field(struct_ft, lead_ft, "lead");
+	assert(ret == 0);
+	elem_ft = bt_field_type_integer_create(8);
+	assert(elem_ft);
+	ret = bt_field_type_set_alignment(elem_ft, alignment);
+	assert(ret == 0);
+
+	if (sequence) {
+		struct bt_field_type *len_ft;
+
+		len_ft = bt_field_type_integer_create(8);
+		assert(len_ft);
+		ret = bt_field_type_structure_add_field(struct_ft, len_ft,
+			"len");
+		assert(ret == 0);
+		bt_put(len_ft);
+		array_ft = bt_field_type_sequence_create(elem_ft, "len");
+	} else {
+		array_ft = bt_field_type_array_create(elem_ft, ELEM_COUNT);
+	}
+
+	assert(array_ft);
+	ret = bt_field_type_structure_add_field(struct_ft, array_ft,
+		"elems");
+	assert(ret == 0);
+	bt_put(array_ft);
+	bt_put(elem_ft);
+	bt_put(lead_ft);
+	return struct_ft;
+}
+
+/*
+ * Decodes `buf` with `ft` and fills `test_data`. Returns the type
+ * reader's status.
+ */
+static
+enum bt_btr_status decode(struct bt_field_type *ft, const uint8_t *buf,
+		size_t sz, struct test_data *test_data)
+{
+	struct bt_btr_cbs cbs = {
+		.types = {
+			.unsigned_int = unsigned_int_cb,
+			.byte_array = byte_array_cb,
+		},
+		.query = {
+			.get_sequence_length = get_sequence_length_cb,
+		},
+	};
+	enum bt_btr_status status;
+	struct bt_field *field;
+	struct bt_btr *btr;
+
+	/* Creating a field freezes the field type */
+	field = bt_field_create(ft);
+	assert(field);
+	bt_put(field);
+	memset(test_data, 0, sizeof(*test_data));
+	btr = bt_btr_create(cbs, test_data);
+	assert(btr);
+	bt_btr_start(btr, ft, buf, 0, 0, sz, &status);
+	bt_btr_destroy(btr);
+	return status;
+}
+
+static
+void test_byte_aligned_array(void)
+{
+	static const uint8_t buf[] = { 0x01, 0x10, 0x20, 0x30, 0x40 };
+	struct test_data test_data;
+	struct bt_field_type *ft;
+	enum bt_btr_status status;
+
+	ft = create_struct_ft(8, false);
+	status = decode(ft, buf, sizeof(buf), &test_data);
+	ok(status == BT_BTR_STATUS_OK,
+		"type reader decodes an array of byte-aligned bytes");
+	ok(test_data.byte_array_count == 1 &&
+		test_data.bytes == &buf[1] &&
+		test_data.bytes_len == ELEM_COUNT,
+		"array of byte-aligned bytes is passed at once");
+	ok(test_data.value_count == 1 && test_data.values[0] == 0x01,
+		"no integer callback is called for the array's elements");
+	bt_put(ft);
+}
+
+/*
+ * Checks that the elements of an array or sequence of 8-bit integers
+ * aligned on 16 bits are decoded one by one, with the values at the
+ * aligned offsets.
+ */
+static
+void test_padded_elements(bool sequence)
+{
+	/* Lead, (length), padding, and elements followed by padding */
+	static const uint8_t array_buf[] = {
+		0x01, 0xee, 0x10, 0xee, 0x20, 0xee, 0x30, 0xee, 0x40,
+	};
+	static const uint8_t seq_buf[] = {
+		0x01, ELEM_COUNT, 0x10, 0xee, 0x20, 0xee, 0x30, 0xee, 0x40,
+	};
+	static const uint64_t expected[] = { 0x10, 0x20, 0x30, 0x40 };
+	const char *what = sequence ? "sequence" : "array";
+	struct test_data test_data;
+	struct bt_field_type *ft;
+	enum bt_btr_status status;
+	unsigned int first;
+
+	ft = create_struct_ft(16, sequence);
+	status = decode(ft, sequence ? seq_buf : array_buf,
+		sizeof(array_buf), &test_data);
+	ok(status == BT_BTR_STATUS_OK,
+		"type reader decodes 16-bit aligned bytes of a %s", what);
+	ok(test_data.byte_array_count == 0,
+		"%s of 16-bit aligned bytes is not passed at once", what);
+
+	/* Skip `lead` and, for a sequence, `len` */
+	first = sequence ? 2 : 1;
+	ok(test_data.value_count == first + ELEM_COUNT &&
+		memcmp(&test_data.values[first], expected,
+			sizeof(expected)) == 0,
+		"%s elements are read at their aligned offsets", what);
+	bt_put(ft);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	test_byte_aligned_array();
+	test_padded_elements(false);
+	test_padded_elements(true);
+	return exit_status();
+}
@@ -0,0 +1,370 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <assert.h>
+#include <babeltrace/babeltrace.h>
+#include <glib.h>
+
+#include "tap/tap.h"
+#include "common.h"
+
+#define NR_TESTS		6
+
+#define FILE_COUNT		2
+#define PACKETS_PER_FILE	2
+#define EVENTS_PER_PACKET	3
+#define EVENT_COUNT		(FILE_COUNT * PACKETS_PER_FILE * EVENTS_PER_PACKET)
+#define PACKET_HEADER_SIZE	16
+#define PACKET_CONTEXT_SIZE	32
+#define EVENT_SIZE		16
+#define PACKET_SIZE		(PACKET_HEADER_SIZE + PACKET_CONTEXT_SIZE + \
+				EVENT_SIZE * EVENTS_PER_PACKET)
+#define CTF_MAGIC		0xc1fc1fc1
+
+static char trace_dir[] = "/tmp/test-ctf-fs-seek-XXXXXX";
+
+/* Iterator created by the sink when its input port is connected */
+static struct bt_notification_iterator *sink_notif_iter;
+
+/*
+ * Both data stream files have the same stream instance ID, so that
+ * they form a single group (a single output port) of two files.
+ */
+static const char metadata[] =
+	"/* CTF 1.8 */\n"
+	"typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+	"typealias integer { size = 64; align = 8; signed = false; } := uint64_t;\n"
+	"trace {\n"
+	"	major = 1;\n"
+	"	minor = 8;\n"
+	"	byte_order = le;\n"
+	"	packet.header := struct {\n"
+	"		uint32_t magic;\n"
+	"		uint32_t padding;\n"
+	"		uint64_t stream_instance_id;\n"
+	"	};\n"
+	"};\n"
+	"clock {\n"
+	"	name = test_clock;\n"
+	"	freq = 1000000000;\n"
+	"	offset = 0;\n"
+	"};\n"
+	"typealias integer {\n"
+	"	size = 64; align = 8; signed = false;\n"
+	"	map = clock.test_clock.value;\n"
+	"} := uint64_clock_t;\n"
+	"stream {\n"
+	"	packet.context := struct {\n"
+	"		uint64_clock_t timestamp_begin;\n"
+	"		uint64_clock_t timestamp_end;\n"
+	"		uint64_t packet_size;\n"
+	"		uint64_t content_size;\n"
+	"	};\n"
+	"	event.header := struct {\n"
+	"		uint64_clock_t timestamp;\n"
+	"	};\n"
+	"};\n"
+	"event {\n"
+	"	name = ev;\n"
+	"	fields := struct {\n"
+	"		uint64_t value;\n"
+	"	};\n"
+	"};\n";
+
+/*
+ * Time of the event `i` (all files), which is also its payload value:
+ * 100, 110, 120, 200, 210, 220, 300, ...
+ */
+static
+uint64_t event_ts(unsigned int i)
+{
+	return 100 * (i / EVENTS_PER_PACKET + 1) + 10 * (i % EVENTS_PER_PACKET);
+}
+
+static
+void put_u32(uint8_t *buf, uint32_t v)
+{
+	unsigned int i;
+
+	for (i = 0; i < 4; i++) {
+		buf[i] = (uint8_t) (v >> (i * 8));
+	}
+}
+
+static
+void put_u64(uint8_t *buf, uint64_t v)
+{
+	unsigned int i;
+
+	for (i = 0; i < 8; i++) {
+		buf[i] = (uint8_t) (v >> (i * 8));
+	}
+}
+
+/* Writes the packet `packet_index` (all files) to `buf` */
+static
+void write_packet(uint8_t *buf, unsigned int packet_index)
+{
+	unsigned int first = packet_index * EVENTS_PER_PACKET;
+	uint8_t *pos = buf;
+	unsigned int i;
+
+	put_u32(pos, CTF_MAGIC);
+	put_u32(pos + 4, 0);
+	put_u64(pos + 8, 0);
+	pos += PACKET_HEADER_SIZE;
+	put_u64(pos, event_ts(first));
+	put_u64(pos + 8, event_ts(first + EVENTS_PER_PACKET - 1));
+	put_u64(pos + 16, PACKET_SIZE * 8);
+	put_u64(pos + 24, PACKET_SIZE * 8);
+	pos += PACKET_CONTEXT_SIZE;
+
+	for (i = first; i < first + EVENTS_PER_PACKET; i++) {
+		put_u64(pos, event_ts(i));
+		put_u64(pos + 8, event_ts(i));
+		pos += EVENT_SIZE;
+	}
+}
+
+static
+bool write_trace(void)
+{
+	uint8_t buf[PACKET_SIZE * PACKETS_PER_FILE];
+	bool ret = true;
+	unsigned int f;
+	char *path;
+
+	path = g_build_filename(trace_dir, "metadata", NULL);
+	assert(path);
+	ret = g_file_set_contents(path, metadata, -1, NULL);
+	g_free(path);
+
+	for (f = 0; ret && f < FILE_COUNT; f++) {
+		char name[32];
+		unsigned int p;
+
+		for (p = 0; p < PACKETS_PER_FILE; p++) {
+			write_packet(&buf[p * PACKET_SIZE],
+				f * PACKETS_PER_FILE + p);
+		}
+
+		snprintf(name, sizeof(name), "stream_%u", f);
+		path = g_build_filename(trace_dir, name, NULL);
+		assert(path);
+		ret = g_file_set_contents(path, (const gchar *) buf,
+			sizeof(buf), NULL);
+		g_free(path);
+	}
+
+	return ret;
+}
+
+static
+enum bt_component_status sink_consume(
+		struct bt_private_component *private_component)
+{
+	/* The test drives the iterator itself */
+	return BT_COMPONENT_STATUS_END;
+}
+
+static
+void sink_port_connected(struct bt_private_component *private_component,
+		struct bt_private_port *self_private_port,
+		struct bt_port *other_port)
+{
+	struct bt_private_connection *priv_conn =
+		bt_private_port_get_private_connection(self_private_port);
+	enum bt_connection_status conn_status;
+
+	assert(priv_conn);
+	conn_status = bt_private_connection_create_notification_iterator(
+		priv_conn, NULL, &sink_notif_iter);
+	assert(conn_status == 0);
+	bt_put(priv_conn);
+}
+
+static
+enum bt_component_status sink_init(
+		struct bt_private_component *private_component,
+		struct bt_value *params, void *init_method_data)
+{
+	int ret;
+
+	ret = bt_private_component_sink_add_input_private_port(
+		private_component, "in", NULL, NULL);
+	assert(ret == 0);
+	return BT_COMPONENT_STATUS_OK;
+}
+
+/* Returns the payload value of the event notification `notif` */
+static
+uint64_t get_event_value(struct bt_notification *notif)
+{
+	struct bt_event *event = bt_notification_event_get_event(notif);
+	struct bt_field *payload;
+	struct bt_field *field;
+	uint64_t value;
+	int ret;
+
+	assert(event);
+	payload = bt_event_get_event_payload(event);
+	assert(payload);
+	field = bt_field_structure_get_field_by_name(payload, "value");
+	assert(field);
+	ret = bt_field_unsigned_integer_get_value(field, &value);
+	assert(ret == 0);
+	bt_put(field);
+	bt_put(payload);
+	bt_put(event);
+	return value;
+}
+
+/*
+ * Creates a graph with a ctf.fs source reading the test trace, seeks
+ * the iterator of its (only) output port to `ns_from_epoch` before
+ * getting any notification, and checks that the iterator delivers the
+ * events from `expected_first` (index in all the trace's events) to
+ * the last one, and then ends.
+ */
+static
+void test_seek(int64_t ns_from_epoch, unsigned int expected_first,
+		const char *what)
+{
+	struct bt_component_class *sink_comp_class;
+	struct bt_component *src_comp;
+	struct bt_component *sink_comp;
+	struct bt_graph *graph;
+	struct bt_value *params;
+	enum bt_notification_iterator_status seek_status;
+	enum bt_notification_iterator_status status;
+	unsigned int next_event = expected_first;
+	bool events_ok = true;
+	int ret;
+
+	graph = bt_graph_create();
+	assert(graph);
+
+	/* Create source component */
+	params = bt_value_map_create();
+	assert(params);
+	ret = bt_value_map_insert_string(params, "path", trace_dir);
+	assert(ret == 0);
+	src_comp = test_add_plugin_component(graph, "ctf", "fs",
+		BT_COMPONENT_CLASS_TYPE_SOURCE, "source", params);
+	assert(src_comp);
+
+	/* Create sink component */
+	sink_comp_class = bt_component_class_sink_create("sink",
+		sink_consume);
+	assert(sink_comp_class);
+	ret = bt_component_class_set_init_method(sink_comp_class, sink_init);
+	assert(ret == 0);
+	ret = bt_component_class_set_port_connected_method(sink_comp_class,
+		sink_port_connected);
+	assert(ret == 0);
+	ret = bt_graph_add_component(graph, sink_comp_class, "sink", NULL,
+		&sink_comp);
+	assert(ret == 0);
+
+	test_connect_ports(graph,
+		bt_component_source_get_output_port_by_index(src_comp, 0),
+		bt_component_sink_get_input_port_by_name(sink_comp, "in"));
+	assert(sink_notif_iter);
+
+	seek_status = bt_notification_iterator_seek_time(sink_notif_iter,
+		ns_from_epoch);
+
+	while (true) {
+		struct bt_notification *notif;
+
+		status = bt_notification_iterator_next(sink_notif_iter);
+		if (status == BT_NOTIFICATION_ITERATOR_STATUS_AGAIN) {
+			continue;
+		} else if (status != BT_NOTIFICATION_ITERATOR_STATUS_OK) {
+			break;
+		}
+
+		notif = bt_notification_iterator_get_notification(
+			sink_notif_iter);
+		assert(notif);
+
+		if (bt_notification_get_type(notif) ==
+				BT_NOTIFICATION_TYPE_EVENT) {
+			if (next_event >= EVENT_COUNT ||
+					get_event_value(notif) !=
+					event_ts(next_event)) {
+				events_ok = false;
+			}
+
+			next_event++;
+		}
+
+		bt_put(notif);
+	}
+
+	ok(seek_status == BT_NOTIFICATION_ITERATOR_STATUS_OK &&
+		status == BT_NOTIFICATION_ITERATOR_STATUS_END &&
+		events_ok && next_event == EVENT_COUNT,
+		"ctf.fs seeks %s", what);
+	diag("seek status: %d, last status: %d, delivered events: %u",
+		seek_status, status, next_event - expected_first);
+
+	BT_PUT(sink_notif_iter);
+	bt_put(params);
+	bt_put(src_comp);
+	bt_put(sink_comp);
+	bt_put(sink_comp_class);
+	bt_put(graph);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+
+	if (!g_mkdtemp(trace_dir)) {
+		fail("cannot create a temporary directory");
+		return exit_status();
+	}
+
+	if (!write_trace()) {
+		fail("cannot write the test trace");
+		goto end;
+	}
+
+	test_seek(-1, 0,
+		"to the first packet for a negative time");
+	test_seek(50, 0,
+		"to the first packet for a time before it");
+	test_seek(205, 1 * EVENTS_PER_PACKET,
+		"to the packet containing a time within a file");
+	test_seek(250, 2 * EVENTS_PER_PACKET,
+		"to the next file for a time between two files");
+	test_seek(410, 3 * EVENTS_PER_PACKET,
+		"to the packet containing a time within the last file");
+	test_seek(1000, EVENT_COUNT,
+		"to the end for a time after the last packet");
+
+end:
+	test_remove_dir(trace_dir);
+	return exit_status();
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "text/pretty/pretty.h"
+
+#include "tap/tap.h"
+
+#define NR_TESTS	9
+
+/* Seconds around a boundary to check, on each side */
+#define AROUND		150
+
+/*
+ * POSIX time zones, so that the test does not depend on the installed
+ * time zone database: North American daylight saving time rules, with
+ * a whole-hour offset and with a half-hour offset.
+ */
+static const char *time_zones[] = {
+	"EST5EDT,M3.2.0,M11.1.0",
+	"NST3:30NDT,M3.2.0,M11.1.0",
+};
+
+static struct pretty_component pretty;
+
+static
+void set_time_zone(const char *tz)
+{
+	int ret = setenv("TZ", tz, 1);
+
+	assert(ret == 0);
+	tzset();
+}
+
+/*
+ * Checks the wall clock time cache for the seconds `first` to `last`
+ * (inclusive), visited every `step` seconds without resetting the
+ * cache, against strftime() with localtime_r() (or gmtime_r() with
+ * the clock-gmt option).
+ */
+static
+bool check_seconds(int64_t first, int64_t last, int64_t step)
+{
+	int64_t sec;
+
+	for (sec = first; sec <= last; sec += step) {
+		time_t time_s = (time_t) sec;
+		char expected[64];
+		struct tm tm;
+		struct tm *res;
+		size_t len;
+
+		if (pretty.options.clock_gmt) {
+			res = gmtime_r(&time_s, &tm);
+		} else {
+			res = localtime_r(&time_s, &tm);
+		}
+
+		assert(res);
+		len = strftime(expected, sizeof(expected),
+			"%Y-%m-%d %H:%M:%S.", &tm);
+		assert(len > 0);
+
+		if (pretty_update_wall_clock_cache(&pretty, (uint64_t) sec)) {
+			diag("cannot format %" PRId64 " s", sec);
+			return false;
+		}
+
+		if (pretty.wall_clock_cache.prefix_len != len ||
+				memcmp(pretty.wall_clock_cache.prefix, expected,
+					len) != 0) {
+			diag("%" PRId64 " s: got \"%.*s\", expecting \"%s\"",
+				sec, (int) pretty.wall_clock_cache.prefix_len,
+				pretty.wall_clock_cache.prefix, expected);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Checks every second around `boundary` with an empty cache */
+static
+bool check_around(int64_t boundary)
+{
+	memset(&pretty.wall_clock_cache, 0, sizeof(pretty.wall_clock_cache));
+	return check_seconds(boundary - AROUND, boundary + AROUND, 1);
+}
+
+/* Returns the time (s from the epoch) of a given local date and time */
+static
+int64_t local_time(int year, int month, int day, int hour, int minute)
+{
+	struct tm tm = {
+		.tm_year = year - 1900,
+		.tm_mon = month - 1,
+		.tm_mday = day,
+		.tm_hour = hour,
+		.tm_min = minute,
+		.tm_isdst = -1,
+	};
+	time_t time_s = mktime(&tm);
+
+	assert(time_s != (time_t) -1);
+	return (int64_t) time_s;
+}
+
+static
+bool is_dst(int64_t sec)
+{
+	time_t time_s = (time_t) sec;
+	struct tm tm;
+	struct tm *res = localtime_r(&time_s, &tm);
+
+	assert(res);
+	return tm.tm_isdst > 0;
+}
+
+/*
+ * Returns the first time, from `begin`, at which daylight saving time
+ * starts or ends.
+ */
+static
+int64_t find_dst_transition(int64_t begin)
+{
+	int64_t low = begin;
+	int64_t high = begin;
+	bool begin_dst = is_dst(begin);
+
+	/* Find the hour of the transition, then its second */
+	do {
+		low = high;
+		high += 3600;
+		assert(high - begin < 366 * 86400);
+	} while (is_dst(high) == begin_dst);
+
+	while (high - low > 1) {
+		int64_t mid = low + (high - low) / 2;
+
+		if (is_dst(mid) == begin_dst) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+
+	return high;
+}
+
+static
+bool check_dst_transitions(void)
+{
+	int64_t dst_begin = find_dst_transition(local_time(2017, 1, 1, 0, 0));
+	int64_t dst_end = find_dst_transition(dst_begin);
+
+	if (!check_around(dst_begin) || !check_around(dst_end)) {
+		return false;
+	}
+
+	/* Also across the transitions with a cache from another minute */
+	memset(&pretty.wall_clock_cache, 0, sizeof(pretty.wall_clock_cache));
+	return check_seconds(dst_begin - 7200, dst_begin + 7200, 61) &&
+		check_seconds(dst_end - 7200, dst_end + 7200, 61);
+}
+
+static
+void test_local_time(const char *tz)
+{
+	set_time_zone(tz);
+	pretty.options.clock_gmt = false;
+	ok(check_around(local_time(2017, 6, 15, 12, 34)),
+		"wall clock time matches localtime_r() around a minute boundary (%s)",
+		tz);
+	ok(check_around(local_time(2017, 6, 16, 0, 0)),
+		"wall clock time matches localtime_r() around a day boundary (%s)",
+		tz);
+	ok(check_around(local_time(2018, 1, 1, 0, 0)),
+		"wall clock time matches localtime_r() around a year boundary (%s)",
+		tz);
+	ok(check_dst_transitions(),
+		"wall clock time matches localtime_r() around DST transitions (%s)",
+		tz);
+}
+
+static
+void test_gmt(void)
+{
+	/* A local time zone with DST must not change anything */
+	set_time_zone(time_zones[0]);
+	pretty.options.clock_gmt = true;
+
+	/* 2018-01-01 00:00:00 UTC: also a minute and a day boundary */
+	ok(check_around(1514764800),
+		"wall clock time matches gmtime_r() with the clock-gmt option");
+	pretty.options.clock_gmt = false;
+}
+
+int main(int argc, char **argv)
+{
+	size_t i;
+
+	plan_tests(NR_TESTS);
+	pretty.options.clock_date = true;
+
+	for (i = 0; i < sizeof(time_zones) / sizeof(time_zones[0]); i++) {
+		test_local_time(time_zones[i]);
+	}
+
+	test_gmt();
+	return exit_status();
+}
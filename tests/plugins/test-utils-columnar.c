@@ -0,0 +1,830 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <assert.h>
+#include <babeltrace/babeltrace.h>
+#include <glib.h>
+
+#include "tap/tap.h"
+#include "common.h"
+#include "utils/columnar/format.h"
+
+#define NR_TESTS	11
+
+#define EVENT_COUNT	10
+#define CHUNK_SIZE	4
+#define CHUNK_COUNT	((EVENT_COUNT + CHUNK_SIZE - 1) / CHUNK_SIZE)
+#define EVENT_DIR_NAME	"0-my_event"
+
+struct chunk {
+	const struct columnar_chunk_header *header;
+	const uint8_t *data;
+	const struct columnar_chunk_footer *footer;
+};
+
+static struct bt_clock_class_priority_map *src_cc_prio_map;
+static struct bt_clock_class *src_clock_class;
+static struct bt_stream_class *src_stream_class;
+static struct bt_event_class *src_event_class;
+static struct bt_packet *src_packet;
+static char out_dir[] = "/tmp/test-utils-columnar-XXXXXX";
+
+static const char expected_schema[] =
+	"version 1\n"
+	"name my event\n"
+	"id 0\n"
+	"stream-class-id 0\n"
+	"trace \n"
+	"column delta-s64 timestamp\n"
+	"column u32 event.fields.a\n"
+	"column s16 event.fields.b\n"
+	"column f32 event.fields.g\n"
+	"column f64 event.fields.f\n"
+	"column string event.fields.s\n"
+	"column string event.fields.text\n"
+	"column u8 event.fields.inner.c\n"
+	"skipped event.fields.arr\n";
+
+/* Expected values of row `i` */
+static
+int64_t expected_ts(uint64_t i)
+{
+	/* Not monotonic to check the signed deltas */
+	return i == 5 ? 1000 : 2000 + (int64_t) (i * i * 10);
+}
+
+static
+uint32_t expected_a(uint64_t i)
+{
+	return (uint32_t) (i * 3);
+}
+
+static
+int16_t expected_b(uint64_t i)
+{
+	return (int16_t) -(int64_t) i;
+}
+
+static
+double expected_g(uint64_t i)
+{
+	return (double) i * 0.25;
+}
+
+static
+double expected_f(uint64_t i)
+{
+	return (double) i / 3.;
+}
+
+static
+uint8_t expected_c(uint64_t i)
+{
+	return (uint8_t) (200 + i);
+}
+
+static
+void set_uint(struct bt_field *parent, const char *name, uint64_t v)
+{
+	struct bt_field *field = bt_field_structure_get_field_by_name(parent,
+		name);
+	int ret;
+
+	assert(field);
+	ret = bt_field_unsigned_integer_set_value(field, v);
+	assert(ret == 0);
+	bt_put(field);
+}
+
+static
+struct bt_field_type *create_int_ft(unsigned int size, bool is_signed)
+{
+	struct bt_field_type *ft = bt_field_type_integer_create(size);
+	int ret;
+
+	assert(ft);
+	ret = bt_field_type_integer_set_is_signed(ft, is_signed);
+	assert(ret == 0);
+	return ft;
+}
+
+static
+void add_member(struct bt_field_type *struct_ft, struct bt_field_type *ft,
+		const char *name)
+{
+	int ret = bt_field_type_structure_add_field(struct_ft, ft, name);
+
+	assert(ret == 0);
+	bt_put(ft);
+}
+
+static
+struct bt_field_type *create_payload_ft(void)
+{
+	struct bt_field_type *payload_ft = bt_field_type_structure_create();
+	struct bt_field_type *inner_ft = bt_field_type_structure_create();
+	struct bt_field_type *char_ft;
+	struct bt_field_type *elem_ft;
+	struct bt_field_type *ft;
+	int ret;
+
+	assert(payload_ft);
+	assert(inner_ft);
+	add_member(payload_ft, create_int_ft(32, false), "a");
+	add_member(payload_ft, create_int_ft(16, true), "b");
+	ft = bt_field_type_floating_point_create();
+	assert(ft);
+	add_member(payload_ft, ft, "g");
+	ft = bt_field_type_floating_point_create();
+	assert(ft);
+	ret = bt_field_type_floating_point_set_exponent_digits(ft, 11);
+	assert(ret == 0);
+	ret = bt_field_type_floating_point_set_mantissa_digits(ft, 53);
+	assert(ret == 0);
+	add_member(payload_ft, ft, "f");
+	ft = bt_field_type_string_create();
+	assert(ft);
+	add_member(payload_ft, ft, "s");
+	char_ft = create_int_ft(8, false);
+	ret = bt_field_type_integer_set_encoding(char_ft,
+		BT_STRING_ENCODING_UTF8);
+	assert(ret == 0);
+	ret = bt_field_type_set_alignment(char_ft, 8);
+	assert(ret == 0);
+	ft = bt_field_type_array_create(char_ft, 4);
+	assert(ft);
+	bt_put(char_ft);
+	add_member(payload_ft, ft, "text");
+	add_member(inner_ft, create_int_ft(8, false), "c");
+	add_member(payload_ft, inner_ft, "inner");
+	elem_ft = create_int_ft(16, false);
+	ft = bt_field_type_array_create(elem_ft, 2);
+	assert(ft);
+	bt_put(elem_ft);
+	add_member(payload_ft, ft, "arr");
+	return payload_ft;
+}
+
+static
+void init_static_data(void)
+{
+	int ret;
+	struct bt_trace *trace;
+	struct bt_stream *stream;
+	struct bt_field_type *empty_struct_ft;
+	struct bt_field_type *payload_ft;
+
+	/* Metadata */
+	empty_struct_ft = bt_field_type_structure_create();
+	assert(empty_struct_ft);
+	trace = bt_trace_create();
+	assert(trace);
+	ret = bt_trace_set_native_byte_order(trace,
+		BT_BYTE_ORDER_LITTLE_ENDIAN);
+	assert(ret == 0);
+	ret = bt_trace_set_packet_header_type(trace, empty_struct_ft);
+	assert(ret == 0);
+	src_clock_class = bt_clock_class_create("my-clock", 1000000000);
+	assert(src_clock_class);
+	ret = bt_clock_class_set_is_absolute(src_clock_class, 1);
+	assert(ret == 0);
+	ret = bt_trace_add_clock_class(trace, src_clock_class);
+	assert(ret == 0);
+	src_cc_prio_map = bt_clock_class_priority_map_create();
+	assert(src_cc_prio_map);
+	ret = bt_clock_class_priority_map_add_clock_class(src_cc_prio_map,
+		src_clock_class, 0);
+	assert(ret == 0);
+	src_stream_class = bt_stream_class_create("my-stream-class");
+	assert(src_stream_class);
+	ret = bt_stream_class_set_packet_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_header_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	src_event_class = bt_event_class_create("my event");
+	assert(src_event_class);
+	ret = bt_event_class_set_context_type(src_event_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	payload_ft = create_payload_ft();
+	ret = bt_event_class_set_payload_type(src_event_class, payload_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_add_event_class(src_stream_class,
+		src_event_class);
+	assert(ret == 0);
+	ret = bt_trace_add_stream_class(trace, src_stream_class);
+	assert(ret == 0);
+	stream = bt_stream_create(src_stream_class, "stream0");
+	assert(stream);
+	src_packet = bt_packet_create(stream);
+	assert(src_packet);
+	bt_put(stream);
+	bt_put(trace);
+	bt_put(payload_ft);
+	bt_put(empty_struct_ft);
+}
+
+static
+void fini_static_data(void)
+{
+	bt_put(src_cc_prio_map);
+	bt_put(src_clock_class);
+	bt_put(src_stream_class);
+	bt_put(src_event_class);
+	bt_put(src_packet);
+}
+
+static
+struct bt_event *src_create_event(uint64_t stream_index, uint64_t i)
+{
+	struct bt_event *event = bt_event_create(src_event_class);
+	struct bt_clock_value *clock_value;
+	struct bt_field *payload;
+	struct bt_field *field;
+	struct bt_field *elem;
+	char *str;
+	uint64_t j;
+	int ret;
+
+	assert(event);
+	ret = bt_event_set_packet(event, src_packet);
+	assert(ret == 0);
+	clock_value = bt_clock_value_create(src_clock_class,
+		(uint64_t) expected_ts(i));
+	assert(clock_value);
+	ret = bt_event_set_clock_value(event, clock_value);
+	assert(ret == 0);
+	bt_put(clock_value);
+
+	payload = bt_event_get_payload(event, NULL);
+	assert(payload);
+	set_uint(payload, "a", expected_a(i));
+	field = bt_field_structure_get_field_by_name(payload, "b");
+	assert(field);
+	ret = bt_field_signed_integer_set_value(field, expected_b(i));
+	assert(ret == 0);
+	bt_put(field);
+	field = bt_field_structure_get_field_by_name(payload, "g");
+	assert(field);
+	ret = bt_field_floating_point_set_value(field, expected_g(i));
+	assert(ret == 0);
+	bt_put(field);
+	field = bt_field_structure_get_field_by_name(payload, "f");
+	assert(field);
+	ret = bt_field_floating_point_set_value(field, expected_f(i));
+	assert(ret == 0);
+	bt_put(field);
+
+	/* `s` is `i` times `x` */
+	field = bt_field_structure_get_field_by_name(payload, "s");
+	assert(field);
+	str = g_strnfill(i, 'x');
+	assert(str);
+	ret = bt_field_string_set_value(field, str);
+	assert(ret == 0);
+	g_free(str);
+	bt_put(field);
+
+	/* `text` is "ab" followed with null characters */
+	field = bt_field_structure_get_field_by_name(payload, "text");
+	assert(field);
+
+	for (j = 0; j < 4; j++) {
+		elem = bt_field_array_get_field(field, j);
+		assert(elem);
+		ret = bt_field_unsigned_integer_set_value(elem,
+			j < 2 ? 'a' + j : 0);
+		assert(ret == 0);
+		bt_put(elem);
+	}
+
+	bt_put(field);
+	field = bt_field_structure_get_field_by_name(payload, "inner");
+	assert(field);
+	set_uint(field, "c", expected_c(i));
+	bt_put(field);
+	field = bt_field_structure_get_field_by_name(payload, "arr");
+	assert(field);
+
+	for (j = 0; j < 2; j++) {
+		elem = bt_field_array_get_field(field, j);
+		assert(elem);
+		ret = bt_field_unsigned_integer_set_value(elem, j);
+		assert(ret == 0);
+		bt_put(elem);
+	}
+
+	bt_put(field);
+	bt_put(payload);
+	return event;
+}
+
+/* Returns the output directory path of the sink (to free) */
+static
+char *get_sink_path(void)
+{
+	return g_build_filename(out_dir, "out", NULL);
+}
+
+/* Returns the content of the file `name` of the event class directory */
+static
+gchar *get_event_file(const char *name, gsize *len)
+{
+	char *path = g_build_filename(out_dir, "out", EVENT_DIR_NAME, name,
+		NULL);
+	gchar *content = NULL;
+
+	assert(path);
+
+	if (!g_file_get_contents(path, &content, len, NULL)) {
+		content = NULL;
+	}
+
+	g_free(path);
+	return content;
+}
+
+/*
+ * Splits the content of a column file of type `type` into its chunks,
+ * checking their framing and their value counts. Returns false on
+ * error.
+ */
+static
+bool get_chunks(const gchar *buf, gsize len, enum columnar_type type,
+		struct chunk *chunks)
+{
+	const uint8_t expected_byte_order =
+		G_BYTE_ORDER == G_LITTLE_ENDIAN ?
+		COLUMNAR_BYTE_ORDER_LE : COLUMNAR_BYTE_ORDER_BE;
+	gsize offset = 0;
+	int i;
+
+	for (i = 0; i < CHUNK_COUNT; i++) {
+		const uint64_t expected_count = i < CHUNK_COUNT - 1 ?
+			CHUNK_SIZE : EVENT_COUNT - (CHUNK_COUNT - 1) * CHUNK_SIZE;
+		struct chunk *chunk = &chunks[i];
+
+		if (len - offset < sizeof(*chunk->header)) {
+			diag("chunk %d: truncated header", i);
+			return false;
+		}
+
+		chunk->header = (const void *) &buf[offset];
+		offset += sizeof(*chunk->header);
+
+		if (chunk->header->magic != COLUMNAR_CHUNK_HEADER_MAGIC ||
+				chunk->header->version != COLUMNAR_FORMAT_VERSION ||
+				chunk->header->type != type ||
+				chunk->header->byte_order != expected_byte_order ||
+				chunk->header->count != expected_count ||
+				chunk->header->data_size % 8 != 0) {
+			diag("chunk %d: unexpected header", i);
+			return false;
+		}
+
+		if (len - offset < chunk->header->data_size +
+				sizeof(*chunk->footer)) {
+			diag("chunk %d: truncated data or footer", i);
+			return false;
+		}
+
+		chunk->data = (const uint8_t *) &buf[offset];
+		offset += chunk->header->data_size;
+		chunk->footer = (const void *) &buf[offset];
+		offset += sizeof(*chunk->footer);
+
+		if (chunk->footer->magic != COLUMNAR_CHUNK_FOOTER_MAGIC ||
+				chunk->footer->chunk_size !=
+				sizeof(*chunk->header) +
+				chunk->header->data_size +
+				sizeof(*chunk->footer)) {
+			diag("chunk %d: unexpected footer", i);
+			return false;
+		}
+	}
+
+	if (offset != len) {
+		diag("unexpected data after the last chunk");
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Reads the chunks of the column file `name` of type `type` into
+ * `chunks`. Returns the file content (to free) or NULL on error.
+ */
+static
+gchar *read_column(const char *name, enum columnar_type type,
+		struct chunk *chunks)
+{
+	gsize len;
+	gchar *buf = get_event_file(name, &len);
+
+	if (!buf) {
+		diag("cannot read column file `%s`", name);
+		goto end;
+	}
+
+	if (!get_chunks(buf, len, type, chunks)) {
+		g_free(buf);
+		buf = NULL;
+	}
+
+end:
+	return buf;
+}
+
+static
+bool check_timestamp_column(void)
+{
+	struct chunk chunks[CHUNK_COUNT];
+	gchar *buf = read_column("timestamp.col", COLUMNAR_TYPE_DELTA_S64,
+		chunks);
+	bool ret = false;
+	uint64_t row = 0;
+	int i;
+
+	if (!buf) {
+		goto end;
+	}
+
+	for (i = 0; i < CHUNK_COUNT; i++) {
+		const int64_t *deltas = (const void *) chunks[i].data;
+		int64_t value = chunks[i].header->base;
+		int64_t min = INT64_MAX, max = INT64_MIN;
+		uint64_t j;
+
+		if (deltas[0] != 0) {
+			diag("chunk %d: first delta is not 0", i);
+			goto end;
+		}
+
+		for (j = 0; j < chunks[i].header->count; j++, row++) {
+			value += deltas[j];
+
+			if (value != expected_ts(row)) {
+				diag("row %" PRIu64 ": %" PRId64, row, value);
+				goto end;
+			}
+
+			min = MIN(min, value);
+			max = MAX(max, value);
+		}
+
+		if (chunks[i].footer->min.s != min ||
+				chunks[i].footer->max.s != max) {
+			diag("chunk %d: unexpected min/max", i);
+			goto end;
+		}
+	}
+
+	ret = true;
+
+end:
+	g_free(buf);
+	return ret;
+}
+
+static
+bool check_int_columns(void)
+{
+	struct chunk a_chunks[CHUNK_COUNT];
+	struct chunk b_chunks[CHUNK_COUNT];
+	struct chunk c_chunks[CHUNK_COUNT];
+	gchar *a_buf = read_column("event.fields.a.col", COLUMNAR_TYPE_U32,
+		a_chunks);
+	gchar *b_buf = read_column("event.fields.b.col", COLUMNAR_TYPE_S16,
+		b_chunks);
+	gchar *c_buf = read_column("event.fields.inner.c.col",
+		COLUMNAR_TYPE_U8, c_chunks);
+	bool ret = false;
+	uint64_t row = 0;
+	int i;
+
+	if (!a_buf || !b_buf || !c_buf) {
+		goto end;
+	}
+
+	for (i = 0; i < CHUNK_COUNT; i++) {
+		const uint32_t *a = (const void *) a_chunks[i].data;
+		const int16_t *b = (const void *) b_chunks[i].data;
+		const uint8_t *c = c_chunks[i].data;
+		const uint64_t count = a_chunks[i].header->count;
+		const uint64_t first = row;
+		uint64_t j;
+
+		for (j = 0; j < count; j++, row++) {
+			if (a[j] != expected_a(row) ||
+					b[j] != expected_b(row) ||
+					c[j] != expected_c(row)) {
+				diag("row %" PRIu64 ": unexpected value", row);
+				goto end;
+			}
+		}
+
+		/* Monotonic: the first and last rows are the extremes */
+		if (a_chunks[i].footer->min.u != expected_a(first) ||
+				a_chunks[i].footer->max.u !=
+					expected_a(row - 1) ||
+				b_chunks[i].footer->min.s !=
+					expected_b(row - 1) ||
+				b_chunks[i].footer->max.s !=
+					expected_b(first) ||
+				c_chunks[i].footer->min.u != expected_c(first) ||
+				c_chunks[i].footer->max.u !=
+					expected_c(row - 1)) {
+			diag("chunk %d: unexpected min/max", i);
+			goto end;
+		}
+	}
+
+	ret = true;
+
+end:
+	g_free(a_buf);
+	g_free(b_buf);
+	g_free(c_buf);
+	return ret;
+}
+
+static
+bool check_float_columns(void)
+{
+	struct chunk g_chunks[CHUNK_COUNT];
+	struct chunk f_chunks[CHUNK_COUNT];
+	gchar *g_buf = read_column("event.fields.g.col", COLUMNAR_TYPE_F32,
+		g_chunks);
+	gchar *f_buf = read_column("event.fields.f.col", COLUMNAR_TYPE_F64,
+		f_chunks);
+	bool ret = false;
+	uint64_t row = 0;
+	int i;
+
+	if (!g_buf || !f_buf) {
+		goto end;
+	}
+
+	for (i = 0; i < CHUNK_COUNT; i++) {
+		const float *g = (const void *) g_chunks[i].data;
+		const double *f = (const void *) f_chunks[i].data;
+		const uint64_t first = row;
+		uint64_t j;
+
+		for (j = 0; j < g_chunks[i].header->count; j++, row++) {
+			if (g[j] != (float) expected_g(row) ||
+					f[j] != expected_f(row)) {
+				diag("row %" PRIu64 ": unexpected value", row);
+				goto end;
+			}
+		}
+
+		if (g_chunks[i].footer->min.f != expected_g(first) ||
+				g_chunks[i].footer->max.f !=
+					expected_g(row - 1) ||
+				f_chunks[i].footer->min.f !=
+					expected_f(first) ||
+				f_chunks[i].footer->max.f !=
+					expected_f(row - 1)) {
+			diag("chunk %d: unexpected min/max", i);
+			goto end;
+		}
+	}
+
+	ret = true;
+
+end:
+	g_free(g_buf);
+	g_free(f_buf);
+	return ret;
+}
+
+/*
+ * Checks the string column `name`, where row `i` is `expected(i)`, of
+ * length `expected_len(i)`.
+ */
+static
+bool check_string_column(const char *name,
+		const char *(*expected)(uint64_t),
+		uint64_t (*expected_len)(uint64_t))
+{
+	struct chunk chunks[CHUNK_COUNT];
+	gchar *buf = read_column(name, COLUMNAR_TYPE_STRING, chunks);
+	bool ret = false;
+	uint64_t row = 0;
+	int i;
+
+	if (!buf) {
+		goto end;
+	}
+
+	for (i = 0; i < CHUNK_COUNT; i++) {
+		const uint64_t count = chunks[i].header->count;
+		const uint64_t *offsets = (const void *) chunks[i].data;
+		const char *blob = (const char *) &offsets[count + 1];
+		const uint64_t first = row;
+		uint64_t j;
+
+		if (offsets[0] != 0 || (count + 1) * 8 + offsets[count] >
+				chunks[i].header->data_size) {
+			diag("chunk %d: unexpected offsets", i);
+			goto end;
+		}
+
+		for (j = 0; j < count; j++, row++) {
+			const char *str = &blob[offsets[j]];
+
+			if (offsets[j + 1] - offsets[j] !=
+					expected_len(row) + 1 ||
+					strcmp(str, expected(row)) != 0) {
+				diag("row %" PRIu64 ": unexpected value", row);
+				goto end;
+			}
+		}
+
+		if (chunks[i].footer->min.u != expected_len(first) ||
+				chunks[i].footer->max.u !=
+					expected_len(row - 1)) {
+			diag("chunk %d: unexpected min/max", i);
+			goto end;
+		}
+	}
+
+	ret = true;
+
+end:
+	g_free(buf);
+	return ret;
+}
+
+static
+const char *expected_s(uint64_t i)
+{
+	static const char xs[] = "xxxxxxxxxxxxxxxx";
+
+	assert(i < sizeof(xs));
+	return &xs[sizeof(xs) - 1 - i];
+}
+
+static
+uint64_t expected_s_len(uint64_t i)
+{
+	return i;
+}
+
+static
+const char *expected_text(uint64_t i)
+{
+	return "ab";
+}
+
+static
+uint64_t expected_text_len(uint64_t i)
+{
+	return 2;
+}
+
+static
+struct bt_component *create_sink(struct bt_graph *graph,
+		struct bt_value *params)
+{
+	return test_add_plugin_component(graph, "utils", "columnar",
+		BT_COMPONENT_CLASS_TYPE_SINK, "sink", params);
+}
+
+static
+void test_no_path(void)
+{
+	struct bt_graph *graph = bt_graph_create();
+	struct bt_value *params = bt_value_map_create();
+	struct bt_component *sink;
+
+	assert(graph);
+	assert(params);
+	sink = create_sink(graph, params);
+	ok(!sink, "component creation fails without a `path` parameter");
+	bt_put(sink);
+	bt_put(params);
+	bt_put(graph);
+}
+
+static
+void test_columns(void)
+{
+	struct test_src_stream src_stream = {
+		.packet = src_packet,
+		.event_count = EVENT_COUNT,
+	};
+	struct test_src_config src_config = {
+		.streams = &src_stream,
+		.stream_count = 1,
+		.cc_prio_map = src_cc_prio_map,
+		.create_event = src_create_event,
+	};
+	struct bt_component *src_comp;
+	struct bt_component *sink_comp;
+	struct bt_graph *graph;
+	struct bt_value *params;
+	enum bt_graph_status graph_status;
+	char *sink_path = get_sink_path();
+	char *arr_path;
+	gchar *schema;
+	gsize len;
+	int ret;
+
+	graph = bt_graph_create();
+	assert(graph);
+	src_comp = test_src_add(graph, &src_config);
+
+	/* Create sink component */
+	params = bt_value_map_create();
+	assert(params);
+	ret = bt_value_map_insert_string(params, "path", sink_path);
+	assert(ret == 0);
+	ret = bt_value_map_insert_integer(params, "chunk-size", CHUNK_SIZE);
+	assert(ret == 0);
+	sink_comp = create_sink(graph, params);
+	ok(sink_comp, "component creation succeeds");
+	assert(sink_comp);
+
+	test_connect_ports(graph,
+		bt_component_source_get_output_port_by_name(src_comp, "out0"),
+		bt_component_sink_get_input_port_by_name(sink_comp, "in"));
+	graph_status = test_run_graph(graph);
+
+	ok(graph_status == BT_GRAPH_STATUS_END,
+		"graph finishes without any error");
+
+	schema = get_event_file("schema", &len);
+	ok(schema && strcmp(schema, expected_schema) == 0,
+		"schema file describes the event class and its columns");
+	g_free(schema);
+	ok(check_timestamp_column(),
+		"timestamp column is delta-encoded with its min/max");
+	ok(check_int_columns(),
+		"integer columns have the field widths with their min/max");
+	ok(check_float_columns(),
+		"floating point number columns have their min/max");
+	ok(check_string_column("event.fields.s.col", expected_s,
+		expected_s_len),
+		"string column has offsets, a blob, and min/max lengths");
+	ok(check_string_column("event.fields.text.col", expected_text,
+		expected_text_len),
+		"text array column stops at the first null character");
+	arr_path = g_build_filename(sink_path, EVENT_DIR_NAME,
+		"event.fields.arr.col", NULL);
+	ok(!g_file_test(arr_path, G_FILE_TEST_EXISTS),
+		"non-text array field has no column");
+	g_free(arr_path);
+	ok(g_file_test(sink_path, G_FILE_TEST_IS_DIR),
+		"output directory is created");
+
+	bt_put(params);
+	bt_put(src_comp);
+	bt_put(sink_comp);
+	bt_put(graph);
+	g_free(sink_path);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+
+	if (!g_mkdtemp(out_dir)) {
+		fail("cannot create a temporary directory");
+		return exit_status();
+	}
+
+	init_static_data();
+	test_no_path();
+	test_columns();
+	fini_static_data();
+	test_remove_dir(out_dir);
+	return exit_status();
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "tap/tap.h"
+#include "utils/stats/histogram.h"
+
+#define NR_TESTS	9
+
+/* Checks that `v` is within the bounds of its bucket */
+static
+bool check_value_bucket(uint64_t v)
+{
+	unsigned int index = stats_histogram_bucket_index(v);
+
+	if (index >= STATS_HISTOGRAM_BUCKET_COUNT ||
+			stats_histogram_bucket_lower(index) > v ||
+			stats_histogram_bucket_upper(index) < v) {
+		diag("value %" PRIu64 ": bucket %u", v, index);
+		return false;
+	}
+
+	return true;
+}
+
+/* xorshift64*: deterministic pseudo-random values */
+static
+uint64_t next_random(uint64_t *state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * UINT64_C(2685821657736338717);
+}
+
+static
+void test_buckets(void)
+{
+	uint64_t state = UINT64_C(0x9e3779b97f4a7c15);
+	bool small_ok = true;
+	bool random_ok = true;
+	bool contiguous_ok = true;
+	bool precision_ok = true;
+	uint64_t v;
+	unsigned int i;
+
+	for (v = 0; v <= 65536; v++) {
+		small_ok = small_ok && check_value_bucket(v);
+	}
+
+	ok(small_ok, "small values are within the bounds of their bucket");
+
+	for (i = 0; i < 100000; i++) {
+		v = next_random(&state) >> (i % 64);
+		random_ok = random_ok && check_value_bucket(v);
+	}
+
+	random_ok = random_ok && check_value_bucket(UINT64_MAX) &&
+		check_value_bucket(UINT64_C(1) << 63);
+	ok(random_ok, "random values are within the bounds of their bucket");
+
+	for (i = 0; i < STATS_HISTOGRAM_BUCKET_COUNT - 1; i++) {
+		if (stats_histogram_bucket_lower(i + 1) !=
+				stats_histogram_bucket_upper(i) + 1) {
+			diag("bucket %u: not contiguous with the next one", i);
+			contiguous_ok = false;
+		}
+	}
+
+	ok(contiguous_ok && stats_histogram_bucket_lower(0) == 0 &&
+		stats_histogram_bucket_upper(STATS_HISTOGRAM_BUCKET_COUNT - 1) ==
+			UINT64_MAX,
+		"buckets are contiguous and cover all the values");
+
+	for (i = STATS_HISTOGRAM_SUB_BUCKET_COUNT;
+			i < STATS_HISTOGRAM_BUCKET_COUNT; i++) {
+		uint64_t lower = stats_histogram_bucket_lower(i);
+		uint64_t width = stats_histogram_bucket_upper(i) - lower + 1;
+
+		if (width > lower / STATS_HISTOGRAM_SUB_BUCKET_COUNT) {
+			diag("bucket %u: too wide", i);
+			precision_ok = false;
+		}
+	}
+
+	ok(precision_ok, "bucket width is bounded by the relative precision");
+}
+
+static
+void test_record(void)
+{
+	struct stats_histogram hist;
+	uint64_t v;
+
+	memset(&hist, 0, sizeof(hist));
+
+	for (v = 10; v <= 1000; v++) {
+		stats_histogram_record(&hist, v);
+	}
+
+	stats_histogram_record(&hist, 5);
+	ok(hist.count == 992 && hist.min == 5 && hist.max == 1000 &&
+		hist.sum == 500455 + 5 &&
+		hist.buckets[stats_histogram_bucket_index(5)] == 1 &&
+		hist.buckets[stats_histogram_bucket_index(1000)] > 0,
+		"recording updates the count, min, max, sum, and buckets");
+	stats_histogram_record(&hist, UINT64_MAX);
+	ok(hist.sum == UINT64_MAX && hist.max == UINT64_MAX,
+		"sum saturates");
+}
+
+static
+void test_percentile(void)
+{
+	struct stats_histogram hist;
+	uint64_t v;
+	uint64_t p50;
+	uint64_t p99;
+
+	memset(&hist, 0, sizeof(hist));
+	ok(stats_histogram_percentile(&hist, 50.) == 0,
+		"percentile of an empty histogram is 0");
+
+	for (v = 1; v <= 1000; v++) {
+		stats_histogram_record(&hist, v);
+	}
+
+	p50 = stats_histogram_percentile(&hist, 50.);
+	p99 = stats_histogram_percentile(&hist, 99.);
+	ok(p50 >= 500 && p50 <= 500 + 500 / STATS_HISTOGRAM_SUB_BUCKET_COUNT &&
+		p99 >= 990 && p99 <= 1000,
+		"percentiles are within the relative precision");
+	ok(stats_histogram_percentile(&hist, 100.) == 1000 &&
+		stats_histogram_percentile(&hist, 0.) == 1,
+		"percentiles 0 and 100 are the minimum and maximum");
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	test_buckets();
+	test_record();
+	test_percentile();
+	return exit_status();
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <babeltrace/babeltrace.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "tap/tap.h"
+#include "common.h"
+
+#define NR_TESTS	10
+
+#define EVENT_COUNT	10
+
+/* Every third event (starting with the first one) is a `first` event */
+#define FIRST_EVENT_COUNT	((EVENT_COUNT + 2) / 3)
+#define SECOND_EVENT_COUNT	(EVENT_COUNT - FIRST_EVENT_COUNT)
+
+static struct bt_clock_class_priority_map *src_cc_prio_map;
+static struct bt_clock_class *src_clock_class;
+static struct bt_stream_class *src_stream_class;
+static struct bt_event_class *src_first_event_class;
+static struct bt_event_class *src_second_event_class;
+static struct bt_packet *src_packet;
+static struct test_src_stream src_stream;
+static struct test_src_config src_config;
+
+static
+struct bt_event_class *create_event_class(const char *name,
+		struct bt_field_type *empty_struct_ft)
+{
+	struct bt_event_class *event_class = bt_event_class_create(name);
+	struct bt_field_type *payload_ft;
+	struct bt_field_type *ft;
+	int ret;
+
+	assert(event_class);
+	ret = bt_event_class_set_context_type(event_class, empty_struct_ft);
+	assert(ret == 0);
+	payload_ft = bt_field_type_structure_create();
+	assert(payload_ft);
+	ft = bt_field_type_integer_create(32);
+	assert(ft);
+	ret = bt_field_type_structure_add_field(payload_ft, ft, "value");
+	assert(ret == 0);
+	bt_put(ft);
+	ret = bt_event_class_set_payload_type(event_class, payload_ft);
+	assert(ret == 0);
+	bt_put(payload_ft);
+	ret = bt_stream_class_add_event_class(src_stream_class, event_class);
+	assert(ret == 0);
+	return event_class;
+}
+
+static
+struct bt_event *src_create_event(uint64_t stream_index, uint64_t i)
+{
+	struct bt_event *event = bt_event_create(i % 3 == 0 ?
+		src_first_event_class : src_second_event_class);
+	struct bt_clock_value *clock_value;
+	struct bt_field *payload;
+	struct bt_field *field;
+	int ret;
+
+	assert(event);
+	ret = bt_event_set_packet(event, src_packet);
+	assert(ret == 0);
+	clock_value = bt_clock_value_create(src_clock_class, 1000 + i * 100);
+	assert(clock_value);
+	ret = bt_event_set_clock_value(event, clock_value);
+	assert(ret == 0);
+	bt_put(clock_value);
+	payload = bt_event_get_payload(event, NULL);
+	assert(payload);
+	field = bt_field_structure_get_field_by_name(payload, "value");
+	assert(field);
+	ret = bt_field_unsigned_integer_set_value(field, i);
+	assert(ret == 0);
+	bt_put(field);
+	bt_put(payload);
+	return event;
+}
+
+static
+void init_static_data(void)
+{
+	int ret;
+	struct bt_trace *trace;
+	struct bt_stream *stream;
+	struct bt_field_type *empty_struct_ft;
+
+	/* Metadata */
+	empty_struct_ft = bt_field_type_structure_create();
+	assert(empty_struct_ft);
+	trace = bt_trace_create();
+	assert(trace);
+	ret = bt_trace_set_native_byte_order(trace,
+		BT_BYTE_ORDER_LITTLE_ENDIAN);
+	assert(ret == 0);
+	ret = bt_trace_set_packet_header_type(trace, empty_struct_ft);
+	assert(ret == 0);
+	src_clock_class = bt_clock_class_create("my-clock", 1000000000);
+	assert(src_clock_class);
+	ret = bt_clock_class_set_is_absolute(src_clock_class, 1);
+	assert(ret == 0);
+	ret = bt_trace_add_clock_class(trace, src_clock_class);
+	assert(ret == 0);
+	src_cc_prio_map = bt_clock_class_priority_map_create();
+	assert(src_cc_prio_map);
+	ret = bt_clock_class_priority_map_add_clock_class(src_cc_prio_map,
+		src_clock_class, 0);
+	assert(ret == 0);
+	src_stream_class = bt_stream_class_create("my-stream-class");
+	assert(src_stream_class);
+	ret = bt_stream_class_set_packet_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_header_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	src_first_event_class = create_event_class("first", empty_struct_ft);
+	src_second_event_class = create_event_class("second",
+		empty_struct_ft);
+	ret = bt_trace_add_stream_class(trace, src_stream_class);
+	assert(ret == 0);
+	stream = bt_stream_create(src_stream_class, "stream0");
+	assert(stream);
+	src_packet = bt_packet_create(stream);
+	assert(src_packet);
+	bt_put(stream);
+	bt_put(trace);
+	bt_put(empty_struct_ft);
+
+	/* Source */
+	src_stream.packet = src_packet;
+	src_stream.event_count = EVENT_COUNT;
+	src_config.streams = &src_stream;
+	src_config.stream_count = 1;
+	src_config.cc_prio_map = src_cc_prio_map;
+	src_config.create_event = src_create_event;
+}
+
+static
+void fini_static_data(void)
+{
+	bt_put(src_cc_prio_map);
+	bt_put(src_clock_class);
+	bt_put(src_stream_class);
+	bt_put(src_first_event_class);
+	bt_put(src_second_event_class);
+	bt_put(src_packet);
+}
+
+/*
+ * Runs a graph made of the source and of a sink.utils.stats component
+ * and returns what the sink prints (to free), or NULL on error.
+ * `*graph_status` is set to the last status of bt_graph_run().
+ */
+static
+gchar *run_graph(enum bt_graph_status *graph_status)
+{
+	struct bt_component *src_comp;
+	struct bt_component *sink_comp;
+	struct bt_graph *graph;
+	gchar *output = NULL;
+	gchar *output_path = NULL;
+	int output_fd;
+	int stdout_fd;
+	int ret;
+
+	graph = bt_graph_create();
+	assert(graph);
+	src_comp = test_src_add(graph, &src_config);
+	sink_comp = test_add_plugin_component(graph, "utils", "stats",
+		BT_COMPONENT_CLASS_TYPE_SINK, "sink", NULL);
+	assert(sink_comp);
+	test_connect_ports(graph,
+		bt_component_source_get_output_port_by_name(src_comp, "out0"),
+		bt_component_sink_get_input_port_by_name(sink_comp, "in"));
+
+	/* The sink prints to the standard output: redirect it to a file */
+	output_fd = g_file_open_tmp("test-utils-stats-XXXXXX", &output_path,
+		NULL);
+	assert(output_fd >= 0);
+	fflush(stdout);
+	stdout_fd = dup(STDOUT_FILENO);
+	assert(stdout_fd >= 0);
+	ret = dup2(output_fd, STDOUT_FILENO);
+	assert(ret >= 0);
+
+	*graph_status = test_run_graph(graph);
+
+	/* Finalizing the sink can also print the statistics */
+	bt_put(src_comp);
+	bt_put(sink_comp);
+	bt_put(graph);
+	fflush(stdout);
+	ret = dup2(stdout_fd, STDOUT_FILENO);
+	assert(ret >= 0);
+	close(stdout_fd);
+	close(output_fd);
+
+	if (!g_file_get_contents(output_path, &output, NULL, NULL)) {
+		output = NULL;
+	}
+
+	(void) g_unlink(output_path);
+	g_free(output_path);
+	return output;
+}
+
+/*
+ * Returns the value of the first line of `output`, except its first
+ * line, which is `key: VALUE` after `indent` spaces, or -1 if there's
+ * none.
+ */
+static
+int64_t get_value(const gchar *output, unsigned int indent, const char *key)
+{
+	gchar *prefix = g_strdup_printf("\n%*s%s: ", indent, "", key);
+	const gchar *line = strstr(output, prefix);
+	int64_t value = -1;
+
+	if (line) {
+		value = g_ascii_strtoll(line + strlen(prefix), NULL, 10);
+	}
+
+	g_free(prefix);
+	return value;
+}
+
+/* Returns the number of occurrences of `needle` in `haystack` */
+static
+unsigned int count_occurrences(const gchar *haystack, const gchar *needle)
+{
+	unsigned int count = 0;
+
+	while ((haystack = strstr(haystack, needle))) {
+		count++;
+		haystack += strlen(needle);
+	}
+
+	return count;
+}
+
+/*
+ * Returns the number of events of the event class named `name` in
+ * `output`, or -1 if there's no such event class.
+ *
+ * The keys of an event class's map are sorted, so that its `events`
+ * entry, which starts the map, comes before its `name` entry.
+ */
+static
+int64_t get_event_class_count(const gchar *output, const char *name)
+{
+	gchar **lines = g_strsplit(output, "\n", -1);
+	gchar *name_line = g_strdup_printf("    name: %s", name);
+	int64_t count = -1;
+	int64_t cur_count = -1;
+	gchar **line;
+
+	for (line = lines; *line; line++) {
+		if (g_str_has_prefix(*line, "  - events: ")) {
+			cur_count = g_ascii_strtoll(*line + strlen("  - events: "),
+				NULL, 10);
+		} else if (strcmp(*line, name_line) == 0) {
+			count = cur_count;
+			break;
+		} else if (g_str_has_prefix(*line, "streams:")) {
+			break;
+		}
+	}
+
+	g_free(name_line);
+	g_strfreev(lines);
+	return count;
+}
+
+static
+void test_counts(void)
+{
+	enum bt_graph_status graph_status = BT_GRAPH_STATUS_OK;
+	gchar *output = run_graph(&graph_status);
+	const gchar *streams;
+
+	ok(graph_status == BT_GRAPH_STATUS_END,
+		"graph finishes without any error");
+	ok(output, "sink prints statistics");
+
+	if (!output) {
+		skip(5, "No statistics");
+		return;
+	}
+
+	ok(get_value(output, 0, "events") == EVENT_COUNT,
+		"total number of events is printed");
+	ok(get_event_class_count(output, "first") == FIRST_EVENT_COUNT,
+		"number of events of the first event class is printed");
+	ok(get_event_class_count(output, "second") == SECOND_EVENT_COUNT,
+		"number of events of the second event class is printed");
+	streams = strstr(output, "\nstreams:\n");
+	ok(streams && get_value(streams, 4, "events") == EVENT_COUNT &&
+		get_value(streams, 4, "packets") == 1,
+		"numbers of events and packets of the stream are printed");
+	ok(count_occurrences(output, "event-classes:") == 1,
+		"statistics are printed once");
+	g_free(output);
+}
+
+/*
+ * Returns whether a sink.utils.stats component can be created with
+ * `params`.
+ */
+static
+bool can_create_sink(struct bt_value *params)
+{
+	struct bt_graph *graph = bt_graph_create();
+	struct bt_component *sink_comp;
+	bool created;
+
+	assert(graph);
+	sink_comp = test_add_plugin_component(graph, "utils", "stats",
+		BT_COMPONENT_CLASS_TYPE_SINK, "sink", params);
+	created = sink_comp != NULL;
+	bt_put(sink_comp);
+	bt_put(graph);
+	return created;
+}
+
+static
+void test_invalid_params(void)
+{
+	struct bt_value *params = bt_value_map_create();
+	int ret;
+
+	assert(params);
+	ret = bt_value_map_insert_string(params, "step", "10");
+	assert(ret == 0);
+	ok(!can_create_sink(params),
+		"component creation fails with a non-integer `step` parameter");
+	ret = bt_value_map_insert_integer(params, "step", -1);
+	assert(ret == 0);
+	ok(!can_create_sink(params),
+		"component creation fails with a negative `step` parameter");
+	ret = bt_value_map_insert_integer(params, "step", 10);
+	assert(ret == 0);
+	ret = bt_value_map_insert_integer(params, "buckets", 1);
+	assert(ret == 0);
+	ok(!can_create_sink(params),
+		"component creation fails with a non-boolean `buckets` parameter");
+	bt_put(params);
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	init_static_data();
+	test_counts();
+	test_invalid_params();
+	fini_static_data();
+	return exit_status();
+}
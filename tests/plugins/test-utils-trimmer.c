@@ -0,0 +1,613 @@
+/*
+ * Copyright 2017 EfficiOS Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; under version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+#include <assert.h>
+#include <babeltrace/babeltrace.h>
+#include <glib.h>
+
+#include "tap/tap.h"
+#include "common.h"
+
+#define NR_TESTS	10
+
+/* Trimmer's bounds (ns from Epoch) */
+#define BEGIN_NS	150
+#define END_NS		450
+
+/* Time of day of BEGIN_NS, a lazy bound resolved with the first event */
+#define LAZY_BEGIN	"00:00:00.000000150"
+
+/* Number of events after which a source iterator returns "again" once */
+#define AGAIN_AFTER_EVENTS	2
+
+#define STREAM_COUNT	2
+
+/*
+ * Event times of each stream. The packet of each stream begins at the
+ * time of its first event and ends at the time of its last event.
+ *
+ * Stream 1's packet begins after the trimmer's end bound, while stream
+ * 0 still has events within the bounds. The muxer delivers the
+ * "packet begin" notification of stream 1 before the events of stream
+ * 0 because it has no time.
+ */
+static const int64_t stream0_ts[] = { 100, 200, 300, 400, 500, -1 };
+static const int64_t stream1_ts[] = { 1000, 1100, -1 };
+static const int64_t *streams_ts[STREAM_COUNT] = { stream0_ts, stream1_ts };
+
+/* Expected times of the events which the sink receives */
+static const int64_t expected_ts[] = { 200, 300, 400, -1 };
+
+static struct bt_clock_class_priority_map *src_cc_prio_map;
+static struct bt_clock_class *src_clock_class;
+static struct bt_stream_class *src_stream_class;
+static struct bt_event_class *src_event_class;
+static struct bt_packet *src_packets[STREAM_COUNT];
+static struct test_src_stream src_streams[STREAM_COUNT];
+
+/* Times of the events which the sink received */
+static GArray *sink_ts;
+
+/* Number of "packet begin" notifications which the sink received */
+static uint64_t sink_packet_begin_count;
+
+/* Time to which each source notification iterator was sought, if any */
+static int64_t sought_ns[STREAM_COUNT];
+static bool sought[STREAM_COUNT];
+
+/* Number of events before the beginning bound which the source created */
+static uint64_t src_events_before_begin;
+
+static
+uint64_t ts_count(const int64_t *ts)
+{
+	uint64_t count = 0;
+
+	while (ts[count] >= 0) {
+		count++;
+	}
+
+	return count;
+}
+
+static
+struct bt_field_type *create_clock_int_ft(void)
+{
+	struct bt_field_type *ft = bt_field_type_integer_create(64);
+	int ret;
+
+	assert(ft);
+	ret = bt_field_type_integer_set_mapped_clock_class(ft,
+		src_clock_class);
+	assert(ret == 0);
+	return ft;
+}
+
+static
+struct bt_field_type *create_packet_context_ft(void)
+{
+	struct bt_field_type *ft = bt_field_type_structure_create();
+	struct bt_field_type *int_ft;
+	int ret;
+
+	assert(ft);
+	int_ft = create_clock_int_ft();
+	ret = bt_field_type_structure_add_field(ft, int_ft,
+		"timestamp_begin");
+	assert(ret == 0);
+	bt_put(int_ft);
+	int_ft = create_clock_int_ft();
+	ret = bt_field_type_structure_add_field(ft, int_ft, "timestamp_end");
+	assert(ret == 0);
+	bt_put(int_ft);
+	return ft;
+}
+
+static
+void set_packet_context_field(struct bt_packet *packet, const char *name,
+		uint64_t value)
+{
+	struct bt_field *packet_context = bt_packet_get_context(packet);
+	struct bt_field *field;
+	int ret;
+
+	assert(packet_context);
+	field = bt_field_structure_get_field_by_name(packet_context, name);
+	assert(field);
+	ret = bt_field_unsigned_integer_set_value(field, value);
+	assert(ret == 0);
+	bt_put(field);
+	bt_put(packet_context);
+}
+
+static
+void init_static_data(void)
+{
+	int ret;
+	int i;
+	struct bt_trace *trace;
+	struct bt_field_type *empty_struct_ft;
+	struct bt_field_type *packet_context_ft;
+
+	/* Metadata */
+	empty_struct_ft = bt_field_type_structure_create();
+	assert(empty_struct_ft);
+	trace = bt_trace_create();
+	assert(trace);
+	ret = bt_trace_set_native_byte_order(trace,
+		BT_BYTE_ORDER_LITTLE_ENDIAN);
+	assert(ret == 0);
+	ret = bt_trace_set_packet_header_type(trace, empty_struct_ft);
+	assert(ret == 0);
+	src_clock_class = bt_clock_class_create("my-clock", 1000000000);
+	assert(src_clock_class);
+	ret = bt_clock_class_set_is_absolute(src_clock_class, 1);
+	assert(ret == 0);
+	ret = bt_trace_add_clock_class(trace, src_clock_class);
+	assert(ret == 0);
+	src_cc_prio_map = bt_clock_class_priority_map_create();
+	assert(src_cc_prio_map);
+	ret = bt_clock_class_priority_map_add_clock_class(src_cc_prio_map,
+		src_clock_class, 0);
+	assert(ret == 0);
+	src_stream_class = bt_stream_class_create("my-stream-class");
+	assert(src_stream_class);
+	packet_context_ft = create_packet_context_ft();
+	ret = bt_stream_class_set_packet_context_type(src_stream_class,
+		packet_context_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_header_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_set_event_context_type(src_stream_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	src_event_class = bt_event_class_create("my-event-class");
+	assert(src_event_class);
+	ret = bt_event_class_set_context_type(src_event_class,
+		empty_struct_ft);
+	assert(ret == 0);
+	ret = bt_stream_class_add_event_class(src_stream_class,
+		src_event_class);
+	assert(ret == 0);
+	ret = bt_trace_add_stream_class(trace, src_stream_class);
+	assert(ret == 0);
+
+	for (i = 0; i < STREAM_COUNT; i++) {
+		const int64_t *ts = streams_ts[i];
+		struct bt_stream *stream;
+		char name[16];
+
+		snprintf(name, sizeof(name), "stream%d", i);
+		stream = bt_stream_create(src_stream_class, name);
+		assert(stream);
+		src_packets[i] = bt_packet_create(stream);
+		assert(src_packets[i]);
+		set_packet_context_field(src_packets[i], "timestamp_begin",
+			(uint64_t) ts[0]);
+		set_packet_context_field(src_packets[i], "timestamp_end",
+			(uint64_t) ts[ts_count(ts) - 1]);
+		src_streams[i].packet = src_packets[i];
+		src_streams[i].event_count = ts_count(ts);
+		bt_put(stream);
+	}
+
+	bt_put(trace);
+	bt_put(packet_context_ft);
+	bt_put(empty_struct_ft);
+}
+
+static
+void fini_static_data(void)
+{
+	int i;
+
+	bt_put(src_cc_prio_map);
+	bt_put(src_clock_class);
+	bt_put(src_stream_class);
+	bt_put(src_event_class);
+
+	for (i = 0; i < STREAM_COUNT; i++) {
+		bt_put(src_packets[i]);
+	}
+}
+
+static
+struct bt_event *src_create_event(uint64_t stream_index, uint64_t index)
+{
+	struct bt_event *event = bt_event_create(src_event_class);
+	struct bt_clock_value *clock_value;
+	int64_t ts = streams_ts[stream_index][index];
+	int ret;
+
+	assert(event);
+	ret = bt_event_set_packet(event, src_packets[stream_index]);
+	assert(ret == 0);
+	clock_value = bt_clock_value_create(src_clock_class, (uint64_t) ts);
+	assert(clock_value);
+	ret = bt_event_set_clock_value(event, clock_value);
+	assert(ret == 0);
+	bt_put(clock_value);
+
+	if (ts < BEGIN_NS) {
+		src_events_before_begin++;
+	}
+
+	return event;
+}
+
+static
+int64_t src_get_event_ns(uint64_t stream_index, uint64_t index)
+{
+	return streams_ts[stream_index][index];
+}
+
+static
+void src_sought(uint64_t stream_index, int64_t ns_from_epoch)
+{
+	sought[stream_index] = true;
+	sought_ns[stream_index] = ns_from_epoch;
+}
+
+static
+enum bt_component_status sink_consume(
+		struct bt_private_component *priv_component)
+{
+	enum bt_component_status ret = BT_COMPONENT_STATUS_OK;
+	struct bt_notification_iterator *notif_iter =
+		bt_private_component_get_user_data(priv_component);
+	struct bt_notification *notification = NULL;
+	enum bt_notification_iterator_status it_ret;
+
+	assert(notif_iter);
+	it_ret = bt_notification_iterator_next(notif_iter);
+
+	switch (it_ret) {
+	case BT_NOTIFICATION_ITERATOR_STATUS_OK:
+		break;
+	case BT_NOTIFICATION_ITERATOR_STATUS_END:
+		ret = BT_COMPONENT_STATUS_END;
+		goto end;
+	case BT_NOTIFICATION_ITERATOR_STATUS_AGAIN:
+		ret = BT_COMPONENT_STATUS_AGAIN;
+		goto end;
+	default:
+		ret = BT_COMPONENT_STATUS_ERROR;
+		goto end;
+	}
+
+	notification = bt_notification_iterator_get_notification(notif_iter);
+	assert(notification);
+
+	if (bt_notification_get_type(notification) ==
+			BT_NOTIFICATION_TYPE_PACKET_BEGIN) {
+		sink_packet_begin_count++;
+	} else if (bt_notification_get_type(notification) ==
+			BT_NOTIFICATION_TYPE_EVENT) {
+		struct bt_event *event =
+			bt_notification_event_get_event(notification);
+		struct bt_clock_value *clock_value;
+		int64_t ts;
+		int int_ret;
+
+		assert(event);
+		clock_value = bt_event_get_clock_value(event, src_clock_class);
+		assert(clock_value);
+		int_ret = bt_clock_value_get_value_ns_from_epoch(clock_value,
+			&ts);
+		assert(int_ret == 0);
+		g_array_append_val(sink_ts, ts);
+		bt_put(clock_value);
+		bt_put(event);
+	}
+
+end:
+	bt_put(notification);
+	return ret;
+}
+
+static
+void sink_port_connected(struct bt_private_component *private_component,
+		struct bt_private_port *self_private_port,
+		struct bt_port *other_port)
+{
+	struct bt_private_connection *priv_conn =
+		bt_private_port_get_private_connection(self_private_port);
+	struct bt_notification_iterator *notif_iter = NULL;
+	enum bt_connection_status conn_status;
+	int ret;
+
+	assert(priv_conn);
+	conn_status = bt_private_connection_create_notification_iterator(
+		priv_conn, NULL, &notif_iter);
+	assert(conn_status == 0);
+	ret = bt_private_component_set_user_data(private_component,
+		notif_iter);
+	assert(ret == 0);
+	bt_put(priv_conn);
+}
+
+static
+enum bt_component_status sink_init(
+		struct bt_private_component *private_component,
+		struct bt_value *params, void *init_method_data)
+{
+	int ret;
+
+	ret = bt_private_component_sink_add_input_private_port(
+		private_component, "in", NULL, NULL);
+	assert(ret == 0);
+	return BT_COMPONENT_STATUS_OK;
+}
+
+static
+void sink_finalize(struct bt_private_component *private_component)
+{
+	bt_put(bt_private_component_get_user_data(private_component));
+}
+
+/*
+ * Connects the source's output port `port_name` to the first available
+ * input port of the muxer.
+ */
+static
+void connect_src_to_muxer(struct bt_graph *graph,
+		struct bt_component *src_comp, const char *port_name,
+		struct bt_component *muxer_comp)
+{
+	struct bt_port *avail_muxer_port = NULL;
+	int64_t count;
+	int64_t i;
+
+	count = bt_component_filter_get_input_port_count(muxer_comp);
+	assert(count >= 0);
+
+	for (i = 0; i < count; i++) {
+		struct bt_port *muxer_port =
+			bt_component_filter_get_input_port_by_index(
+				muxer_comp, i);
+
+		assert(muxer_port);
+
+		if (!bt_port_is_connected(muxer_port)) {
+			BT_MOVE(avail_muxer_port, muxer_port);
+			break;
+		} else {
+			bt_put(muxer_port);
+		}
+	}
+
+	test_connect_ports(graph,
+		bt_component_source_get_output_port_by_name(src_comp,
+			port_name),
+		avail_muxer_port);
+}
+
+/*
+ * Runs the graph source -> muxer -> trimmer -> sink, the source
+ * supporting the "seek time" operation if `with_seek` is true. The
+ * trimmer's beginning bound is LAZY_BEGIN if `lazy_begin` is true, and
+ * BEGIN_NS otherwise. With a lazy beginning bound, the source iterators
+ * return BT_NOTIFICATION_ITERATOR_STATUS_AGAIN once after
+ * AGAIN_AFTER_EVENTS events, so that the muxer already has some events
+ * of a stream, but not all its notifications, when the trimmer seeks.
+ */
+static
+enum bt_graph_status run_graph(bool with_seek, bool lazy_begin)
+{
+	struct test_src_config src_config = { 0 };
+	struct bt_component_class *sink_comp_class;
+	struct bt_component *src_comp;
+	struct bt_component *muxer_comp;
+	struct bt_component *trimmer_comp;
+	struct bt_component *sink_comp;
+	struct bt_value *trimmer_params;
+	struct bt_graph *graph;
+	enum bt_graph_status graph_status;
+	int ret;
+	int i;
+
+	g_array_set_size(sink_ts, 0);
+	sink_packet_begin_count = 0;
+	src_events_before_begin = 0;
+
+	for (i = 0; i < STREAM_COUNT; i++) {
+		sought[i] = false;
+		sought_ns[i] = 0;
+	}
+
+	graph = bt_graph_create();
+	assert(graph);
+
+	/* Create source component */
+	src_config.streams = src_streams;
+	src_config.stream_count = STREAM_COUNT;
+	src_config.cc_prio_map = src_cc_prio_map;
+	src_config.create_event = src_create_event;
+
+	if (with_seek) {
+		src_config.get_event_ns = src_get_event_ns;
+		src_config.sought = src_sought;
+	}
+
+	/*
+	 * With a lazy bound, the first batch of the muxer contains some
+	 * events, but not all the notifications.
+	 */
+	if (lazy_begin) {
+		src_config.again_after_events = AGAIN_AFTER_EVENTS;
+	}
+
+	src_comp = test_src_add(graph, &src_config);
+
+	/* Create muxer and trimmer components */
+	muxer_comp = test_add_plugin_component(graph, "utils", "muxer",
+		BT_COMPONENT_CLASS_TYPE_FILTER, "muxer", NULL);
+	assert(muxer_comp);
+	trimmer_params = bt_value_map_create();
+	assert(trimmer_params);
+
+	if (lazy_begin) {
+		ret = bt_value_map_insert_string(trimmer_params, "begin",
+			LAZY_BEGIN);
+		assert(ret == 0);
+		ret = bt_value_map_insert_bool(trimmer_params, "clock-gmt",
+			BT_TRUE);
+	} else {
+		ret = bt_value_map_insert_integer(trimmer_params, "begin",
+			BEGIN_NS);
+	}
+
+	assert(ret == 0);
+	ret = bt_value_map_insert_integer(trimmer_params, "end", END_NS);
+	assert(ret == 0);
+	trimmer_comp = test_add_plugin_component(graph, "utils", "trimmer",
+		BT_COMPONENT_CLASS_TYPE_FILTER, "trimmer", trimmer_params);
+	assert(trimmer_comp);
+
+	/* Create sink component */
+	sink_comp_class = bt_component_class_sink_create("sink", sink_consume);
+	assert(sink_comp_class);
+	ret = bt_component_class_set_init_method(sink_comp_class, sink_init);
+	assert(ret == 0);
+	ret = bt_component_class_set_finalize_method(sink_comp_class,
+		sink_finalize);
+	assert(ret == 0);
+	ret = bt_component_class_set_port_connected_method(sink_comp_class,
+		sink_port_connected);
+	assert(ret == 0);
+	ret = bt_graph_add_component(graph, sink_comp_class, "sink", NULL,
+		&sink_comp);
+	assert(ret == 0);
+
+	/* Connect ports */
+	connect_src_to_muxer(graph, src_comp, "out0", muxer_comp);
+	connect_src_to_muxer(graph, src_comp, "out1", muxer_comp);
+	test_connect_ports(graph,
+		bt_component_filter_get_output_port_by_name(muxer_comp, "out"),
+		bt_component_filter_get_input_port_by_name(trimmer_comp, "in"));
+	test_connect_ports(graph,
+		bt_component_filter_get_output_port_by_name(trimmer_comp,
+			"out"),
+		bt_component_sink_get_input_port_by_name(sink_comp, "in"));
+
+	graph_status = test_run_graph(graph);
+	bt_put(trimmer_params);
+	bt_put(src_comp);
+	bt_put(muxer_comp);
+	bt_put(trimmer_comp);
+	bt_put(sink_comp);
+	bt_put(sink_comp_class);
+	bt_put(graph);
+	return graph_status;
+}
+
+static
+bool all_sought_to_begin(void)
+{
+	int i;
+
+	for (i = 0; i < STREAM_COUNT; i++) {
+		if (!sought[i] || sought_ns[i] != BEGIN_NS) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static
+bool sink_got_expected_events(void)
+{
+	uint64_t i;
+
+	if (sink_ts->len != ts_count(expected_ts)) {
+		diag("sink received %u events, expecting %" PRIu64,
+			sink_ts->len, ts_count(expected_ts));
+		return false;
+	}
+
+	for (i = 0; i < sink_ts->len; i++) {
+		int64_t ts = g_array_index(sink_ts, int64_t, i);
+
+		if (ts != expected_ts[i]) {
+			diag("event %" PRIu64 ": time %" PRId64 ", expecting %" PRId64,
+				i, ts, expected_ts[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static
+void test_two_streams(void)
+{
+	diag("test: two streams, one of them beginning after the end bound");
+	ok(run_graph(false, false) == BT_GRAPH_STATUS_END,
+		"graph finishes without any error");
+	ok(sink_got_expected_events(),
+		"all the events within the bounds are delivered");
+}
+
+static
+void test_seek_through_muxer(void)
+{
+	diag("test: seeking the source through the muxer");
+	ok(run_graph(true, false) == BT_GRAPH_STATUS_END,
+		"graph finishes without any error");
+	ok(sink_got_expected_events(),
+		"all the events within the bounds are delivered");
+	ok(all_sought_to_begin(),
+		"muxer forwards the beginning bound to all its upstream iterators");
+	ok(src_events_before_begin == 0,
+		"source does not create the events before the beginning bound");
+}
+
+static
+void test_seek_lazy_begin_bound(void)
+{
+	diag("test: seeking the source to a lazy beginning bound");
+	ok(run_graph(true, true) == BT_GRAPH_STATUS_END,
+		"graph finishes without any error");
+	ok(sink_got_expected_events(),
+		"all the events within the bounds are delivered once");
+	ok(sink_packet_begin_count == 1,
+		"the packet within the bounds begins once");
+	ok(all_sought_to_begin(),
+		"lazy beginning bound is forwarded to the upstream iterators");
+}
+
+int main(int argc, char **argv)
+{
+	plan_tests(NR_TESTS);
+	sink_ts = g_array_new(FALSE, FALSE, sizeof(int64_t));
+	assert(sink_ts);
+	init_static_data();
+	test_two_streams();
+	test_seek_through_muxer();
+	test_seek_lazy_begin_bound();
+	fini_static_data();
+	g_array_free(sink_ts, TRUE);
+	return exit_status();
+}